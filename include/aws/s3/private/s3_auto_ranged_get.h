@@ -8,12 +8,29 @@
 
 #include "aws/s3/private/s3_meta_request_impl.h"
 
+#include <aws/common/array_list.h>
+
+/* Number of recent part durations that parts in flight are compared against, to find the ones to hedge. */
+#define AWS_S3_AUTO_RANGED_GET_NUM_PART_DURATIONS 32
+
 enum aws_s3_auto_ranged_get_request_type {
     AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_HEAD_OBJECT,
     AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE,
     AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_PART_NUMBER_1,
 };
 
+/* A part in flight with a duplicate request (see aws_s3_get_hedge_options).
+ * Holds a reference to both requests until both have finished. */
+struct aws_s3_hedged_part {
+    struct aws_s3_request *original;
+    struct aws_s3_request *hedge;
+
+    uint32_t num_finished;
+
+    /* True once one of the two requests stood in for the part. The other one is dropped when it finishes. */
+    bool resolved;
+};
+
 struct aws_s3_auto_ranged_get {
     struct aws_s3_meta_request base;
 
@@ -21,6 +38,9 @@ struct aws_s3_auto_ranged_get {
 
     struct aws_string *etag;
 
+    /* Client's block cache, if parts of this meta request can be served from it. */
+    struct aws_s3_block_cache *block_cache;
+
     bool initial_message_has_start_range;
     bool initial_message_has_end_range;
     uint64_t initial_range_start;
@@ -29,6 +49,12 @@ struct aws_s3_auto_ranged_get {
     uint64_t object_size_hint;
     bool object_size_hint_available;
 
+    /* Size of the object from the client's object metadata cache, if object_range_from_cache */
+    uint64_t cached_object_size;
+
+    /* Wakes up the client to look for parts to hedge, once the oldest part in flight becomes a straggler. */
+    struct aws_task hedge_check_task;
+
     /* Members to only be used when the mutex in the base type is locked. */
     struct {
         /* The starting byte of the data that we will be retrieved from the object.
@@ -47,12 +73,42 @@ struct aws_s3_auto_ranged_get {
          * currently refers to a range-get, and does not require a "part" on the service side. */
         uint32_t total_num_parts;
 
+        /* Once the tail of the object range is split (see aws_s3_client_config.get_tail_min_part_size), the parts
+         * from tail_first_part_number on are tail_part_size long, starting at tail_range_start. 0 until then. */
+        uint32_t tail_first_part_number;
+        uint64_t tail_range_start;
+        uint64_t tail_part_size;
+
         uint32_t num_parts_requested;
         uint32_t num_parts_completed;
         uint32_t num_parts_successful;
         uint32_t num_parts_failed;
         uint32_t num_parts_checksum_validated;
 
+        /* Parts sent after part 1 while it discovers the object range, and the max number of them.
+         * They are numbered 2 to num_speculative_parts + 1. */
+        uint32_t num_speculative_parts;
+        uint32_t max_speculative_parts;
+
+        /* Lowest part number of the speculative parts that were found to be past the end of the object (416).
+         * 0 if none. */
+        uint32_t first_speculative_part_past_end;
+
+        /* ETag of the first successful speculative part, checked against the ETag discovered with the object range */
+        struct aws_string *speculative_etag;
+
+        /* Durations of the recently finished parts, as a ring buffer. num_part_durations counts all of them. */
+        uint64_t part_durations_ns[AWS_S3_AUTO_RANGED_GET_NUM_PART_DURATIONS];
+        uint32_t num_part_durations;
+
+        /* aws_array_list<struct aws_s3_hedged_part> of the parts with a duplicate request that hasn't finished */
+        struct aws_array_list hedged_parts;
+        uint32_t num_hedges_requested;
+
+        /* Each hedged part is counted once in num_parts_completed, by the request that stood in for it. This counts
+         * the other requests, which lost and are still in flight. */
+        uint32_t num_hedge_losers_in_flight;
+
         uint32_t object_range_known : 1;
 
         /* True if object_range_known, and it's found to be empty.
@@ -61,10 +117,15 @@ struct aws_s3_auto_ranged_get {
         uint32_t head_object_sent : 1;
         uint32_t head_object_completed : 1;
         uint32_t read_window_warning_issued : 1;
+        uint32_t hedge_check_scheduled : 1;
     } synced_data;
 
     uint32_t initial_message_has_range_header : 1;
     uint32_t initial_message_has_if_match_header : 1;
+
+    /* True if the object range came from the client's object metadata cache instead of a discovery request.
+     * Part 1 then checks the ETag and delivers the response headers. */
+    uint32_t object_range_from_cache : 1;
 };
 
 AWS_EXTERN_C_BEGIN
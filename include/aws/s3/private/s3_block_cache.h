@@ -0,0 +1,77 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#ifndef AWS_S3_BLOCK_CACHE_H
+#define AWS_S3_BLOCK_CACHE_H
+
+#include <aws/s3/s3_client.h>
+
+#include <aws/common/byte_buf.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_event_loop_group;
+struct aws_future_bool;
+struct aws_http_message;
+
+/**
+ * Block cache keeps parts of objects downloaded by ranged GetObject requests, so later downloads of the same
+ * parts of the same version of an object can skip the request.
+ *
+ * Blocks are held in memory up to memory_limit_in_bytes. Past that, the eviction policy picks which block
+ * leaves memory. If a spill directory is set, the block is written to a file there instead of being dropped,
+ * and spilled files are evicted oldest first once disk_limit_in_bytes is reached. Spilled files are written
+ * and read without the cache's lock held, by tasks on the I/O ELG passed to get or put. With a NULL ELG, the
+ * calling thread does the file I/O instead.
+ *
+ * All functions are thread-safe.
+ */
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Init out_key with the cache key of a byte range of the object the message gets, at the given ETag.
+ * The key is made of the Host header, the request path, the ETag and the range (range_end is inclusive).
+ */
+AWS_S3_API
+int aws_s3_block_cache_key_init(
+    struct aws_byte_buf *out_key,
+    struct aws_allocator *allocator,
+    const struct aws_http_message *message,
+    struct aws_byte_cursor etag,
+    uint64_t range_start,
+    uint64_t range_end);
+
+/**
+ * Copy the block cached under key to the end of dest.
+ * The future's result is true on a hit. It's false on a miss, or if the block doesn't fit in the remaining capacity
+ * of dest. It never fails.
+ * Blocks in memory complete the future right away. Blocks spilled to disk are read back by a task on io_elg and
+ * moved back into memory, so dest must stay valid until the future is done. A block someone else is reading back
+ * counts as a miss.
+ */
+AWS_S3_API
+struct aws_future_bool *aws_s3_block_cache_get(
+    struct aws_s3_block_cache *block_cache,
+    struct aws_byte_cursor key,
+    struct aws_byte_buf *dest,
+    struct aws_event_loop_group *io_elg);
+
+/**
+ * Add a copy of data to the cache under key, evicting or spilling other blocks if the cache is over its
+ * memory limit. Nothing happens if key is already cached, or data is larger than the memory limit.
+ * Files of spilled blocks are written later, by a task on io_elg. Their data stays readable from memory meanwhile.
+ */
+AWS_S3_API
+void aws_s3_block_cache_put(
+    struct aws_s3_block_cache *block_cache,
+    struct aws_byte_cursor key,
+    struct aws_byte_cursor data,
+    struct aws_event_loop_group *io_elg);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_S3_BLOCK_CACHE_H */
@@ -6,7 +6,9 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 
-#include <aws/s3/s3.h>
+#include <aws/common/atomics.h>
+#include <aws/io/future.h>
+#include <aws/s3/s3_client.h>
 
 /*
  * S3 buffer pool.
@@ -21,18 +23,78 @@
  *   memory limit, it fails and reservation hold is put on the whole buffer
  *   pool. (aws_s3_buffer_pool_remove_reservation_hold can be used to remove
  *   reservation hold).
+ *   alternatively, call reserve_async to get a future for the ticket. if
+ *   memory limit is hit, caller waits in a FIFO queue and the future completes
+ *   as soon as enough tickets are released. the client only reserves async,
+ *   so it never puts a hold on the pool, even if the pool is shared.
  *   -- once request needs memory, it can exchange ticket for a buffer using
  *   aws_s3_buffer_pool_acquire_buffer. this operation never fails, even if it
- *   ends up going over memory limit.
+ *   ends up going over memory limit (unless a buffer provider is out of memory).
  *   -- buffer lifetime is tied to the ticket. so once request is done with the
  *   buffer, ticket is released and buffer returns back to the pool.
+ * All functions are thread safe. Reserve and release only update atomic
+ * counters, and part sized buffers are recycled through per-thread shards,
+ * so the pool lock is mostly avoided on the hot path.
  */
 
+/**
+ * Buffers acquired from the pool start at a multiple of this, so they can be
+ * used for direct I/O (ex. O_DIRECT on Linux) as is. Chunk size is rounded up
+ * to a multiple of it internally to keep that true for any part size.
+ * Doesn't hold for buffers from a custom buffer provider.
+ */
+#define AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT 4096
+
 AWS_EXTERN_C_BEGIN
 
 struct aws_s3_buffer_pool;
 struct aws_s3_buffer_pool_ticket;
 
+/*
+ * Accounting of memory held by a group of tickets (ex. all tickets of one
+ * meta request). Pool keeps the numbers up to date as tickets attached with
+ * aws_s3_buffer_pool_ticket_set_tracker() are acquired and released.
+ * Trackers can be nested (ex. meta request trackers under the tracker of their
+ * client), tickets attached to a tracker count towards all of its parents too.
+ * Tracker must outlive all tickets attached to it, and its children.
+ */
+struct aws_s3_buffer_pool_tracker {
+    /* Bytes reserved by attached tickets that have not been traded in for a buffer yet. */
+    struct aws_atomic_var reserved;
+    /* Bytes in buffers of attached tickets. */
+    struct aws_atomic_var used;
+    /* Optional. */
+    struct aws_s3_buffer_pool_tracker *parent;
+};
+
+/**
+ * Future for a buffer pool ticket (see aws_s3_buffer_pool_reserve_async()).
+ * If the future is released while still holding the ticket, the ticket is released too.
+ */
+AWS_FUTURE_T_POINTER_WITH_RELEASE_DECLARATION(aws_future_s3_buffer_ticket, struct aws_s3_buffer_pool_ticket, AWS_S3_API)
+
+struct aws_s3_buffer_pool_options {
+    /* See aws_s3_buffer_pool_new() */
+    size_t chunk_size;
+    size_t mem_limit;
+
+    /* How blocks in primary storage are allocated. */
+    enum aws_s3_buffer_pool_memory_backing memory_backing;
+
+    /* How much of primary storage to allocate and pre-fault on creation. Rounded up to whole blocks and capped to
+     * mem_limit. Those blocks are never trimmed. */
+    size_t prefault_size;
+
+    /* Number of NUMA nodes to split primary storage across. 0 or 1 means pool is not NUMA aware.
+     * When set, blocks are always mapped (so they can be bound to a node) and buffers are acquired from the
+     * node of the CPU calling acquire. Pool nodes map to the kernel's NUMA node ids in ascending order, so
+     * node ids don't need to be contiguous. */
+    size_t num_numa_nodes;
+
+    /* How much unused memory aws_s3_buffer_pool_trim_step() keeps around for the next burst of work. */
+    size_t trim_low_water_mark;
+};
+
 struct aws_s3_buffer_pool_usage_stats {
     /* Effective Max memory limit. Memory limit value provided during construction minus
      * buffer reserved for overhead of the pool */
@@ -49,18 +111,54 @@ struct aws_s3_buffer_pool_usage_stats {
      * Does not account for wasted space if memory doesn't map perfectly into chunks.
      * This is always <= primary_allocated */
     size_t primary_used;
+    /* Number of primary acquires and releases that could not go through the per-thread shards and took the
+     * pool lock instead. Part sized buffers recycled on the same thread never take the lock. */
+    size_t primary_locked_ops;
     /* How much memory is reserved, but not yet used, in primary storage.
      * Does not account for wasted space if memory doesn't map perfectly into chunks. */
     size_t primary_reserved;
 
-    /* Secondary memory used. Accurate, maps directly to base allocator. */
+    /* Secondary memory used.
+     * Does not account for wasted space if buffer is rounded up to its size class. */
     size_t secondary_used;
-    /* Secondary memory reserved, but not yet used. Accurate, maps directly to base allocator. */
+    /* Secondary memory reserved, but not yet used.
+     * Does not account for wasted space if buffer is rounded up to its size class. */
     size_t secondary_reserved;
+    /* Secondary memory kept for reuse in size classes. Freed on trim.
+     * See aws_s3_buffer_pool_get_size_class_usage() for per size class numbers. */
+    size_t secondary_cached;
+    /* Number of secondary size classes. 0 if pool has no primary storage. */
+    size_t num_size_classes;
 
     /* Bytes used in "forced" buffers (created even if they exceed memory limits).
      * This is always <= primary_used + secondary_used */
     size_t forced_used;
+
+    /* Part of primary_allocated mapped from the huge page pool (MAP_HUGETLB). */
+    size_t primary_hugetlb_allocated;
+    /* Part of primary_allocated mapped with transparent huge pages requested.
+     * Whether kernel actually backs it with huge pages depends on THP settings. */
+    size_t primary_thp_allocated;
+    /* Part of primary_allocated pre-faulted on creation. Those blocks are kept until the pool is destroyed. */
+    size_t primary_prefaulted;
+
+    /* Number of NUMA nodes primary storage is split across. 1 if pool is not NUMA aware.
+     * See aws_s3_buffer_pool_get_numa_node_allocated() for per node numbers. */
+    size_t num_numa_nodes;
+
+    /* Memory the buffer provider reports as allocated. 0 if pool doesn't get memory from a provider,
+     * see aws_s3_buffer_pool_new_from_provider(). */
+    size_t provider_allocated;
+};
+
+struct aws_s3_buffer_pool_size_class_usage {
+    /* Size of buffers in the class. Secondary acquires are rounded up to the smallest class that fits them.
+     * This wasted space is not accounted for in secondary_used and secondary_reserved. */
+    size_t buffer_size;
+    /* Memory allocated for buffers in the class, both used and kept for reuse. */
+    size_t allocated;
+    /* Part of allocated kept for reuse. This is always <= allocated. */
+    size_t cached;
 };
 
 /*
@@ -77,7 +175,16 @@ AWS_S3_API struct aws_s3_buffer_pool *aws_s3_buffer_pool_new(
     size_t mem_limit);
 
 /*
- * Destroys buffer pool.
+ * Create new buffer pool, with more control over how memory is allocated.
+ * Returns buffer pool pointer on success and NULL on failure.
+ */
+AWS_S3_API struct aws_s3_buffer_pool *aws_s3_buffer_pool_new_with_options(
+    struct aws_allocator *allocator,
+    const struct aws_s3_buffer_pool_options *options);
+
+/*
+ * Releases the reference taken when buffer pool was created.
+ * Pool is destroyed once all references are released (see aws_s3_buffer_pool_acquire()).
  * Does nothing if buffer_pool is NULL.
  */
 AWS_S3_API void aws_s3_buffer_pool_destroy(struct aws_s3_buffer_pool *buffer_pool);
@@ -99,8 +206,37 @@ AWS_S3_API struct aws_s3_buffer_pool_ticket *aws_s3_buffer_pool_reserve(
     struct aws_s3_buffer_pool *buffer_pool,
     size_t size);
 
+/*
+ * Reserves memory from the pool for later use, waiting for memory to be
+ * released if the pool is at its memory limit.
+ * Returns a future for the ticket. The future completes immediately if memory
+ * is available and nobody is waiting already. Otherwise caller is put at the
+ * back of a FIFO wait queue, and the future completes (on the thread releasing
+ * the memory) once all earlier waiters are served and the reservation fits.
+ * Reservation hold does not apply to async reservations. While anybody is
+ * waiting, aws_s3_buffer_pool_reserve() fails, so it cannot jump the queue.
+ * The future completes with AWS_ERROR_S3_CANCELED if the reservation is
+ * cancelled or the pool is destroyed first.
+ */
+AWS_S3_API struct aws_future_s3_buffer_ticket *aws_s3_buffer_pool_reserve_async(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t size);
+
+/*
+ * Cancels a reservation made with aws_s3_buffer_pool_reserve_async(), removing
+ * it from the wait queue and completing the future with AWS_ERROR_S3_CANCELED.
+ * Does nothing if the future has already completed. Caller still needs to
+ * release the future (which releases the ticket, if it holds one).
+ */
+AWS_S3_API void aws_s3_buffer_pool_cancel_reservation(
+    struct aws_s3_buffer_pool *buffer_pool,
+    struct aws_future_s3_buffer_ticket *future);
+
 /*
  * Whether pool has a reservation hold.
+ * Hold is only ever set by a failed aws_s3_buffer_pool_reserve(), which the
+ * client doesn't use. Callers that reserve synchronously are responsible for
+ * removing the hold they caused.
  */
 AWS_S3_API bool aws_s3_buffer_pool_has_reservation_hold(struct aws_s3_buffer_pool *buffer_pool);
 
@@ -111,7 +247,10 @@ AWS_S3_API void aws_s3_buffer_pool_remove_reservation_hold(struct aws_s3_buffer_
 
 /*
  * Trades in the ticket for a buffer.
- * Cannot fail and can over allocate above mem limit if reservation was not accurate.
+ * Can over allocate above mem limit if reservation was not accurate.
+ * Only fails if the pool's buffer provider runs out of memory. Then it raises
+ * AWS_ERROR_OOM and returns an empty buffer with NULL memory, and the ticket
+ * can be released as usual.
  * Using the same ticket twice will return the same buffer.
  * Buffer is only valid until the ticket is released.
  */
@@ -119,11 +258,23 @@ AWS_S3_API struct aws_byte_buf aws_s3_buffer_pool_acquire_buffer(
     struct aws_s3_buffer_pool *buffer_pool,
     struct aws_s3_buffer_pool_ticket *ticket);
 
+/*
+ * Same as aws_s3_buffer_pool_acquire_buffer(), but buffer is taken from the given
+ * NUMA node instead of the node of the calling thread.
+ * Node is wrapped around if it is out of range. Does not matter if pool is not NUMA aware.
+ */
+AWS_S3_API struct aws_byte_buf aws_s3_buffer_pool_acquire_buffer_on_numa_node(
+    struct aws_s3_buffer_pool *buffer_pool,
+    struct aws_s3_buffer_pool_ticket *ticket,
+    size_t numa_node);
+
 /*
  * Force immediate acquisition of a buffer from the pool.
  * This should only be used if waiting to reserve a ticket would risk deadlock.
  * This cannot fail, not even if the pool has a reservation hold,
- * not even if the memory limit has been exceeded.
+ * not even if the memory limit has been exceeded. Only a buffer provider
+ * running out of memory fails it, with AWS_ERROR_OOM raised, an empty buffer
+ * returned and out_new_ticket set to NULL.
  */
 AWS_S3_API struct aws_byte_buf aws_s3_buffer_pool_acquire_forced_buffer(
     struct aws_s3_buffer_pool *buffer_pool,
@@ -138,18 +289,66 @@ AWS_S3_API void aws_s3_buffer_pool_release_ticket(
     struct aws_s3_buffer_pool *buffer_pool,
     struct aws_s3_buffer_pool_ticket *ticket);
 
+/*
+ * Initializes tracker with no tickets attached.
+ * parent is optional.
+ */
+AWS_S3_API void aws_s3_buffer_pool_tracker_init(
+    struct aws_s3_buffer_pool_tracker *tracker,
+    struct aws_s3_buffer_pool_tracker *parent);
+
+/*
+ * Attaches ticket to the tracker, so its memory is accounted for there until
+ * the ticket is released. Detaches it from any previous tracker.
+ * Pass NULL to just detach the ticket.
+ * Not thread safe with respect to other calls on the same ticket.
+ */
+AWS_S3_API void aws_s3_buffer_pool_ticket_set_tracker(
+    struct aws_s3_buffer_pool_ticket *ticket,
+    struct aws_s3_buffer_pool_tracker *tracker);
+
+/*
+ * Size the ticket was reserved for.
+ */
+AWS_S3_API size_t aws_s3_buffer_pool_ticket_get_size(const struct aws_s3_buffer_pool_ticket *ticket);
+
 /*
  * Get pool memory usage stats.
  */
 AWS_S3_API struct aws_s3_buffer_pool_usage_stats aws_s3_buffer_pool_get_usage(struct aws_s3_buffer_pool *buffer_pool);
 
+/*
+ * Get memory usage of one secondary size class. Size classes are indexed from
+ * 0 to num_size_classes - 1 (see aws_s3_buffer_pool_usage_stats), smallest first.
+ * Returns zeroed stats for indices out of range.
+ */
+AWS_S3_API struct aws_s3_buffer_pool_size_class_usage aws_s3_buffer_pool_get_size_class_usage(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t size_class_index);
+
+/*
+ * Get how much memory primary storage has allocated on the given NUMA node.
+ * Returns 0 for nodes out of range.
+ */
+AWS_S3_API size_t aws_s3_buffer_pool_get_numa_node_allocated(struct aws_s3_buffer_pool *buffer_pool, size_t numa_node);
+
 /*
  * Trims all unused mem from the pool.
  * Warning: fairly slow operation, do not use in critical path.
- * TODO: partial trimming? ex. only trim down to 50% of max?
  */
 AWS_S3_API void aws_s3_buffer_pool_trim(struct aws_s3_buffer_pool *buffer_pool);
 
+/*
+ * Trims some unused mem from the pool. Meant to be called periodically while
+ * pool is idle, so that unused memory decays gradually instead of all being
+ * freed at once and faulted back in on the next burst of work.
+ * Each step frees about half of unused mem above the trim low water mark, and
+ * never goes below the mark.
+ * Returns true if there is more to trim, i.e. step should be called again later.
+ * Warning: fairly slow operation, do not use in critical path.
+ */
+AWS_S3_API bool aws_s3_buffer_pool_trim_step(struct aws_s3_buffer_pool *buffer_pool);
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_S3_BUFFER_ALLOCATOR_H */
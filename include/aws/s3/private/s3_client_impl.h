@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 
+#include "aws/s3/private/s3_buffer_pool.h"
 #include "aws/s3/s3_client.h"
 
 #include <aws/common/atomics.h>
@@ -26,6 +27,7 @@ struct aws_http_connection;
 struct aws_http_connection_manager;
 struct aws_host_resolver;
 struct aws_s3_endpoint;
+struct aws_s3_io_uring;
 
 enum aws_s3_connection_finish_code {
     AWS_S3_CONNECTION_FINISH_CODE_SUCCESS,
@@ -167,8 +169,10 @@ struct aws_s3_client_vtable {
 
     void (*finish_destroy)(struct aws_s3_client *client);
 
-    struct aws_parallel_input_stream *(
-        *parallel_input_stream_new_from_file)(struct aws_allocator *allocator, struct aws_byte_cursor file_name);
+    struct aws_parallel_input_stream *(*parallel_input_stream_new_from_file)(
+        struct aws_allocator *allocator,
+        struct aws_byte_cursor file_name,
+        struct aws_event_loop_group *reading_elg);
 };
 
 struct aws_s3_upload_part_timeout_stats {
@@ -202,6 +206,21 @@ struct aws_s3_client {
 
     struct aws_s3_buffer_pool *buffer_pool;
 
+    /* True if buffer_pool was passed in through the config, and may be used by other clients too. */
+    const bool shares_buffer_pool;
+
+    /* Cache of GetObject parts, shared with other clients. NULL if parts aren't cached. */
+    struct aws_s3_block_cache *block_cache;
+
+    /* Size and ETag of objects downloaded before. NULL if disabled. */
+    struct aws_s3_object_metadata_cache *object_metadata_cache;
+
+    /* Max memory this client can hold from a shared buffer pool. 0 means no limit beyond the pool's. */
+    const size_t memory_limit;
+
+    /* Memory held in buffer pool tickets of all meta requests of the client. */
+    struct aws_s3_buffer_pool_tracker memory_usage;
+
     struct aws_s3_client_vtable *vtable;
 
     struct aws_ref_count ref_count;
@@ -215,6 +234,14 @@ struct aws_s3_client {
     /* Event loop group for streaming request bodies back to the user. */
     struct aws_event_loop_group *body_streaming_elg;
 
+    /* Event loop group for blocking reads of the files that request bodies are sent from.
+     * NULL until the first meta request that needs it, see aws_s3_client_get_file_io_elg(). Set under the lock. */
+    struct aws_event_loop_group *file_io_elg;
+
+    /* io_uring ring shared by the meta requests that read their file through io_uring.
+     * NULL until the first meta request that needs it, see aws_s3_client_get_io_uring(). Set under the lock. */
+    struct aws_s3_io_uring *io_uring;
+
     /* Region of the S3 bucket. */
     struct aws_string *region;
 
@@ -232,6 +259,9 @@ struct aws_s3_client {
      * used as threshold. */
     const uint64_t multipart_upload_threshold;
 
+    /* Default memory limit of meta requests, indexed by meta request type. 0 means no limit. */
+    size_t meta_request_memory_limits[AWS_S3_META_REQUEST_TYPE_MAX];
+
     /* TLS Options to be used for each connection. */
     struct aws_tls_connection_options *tls_connection_options;
 
@@ -312,6 +342,15 @@ struct aws_s3_client {
      * Ignored unless `enable_read_backpressure` is true. */
     const size_t initial_read_window;
 
+    /* Number of parts a GetObject requests before the size of the object is known, after the first one. */
+    const uint32_t num_speculative_get_parts;
+
+    /* Hedging of GetObject parts. Parts aren't hedged if percentile is 0. */
+    struct aws_s3_get_hedge_options get_hedge_options;
+
+    /* Smallest size the last parts of a GetObject are split to. Parts aren't split if 0. */
+    const size_t get_tail_min_part_size;
+
     /**
      * Timeout in ms for upload request for request after sending to the response first byte received.
      */
@@ -390,6 +429,13 @@ struct aws_s3_client {
          * shutdown callback has not yet been called.*/
         uint32_t body_streaming_elg_allocated : 1;
 
+        /* Whether or not the file I/O ELG is allocated. If the file I/O ELG is NULL, but this is true, the shutdown
+         * callback has not yet been called.*/
+        uint32_t file_io_elg_allocated : 1;
+
+        /* Whether or not creating the io_uring ring failed, so it's not tried again for every meta request. */
+        uint32_t io_uring_unavailable : 1;
+
         /* Whether or not a S3 Express provider is active with the client.*/
         uint32_t s3express_provider_active : 1;
 
@@ -476,6 +522,16 @@ struct aws_s3_request *aws_s3_client_dequeue_request_threaded(struct aws_s3_clie
 AWS_S3_API
 void aws_s3_client_schedule_process_work(struct aws_s3_client *client);
 
+/* Get the file I/O ELG, creating it on first use so that clients which never send files don't pay for its threads.
+ * Returns NULL if it couldn't be created, files are then read on the thread asking for the data. */
+AWS_S3_API
+struct aws_event_loop_group *aws_s3_client_get_file_io_elg(struct aws_s3_client *client);
+
+/* Get the io_uring ring, creating it on first use. Returns NULL, with AWS_ERROR_PLATFORM_NOT_SUPPORTED raised, if
+ * io_uring is not available. */
+AWS_S3_API
+struct aws_s3_io_uring *aws_s3_client_get_io_uring(struct aws_s3_client *client);
+
 AWS_S3_API
 void aws_s3_client_update_meta_requests_threaded(struct aws_s3_client *client);
 
@@ -24,6 +24,7 @@ struct aws_s3_meta_request;
 struct aws_s3_request;
 struct aws_http_headers;
 struct aws_http_make_request_options;
+struct aws_parallel_output_stream;
 struct aws_retry_strategy;
 
 enum aws_s3_meta_request_state {
@@ -149,9 +150,24 @@ struct aws_s3_meta_request {
     struct aws_parallel_input_stream *request_body_parallel_stream;
     bool request_body_using_async_writes;
 
+    /* If set, request_body_parallel_stream is over the caller's memory, and this is invoked once it's released.
+     * See aws_s3_meta_request_options.send_buffer. */
+    aws_s3_meta_request_send_buffer_release_fn *send_buffer_release_callback;
+
+    /* If set, the response body is written straight to this file at each part's offset, instead of being
+     * streamed back to the user in order. See aws_s3_meta_request_options.recv_filepath. */
+    struct aws_parallel_output_stream *recv_file;
+    bool recv_file_preallocate;
+
     /* Part size to use for uploads and downloads.  Passed down by the creating client. */
     const size_t part_size;
 
+    /* Max memory the meta request can hold in buffer pool tickets. 0 means no limit. */
+    const size_t memory_limit;
+
+    /* Memory held in buffer pool tickets of the meta request. */
+    struct aws_s3_buffer_pool_tracker memory_usage;
+
     struct aws_cached_signing_config_aws *cached_signing_config;
 
     /* Client that created this meta request which also processes this request. After the meta request is finished, this
@@ -175,6 +191,11 @@ struct aws_s3_meta_request {
     aws_s3_meta_request_progress_fn *progress_callback;
     aws_s3_meta_request_telemetry_fn *telemetry_callback;
     aws_s3_meta_request_upload_review_fn *upload_review_callback;
+    aws_s3_meta_request_receive_buffer_fn *receive_buffer_callback;
+
+    /* If set, parts are sent to the body_callback as they complete, bypassing the in-order streaming queue.
+     * See aws_s3_meta_request_options.out_of_order_body_callback. */
+    bool out_of_order_body_callback;
 
     /* Customer specified callbacks to be called by our specialized callback to calculate the response checksum. */
     aws_s3_meta_request_headers_callback_fn *headers_user_callback_after_checksum;
@@ -252,6 +273,10 @@ struct aws_s3_meta_request {
             void *waker_user_data;
         } async_write;
 
+        /* Buffer pool reservation waiting for memory to be released.
+         * See aws_s3_meta_request_reserve_ticket_synced() */
+        struct aws_future_s3_buffer_ticket *pending_ticket_reservation;
+
     } synced_data;
 
     /* Anything in this structure should only ever be accessed by the client on its process work event loop task. */
@@ -371,6 +396,13 @@ void aws_s3_meta_request_finished_request(
     struct aws_s3_request *request,
     int error_code);
 
+/* Copies the response body of a request into memory from the receive_buffer_callback, for requests that
+ * were not received into it directly. See aws_s3_meta_request_options.receive_buffer_callback. */
+AWS_S3_API
+int aws_s3_meta_request_copy_to_receive_buffer(
+    struct aws_s3_meta_request *meta_request,
+    struct aws_s3_request *request);
+
 /* Called to place the request in the meta request's priority queue for streaming back to the caller.  Once all requests
  * with a part number less than the given request has been received, the given request and the previous requests will
  * be scheduled for streaming.  */
@@ -393,6 +425,14 @@ bool aws_s3_meta_request_are_events_out_for_delivery_synced(struct aws_s3_meta_r
 /* Cancel the requests with cancellable HTTP stream for the meta request */
 void aws_s3_meta_request_cancel_cancellable_requests_synced(struct aws_s3_meta_request *meta_request, int error_code);
 
+/* Reserve a ticket of the given size from the client's buffer pool.
+ * Returns NULL if the meta request is at its own memory limit, or if the pool is at its memory limit. In the latter
+ * case the meta request waits in the pool's queue, and client work is scheduled once the reservation goes through, so
+ * the next call picks the ticket up. */
+struct aws_s3_buffer_pool_ticket *aws_s3_meta_request_reserve_ticket_synced(
+    struct aws_s3_meta_request *meta_request,
+    size_t size);
+
 /* Asynchronously read from the meta request's input stream. Should always be done outside of any mutex,
  * as reading from the stream could cause user code to call back into aws-c-s3.
  * This will fill the buffer to capacity, unless end of stream is reached.
@@ -0,0 +1,71 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#ifndef AWS_S3_OBJECT_METADATA_CACHE_H
+#define AWS_S3_OBJECT_METADATA_CACHE_H
+
+#include <aws/s3/s3.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_byte_cursor;
+struct aws_http_message;
+struct aws_string;
+
+/**
+ * Client-level cache of the size and ETag of objects downloaded before, so that a GetObject of the same object
+ * can split into ranged parts right away, instead of first discovering the size with a round trip.
+ *
+ * Objects are identified by the Host header and the request path of the GetObject message.
+ * Holds at most max_entries objects, and the least recently used one is dropped to make room for a new one.
+ * All functions are thread-safe.
+ */
+struct aws_s3_object_metadata_cache;
+
+AWS_EXTERN_C_BEGIN
+
+AWS_S3_API
+struct aws_s3_object_metadata_cache *aws_s3_object_metadata_cache_new(
+    struct aws_allocator *allocator,
+    size_t max_entries);
+
+AWS_S3_API
+void aws_s3_object_metadata_cache_destroy(struct aws_s3_object_metadata_cache *cache);
+
+/**
+ * Look up the object the message gets.
+ * On a hit, returns true, and sets out_object_size and out_etag. out_etag must be destroyed by the caller.
+ */
+AWS_S3_API
+bool aws_s3_object_metadata_cache_get(
+    struct aws_s3_object_metadata_cache *cache,
+    const struct aws_http_message *message,
+    uint64_t *out_object_size,
+    struct aws_string **out_etag);
+
+/**
+ * Remember the size and ETag of the object the message gets, replacing what was there before.
+ */
+AWS_S3_API
+void aws_s3_object_metadata_cache_put(
+    struct aws_s3_object_metadata_cache *cache,
+    const struct aws_http_message *message,
+    uint64_t object_size,
+    struct aws_byte_cursor etag);
+
+/**
+ * Forget the object the message gets, ex. once its ETag is found to be stale.
+ * Only removes the entry if it still has the given ETag, so a newer entry put by another request stays.
+ */
+AWS_S3_API
+void aws_s3_object_metadata_cache_remove(
+    struct aws_s3_object_metadata_cache *cache,
+    const struct aws_http_message *message,
+    struct aws_byte_cursor etag);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_S3_OBJECT_METADATA_CACHE_H */
@@ -13,10 +13,12 @@
 AWS_PUSH_SANE_WARNING_LEVEL
 
 struct aws_byte_buf;
+struct aws_byte_cursor;
 struct aws_future_bool;
 struct aws_input_stream;
 
 struct aws_event_loop_group;
+struct aws_s3_io_uring;
 
 struct aws_parallel_input_stream {
     const struct aws_parallel_input_stream_vtable *vtable;
@@ -38,6 +40,17 @@ struct aws_parallel_input_stream_vtable {
      */
     struct aws_future_bool *(
         *read)(struct aws_parallel_input_stream *stream, uint64_t offset, struct aws_byte_buf *dest);
+
+    /**
+     * Optional. Only for streams whose data is already in memory, ex. a mapped file.
+     * Point out_range at the data from the offset, without copying it.
+     * The implementation needs to support this to be invoked concurrently from multiple threads
+     */
+    int (*get_mapped_range)(
+        struct aws_parallel_input_stream *stream,
+        uint64_t offset,
+        size_t length,
+        struct aws_byte_cursor *out_range);
 };
 
 AWS_EXTERN_C_BEGIN
@@ -84,21 +97,135 @@ struct aws_future_bool *aws_parallel_input_stream_read(
     uint64_t offset,
     struct aws_byte_buf *dest);
 
+/**
+ * Returns true if the stream's data is already in memory, so aws_parallel_input_stream_get_mapped_range() can be
+ * used instead of reading into a buffer.
+ */
+AWS_S3_API
+bool aws_parallel_input_stream_is_mapped(const struct aws_parallel_input_stream *stream);
+
+/**
+ * Point out_range at the data from the offset, without copying it.
+ * It's thread safe to be called from multiple threads.
+ *
+ * @param stream            The stream to get the data of
+ * @param offset            The offset in the stream from beginning
+ * @param length            The number of bytes wanted. out_range is shorter if the end of the stream is reached.
+ * @param out_range         Set to the data. Stays valid until the stream is destroyed.
+ * @return                  AWS_OP_SUCCESS, or AWS_OP_ERR with AWS_ERROR_UNSUPPORTED_OPERATION if the stream's data
+ *                          is not in memory.
+ */
+AWS_S3_API
+int aws_parallel_input_stream_get_mapped_range(
+    struct aws_parallel_input_stream *stream,
+    uint64_t offset,
+    size_t length,
+    struct aws_byte_cursor *out_range);
+
 /**
  * Create a new file based parallel input stream.
  *
- * This implementation will open a file handler when the read happens, and seek to the offset to start reading. Close
- * the file handler as read finishes.
+ * The file is opened once, and stays open until the stream is destroyed. Each read goes to its offset with a
+ * positional read, so reads from different threads don't need to take turns.
+ * If reading_elg is set, reads block one of its threads instead of the caller's, and the future completes from there.
  *
  * @param allocator         memory allocator
  * @param file_name         The file path to read from
+ * @param reading_elg       Optional. Event loop group dedicated to blocking file reads. If NULL, reads block the
+ *                          calling thread, and the future is done when read returns.
  * @return aws_parallel_input_stream
  */
 AWS_S3_API
 struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name,
+    struct aws_event_loop_group *reading_elg);
+
+/**
+ * Same as aws_parallel_input_stream_new_from_file(), but reads bypass the page cache with direct I/O (O_DIRECT).
+ *
+ * Only blocks aligned to AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT in both the file and the destination buffer are read
+ * directly, so read into buffers from the buffer pool. Unaligned edges, ex. the tail of the file, are read through
+ * the page cache. Where direct I/O is not supported, everything is read through the page cache.
+ */
+AWS_S3_API
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file_direct(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name,
+    struct aws_event_loop_group *reading_elg);
+
+/**
+ * Create a new io_uring ring to read files through, shared by any number of streams.
+ *
+ * Reads are submitted to the kernel without waiting on each other, so many parts can be read at once without a
+ * thread blocked per read. A dedicated thread polls for completions and completes the futures from there.
+ * Reads beyond the depth of the queue, across all the streams on the ring, wait for earlier ones to finish.
+ * If waiting for completions ever fails, every read on the ring fails from then on.
+ *
+ * Streams hold a reference to the ring. The thread exits once the last reference is released.
+ *
+ * Fails with AWS_ERROR_PLATFORM_NOT_SUPPORTED where io_uring is not available, ex. on other platforms, older
+ * kernels, or where it's disabled. Use aws_parallel_input_stream_new_from_file() instead in that case.
+ */
+AWS_S3_API
+struct aws_s3_io_uring *aws_s3_io_uring_new(struct aws_allocator *allocator);
+
+AWS_S3_API
+struct aws_s3_io_uring *aws_s3_io_uring_acquire(struct aws_s3_io_uring *ring);
+
+/**
+ * Release a reference to the ring. Always returns NULL.
+ */
+AWS_S3_API
+struct aws_s3_io_uring *aws_s3_io_uring_release(struct aws_s3_io_uring *ring);
+
+/**
+ * Create a new file based parallel input stream that reads through an io_uring ring from aws_s3_io_uring_new().
+ *
+ * @param allocator         memory allocator
+ * @param file_name         The file path to read from
+ * @param ring              The ring to submit reads to. The stream holds a reference to it.
+ * @return aws_parallel_input_stream
+ */
+AWS_S3_API
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file_io_uring(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name,
+    struct aws_s3_io_uring *ring);
+
+/**
+ * Create a new file based parallel input stream that maps the file into memory.
+ *
+ * Parts can be sent straight from the mapping with aws_parallel_input_stream_get_mapped_range(), without a buffer
+ * per part or a copy to read into it. Reads still work, and copy out of the mapping.
+ * The file must not be truncated while the stream is alive, touching a page past its new end is a fatal signal.
+ *
+ * Fails with AWS_ERROR_PLATFORM_NOT_SUPPORTED on Windows.
+ *
+ * @param allocator         memory allocator
+ * @param file_name         The file path to map
+ * @return aws_parallel_input_stream
+ */
+AWS_S3_API
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file_mmap(
     struct aws_allocator *allocator,
     struct aws_byte_cursor file_name);
 
+/**
+ * Create a new parallel input stream over memory owned by the caller, without copying it.
+ *
+ * Parts can be sent straight from the memory with aws_parallel_input_stream_get_mapped_range(), and reads copy out
+ * of it. The memory must stay valid and unchanged until the stream is destroyed.
+ *
+ * @param allocator         memory allocator
+ * @param buffer            The memory to read from
+ * @return aws_parallel_input_stream
+ */
+AWS_S3_API
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_buffer(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor buffer);
+
 AWS_EXTERN_C_END
 AWS_POP_SANE_WARNING_LEVEL
 
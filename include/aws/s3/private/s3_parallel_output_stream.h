@@ -0,0 +1,124 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#ifndef AWS_S3_PARALLEL_OUTPUT_STREAM_H
+#define AWS_S3_PARALLEL_OUTPUT_STREAM_H
+
+#include <aws/s3/s3.h>
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/ref_count.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_parallel_output_stream {
+    const struct aws_parallel_output_stream_vtable *vtable;
+    struct aws_allocator *alloc;
+    struct aws_ref_count ref_count;
+
+    void *impl;
+};
+
+struct aws_parallel_output_stream_vtable {
+    /**
+     * Destroy the stream, its refcount has reached 0.
+     */
+    void (*destroy)(struct aws_parallel_output_stream *stream);
+
+    /**
+     * Write all of data at the offset.
+     * The implementation needs to support this to be invoked concurrently from multiple threads, for different offsets
+     */
+    int (*write)(struct aws_parallel_output_stream *stream, uint64_t offset, struct aws_byte_cursor data);
+
+    /**
+     * Optional.
+     * Reserve space for size bytes ahead of writing them.
+     */
+    int (*preallocate)(struct aws_parallel_output_stream *stream, uint64_t size);
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Initialize aws_parallel_output_stream "base class"
+ */
+AWS_S3_API
+void aws_parallel_output_stream_init_base(
+    struct aws_parallel_output_stream *stream,
+    struct aws_allocator *alloc,
+    const struct aws_parallel_output_stream_vtable *vtable,
+    void *impl);
+
+/**
+ * Increment reference count.
+ * You may pass in NULL (has no effect).
+ * Returns whatever pointer was passed in.
+ */
+AWS_S3_API
+struct aws_parallel_output_stream *aws_parallel_output_stream_acquire(struct aws_parallel_output_stream *stream);
+
+/**
+ * Decrement reference count.
+ * You may pass in NULL (has no effect).
+ * Always returns NULL.
+ */
+AWS_S3_API
+struct aws_parallel_output_stream *aws_parallel_output_stream_release(struct aws_parallel_output_stream *stream);
+
+/**
+ * Write data at the offset, blocking until all of it is written.
+ * It's thread safe to be called from multiple threads without waiting for other writes to complete,
+ * as long as the writes don't overlap.
+ *
+ * @param stream            The stream to write to
+ * @param offset            The offset in the stream from beginning to start writing at
+ * @param data              The data to write
+ * @return                  AWS_OP_SUCCESS, or AWS_OP_ERR with the error raised if something went wrong.
+ */
+AWS_S3_API
+int aws_parallel_output_stream_write(
+    struct aws_parallel_output_stream *stream,
+    uint64_t offset,
+    struct aws_byte_cursor data);
+
+/**
+ * Reserve space for size bytes from the beginning of the stream, so later writes don't fail for lack of space
+ * and don't fragment the file. Does nothing if the stream doesn't support it.
+ */
+AWS_S3_API
+int aws_parallel_output_stream_preallocate(struct aws_parallel_output_stream *stream, uint64_t size);
+
+/**
+ * Create a new file based parallel output stream.
+ *
+ * The file is created, or truncated if it already exists. It stays open until the stream is destroyed, and each
+ * write goes to its offset with a positional write, so writes from different threads don't need to take turns.
+ *
+ * @param allocator         memory allocator
+ * @param file_name         The file path to write to
+ * @return aws_parallel_output_stream
+ */
+AWS_S3_API
+struct aws_parallel_output_stream *aws_parallel_output_stream_new_from_file(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name);
+
+/**
+ * Same as aws_parallel_output_stream_new_from_file(), but writes bypass the page cache with direct I/O (O_DIRECT).
+ *
+ * Only blocks aligned to AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT in both the file and the data are written directly,
+ * so write from buffers from the buffer pool. Unaligned edges, ex. the tail of the file, are written through the
+ * page cache. Where direct I/O is not supported, everything is written through the page cache.
+ */
+AWS_S3_API
+struct aws_parallel_output_stream *aws_parallel_output_stream_new_from_file_direct(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_S3_PARALLEL_OUTPUT_STREAM_H */
@@ -24,6 +24,8 @@ enum aws_s3_request_flags {
     AWS_S3_REQUEST_FLAG_PART_SIZE_RESPONSE_BODY = 0x00000002,
     AWS_S3_REQUEST_FLAG_ALWAYS_SEND = 0x00000004,
     AWS_S3_REQUEST_FLAG_PART_SIZE_REQUEST_BODY = 0x00000008,
+    AWS_S3_REQUEST_FLAG_CALLER_RESPONSE_BODY = 0x00000010,
+    AWS_S3_REQUEST_FLAG_RESUMABLE_RESPONSE_BODY = 0x00000020,
 };
 
 /**
@@ -223,6 +225,19 @@ struct aws_s3_request {
     /* When true, the request body buffer will be allocated in the size of a part. */
     uint32_t has_part_size_request_body : 1;
 
+    /* When true, a successful response body is received directly into caller's memory for the part range.
+     * See aws_s3_meta_request_options.receive_buffer_callback */
+    uint32_t has_caller_response_body : 1;
+
+    /* When true, an attempt that fails partway through a successful response body keeps the bytes it received, and
+     * its retry only asks for the rest of the part range. Only for ranged GETs of an object that can't change between
+     * attempts (ex. sent with If-Match). */
+    uint32_t has_resumable_response_body : 1;
+
+    /* When true, send_data.response_body, and the running checksum, hold the start of the part range from previous
+     * attempts, and the next attempt resumes from the end of it. */
+    uint32_t resumes_response_body : 1;
+
     /* When true, this request is being tracked by the client for limiting the amount of in-flight-requests/stats. */
     uint32_t tracked_by_client : 1;
 
@@ -233,6 +248,10 @@ struct aws_s3_request {
      */
     uint32_t discovers_object_size : 1;
 
+    /* When true, this request was sent before the object size was known, and may be past the end of the object.
+     * This is currently only used by auto_range_get. */
+    uint32_t is_speculative : 1;
+
     /* When true, this request does not represent a useful http request and
      * must not be sent, however client must still call corresponding finished
      * callback for the request. Those requests can occur when request is
@@ -36,6 +36,7 @@ struct aws_http_message;
 struct aws_s3_client;
 struct aws_s3_request;
 struct aws_s3_meta_request;
+struct aws_string;
 
 struct aws_cached_signing_config_aws {
     struct aws_allocator *allocator;
@@ -323,6 +324,35 @@ int aws_s3_crt_error_code_from_recoverable_server_error_code_string(struct aws_b
 AWS_S3_API
 void aws_s3_request_finish_up_metrics_synced(struct aws_s3_request *request, struct aws_s3_meta_request *meta_request);
 
+/* Length of the next piece of file I/O of len bytes between memory at ptr and the file at offset, and whether that
+ * piece can bypass the page cache. Direct I/O needs the memory, the offset and the length aligned to
+ * AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT, so only whole aligned blocks can, and unaligned edges go through the page
+ * cache. */
+AWS_S3_API
+size_t aws_s3_next_direct_io_piece(const uint8_t *ptr, uint64_t offset, size_t len, bool *out_direct);
+
+#if defined(_WIN32)
+/* Open the file for overlapped I/O, creating or truncating it if for_write. Every read and write through the handle
+ * gives its own offset, so threads can use it at once instead of taking turns on a shared file position.
+ * Returns NULL, raising an error, on failure. */
+AWS_S3_API
+void *aws_s3_open_overlapped_file(struct aws_allocator *allocator, const struct aws_string *path, bool for_write);
+
+/* Read or write up to len bytes at offset through a handle from aws_s3_open_overlapped_file(), blocking until done.
+ * Reading at or past the end of the file transfers 0 bytes. */
+AWS_S3_API
+int aws_s3_overlapped_file_io(
+    void *file,
+    uint64_t offset,
+    uint8_t *buffer,
+    uint32_t len,
+    bool write,
+    uint32_t *out_num_transferred);
+
+AWS_S3_API
+void aws_s3_close_overlapped_file(void *file);
+#endif
+
 AWS_EXTERN_C_END
 
 #endif /* AWS_S3_UTIL_H */
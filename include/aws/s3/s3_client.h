@@ -22,6 +22,8 @@ struct aws_tls_connection_options;
 struct aws_input_stream;
 struct aws_hash_table;
 
+struct aws_s3_block_cache;
+struct aws_s3_buffer_pool;
 struct aws_s3_client;
 struct aws_s3_request;
 struct aws_s3_meta_request;
@@ -177,6 +179,36 @@ typedef int(aws_s3_meta_request_receive_body_callback_fn)(
     /* User data specified by aws_s3_meta_request_options.*/
     void *user_data);
 
+/**
+ * Invoked to get memory to receive a range of the object into, instead of the client's own buffers.
+ * See aws_s3_meta_request_options.receive_buffer_callback.
+ *
+ * Set out_buffer to memory of at least range_size bytes (ex. with aws_byte_buf_from_empty_array()),
+ * owned by the caller. Data is written starting at out_buffer's current length.
+ * The memory must stay valid until the meta request finishes.
+ *
+ * Ranges can be requested from any thread, concurrently, and in any order.
+ * A range can be requested again if the part receiving it is retried.
+ *
+ * Return aws_raise_error(E) to fail the request.
+ */
+typedef int(aws_s3_meta_request_receive_buffer_fn)(
+
+    /* The meta request that the callback is being issued for. */
+    struct aws_s3_meta_request *meta_request,
+
+    /* The byte index of the object where the range starts. Same as range_start of the body callback. */
+    uint64_t range_start,
+
+    /* Size of the range, in bytes. */
+    uint64_t range_size,
+
+    /* Set to the memory to receive the range into. */
+    struct aws_byte_buf *out_buffer,
+
+    /* User data specified by aws_s3_meta_request_options.*/
+    void *user_data);
+
 /**
  * Invoked when the entire meta request execution is complete.
  */
@@ -221,6 +253,12 @@ typedef void(aws_s3_meta_request_telemetry_fn)(
 
 typedef void(aws_s3_meta_request_shutdown_fn)(void *user_data);
 
+/**
+ * Invoked once the client no longer references the memory of `aws_s3_meta_request_options.send_buffer`,
+ * so it can be freed or reused.
+ */
+typedef void(aws_s3_meta_request_send_buffer_release_fn)(void *user_data);
+
 typedef void(aws_s3_client_shutdown_complete_callback_fn)(void *user_data);
 
 enum aws_s3_meta_request_tls_mode {
@@ -346,6 +384,292 @@ struct aws_s3_tcp_keep_alive_options {
     uint16_t keep_alive_max_failed_probes;
 };
 
+/**
+ * How memory for the client's buffer pool is obtained.
+ * Part sized buffers are carved out of large blocks (16 parts each) that the
+ * buffer pool keeps around for reuse. This controls how those blocks are allocated.
+ */
+enum aws_s3_buffer_pool_memory_backing {
+    /* Blocks are allocated with the client's allocator. This is the default. */
+    AWS_S3_BUFFER_POOL_MEMORY_BACKING_ALLOCATOR = 0,
+
+    /**
+     * Blocks are anonymous memory mappings. Where supported (Linux), transparent huge pages are requested for
+     * them with madvise(MADV_HUGEPAGE), which cuts TLB misses when copying data in and out of part buffers.
+     * Whether the kernel actually uses huge pages depends on the host's THP settings.
+     * Falls back to AWS_S3_BUFFER_POOL_MEMORY_BACKING_ALLOCATOR on platforms without mmap.
+     */
+    AWS_S3_BUFFER_POOL_MEMORY_BACKING_MMAP,
+
+    /**
+     * Blocks are mapped from the host's reserved huge page pool (MAP_HUGETLB, Linux only).
+     * Huge pages must be reserved up front (ex: vm.nr_hugepages). Blocks that cannot be mapped from huge pages
+     * fall back to AWS_S3_BUFFER_POOL_MEMORY_BACKING_MMAP.
+     */
+    AWS_S3_BUFFER_POOL_MEMORY_BACKING_HUGETLB,
+};
+
+/* Options for how the client's buffer pool allocates memory. */
+struct aws_s3_buffer_pool_memory_options {
+    enum aws_s3_buffer_pool_memory_backing backing;
+
+    /**
+     * Optional.
+     * Amount of memory to allocate and pre-fault when the client is created, so that the first transfers don't
+     * pay for page faults. Rounded up to whole blocks and capped to the memory limit.
+     * Pre-faulted memory stays with the buffer pool for the lifetime of the client and is not trimmed.
+     * If 0, nothing is allocated up front.
+     */
+    uint64_t prefault_size_in_bytes;
+
+    /**
+     * Optional.
+     * Amount of unused memory the buffer pool keeps around while the client is idle, so that the next burst of
+     * transfers can reuse it instead of faulting it back in. Unused memory above this amount is released
+     * gradually while the client is idle (about half of it every few seconds), rather than all at once.
+     * Memory is still released below this amount if a transfer needs room within the memory limit.
+     * If 0, all unused memory is eventually released.
+     */
+    uint64_t trim_low_water_mark_in_bytes;
+
+    /**
+     * Optional.
+     * If true, the buffer pool keeps separate memory for each NUMA node (cpu group, see aws_s3_cpu_group_info)
+     * of the host and binds it to that node. Part buffers are then handed out from the node local to the
+     * event loop thread servicing the request, which avoids cross-socket memory traffic on multi-socket hosts.
+     * Works best with an event loop group pinned to cpu groups (aws_event_loop_group_new_default_pinned_to_cpu_group).
+     * Pre-faulted memory is spread evenly across nodes.
+     * Has no effect on single node hosts or platforms without NUMA support (only Linux is supported).
+     */
+    bool numa_local_buffers;
+};
+
+/* Options for a buffer pool shared by multiple clients. See aws_s3_shared_buffer_pool_new() */
+struct aws_s3_shared_buffer_pool_options {
+    /* Overall memory limit of all clients using the pool. If 0, a default based on the host is used. */
+    uint64_t memory_limit_in_bytes;
+
+    /**
+     * Optional.
+     * Size of the buffers that will most commonly be requested from the pool (typically part size of the clients).
+     * Buffers of other sizes are supported too, but are not pooled as efficiently.
+     * If 0, the default part size of the client is used.
+     */
+    uint64_t part_size;
+
+    /**
+     * Optional.
+     * Controls how memory for the pool is allocated (see aws_s3_client_config.buffer_pool_memory_options).
+     */
+    const struct aws_s3_buffer_pool_memory_options *memory_options;
+};
+
+/* Memory usage reported by a buffer provider. See aws_s3_buffer_provider_vtable */
+struct aws_s3_buffer_provider_usage {
+    /* Max memory the provider can hand out. 0 means no limit. */
+    uint64_t memory_limit;
+
+    /* Memory the provider currently holds, both handed out and kept for reuse. */
+    uint64_t allocated;
+};
+
+/**
+ * Interface for providing the memory of part buffers from outside of the client
+ * (ex. an arena that is already registered with a storage or network layer), so that
+ * parts are received into and sent from that memory directly, without a copy.
+ * See aws_s3_buffer_pool_new_from_provider().
+ *
+ * The buffer pool on top of the provider still takes care of tickets, waiting for memory (see
+ * aws_s3_meta_request_options.memory_limit_in_bytes) and accounting, so a provider only deals with raw memory.
+ * Functions can be called from any thread, and concurrently, but never with a lock of the buffer pool held.
+ */
+struct aws_s3_buffer_provider_vtable {
+    /**
+     * Required.
+     * Take size bytes out of the provider's budget, for a buffer that will be acquired later.
+     * Return false if there is not enough memory right now. The client then waits, and tries again
+     * once any of its buffers are released, or aws_s3_buffer_pool_notify_provider_memory_available() is called.
+     * Memory the provider frees outside of the client must be announced that way, or the client may wait forever.
+     */
+    bool (*reserve)(void *user_data, size_t size);
+
+    /**
+     * Required.
+     * Return memory for a buffer of size bytes. Return NULL only if memory is exhausted, the request that
+     * needed the buffer then fails with AWS_ERROR_OOM.
+     * If forced is false, size was reserved earlier. If forced is true, size was not reserved, and
+     * memory must be returned even if it goes over the provider's budget (waiting could deadlock the client).
+     * The buffer has no alignment requirements. Note that direct I/O (see send_filepath_use_direct_io and
+     * recv_filepath_use_direct_io) only bypasses the page cache for the parts of a buffer aligned to 4KiB,
+     * so providers that want it should hand out 4KiB aligned buffers.
+     */
+    uint8_t *(*acquire)(void *user_data, size_t size, bool forced);
+
+    /**
+     * Required.
+     * Give back size bytes of the provider's budget, and the buffer at ptr if one was acquired.
+     * ptr is NULL if the reservation was never traded in for a buffer.
+     * forced is the same as when the buffer was acquired, so forced buffers (which were never reserved)
+     * can be returned to a separate budget. It is always false if ptr is NULL.
+     */
+    void (*release)(void *user_data, uint8_t *ptr, size_t size, bool forced);
+
+    /**
+     * Optional.
+     * Free memory kept for reuse. Called periodically while the client is idle.
+     */
+    void (*trim)(void *user_data);
+
+    /**
+     * Optional.
+     * Report memory usage of the provider.
+     */
+    struct aws_s3_buffer_provider_usage (*get_usage)(void *user_data);
+
+    /**
+     * Optional.
+     * Called once the buffer pool is destroyed, and the provider is no longer used.
+     */
+    void (*destroy)(void *user_data);
+};
+
+/* A block of a block cache that is held in memory, as seen by the cache's eviction policy. */
+struct aws_s3_block_cache_entry {
+    /* Size of the block in bytes. */
+    size_t size;
+
+    /* For the eviction policy to use as it likes, ex. to link the entry into its own structures. */
+    void *policy_data;
+};
+
+/**
+ * Interface for deciding which block a block cache drops from memory once it is over its memory limit.
+ * See aws_s3_block_cache_options.eviction_policy.
+ *
+ * Functions are called with the cache's lock held, so they are never called concurrently,
+ * and must not call back into the cache.
+ */
+struct aws_s3_block_cache_eviction_policy_vtable {
+    /**
+     * Required.
+     * A block was added to memory.
+     */
+    void (*on_insert)(void *user_data, struct aws_s3_block_cache_entry *entry);
+
+    /**
+     * Required.
+     * A block in memory was read.
+     */
+    void (*on_access)(void *user_data, struct aws_s3_block_cache_entry *entry);
+
+    /**
+     * Required.
+     * A block left memory (evicted, spilled to disk, or the cache is being destroyed).
+     * The entry must not be returned by choose_victim() anymore.
+     */
+    void (*on_remove)(void *user_data, struct aws_s3_block_cache_entry *entry);
+
+    /**
+     * Required.
+     * Return the block to drop from memory next, or NULL if there is none.
+     */
+    struct aws_s3_block_cache_entry *(*choose_victim)(void *user_data);
+
+    /**
+     * Optional.
+     * Called once the block cache is destroyed, and the policy is no longer used.
+     */
+    void (*destroy)(void *user_data);
+};
+
+/* Options for a block cache. See aws_s3_block_cache_new() */
+struct aws_s3_block_cache_options {
+    /* Max size of the blocks held in memory. Must not be 0. */
+    uint64_t memory_limit_in_bytes;
+
+    /**
+     * Optional.
+     * Existing directory that blocks dropped from memory are spilled to, instead of being evicted.
+     * Spilled blocks are read back from disk on a hit. Files are removed when the cache is destroyed.
+     * If empty, blocks are only held in memory.
+     */
+    struct aws_byte_cursor spill_directory;
+
+    /**
+     * Optional.
+     * Max size of the blocks spilled to disk. Once reached, the oldest spilled blocks are evicted.
+     * Must be set if spill_directory is set.
+     */
+    uint64_t disk_limit_in_bytes;
+
+    /**
+     * Optional.
+     * Decides which block leaves memory next. The vtable must stay valid for the lifetime of the cache.
+     * If NULL, the least recently used block does.
+     */
+    const struct aws_s3_block_cache_eviction_policy_vtable *eviction_policy;
+    void *eviction_policy_user_data;
+};
+
+/* Counters of a block cache. See aws_s3_block_cache_get_stats() */
+struct aws_s3_block_cache_stats {
+    /* Parts served from the cache, without a request. */
+    uint64_t hits;
+
+    /* Parts looked up and not found, that were fetched. */
+    uint64_t misses;
+
+    /* Blocks dropped from the cache. Blocks spilled to disk aren't counted until they are dropped from disk. */
+    uint64_t evictions;
+
+    /* Blocks moved from memory to disk. */
+    uint64_t spills;
+
+    /* Size of the blocks in memory. */
+    uint64_t memory_used;
+
+    /* Size of the blocks on disk. */
+    uint64_t disk_used;
+};
+
+/**
+ * Options for hedging the parts of GetObject downloads (see aws_s3_client_config.get_hedge_options).
+ * A part in flight for much longer than the other parts of its download gets a duplicate request on another
+ * connection. Whichever of the two finishes first is used, and the other is cancelled.
+ */
+struct aws_s3_get_hedge_options {
+    /**
+     * A part gets a duplicate once it has been in flight for longer than this percentile of the durations of the
+     * recently finished parts of the same download. From 1 to 99. If 0, 95 is used.
+     */
+    uint32_t percentile;
+
+    /**
+     * Max number of duplicate requests of a download, as a percentage of its number of parts (rounded up).
+     * From 1 to 100. If 0, 5 is used.
+     */
+    uint32_t budget_percent;
+};
+
+/* Memory a client holds from its buffer pool. See aws_s3_client_get_memory_usage() */
+struct aws_s3_client_memory_usage {
+    /* Memory reserved for parts that don't have a buffer yet. */
+    uint64_t reserved;
+
+    /* Memory in part buffers. */
+    uint64_t used;
+
+    /* Max of reserved + used for this client. 0 if the client is only bound by pool_memory_limit. */
+    uint64_t limit;
+
+    /* Memory limit of the buffer pool, which may be shared with other clients. */
+    uint64_t pool_memory_limit;
+
+    /* Memory reserved and used by all clients of the buffer pool. */
+    uint64_t pool_reserved;
+    uint64_t pool_used;
+};
+
 /* Options for a new client. */
 struct aws_s3_client_config {
 
@@ -423,9 +747,95 @@ struct aws_s3_client_config {
     /* Throughput target in gigabits per second (Gbps) that we are trying to reach. */
     double throughput_target_gbps;
 
-    /* How much memory can we use. This will be capped to SIZE_MAX */
+    /**
+     * How much memory can we use. This will be capped to SIZE_MAX
+     * If buffer_pool is set, this is optional and limits this client's share of the pool's memory instead.
+     */
     uint64_t memory_limit_in_bytes;
 
+    /**
+     * Optional.
+     * Controls how memory for the client's buffer pool is allocated.
+     * If NULL, the client's allocator is used and no memory is allocated up front.
+     * Ignored if buffer_pool is set.
+     */
+    const struct aws_s3_buffer_pool_memory_options *buffer_pool_memory_options;
+
+    /**
+     * Optional.
+     * Buffer pool shared with other clients in the process (see aws_s3_shared_buffer_pool_new()), so that clients
+     * can borrow memory from each other within one overall limit, instead of each client having its own.
+     * Can also be a pool getting its memory from outside of the client (see aws_s3_buffer_pool_new_from_provider()).
+     * The client keeps a reference to the pool.
+     * If NULL, the client creates a buffer pool of its own.
+     */
+    struct aws_s3_buffer_pool *buffer_pool;
+
+    /**
+     * Optional.
+     * Cache of the parts of ranged GetObject downloads (see aws_s3_block_cache_new()), so that parts downloaded
+     * before are served from memory or disk instead of being fetched again. Only the missing parts of a download
+     * are fetched. Parts are cached by host, path, ETag and byte range, and the request discovering the object's
+     * size is always sent, so the ETag is checked with If-Match before any cached part is used.
+     * Parts of meta requests validating response checksums are not served from the cache.
+     * Can be shared by multiple clients. The client keeps a reference to the cache.
+     */
+    struct aws_s3_block_cache *block_cache;
+
+    /**
+     * Optional.
+     * Max number of objects whose size and ETag the client remembers from GetObject downloads.
+     * A later download of the same object (same Host header and path) then starts all of its ranged parts right away,
+     * with If-Match on the remembered ETag, instead of first discovering the size of the object with a round trip.
+     * If the object has changed since, that download fails with AWS_ERROR_S3_OBJECT_MODIFIED, and the object is
+     * forgotten, so the next download discovers it again.
+     * Not used by downloads validating response checksums, delivering the body out of order (see
+     * aws_s3_meta_request_options.receive_buffer_callback), or with a Range header that has no start (ex. bytes=-100).
+     * If 0, the client doesn't remember objects.
+     */
+    size_t object_metadata_cache_size;
+
+    /**
+     * Optional.
+     * Number of parts after the first one that a GetObject requests right away, sized from part_size, while the
+     * first part is still discovering the size of the object. This saves a round trip at the start of downloads of
+     * objects larger than a part. Parts that turn out to be past the end of the object are dropped. If these parts
+     * didn't get the same object as the first part (ETag differs), the download fails with
+     * AWS_ERROR_S3_OBJECT_MODIFIED.
+     * Not used by downloads validating response checksums, delivering the body out of order (see
+     * aws_s3_meta_request_options.receive_buffer_callback), or with a Range header that has no start (ex. bytes=-100).
+     * If 0, parts after the first one wait for the size of the object.
+     */
+    uint32_t num_speculative_get_parts;
+
+    /**
+     * Optional.
+     * Hedging of the straggling parts of GetObject downloads (see aws_s3_get_hedge_options).
+     * Parts received directly into caller's memory (see aws_s3_meta_request_options.receive_buffer_callback), and the
+     * parts requested before the object size is known, are not hedged.
+     * If NULL, parts are not hedged.
+     */
+    const struct aws_s3_get_hedge_options *get_hedge_options;
+
+    /**
+     * Optional.
+     * Smallest size that the last parts of GetObject downloads are split to.
+     * Once the rest of the object to request is less than a part for each connection, it's split evenly across the
+     * connections in parts smaller than part_size, but no smaller than this. So the connections share the tail of the
+     * download, instead of a few of them downloading whole parts while the rest are idle. The body is still delivered
+     * in order to the body_callback.
+     * If 0, or not smaller than part_size, the last parts aren't split.
+     */
+    size_t get_tail_min_part_size;
+
+    /**
+     * Optional.
+     * Default memory limit for each meta request, indexed by aws_s3_meta_request_type
+     * (see aws_s3_meta_request_options.memory_limit_in_bytes).
+     * If 0, meta requests of that type are only bound by memory_limit_in_bytes of the client.
+     */
+    uint64_t meta_request_memory_limits_in_bytes[AWS_S3_META_REQUEST_TYPE_MAX];
+
     /* Retry strategy to use. If NULL, a default retry strategy will be used. */
     struct aws_retry_strategy *retry_strategy;
 
@@ -580,7 +990,8 @@ struct aws_s3_checksum_config {
  * Options for a new meta request, ie, file transfer that will be handled by the high performance client.
  *
  * There are several ways to pass the request's body data:
- * 1) If the data is already in memory, set the body-stream on `message`.
+ * 1) If the data is already in memory, set `send_buffer` to send it without copying, or set the body-stream on
+ *    `message`.
  * 2) If the data is on disk, set `send_filepath` for best performance.
  * 3) If the data is available, but copying each chunk is asynchronous, set `send_async_stream`.
  * 4) If you're not sure when each chunk of data will be available, use `send_using_async_writes`.
@@ -640,6 +1051,52 @@ struct aws_s3_meta_request_options {
      */
     struct aws_byte_cursor send_filepath;
 
+    /**
+     * Optional.
+     * If true, `send_filepath` is read through io_uring, so many parts are read at once with a deep queue.
+     * This helps when uploading from fast local disks.
+     * Where io_uring is not available, the file is read the regular way instead.
+     */
+    bool send_filepath_use_io_uring;
+
+    /**
+     * Optional.
+     * If true, `send_filepath` is mapped into memory, and each part is sent straight from the mapping.
+     * This saves a buffer per part in flight, and the copy to read into it.
+     * The file must not be truncated until the meta request finishes.
+     * Where the file can't be mapped, it's read the regular way instead. Takes precedence over
+     * `send_filepath_use_io_uring`.
+     */
+    bool send_filepath_use_mmap;
+
+    /**
+     * Optional.
+     * If true, `send_filepath` is read with direct I/O, bypassing the page cache, so large uploads don't evict
+     * other data from it. Unaligned edges of parts are still read through the page cache.
+     * Ignored on platforms or file systems that don't support it, and with `send_filepath_use_mmap` or
+     * `send_filepath_use_io_uring`.
+     */
+    bool send_filepath_use_direct_io;
+
+    /**
+     * Optional.
+     * If set, this memory is sent as the request body, without copying it.
+     * Each part is sent straight from it, so uploading it takes no buffers from the client's memory limit.
+     * The memory must stay valid and unchanged until `send_buffer_release_callback` is invoked, or until the meta
+     * request finishes if that's not set.
+     * If the message has no Content-Length header, the length of send_buffer is used.
+     * It counts as set if its ptr is not NULL, so an empty body is sent with a zero length and any non-NULL ptr.
+     * Do not set if the body is being passed by other means (see note above).
+     */
+    struct aws_byte_cursor send_buffer;
+
+    /**
+     * Optional.
+     * Invoked with user_data once the client no longer references `send_buffer`, before finish_callback.
+     * Not invoked if creating the meta request fails.
+     */
+    aws_s3_meta_request_send_buffer_release_fn *send_buffer_release_callback;
+
     /**
      * Optional - EXPERIMENTAL/UNSTABLE
      * If set, the request body comes from this async stream.
@@ -780,6 +1237,80 @@ struct aws_s3_meta_request_options {
      * This is just used as an estimate, so it's okay to provide an approximate value if the exact size is unknown.
      */
     const uint64_t *object_size_hint;
+
+    /**
+     * Optional.
+     * Max memory, in bytes, this meta request can hold in part buffers from the client's memory limit
+     * (see aws_s3_client_config.memory_limit_in_bytes). Once reached, no more parts are started until buffers of
+     * earlier parts are released, so one large transfer cannot take all of the client's memory and starve others.
+     * A meta request can always hold at least one part buffer, even if part size is over the limit.
+     * If 0, aws_s3_client_config.meta_request_memory_limits_in_bytes for this meta request's type is used.
+     */
+    uint64_t memory_limit_in_bytes;
+
+    /**
+     * Optional.
+     * For AWS_S3_META_REQUEST_TYPE_GET_OBJECT only.
+     * Invoked to get caller owned memory for each part of the object (ex. a slice of one destination buffer
+     * that is large enough for the whole object), so parts are received directly into it instead of into
+     * the client's buffers. Parts complete independently and out of order, without waiting to be delivered in order.
+     * When set, body_callback is not invoked. Use progress_callback to track how much data has arrived.
+     * Cannot be used together with checksum_config.validate_response_checksum.
+     * See `aws_s3_meta_request_receive_buffer_fn`.
+     */
+    aws_s3_meta_request_receive_buffer_fn *receive_buffer_callback;
+
+    /**
+     * Optional.
+     * For AWS_S3_META_REQUEST_TYPE_GET_OBJECT only.
+     * If set, the object is written to this file instead of being delivered through body_callback.
+     * The file is created, or truncated if it already exists. Each part is written at its offset in the file as
+     * soon as it arrives, so parts don't wait on each other to be delivered in order and memory is only held
+     * for parts in flight. Use progress_callback to track how much data has arrived.
+     * If the meta request fails, the file is left partially written.
+     * Cannot be used together with checksum_config.validate_response_checksum or receive_buffer_callback.
+     */
+    struct aws_byte_cursor recv_filepath;
+
+    /**
+     * Optional.
+     * If set, space for the whole object is reserved in recv_filepath once its size is known,
+     * so the file isn't grown and fragmented as parts are written out of order.
+     * Ignored on platforms or file systems that don't support it.
+     */
+    bool recv_file_preallocate;
+
+    /**
+     * Optional.
+     * If true, recv_filepath is written with direct I/O, bypassing the page cache, so large downloads don't evict
+     * other data from it. Unaligned edges of parts are still written through the page cache.
+     * Ignored on platforms or file systems that don't support it.
+     */
+    bool recv_filepath_use_direct_io;
+
+    /**
+     * Optional.
+     * For AWS_S3_META_REQUEST_TYPE_GET_OBJECT.
+     * If set, body_callback is invoked for each part as soon as it arrives, instead of waiting for all earlier
+     * parts so the body is delivered in order. Use the range_start passed to body_callback to place the data.
+     * Parts don't queue behind a slow earlier part, so less memory is held and the download finishes sooner.
+     * body_callback is still never invoked concurrently.
+     * Cannot be used together with checksum_config.validate_response_checksum.
+     * Cannot be used with other meta request types.
+     */
+    bool out_of_order_body_callback;
+};
+
+/* Memory a meta request holds from the client's memory limit. See aws_s3_meta_request_get_memory_usage() */
+struct aws_s3_meta_request_memory_usage {
+    /* Memory reserved for parts that don't have a buffer yet. */
+    uint64_t reserved;
+
+    /* Memory in part buffers. */
+    uint64_t used;
+
+    /* Max of reserved + used (see aws_s3_meta_request_options.memory_limit_in_bytes). 0 if there is no limit. */
+    uint64_t limit;
 };
 
 /* Result details of a meta request.
@@ -863,6 +1394,94 @@ struct aws_s3_meta_request *aws_s3_client_make_meta_request(
     struct aws_s3_client *client,
     const struct aws_s3_meta_request_options *options);
 
+/**
+ * Get how much memory the client currently holds from its buffer pool.
+ * This function is thread safe.
+ */
+AWS_S3_API
+struct aws_s3_client_memory_usage aws_s3_client_get_memory_usage(struct aws_s3_client *client);
+
+/**
+ * Create a buffer pool that can be shared by multiple clients (see aws_s3_client_config.buffer_pool).
+ * Returns NULL and raises an error on failure.
+ * Release the returned reference with aws_s3_buffer_pool_release() once it is passed to all clients.
+ */
+AWS_S3_API
+struct aws_s3_buffer_pool *aws_s3_shared_buffer_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_s3_shared_buffer_pool_options *options);
+
+/**
+ * Create a buffer pool that gets its memory from the given provider, instead of allocating it.
+ * Pass it to clients through aws_s3_client_config.buffer_pool.
+ * The vtable must stay valid for the lifetime of the pool.
+ * Release the returned reference with aws_s3_buffer_pool_release() once it is passed to all clients.
+ */
+AWS_S3_API
+struct aws_s3_buffer_pool *aws_s3_buffer_pool_new_from_provider(
+    struct aws_allocator *allocator,
+    const struct aws_s3_buffer_provider_vtable *vtable,
+    void *user_data);
+
+/**
+ * Tell a buffer pool created with aws_s3_buffer_pool_new_from_provider() that its provider has memory again,
+ * for example because something else sharing the provider freed some. Reservations waiting for memory are
+ * retried right away, on the calling thread, instead of once the client releases a buffer.
+ * Can be called from any thread, but not while holding a lock that the provider's reserve takes.
+ */
+AWS_S3_API
+void aws_s3_buffer_pool_notify_provider_memory_available(struct aws_s3_buffer_pool *buffer_pool);
+
+/**
+ * Add a reference, keeping the buffer pool alive.
+ * It's OK to pass in NULL (nothing happens).
+ * Always returns the same pointer that was passed in.
+ */
+AWS_S3_API
+struct aws_s3_buffer_pool *aws_s3_buffer_pool_acquire(struct aws_s3_buffer_pool *buffer_pool);
+
+/**
+ * Release a reference.
+ * When the reference count drops to 0, the buffer pool will be cleaned up.
+ * It's OK to pass in NULL (nothing happens).
+ * Always returns NULL.
+ */
+AWS_S3_API
+struct aws_s3_buffer_pool *aws_s3_buffer_pool_release(struct aws_s3_buffer_pool *buffer_pool);
+
+/**
+ * Create a block cache that can be passed to clients through aws_s3_client_config.block_cache.
+ * Returns NULL and raises an error if the options are invalid.
+ * Release the returned reference with aws_s3_block_cache_release() once it is passed to all clients.
+ */
+AWS_S3_API
+struct aws_s3_block_cache *aws_s3_block_cache_new(
+    struct aws_allocator *allocator,
+    const struct aws_s3_block_cache_options *options);
+
+/**
+ * Add a reference, keeping the block cache alive.
+ * It's OK to pass in NULL (nothing happens).
+ * Always returns the same pointer that was passed in.
+ */
+AWS_S3_API
+struct aws_s3_block_cache *aws_s3_block_cache_acquire(struct aws_s3_block_cache *block_cache);
+
+/**
+ * Release a reference.
+ * When the reference count drops to 0, the block cache and its spilled files will be cleaned up.
+ * It's OK to pass in NULL (nothing happens).
+ * Always returns NULL.
+ */
+AWS_S3_API
+struct aws_s3_block_cache *aws_s3_block_cache_release(struct aws_s3_block_cache *block_cache);
+
+/**
+ * Get the counters of a block cache.
+ */
+AWS_S3_API
+struct aws_s3_block_cache_stats aws_s3_block_cache_get_stats(struct aws_s3_block_cache *block_cache);
+
 /**
  * The result of an `aws_s3_meta_request_poll_write()` call.
  * Think of this like Rust's `Poll<Result<size_t, int>>`, or C++'s `optional<expected<size_t, int>>`.
@@ -999,6 +1618,13 @@ void aws_s3_meta_request_increment_read_window(struct aws_s3_meta_request *meta_
 AWS_S3_API
 void aws_s3_meta_request_cancel(struct aws_s3_meta_request *meta_request);
 
+/**
+ * Get how much memory the meta request currently holds from the client's memory limit.
+ * This function is thread safe.
+ */
+AWS_S3_API
+struct aws_s3_meta_request_memory_usage aws_s3_meta_request_get_memory_usage(struct aws_s3_meta_request *meta_request);
+
 /**
  * Note: pause is currently only supported on upload requests.
  * In order to pause an ongoing upload, call aws_s3_meta_request_pause() that
@@ -0,0 +1,119 @@
+#ifndef AWS_S3_OBJECT_READER_H
+#define AWS_S3_OBJECT_READER_H
+
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/s3/s3.h>
+
+AWS_PUSH_SANE_WARNING_LEVEL
+
+struct aws_byte_buf;
+struct aws_future_bool;
+struct aws_http_message;
+struct aws_s3_client;
+struct aws_signing_config_aws;
+
+/**
+ * Long-lived handle for reading an object at random offsets, ex. to back a file system.
+ *
+ * Each read is served from ranges of the object fetched with ranged GetObject meta requests through the client.
+ * Ranges stay cached after they arrive, and reads that land in a range that is still in flight wait for it instead
+ * of sending another request. When reads look sequential, the reader fetches ahead of them, doubling the readahead
+ * with each sequential read up to a limit. Once the object's ETag is known, later ranges are fetched with If-Match,
+ * so every read sees the same version of the object.
+ */
+struct aws_s3_object_reader;
+
+struct aws_s3_object_reader_options {
+    /**
+     * Required.
+     * GetObject request for the object (ex. from the same function that makes GetObject messages for
+     * aws_s3_client_make_meta_request()). Must not have a Range header.
+     */
+    struct aws_http_message *message;
+
+    /**
+     * Optional.
+     * Signing config for the ranged GetObject requests. If NULL, the client's signing config is used.
+     * See aws_s3_meta_request_options.signing_config.
+     */
+    const struct aws_signing_config_aws *signing_config;
+
+    /**
+     * Optional.
+     * How far ahead to fetch once reads look sequential, in bytes. Doubles with each sequential read.
+     * If 0, the client's part size is used.
+     */
+    uint64_t initial_readahead_size;
+
+    /**
+     * Optional.
+     * Max the readahead grows to, in bytes.
+     * If 0, 8 times the client's part size is used.
+     */
+    uint64_t max_readahead_size;
+
+    /**
+     * Optional.
+     * Max size, in bytes, of the ranges the reader holds. Once reached, the least recently read ranges are
+     * dropped to make room for new ones. Ranges still in flight are never dropped, so this can be exceeded
+     * while they finish. Each range is at most the larger of max_readahead_size and the client's part size, and a
+     * large read only starts more ranges ahead of the one it waits on while they fit in this limit.
+     * If 0, 2 times max_readahead_size is used.
+     */
+    uint64_t max_cached_size;
+};
+
+AWS_EXTERN_C_BEGIN
+
+/**
+ * Create an object reader. Nothing is fetched until the first read.
+ * Returns NULL and raises an error if the options are invalid.
+ */
+AWS_S3_API
+struct aws_s3_object_reader *aws_s3_object_reader_new(
+    struct aws_allocator *allocator,
+    struct aws_s3_client *client,
+    const struct aws_s3_object_reader_options *options);
+
+/**
+ * Increment reference count.
+ * You may pass in NULL (has no effect).
+ * Returns whatever pointer was passed in.
+ */
+AWS_S3_API
+struct aws_s3_object_reader *aws_s3_object_reader_acquire(struct aws_s3_object_reader *reader);
+
+/**
+ * Decrement reference count.
+ * You may pass in NULL (has no effect).
+ * Always returns NULL.
+ */
+AWS_S3_API
+struct aws_s3_object_reader *aws_s3_object_reader_release(struct aws_s3_object_reader *reader);
+
+/**
+ * Read the object from offset into the remaining capacity of dest, like aws_parallel_input_stream_read().
+ * The future completes once dest is full, or the end of the object is reached, or an error occurs.
+ * Its result is true if the end of the object was reached before dest was full.
+ * Reads can be made from any thread, and several reads can be in flight at once.
+ * dest must stay valid until the future completes.
+ *
+ * @param reader            The object reader
+ * @param offset            The offset in the object to start reading from
+ * @param dest              The buffer read to
+ * @return                  Future that completes once the read is done. Result is whether end of object was reached.
+ */
+AWS_S3_API
+struct aws_future_bool *aws_s3_object_reader_read(
+    struct aws_s3_object_reader *reader,
+    uint64_t offset,
+    struct aws_byte_buf *dest);
+
+AWS_EXTERN_C_END
+AWS_POP_SANE_WARNING_LEVEL
+
+#endif /* AWS_S3_OBJECT_READER_H */
@@ -4,11 +4,16 @@
  */
 
 #include "aws/s3/private/s3_auto_ranged_get.h"
+#include "aws/s3/private/s3_block_cache.h"
 #include "aws/s3/private/s3_client_impl.h"
 #include "aws/s3/private/s3_meta_request_impl.h"
+#include "aws/s3/private/s3_object_metadata_cache.h"
+#include "aws/s3/private/s3_parallel_output_stream.h"
 #include "aws/s3/private/s3_request_messages.h"
 #include "aws/s3/private/s3_util.h"
+#include <aws/common/clock.h>
 #include <aws/common/string.h>
+#include <aws/io/event_loop.h>
 #include <inttypes.h>
 
 /* Dont use buffer pool when we know response size, and its below this number,
@@ -44,6 +49,12 @@ static struct aws_s3_meta_request_vtable s_s3_auto_ranged_get_vtable = {
     .finish = aws_s3_meta_request_finish_default,
 };
 
+/* Whether each part's body lands in its final place (caller's memory or file) as soon as the part completes,
+ * instead of being streamed back to the user in order through the body_callback. */
+static bool s_delivers_body_out_of_order(const struct aws_s3_meta_request *meta_request) {
+    return meta_request->receive_buffer_callback != NULL || meta_request->recv_file != NULL;
+}
+
 static int s_s3_auto_ranged_get_success_status(struct aws_s3_meta_request *meta_request) {
     AWS_PRECONDITION(meta_request);
 
@@ -57,6 +68,251 @@ static int s_s3_auto_ranged_get_success_status(struct aws_s3_meta_request *meta_
     return AWS_HTTP_STATUS_CODE_200_OK;
 }
 
+/* Write the response body of a part to the recv_file, at the part's offset from the start of the object range.
+ * The write blocks, so it runs on the client's file I/O ELG, see s_s3_auto_ranged_get_request_finished(). */
+static int s_write_to_recv_file(
+    struct aws_s3_meta_request *meta_request,
+    struct aws_s3_request *request,
+    bool found_object_size,
+    uint64_t object_range_start) {
+
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+
+    if (!found_object_size) {
+        /* BEGIN CRITICAL SECTION */
+        aws_s3_meta_request_lock_synced_data(meta_request);
+        AWS_ASSERT(auto_ranged_get->synced_data.object_range_known);
+        object_range_start = auto_ranged_get->synced_data.object_range_start;
+        aws_s3_meta_request_unlock_synced_data(meta_request);
+        /* END CRITICAL SECTION */
+    }
+
+    struct aws_byte_cursor body = aws_byte_cursor_from_buf(&request->send_data.response_body);
+    AWS_ASSERT(request->part_range_start >= object_range_start || body.len == 0);
+    uint64_t offset = request->part_range_start - object_range_start;
+    if (aws_parallel_output_stream_write(meta_request->recv_file, offset, body)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_META_REQUEST,
+            "id=%p Failed to write part %" PRIu32 " to recv_file, error %d (%s)",
+            (void *)meta_request,
+            request->part_number,
+            aws_last_error(),
+            aws_error_str(aws_last_error()));
+        return AWS_OP_ERR;
+    }
+    return AWS_OP_SUCCESS;
+}
+
+/* Init out_key with the block cache key of a part. Returns false if the part can't be cached. */
+static bool s_block_cache_key_init(
+    struct aws_s3_meta_request *meta_request,
+    struct aws_s3_request *request,
+    struct aws_byte_buf *out_key) {
+
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+
+    /* The part discovering the object size is always sent, it checks the ETag that cached parts were stored with */
+    if (auto_ranged_get->block_cache == NULL || request->discovers_object_size || request->is_speculative ||
+        request->request_tag != AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE) {
+        return false;
+    }
+
+    struct aws_byte_cursor etag;
+    if (auto_ranged_get->etag != NULL) {
+        etag = aws_byte_cursor_from_string(auto_ranged_get->etag);
+    } else if (
+        !auto_ranged_get->initial_message_has_if_match_header ||
+        aws_http_headers_get(
+            aws_http_message_get_const_headers(meta_request->initial_request_message), g_if_match_header_name, &etag)) {
+        return false;
+    }
+
+    return aws_s3_block_cache_key_init(
+               out_key,
+               meta_request->allocator,
+               meta_request->initial_request_message,
+               etag,
+               request->part_range_start,
+               request->part_range_end) == AWS_OP_SUCCESS;
+}
+
+/* Start filling the response body of a part from the block cache.
+ * Returns NULL if the part can't come from the cache, or a future that's true on a hit. */
+static struct aws_future_bool *s_read_from_block_cache(
+    struct aws_s3_meta_request *meta_request,
+    struct aws_s3_request *request) {
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+
+    if (auto_ranged_get->object_range_from_cache && request->part_number == 1) {
+        /* Part 1 checks the ETag from the object metadata cache, so it's always sent */
+        return NULL;
+    }
+
+    struct aws_byte_buf key;
+    if (!s_block_cache_key_init(meta_request, request, &key)) {
+        return NULL;
+    }
+
+    size_t part_size = (size_t)(request->part_range_end - request->part_range_start + 1);
+    struct aws_byte_buf *body = &request->send_data.response_body;
+    AWS_ASSERT(body->capacity == 0);
+    if (request->ticket != NULL) {
+        /* Same buffer the response would be received into, so it's kept on a miss */
+        *body = aws_s3_buffer_pool_acquire_buffer(meta_request->client->buffer_pool, request->ticket);
+        if (body->buffer == NULL) {
+            /* Buffer provider is out of memory, receiving the response fails the same way */
+            aws_byte_buf_clean_up(&key);
+            return NULL;
+        }
+    } else {
+        aws_byte_buf_init(body, meta_request->allocator, part_size);
+    }
+
+    /* Spilled blocks are read back on the file I/O ELG, not on this thread */
+    struct aws_future_bool *hit_future = aws_s3_block_cache_get(
+        auto_ranged_get->block_cache,
+        aws_byte_cursor_from_buf(&key),
+        body,
+        aws_s3_client_get_file_io_elg(meta_request->client));
+    aws_byte_buf_clean_up(&key);
+    return hit_future;
+}
+
+/* Finish filling the response body of a part from the block cache.
+ * Returns true if it was a hit, and the part doesn't need to be sent. */
+static bool s_finish_read_from_block_cache(
+    struct aws_s3_meta_request *meta_request,
+    struct aws_s3_request *request,
+    bool hit) {
+
+    size_t part_size = (size_t)(request->part_range_end - request->part_range_start + 1);
+    struct aws_byte_buf *body = &request->send_data.response_body;
+
+    if (hit && body->len != part_size) {
+        AWS_LOGF_WARN(
+            AWS_LS_S3_META_REQUEST,
+            "id=%p: Ignoring cached part %" PRIu32 " of %zu bytes, expected %zu bytes",
+            (void *)meta_request,
+            request->part_number,
+            body->len,
+            part_size);
+        aws_byte_buf_reset(body, false);
+        hit = false;
+    }
+
+    if (!hit) {
+        if (request->ticket == NULL) {
+            aws_byte_buf_clean_up(body);
+        }
+        return false;
+    }
+
+    if (request->has_caller_response_body) {
+        /* Body isn't in caller's memory, request_finished copies it over like for the part discovering size */
+        request->has_caller_response_body = false;
+    }
+    return true;
+}
+
+/* Take the object range from the client's object metadata cache, so that no request is needed to discover it.
+ * Part 1 then checks the cached ETag with If-Match, like the discovery request would. */
+static void s_init_object_range_from_metadata_cache(struct aws_s3_auto_ranged_get *auto_ranged_get) {
+    struct aws_s3_meta_request *meta_request = &auto_ranged_get->base;
+    struct aws_s3_object_metadata_cache *cache = meta_request->client->object_metadata_cache;
+
+    /* Headers must reach the user before any body, so the body has to be delivered in order after part 1 */
+    if (cache == NULL || meta_request->checksum_config.validate_response_checksum ||
+        s_delivers_body_out_of_order(meta_request) || meta_request->out_of_order_body_callback ||
+        (auto_ranged_get->initial_message_has_range_header && !auto_ranged_get->initial_message_has_start_range)) {
+        return;
+    }
+
+    uint64_t object_size = 0;
+    struct aws_string *etag = NULL;
+    if (!aws_s3_object_metadata_cache_get(cache, meta_request->initial_request_message, &object_size, &etag)) {
+        return;
+    }
+
+    uint64_t range_start = auto_ranged_get->initial_message_has_range_header ? auto_ranged_get->initial_range_start : 0;
+    if (object_size == 0 || range_start >= object_size) {
+        /* Let the service respond to these as usual */
+        goto done;
+    }
+
+    if (auto_ranged_get->initial_message_has_if_match_header) {
+        struct aws_byte_cursor if_match;
+        if (aws_http_headers_get(
+                aws_http_message_get_const_headers(meta_request->initial_request_message),
+                g_if_match_header_name,
+                &if_match) ||
+            !aws_string_eq_byte_cursor(etag, &if_match)) {
+            goto done;
+        }
+    }
+
+    uint64_t range_end = object_size - 1; /* range-end is inclusive */
+    if (auto_ranged_get->initial_message_has_end_range) {
+        range_end = aws_min_u64(range_end, auto_ranged_get->initial_range_end);
+    }
+
+    auto_ranged_get->etag = etag;
+    etag = NULL;
+    auto_ranged_get->object_range_from_cache = true;
+    auto_ranged_get->cached_object_size = object_size;
+    auto_ranged_get->synced_data.object_range_known = true;
+    auto_ranged_get->synced_data.object_range_start = range_start;
+    auto_ranged_get->synced_data.object_range_end = range_end;
+    auto_ranged_get->synced_data.total_num_parts = aws_s3_calculate_auto_ranged_get_num_parts(
+        meta_request->part_size, auto_ranged_get->synced_data.first_part_size, range_start, range_end);
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_S3_META_REQUEST,
+        "id=%p: Object size %" PRIu64 " found in object metadata cache, skipping discovery of the object size",
+        (void *)meta_request,
+        object_size);
+
+done:
+    aws_string_destroy(etag);
+}
+
+/* Number of parts to request while part 1 discovers the object range (see
+ * aws_s3_client_config.num_speculative_get_parts). Their ranges assume part 1 is a whole part long. */
+static uint32_t s_get_max_speculative_parts(const struct aws_s3_auto_ranged_get *auto_ranged_get) {
+    const struct aws_s3_meta_request *meta_request = &auto_ranged_get->base;
+    uint32_t max_parts = meta_request->client->num_speculative_get_parts;
+
+    /* Part 1 has to be a ranged get, and its ETag has to be checked before any body is delivered */
+    if (max_parts == 0 || auto_ranged_get->object_range_from_cache ||
+        meta_request->checksum_config.validate_response_checksum || s_delivers_body_out_of_order(meta_request) ||
+        meta_request->out_of_order_body_callback ||
+        (auto_ranged_get->initial_message_has_range_header && !auto_ranged_get->initial_message_has_start_range)) {
+        return 0;
+    }
+
+    /* Don't request past the end of the range, or past the end of the object that the size hint suggests */
+    uint64_t range_start = auto_ranged_get->initial_message_has_range_header ? auto_ranged_get->initial_range_start : 0;
+    uint64_t range_size = UINT64_MAX;
+    if (auto_ranged_get->initial_message_has_end_range) {
+        if (auto_ranged_get->initial_range_end < range_start) {
+            return 0;
+        }
+        range_size = auto_ranged_get->initial_range_end - range_start + 1;
+    }
+    if (auto_ranged_get->object_size_hint_available) {
+        if (auto_ranged_get->object_size_hint <= range_start) {
+            return 0;
+        }
+        range_size = aws_min_u64(range_size, auto_ranged_get->object_size_hint - range_start);
+    }
+
+    uint64_t part_size = meta_request->part_size;
+    if (range_size <= part_size) {
+        return 0;
+    }
+    uint64_t num_parts_after_first = (range_size - part_size) / part_size + ((range_size % part_size) ? 1 : 0);
+    return (uint32_t)aws_min_u64(max_parts, num_parts_after_first);
+}
+
 /* Allocate a new auto-ranged-get meta request. */
 struct aws_s3_meta_request *aws_s3_meta_request_auto_ranged_get_new(
     struct aws_allocator *allocator,
@@ -109,11 +365,24 @@ struct aws_s3_meta_request *aws_s3_meta_request_auto_ranged_get_new(
         }
     }
     auto_ranged_get->initial_message_has_if_match_header = aws_http_headers_has(headers, g_if_match_header_name);
+    if (!auto_ranged_get->base.checksum_config.validate_response_checksum) {
+        /* Parts from the cache have no response to validate the checksum of */
+        auto_ranged_get->block_cache = aws_s3_block_cache_acquire(client->block_cache);
+    }
     auto_ranged_get->synced_data.first_part_size = auto_ranged_get->base.part_size;
     if (options->object_size_hint != NULL) {
         auto_ranged_get->object_size_hint_available = true;
         auto_ranged_get->object_size_hint = *options->object_size_hint;
     }
+    s_init_object_range_from_metadata_cache(auto_ranged_get);
+    auto_ranged_get->synced_data.max_speculative_parts = s_get_max_speculative_parts(auto_ranged_get);
+    aws_array_list_init_dynamic(
+        &auto_ranged_get->synced_data.hedged_parts, allocator, 0, sizeof(struct aws_s3_hedged_part));
+    aws_task_init(
+        &auto_ranged_get->hedge_check_task,
+        s_s3_auto_ranged_get_hedge_check_task,
+        &auto_ranged_get->base,
+        "s3_auto_ranged_get_hedge_check_task");
     AWS_LOGF_DEBUG(
         AWS_LS_S3_META_REQUEST, "id=%p Created new Auto-Ranged Get Meta Request.", (void *)&auto_ranged_get->base);
 
@@ -131,6 +400,10 @@ static void s_s3_meta_request_auto_ranged_get_destroy(struct aws_s3_meta_request
 
     struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
     aws_string_destroy(auto_ranged_get->etag);
+    aws_string_destroy(auto_ranged_get->synced_data.speculative_etag);
+    AWS_ASSERT(aws_array_list_length(&auto_ranged_get->synced_data.hedged_parts) == 0);
+    aws_array_list_clean_up(&auto_ranged_get->synced_data.hedged_parts);
+    aws_s3_block_cache_release(auto_ranged_get->block_cache);
     aws_mem_release(meta_request->allocator, auto_ranged_get);
 }
 
@@ -184,6 +457,377 @@ static enum aws_s3_auto_ranged_get_request_type s_s3_get_request_type_for_discov
     return AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_HEAD_OBJECT;
 }
 
+/* Create the request for the next part after part 1, while part 1 is still discovering the object range.
+ * Returns NULL if it can't be sent yet. */
+static struct aws_s3_request *s_s3_auto_ranged_get_speculative_part_new_synced(
+    struct aws_s3_meta_request *meta_request) {
+    ASSERT_SYNCED_DATA_LOCK_HELD(meta_request);
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+
+    uint32_t part_index = auto_ranged_get->synced_data.num_parts_requested;
+    uint64_t range_offset = (uint64_t)part_index * meta_request->part_size;
+
+    if (meta_request->client->enable_read_backpressure &&
+        range_offset >= meta_request->synced_data.read_window_running_total) {
+        return NULL;
+    }
+
+    struct aws_s3_buffer_pool_ticket *ticket =
+        aws_s3_meta_request_reserve_ticket_synced(meta_request, meta_request->part_size);
+    if (ticket == NULL) {
+        return NULL;
+    }
+
+    /* Headers are recorded to check the part got the same object as part 1 */
+    struct aws_s3_request *request = aws_s3_request_new(
+        meta_request,
+        AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE,
+        AWS_S3_REQUEST_TYPE_GET_OBJECT,
+        part_index + 1 /*part_number*/,
+        AWS_S3_REQUEST_FLAG_RECORD_RESPONSE_HEADERS | AWS_S3_REQUEST_FLAG_PART_SIZE_RESPONSE_BODY);
+    request->ticket = ticket;
+    request->is_speculative = true;
+
+    uint64_t range_start = auto_ranged_get->initial_message_has_range_header ? auto_ranged_get->initial_range_start : 0;
+    request->part_range_start = range_start + range_offset;
+    request->part_range_end = request->part_range_start + meta_request->part_size - 1; /* range-end is inclusive */
+    if (auto_ranged_get->initial_message_has_end_range) {
+        request->part_range_end = aws_min_u64(request->part_range_end, auto_ranged_get->initial_range_end);
+    }
+
+    ++auto_ranged_get->synced_data.num_parts_requested;
+    ++auto_ranged_get->synced_data.num_speculative_parts;
+    return request;
+}
+
+/* Min number of finished parts to compare a part in flight against, before it can be hedged */
+static const uint32_t s_hedge_min_part_durations = 8;
+
+static bool s_hedges_parts(const struct aws_s3_meta_request *meta_request) {
+    return meta_request->client->get_hedge_options.percentile != 0;
+}
+
+/* Find the hedged part that the request is the original or the duplicate request of. Returns NULL if none. */
+static struct aws_s3_hedged_part *s_find_hedged_part_synced(
+    struct aws_s3_auto_ranged_get *auto_ranged_get,
+    const struct aws_s3_request *request,
+    size_t *out_index) {
+
+    size_t num_hedged_parts = aws_array_list_length(&auto_ranged_get->synced_data.hedged_parts);
+    for (size_t i = 0; i < num_hedged_parts; ++i) {
+        struct aws_s3_hedged_part *hedged_part = NULL;
+        aws_array_list_get_at_ptr(&auto_ranged_get->synced_data.hedged_parts, (void **)&hedged_part, i);
+        if (hedged_part->original == request || hedged_part->hedge == request) {
+            if (out_index != NULL) {
+                *out_index = i;
+            }
+            return hedged_part;
+        }
+    }
+    return NULL;
+}
+
+static void s_record_part_duration_synced(
+    struct aws_s3_auto_ranged_get *auto_ranged_get,
+    const struct aws_s3_request *request) {
+    const struct aws_s3_request_metrics *metrics = request->send_data.metrics;
+    if (metrics == NULL || metrics->time_metrics.receive_end_timestamp_ns <= metrics->time_metrics.start_timestamp_ns) {
+        return;
+    }
+
+    uint32_t index = auto_ranged_get->synced_data.num_part_durations % AWS_S3_AUTO_RANGED_GET_NUM_PART_DURATIONS;
+    auto_ranged_get->synced_data.part_durations_ns[index] =
+        metrics->time_metrics.receive_end_timestamp_ns - metrics->time_metrics.start_timestamp_ns;
+    ++auto_ranged_get->synced_data.num_part_durations;
+}
+
+/* The percentile of the recent part durations that a part in flight has to exceed to be hedged */
+static uint64_t s_hedge_threshold_ns_synced(const struct aws_s3_auto_ranged_get *auto_ranged_get, uint32_t percentile) {
+    uint64_t durations_ns[AWS_S3_AUTO_RANGED_GET_NUM_PART_DURATIONS];
+    size_t num_durations =
+        aws_min_size(auto_ranged_get->synced_data.num_part_durations, AWS_S3_AUTO_RANGED_GET_NUM_PART_DURATIONS);
+    AWS_ASSERT(num_durations > 0);
+
+    /* Insertion sort, there are only a few of them */
+    for (size_t i = 0; i < num_durations; ++i) {
+        uint64_t duration_ns = auto_ranged_get->synced_data.part_durations_ns[i];
+        size_t j = i;
+        for (; j > 0 && durations_ns[j - 1] > duration_ns; --j) {
+            durations_ns[j] = durations_ns[j - 1];
+        }
+        durations_ns[j] = duration_ns;
+    }
+    return durations_ns[(num_durations - 1) * percentile / 100];
+}
+
+static void s_s3_auto_ranged_get_hedge_check_task(struct aws_task *task, void *arg, enum aws_task_status task_status) {
+    (void)task;
+    struct aws_s3_meta_request *meta_request = arg;
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+
+    /* BEGIN CRITICAL SECTION */
+    aws_s3_meta_request_lock_synced_data(meta_request);
+    auto_ranged_get->synced_data.hedge_check_scheduled = false;
+    aws_s3_meta_request_unlock_synced_data(meta_request);
+    /* END CRITICAL SECTION */
+
+    if (task_status == AWS_TASK_STATUS_RUN_READY) {
+        /* Nothing else may wake up the client if the straggler is the last part in flight */
+        aws_s3_client_schedule_process_work(meta_request->client);
+    }
+    aws_s3_meta_request_release(meta_request);
+}
+
+static void s_schedule_hedge_check_synced(struct aws_s3_meta_request *meta_request, uint64_t delay_ns) {
+    ASSERT_SYNCED_DATA_LOCK_HELD(meta_request);
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+
+    if (auto_ranged_get->synced_data.hedge_check_scheduled) {
+        return;
+    }
+    auto_ranged_get->synced_data.hedge_check_scheduled = true;
+
+    uint64_t now_ns = 0;
+    aws_event_loop_current_clock_time(meta_request->io_event_loop, &now_ns);
+    aws_s3_meta_request_acquire(meta_request);
+    aws_event_loop_schedule_task_future(
+        meta_request->io_event_loop, &auto_ranged_get->hedge_check_task, aws_add_u64_saturating(now_ns, delay_ns));
+}
+
+/* Create a duplicate request for the part that has been in flight the longest, if it's much slower than the recently
+ * finished parts and the hedge budget allows. Returns NULL if no part needs one yet. */
+static struct aws_s3_request *s_s3_auto_ranged_get_hedge_new_synced(struct aws_s3_meta_request *meta_request) {
+    ASSERT_SYNCED_DATA_LOCK_HELD(meta_request);
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+    const struct aws_s3_get_hedge_options *hedge_options = &meta_request->client->get_hedge_options;
+
+    uint32_t max_hedges =
+        (uint32_t)(((uint64_t)auto_ranged_get->synced_data.total_num_parts * hedge_options->budget_percent + 99) / 100);
+    if (auto_ranged_get->synced_data.num_hedges_requested >= max_hedges ||
+        auto_ranged_get->synced_data.num_part_durations < s_hedge_min_part_durations) {
+        return NULL;
+    }
+
+    /* Parts whose headers are needed, or that are received into caller's memory, aren't hedged */
+    struct aws_s3_request *oldest_request = NULL;
+    uint64_t oldest_start_ns = 0;
+    for (struct aws_linked_list_node *node =
+             aws_linked_list_begin(&meta_request->synced_data.cancellable_http_streams_list);
+         node != aws_linked_list_end(&meta_request->synced_data.cancellable_http_streams_list);
+         node = aws_linked_list_next(node)) {
+
+        struct aws_s3_request *in_flight =
+            AWS_CONTAINER_OF(node, struct aws_s3_request, cancellable_http_streams_list_node);
+        if (in_flight->request_tag != AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE ||
+            in_flight->discovers_object_size || in_flight->record_response_headers ||
+            in_flight->has_caller_response_body || s_find_hedged_part_synced(auto_ranged_get, in_flight, NULL)) {
+            continue;
+        }
+
+        uint64_t start_ns = in_flight->send_data.metrics->time_metrics.start_timestamp_ns;
+        if (oldest_request == NULL || start_ns < oldest_start_ns) {
+            oldest_request = in_flight;
+            oldest_start_ns = start_ns;
+        }
+    }
+
+    if (oldest_request == NULL) {
+        return NULL;
+    }
+
+    uint64_t now_ns = 0;
+    aws_high_res_clock_get_ticks(&now_ns);
+    uint64_t deadline_ns = aws_add_u64_saturating(
+        oldest_start_ns, s_hedge_threshold_ns_synced(auto_ranged_get, hedge_options->percentile));
+    if (now_ns <= deadline_ns) {
+        s_schedule_hedge_check_synced(meta_request, deadline_ns - now_ns + 1);
+        return NULL;
+    }
+
+    struct aws_s3_buffer_pool_ticket *ticket =
+        aws_s3_meta_request_reserve_ticket_synced(meta_request, meta_request->part_size);
+    if (ticket == NULL) {
+        return NULL;
+    }
+
+    struct aws_s3_request *hedge = aws_s3_request_new(
+        meta_request,
+        AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE,
+        AWS_S3_REQUEST_TYPE_GET_OBJECT,
+        oldest_request->part_number,
+        AWS_S3_REQUEST_FLAG_PART_SIZE_RESPONSE_BODY);
+    hedge->ticket = ticket;
+    hedge->part_range_start = oldest_request->part_range_start;
+    hedge->part_range_end = oldest_request->part_range_end;
+
+    struct aws_s3_hedged_part hedged_part = {
+        .original = aws_s3_request_acquire(oldest_request),
+        .hedge = aws_s3_request_acquire(hedge),
+    };
+    aws_array_list_push_back(&auto_ranged_get->synced_data.hedged_parts, &hedged_part);
+    ++auto_ranged_get->synced_data.num_hedges_requested;
+
+    AWS_LOGF_INFO(
+        AWS_LS_S3_META_REQUEST,
+        "id=%p: Part %" PRIu32 " has been in flight for %" PRIu64 "ms, sending a duplicate request %p",
+        (void *)meta_request,
+        oldest_request->part_number,
+        aws_timestamp_convert(now_ns - oldest_start_ns, AWS_TIMESTAMP_NANOS, AWS_TIMESTAMP_MILLIS, NULL),
+        (void *)hedge);
+    return hedge;
+}
+
+/* True if the request is for a hedged part that the other request already stood in for */
+static bool s_is_hedged_part_resolved(struct aws_s3_meta_request *meta_request, struct aws_s3_request *request) {
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+
+    /* BEGIN CRITICAL SECTION */
+    aws_s3_meta_request_lock_synced_data(meta_request);
+    struct aws_s3_hedged_part *hedged_part = s_find_hedged_part_synced(auto_ranged_get, request, NULL);
+    bool resolved = hedged_part != NULL && hedged_part->resolved;
+    aws_s3_meta_request_unlock_synced_data(meta_request);
+    /* END CRITICAL SECTION */
+
+    return resolved;
+}
+
+/* Of a hedged part's two requests, the first one to succeed (or the last one to fail) stands in for the part, and
+ * the other one is cancelled. Returns true if this request is dropped. */
+static bool s_drop_hedged_request(
+    struct aws_s3_meta_request *meta_request,
+    struct aws_s3_request *request,
+    int error_code) {
+
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+    bool dropped = false;
+    struct aws_s3_hedged_part finished_part;
+    AWS_ZERO_STRUCT(finished_part);
+
+    /* BEGIN CRITICAL SECTION */
+    aws_s3_meta_request_lock_synced_data(meta_request);
+    size_t index = 0;
+    struct aws_s3_hedged_part *hedged_part = s_find_hedged_part_synced(auto_ranged_get, request, &index);
+    if (hedged_part != NULL) {
+        bool is_hedge = hedged_part->hedge == request;
+        struct aws_s3_request *other = is_hedge ? hedged_part->original : hedged_part->hedge;
+
+        if (hedged_part->resolved) {
+            dropped = true;
+            --auto_ranged_get->synced_data.num_hedge_losers_in_flight;
+        } else if (error_code == AWS_ERROR_SUCCESS || hedged_part->num_finished > 0) {
+            hedged_part->resolved = true;
+            if (hedged_part->num_finished == 0) {
+                /* This request is counted as the part. The other one is dropped once it finishes. */
+                ++auto_ranged_get->synced_data.num_hedge_losers_in_flight;
+            }
+            if (other->synced_data.cancellable_http_stream != NULL) {
+                aws_linked_list_remove(&other->cancellable_http_streams_list_node);
+                aws_http_stream_cancel(
+                    other->synced_data.cancellable_http_stream, AWS_ERROR_S3_INTERNAL_HEDGED_REQUEST_LOST);
+                other->synced_data.cancellable_http_stream = NULL;
+            }
+            AWS_LOGF_DEBUG(
+                AWS_LS_S3_META_REQUEST,
+                "id=%p: Part %" PRIu32 " finished first with its %s request",
+                (void *)meta_request,
+                request->part_number,
+                is_hedge ? "duplicate" : "original");
+        } else {
+            /* The other request may still succeed */
+            dropped = true;
+        }
+
+        if (++hedged_part->num_finished == 2) {
+            finished_part = *hedged_part;
+            aws_array_list_erase(&auto_ranged_get->synced_data.hedged_parts, index);
+        }
+        if (dropped) {
+            aws_s3_request_finish_up_metrics_synced(request, meta_request);
+        }
+    }
+    aws_s3_meta_request_unlock_synced_data(meta_request);
+    /* END CRITICAL SECTION */
+
+    if (finished_part.original != NULL) {
+        aws_s3_request_release(finished_part.original);
+        aws_s3_request_release(finished_part.hedge);
+    }
+    return dropped;
+}
+
+/* Range of a part of the known object range, including the parts the tail of the range was split into. */
+static void s_get_part_range_synced(
+    struct aws_s3_meta_request *meta_request,
+    uint32_t part_number,
+    uint64_t *out_part_range_start,
+    uint64_t *out_part_range_end) {
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+
+    if (auto_ranged_get->synced_data.tail_first_part_number == 0 ||
+        part_number < auto_ranged_get->synced_data.tail_first_part_number) {
+        aws_s3_calculate_auto_ranged_get_part_range(
+            auto_ranged_get->synced_data.object_range_start,
+            auto_ranged_get->synced_data.object_range_end,
+            meta_request->part_size,
+            auto_ranged_get->synced_data.first_part_size,
+            part_number,
+            out_part_range_start,
+            out_part_range_end);
+        return;
+    }
+
+    uint32_t tail_part_index = part_number - auto_ranged_get->synced_data.tail_first_part_number;
+    *out_part_range_start = auto_ranged_get->synced_data.tail_range_start +
+                            (uint64_t)tail_part_index * auto_ranged_get->synced_data.tail_part_size;
+    *out_part_range_end = aws_min_u64(
+        *out_part_range_start + auto_ranged_get->synced_data.tail_part_size - 1, /* range-end is inclusive */
+        auto_ranged_get->synced_data.object_range_end);
+}
+
+/* Once the rest of the object range is less than a part for each connection, split it evenly across the connections
+ * in smaller parts, so that they all share the tail of the download. Part numbers stay contiguous, so the body is
+ * still delivered in order. Only parts not requested yet are split, straggling parts in flight are hedged instead. */
+static void s_split_tail_parts_synced(struct aws_s3_meta_request *meta_request) {
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+    uint64_t min_part_size = meta_request->client->get_tail_min_part_size;
+
+    if (min_part_size == 0 || min_part_size >= meta_request->part_size ||
+        auto_ranged_get->synced_data.tail_first_part_number != 0) {
+        return;
+    }
+
+    uint32_t next_part_number = auto_ranged_get->synced_data.num_parts_requested + 1;
+    uint64_t next_part_range_start = 0;
+    uint64_t next_part_range_end = 0;
+    s_get_part_range_synced(meta_request, next_part_number, &next_part_range_start, &next_part_range_end);
+
+    uint64_t bytes_left = auto_ranged_get->synced_data.object_range_end - next_part_range_start + 1;
+    uint64_t num_connections =
+        aws_max_u32(aws_s3_client_get_max_active_connections(meta_request->client, meta_request), 1);
+    if (bytes_left >= num_connections * meta_request->part_size) {
+        return;
+    }
+
+    uint64_t tail_part_size = aws_max_u64((bytes_left + num_connections - 1) / num_connections, min_part_size);
+    if (tail_part_size >= meta_request->part_size) {
+        return;
+    }
+
+    auto_ranged_get->synced_data.tail_first_part_number = next_part_number;
+    auto_ranged_get->synced_data.tail_range_start = next_part_range_start;
+    auto_ranged_get->synced_data.tail_part_size = tail_part_size;
+    auto_ranged_get->synced_data.total_num_parts = auto_ranged_get->synced_data.num_parts_requested +
+                                                   (uint32_t)((bytes_left + tail_part_size - 1) / tail_part_size);
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_S3_META_REQUEST,
+        "id=%p: Splitting the last %" PRIu64 " bytes into parts of %" PRIu64 " bytes, for %" PRIu32 " parts in total",
+        (void *)meta_request,
+        bytes_left,
+        tail_part_size,
+        auto_ranged_get->synced_data.total_num_parts);
+}
+
 static bool s_s3_auto_ranged_get_update(
     struct aws_s3_meta_request *meta_request,
     uint32_t flags,
@@ -221,8 +865,16 @@ static bool s_s3_auto_ranged_get_update(
             /* If the overall range of the object that we are trying to retrieve isn't known yet, then we need to send a
              * request to figure that out. */
             if (!auto_ranged_get->synced_data.object_range_known) {
-                if (auto_ranged_get->synced_data.head_object_sent ||
-                    auto_ranged_get->synced_data.num_parts_requested > 0) {
+                if (auto_ranged_get->synced_data.head_object_sent) {
+                    goto has_work_remaining;
+                }
+                if (auto_ranged_get->synced_data.num_parts_requested >
+                    auto_ranged_get->synced_data.num_speculative_parts) {
+                    /* Part 1 is discovering the object range, request the parts after it in the meantime */
+                    if (auto_ranged_get->synced_data.num_speculative_parts <
+                        auto_ranged_get->synced_data.max_speculative_parts) {
+                        request = s_s3_auto_ranged_get_speculative_part_new_synced(meta_request);
+                    }
                     goto has_work_remaining;
                 }
                 struct aws_s3_buffer_pool_ticket *ticket = NULL;
@@ -246,7 +898,7 @@ static bool s_s3_auto_ranged_get_update(
                             "id=%p: Doing a 'GET_OBJECT_WITH_PART_NUMBER_1' to discover the size of the object and get "
                             "the first part",
                             (void *)meta_request);
-                        ticket = aws_s3_buffer_pool_reserve(meta_request->client->buffer_pool, meta_request->part_size);
+                        ticket = aws_s3_meta_request_reserve_ticket_synced(meta_request, meta_request->part_size);
 
                         if (ticket == NULL) {
                             goto has_work_remaining;
@@ -298,8 +950,8 @@ static bool s_s3_auto_ranged_get_update(
                              * even if expect to receive less data. Pool will
                              * reserve the whole part size for it anyways, so no
                              * reason getting a smaller chunk. */
-                            ticket = aws_s3_buffer_pool_reserve(
-                                meta_request->client->buffer_pool, (size_t)meta_request->part_size);
+                            ticket = aws_s3_meta_request_reserve_ticket_synced(
+                                meta_request, (size_t)meta_request->part_size);
 
                             if (ticket == NULL) {
                                 goto has_work_remaining;
@@ -328,10 +980,20 @@ static bool s_s3_auto_ranged_get_update(
                 goto has_work_remaining;
             }
 
+            /* Duplicate a part much slower than the others, it may hold back the delivery of all the parts after it */
+            if (s_hedges_parts(meta_request)) {
+                request = s_s3_auto_ranged_get_hedge_new_synced(meta_request);
+                if (request != NULL) {
+                    goto has_work_remaining;
+                }
+            }
+
             /* If there are still more parts to be requested */
             if (auto_ranged_get->synced_data.num_parts_requested < auto_ranged_get->synced_data.total_num_parts) {
+                s_split_tail_parts_synced(meta_request);
 
-                if (meta_request->client->enable_read_backpressure) {
+                /* The read window only applies to data delivered through the body_callback */
+                if (meta_request->client->enable_read_backpressure && !s_delivers_body_out_of_order(meta_request)) {
                     /* Don't start a part until we have enough window to send bytes to the user.
                      *
                      * Note that we start a part once we have enough window to deliver ANY of its bytes.
@@ -341,6 +1003,20 @@ static bool s_s3_auto_ranged_get_update(
                      * and this implementation is waiting for more window before it will send more parts. */
                     uint64_t read_data_requested =
                         auto_ranged_get->synced_data.num_parts_requested * meta_request->part_size;
+                    if (auto_ranged_get->synced_data.tail_first_part_number != 0 &&
+                        auto_ranged_get->synced_data.num_parts_requested >=
+                            auto_ranged_get->synced_data.tail_first_part_number) {
+                        /* Parts past the split are smaller */
+                        uint64_t last_part_range_start = 0;
+                        uint64_t last_part_range_end = 0;
+                        s_get_part_range_synced(
+                            meta_request,
+                            auto_ranged_get->synced_data.num_parts_requested,
+                            &last_part_range_start,
+                            &last_part_range_end);
+                        read_data_requested =
+                            last_part_range_end + 1 - auto_ranged_get->synced_data.object_range_start;
+                    }
                     if (read_data_requested >= meta_request->synced_data.read_window_running_total) {
 
                         /* Avoid spamming users with this DEBUG message */
@@ -360,11 +1036,27 @@ static bool s_s3_auto_ranged_get_update(
                     auto_ranged_get->synced_data.read_window_warning_issued = 0;
                 }
 
-                struct aws_s3_buffer_pool_ticket *ticket =
-                    aws_s3_buffer_pool_reserve(meta_request->client->buffer_pool, meta_request->part_size);
+                /* Once the range is known, parts can go straight into caller's memory, without a buffer from the
+                 * pool. Parts discovering the range are received into the pool and copied over. */
+                struct aws_s3_buffer_pool_ticket *ticket = NULL;
+                uint32_t request_flags = AWS_S3_REQUEST_FLAG_PART_SIZE_RESPONSE_BODY;
+                if (auto_ranged_get->object_range_from_cache &&
+                    auto_ranged_get->synced_data.num_parts_requested == 0) {
+                    /* Part 1 checks the cached ETag, and its headers go to the headers_callback */
+                    request_flags |= AWS_S3_REQUEST_FLAG_RECORD_RESPONSE_HEADERS;
+                }
+                if (auto_ranged_get->etag != NULL || auto_ranged_get->initial_message_has_if_match_header) {
+                    /* If-Match makes sure a retry resumes the same object the part started to get */
+                    request_flags |= AWS_S3_REQUEST_FLAG_RESUMABLE_RESPONSE_BODY;
+                }
+                if (meta_request->receive_buffer_callback != NULL) {
+                    request_flags |= AWS_S3_REQUEST_FLAG_CALLER_RESPONSE_BODY;
+                } else {
+                    ticket = aws_s3_meta_request_reserve_ticket_synced(meta_request, meta_request->part_size);
 
-                if (ticket == NULL) {
-                    goto has_work_remaining;
+                    if (ticket == NULL) {
+                        goto has_work_remaining;
+                    }
                 }
 
                 request = aws_s3_request_new(
@@ -372,18 +1064,12 @@ static bool s_s3_auto_ranged_get_update(
                     AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE,
                     AWS_S3_REQUEST_TYPE_GET_OBJECT,
                     auto_ranged_get->synced_data.num_parts_requested + 1 /*part_number*/,
-                    AWS_S3_REQUEST_FLAG_PART_SIZE_RESPONSE_BODY);
+                    request_flags);
 
                 request->ticket = ticket;
 
-                aws_s3_calculate_auto_ranged_get_part_range(
-                    auto_ranged_get->synced_data.object_range_start,
-                    auto_ranged_get->synced_data.object_range_end,
-                    meta_request->part_size,
-                    auto_ranged_get->synced_data.first_part_size,
-                    request->part_number,
-                    &request->part_range_start,
-                    &request->part_range_end);
+                s_get_part_range_synced(
+                    meta_request, request->part_number, &request->part_range_start, &request->part_range_end);
 
                 ++auto_ranged_get->synced_data.num_parts_requested;
                 goto has_work_remaining;
@@ -394,6 +1080,12 @@ static bool s_s3_auto_ranged_get_update(
             if (meta_request->synced_data.num_parts_delivery_completed < auto_ranged_get->synced_data.total_num_parts) {
                 goto has_work_remaining;
             }
+
+            /* Speculative parts past the end of the object, or cancelled hedged requests, may still be in flight */
+            if (auto_ranged_get->synced_data.num_parts_completed < auto_ranged_get->synced_data.num_parts_requested ||
+                auto_ranged_get->synced_data.num_hedge_losers_in_flight > 0) {
+                goto has_work_remaining;
+            }
         } else {
             /* Else, if there is a finish result set, make sure that all work-in-progress winds down before the meta
              * request completely exits. */
@@ -403,7 +1095,8 @@ static bool s_s3_auto_ranged_get_update(
             }
 
             /* Wait for all requests to complete (successfully or unsuccessfully) before finishing.*/
-            if (auto_ranged_get->synced_data.num_parts_completed < auto_ranged_get->synced_data.num_parts_requested) {
+            if (auto_ranged_get->synced_data.num_parts_completed < auto_ranged_get->synced_data.num_parts_requested ||
+                auto_ranged_get->synced_data.num_hedge_losers_in_flight > 0) {
                 goto has_work_remaining;
             }
 
@@ -460,8 +1153,17 @@ static bool s_s3_auto_ranged_get_update(
     return work_remaining;
 }
 
+/* Reading a part from the block cache while preparing its request */
+struct s3_auto_ranged_get_block_cache_read {
+    struct aws_s3_request *request;
+    struct aws_future_bool *hit_future;
+    struct aws_future_void *prepare_future;
+};
+
+static void s_s3_auto_ranged_get_on_block_cache_read_done(void *user_data);
+
 /* Given a request, prepare it for sending based on its description.
- * Currently, this is actually synchronous. */
+ * This is synchronous, unless the part is read back from the block cache's disk. */
 static struct aws_future_void *s_s3_auto_ranged_get_prepare_request(struct aws_s3_request *request) {
     AWS_PRECONDITION(request);
     struct aws_s3_meta_request *meta_request = request->meta_request;
@@ -471,6 +1173,7 @@ static struct aws_future_void *s_s3_auto_ranged_get_prepare_request(struct aws_s
     struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
 
     bool success = false;
+    struct aws_future_bool *block_cache_read = NULL;
 
     switch (request->request_tag) {
         case AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_HEAD_OBJECT:
@@ -481,13 +1184,23 @@ static struct aws_future_void *s_s3_auto_ranged_get_prepare_request(struct aws_s
                 aws_http_message_set_request_method(message, g_head_method);
             }
             break;
-        case AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE:
+        case AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE: {
+            uint64_t range_start = request->part_range_start;
+            if (request->resumes_response_body) {
+                /* Previous attempts got the start of the part */
+                range_start += request->send_data.response_body.len;
+                AWS_LOGF_DEBUG(
+                    AWS_LS_S3_META_REQUEST,
+                    "id=%p: Resuming part %d of request %p at byte %" PRIu64,
+                    (void *)meta_request,
+                    request->part_number,
+                    (void *)request,
+                    range_start);
+            }
             message = aws_s3_ranged_get_object_message_new(
-                meta_request->allocator,
-                meta_request->initial_request_message,
-                request->part_range_start,
-                request->part_range_end);
+                meta_request->allocator, meta_request->initial_request_message, range_start, request->part_range_end);
             break;
+        }
         case AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_PART_NUMBER_1:
             message = aws_s3_message_util_copy_http_message_no_body_all_headers(
                 meta_request->allocator, meta_request->initial_request_message);
@@ -509,7 +1222,8 @@ static struct aws_future_void *s_s3_auto_ranged_get_prepare_request(struct aws_s
     if (meta_request->checksum_config.validate_response_checksum) {
         aws_http_headers_set(aws_http_message_get_headers(message), g_request_validation_mode, g_enabled);
     }
-    if (!auto_ranged_get->initial_message_has_if_match_header && auto_ranged_get->etag) {
+    /* Speculative parts may be sent before the ETag is known, their ETag is checked once they finish instead */
+    if (!auto_ranged_get->initial_message_has_if_match_header && !request->is_speculative && auto_ranged_get->etag) {
         /* Add the if_match to the request */
         AWS_LOGF_DEBUG(
             AWS_LS_S3_META_REQUEST,
@@ -526,6 +1240,13 @@ static struct aws_future_void *s_s3_auto_ranged_get_prepare_request(struct aws_s
     aws_s3_request_setup_send_data(request, message);
     aws_http_message_release(message);
 
+    if (s_hedges_parts(meta_request) && s_is_hedged_part_resolved(meta_request, request)) {
+        /* The other request of this part finished first, this one doesn't need to be sent */
+        request->is_noop = true;
+    } else if (request->num_times_prepared == 0) {
+        block_cache_read = s_read_from_block_cache(meta_request, request);
+    }
+
     /* Success! */
     AWS_LOGF_DEBUG(
         AWS_LS_S3_META_REQUEST,
@@ -539,7 +1260,15 @@ static struct aws_future_void *s_s3_auto_ranged_get_prepare_request(struct aws_s
 
 finish:;
     struct aws_future_void *future = aws_future_void_new(meta_request->allocator);
-    if (success) {
+    if (block_cache_read != NULL) {
+        /* Completes on the file I/O ELG if the part has to be read back from disk */
+        struct s3_auto_ranged_get_block_cache_read *read_job =
+            aws_mem_calloc(meta_request->allocator, 1, sizeof(struct s3_auto_ranged_get_block_cache_read));
+        read_job->request = request;
+        read_job->hit_future = block_cache_read;
+        read_job->prepare_future = aws_future_void_acquire(future);
+        aws_future_bool_register_callback(block_cache_read, s_s3_auto_ranged_get_on_block_cache_read_done, read_job);
+    } else if (success) {
         aws_future_void_set_result(future);
     } else {
         aws_future_void_set_error(future, aws_last_error_or_unknown());
@@ -547,6 +1276,31 @@ finish:;
     return future;
 }
 
+/* Completion callback for reading a part from the block cache */
+static void s_s3_auto_ranged_get_on_block_cache_read_done(void *user_data) {
+    struct s3_auto_ranged_get_block_cache_read *read_job = user_data;
+    struct aws_s3_request *request = read_job->request;
+    struct aws_s3_meta_request *meta_request = request->meta_request;
+
+    if (s_finish_read_from_block_cache(meta_request, request, aws_future_bool_get_result(read_job->hit_future))) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_S3_META_REQUEST,
+            "id=%p: Part %d of request %p served from block cache",
+            (void *)meta_request,
+            request->part_number,
+            (void *)request);
+        request->is_noop = true;
+    }
+
+    /* Completing the future may finish the request, so nothing of it is touched after */
+    struct aws_future_void *prepare_future = read_job->prepare_future;
+    aws_future_bool_release(read_job->hit_future);
+    aws_mem_release(meta_request->allocator, read_job);
+
+    aws_future_void_set_result(prepare_future);
+    aws_future_void_release(prepare_future);
+}
+
 /* Check the finish result of meta request.
  * Return true if the request failed because it downloaded an empty file.
  * Return false if the request failed for any other reason */
@@ -749,6 +1503,160 @@ static int s_discover_object_range_and_size(
     return result;
 }
 
+/* Send the response headers of the request that found the object range to the headers_callback, with
+ * Content-Length (and Content-Range, if the user asked for a range) describing the whole range being downloaded. */
+static int s_deliver_response_headers(
+    struct aws_s3_meta_request *meta_request,
+    struct aws_s3_request *request,
+    uint64_t object_range_start,
+    uint64_t object_range_end,
+    uint64_t object_size) {
+
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+    struct aws_http_headers *response_headers = aws_http_headers_new(meta_request->allocator);
+
+    copy_http_headers(request->send_data.response_headers, response_headers);
+
+    if (request->request_tag == AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE ||
+        request->request_tag == AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_PART_NUMBER_1) {
+
+        if (auto_ranged_get->initial_message_has_range_header) {
+            /* Populate the header with object_range */
+            char content_range_buffer[64] = "";
+            snprintf(
+                content_range_buffer,
+                sizeof(content_range_buffer),
+                "bytes %" PRIu64 "-%" PRIu64 "/%" PRIu64,
+                object_range_start,
+                object_range_end,
+                object_size);
+            aws_http_headers_set(
+                response_headers, g_content_range_header_name, aws_byte_cursor_from_c_str(content_range_buffer));
+        } else {
+            /* content range isn't applicable. */
+            aws_http_headers_erase(response_headers, g_content_range_header_name);
+        }
+    }
+
+    uint64_t content_length = object_size ? object_range_end - object_range_start + 1 : 0;
+    char content_length_buffer[64] = "";
+    snprintf(content_length_buffer, sizeof(content_length_buffer), "%" PRIu64, content_length);
+    aws_http_headers_set(
+        response_headers, g_content_length_header_name, aws_byte_cursor_from_c_str(content_length_buffer));
+
+    int result = AWS_OP_SUCCESS;
+    if (meta_request->headers_callback(
+            meta_request,
+            response_headers,
+            s_s3_auto_ranged_get_success_status(meta_request),
+            meta_request->user_data)) {
+
+        result = AWS_OP_ERR;
+    }
+    meta_request->headers_callback = NULL;
+
+    aws_http_headers_release(response_headers);
+    return result;
+}
+
+/* Check that the speculative parts got the same object as the request discovering the object range: same ETag, and
+ * only parts past the end of the object got a 416. Called when a speculative part finishes, and when the object range
+ * is found. Returns the error code to fail the meta request with, or AWS_ERROR_SUCCESS. */
+static int s_check_speculative_parts_synced(
+    struct aws_s3_meta_request *meta_request,
+    struct aws_s3_request *request,
+    bool past_object_end) {
+    ASSERT_SYNCED_DATA_LOCK_HELD(meta_request);
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+
+    if (past_object_end) {
+        if (auto_ranged_get->synced_data.first_speculative_part_past_end == 0 ||
+            request->part_number < auto_ranged_get->synced_data.first_speculative_part_past_end) {
+            auto_ranged_get->synced_data.first_speculative_part_past_end = request->part_number;
+        }
+    } else if (request->is_speculative) {
+        struct aws_byte_cursor etag_header_value;
+        if (aws_http_headers_get(request->send_data.response_headers, g_etag_header_name, &etag_header_value)) {
+            return AWS_ERROR_S3_MISSING_ETAG;
+        }
+        if (auto_ranged_get->synced_data.speculative_etag == NULL) {
+            auto_ranged_get->synced_data.speculative_etag =
+                aws_string_new_from_cursor(meta_request->allocator, &etag_header_value);
+        } else if (!aws_string_eq_byte_cursor(auto_ranged_get->synced_data.speculative_etag, &etag_header_value)) {
+            goto object_modified;
+        }
+    }
+
+    if (!auto_ranged_get->synced_data.object_range_known) {
+        /* Checked again once the object range is found */
+        return AWS_ERROR_SUCCESS;
+    }
+
+    /* The ETag is set before the object range is recorded. It's NULL if the user's If-Match applies to all parts. */
+    if (auto_ranged_get->synced_data.speculative_etag != NULL && auto_ranged_get->etag != NULL &&
+        !aws_string_eq(auto_ranged_get->synced_data.speculative_etag, auto_ranged_get->etag)) {
+        goto object_modified;
+    }
+
+    /* Speculative parts are sized from part_size, so compare with the number of parts before the tail was split */
+    if (auto_ranged_get->synced_data.first_speculative_part_past_end != 0 &&
+        auto_ranged_get->synced_data.first_speculative_part_past_end <=
+            aws_s3_calculate_auto_ranged_get_num_parts(
+                meta_request->part_size,
+                auto_ranged_get->synced_data.first_part_size,
+                auto_ranged_get->synced_data.object_range_start,
+                auto_ranged_get->synced_data.object_range_end)) {
+        goto object_modified;
+    }
+
+    return AWS_ERROR_SUCCESS;
+
+object_modified:
+    AWS_LOGF_ERROR(
+        AWS_LS_S3_META_REQUEST,
+        "id=%p Parts requested before the object size was known got a different object, it was modified",
+        (void *)meta_request);
+    return AWS_ERROR_S3_OBJECT_MODIFIED;
+}
+
+/* What's left to do once a part finished, carried over to the file I/O ELG when the part goes to the recv_file */
+struct s3_auto_ranged_get_part_finish {
+    struct aws_task task;
+    struct aws_s3_request *request;
+    int error_code;
+    uint64_t object_range_start;
+    uint64_t object_range_end;
+    uint64_t object_size;
+    uint64_t first_part_size;
+    bool found_object_size;
+    bool request_failed;
+    bool first_part_size_mismatch;
+    bool empty_file_error;
+    bool past_object_end;
+    bool preallocate_recv_file;
+    bool write_to_recv_file;
+};
+
+static void s_s3_auto_ranged_get_finish_part(
+    struct aws_s3_meta_request *meta_request,
+    const struct s3_auto_ranged_get_part_finish *part_finish);
+
+static void s_s3_auto_ranged_get_finish_part_task(struct aws_task *task, void *arg, enum aws_task_status task_status) {
+    (void)task;
+    (void)task_status;
+    struct s3_auto_ranged_get_part_finish *part_finish = arg;
+    struct aws_s3_request *request = part_finish->request;
+    struct aws_s3_meta_request *meta_request = request->meta_request;
+
+    /* Runs even if the ELG is shutting down, the meta request can't finish without its parts */
+    s_s3_auto_ranged_get_finish_part(meta_request, part_finish);
+
+    /* Client already looked at the meta request when the part finished, before its result was recorded */
+    aws_s3_client_schedule_process_work(meta_request->client);
+    aws_s3_request_release(request);
+    aws_mem_release(meta_request->allocator, part_finish);
+}
+
 static void s_s3_auto_ranged_get_request_finished(
     struct aws_s3_meta_request *meta_request,
     struct aws_s3_request *request,
@@ -760,6 +1668,10 @@ static void s_s3_auto_ranged_get_request_finished(
     struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
     AWS_PRECONDITION(auto_ranged_get);
 
+    if (s_hedges_parts(meta_request) && s_drop_hedged_request(meta_request, request, error_code)) {
+        return;
+    }
+
     uint64_t object_range_start = 0ULL;
     uint64_t object_range_end = 0ULL;
     uint64_t object_size = 0ULL;
@@ -770,6 +1682,17 @@ static void s_s3_auto_ranged_get_request_finished(
     bool first_part_size_mismatch = (error_code == AWS_ERROR_S3_INTERNAL_PART_SIZE_MISMATCH_RETRYING_WITH_RANGE);
     bool empty_file_error = false;
 
+    struct s3_auto_ranged_get_part_finish part_finish;
+    AWS_ZERO_STRUCT(part_finish);
+
+    /* A speculative part turning out to be past the end of the object is expected, it's dropped */
+    bool past_object_end =
+        request->is_speculative && request_failed &&
+        request->send_data.response_status == AWS_HTTP_STATUS_CODE_416_REQUESTED_RANGE_NOT_SATISFIABLE;
+    if (past_object_end) {
+        error_code = AWS_ERROR_SUCCESS;
+    }
+
     if (request->discovers_object_size) {
         /* Try to discover the object-range and object-size.*/
         if (s_discover_object_range_and_size(
@@ -809,56 +1732,167 @@ static void s_s3_auto_ranged_get_request_finished(
         error_code = AWS_ERROR_SUCCESS;
         found_object_size = true;
 
-        if (!empty_file_error && meta_request->headers_callback != NULL) {
-            struct aws_http_headers *response_headers = aws_http_headers_new(meta_request->allocator);
-
-            copy_http_headers(request->send_data.response_headers, response_headers);
-
-            if (request->request_tag == AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_RANGE ||
-                request->request_tag == AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_GET_OBJECT_WITH_PART_NUMBER_1) {
-
-                if (auto_ranged_get->initial_message_has_range_header) {
-                    /* Populate the header with object_range */
-                    char content_range_buffer[64] = "";
-                    snprintf(
-                        content_range_buffer,
-                        sizeof(content_range_buffer),
-                        "bytes %" PRIu64 "-%" PRIu64 "/%" PRIu64,
-                        object_range_start,
-                        object_range_end,
-                        object_size);
-                    aws_http_headers_set(
-                        response_headers,
-                        g_content_range_header_name,
-                        aws_byte_cursor_from_c_str(content_range_buffer));
-                } else {
-                    /* content range isn't applicable. */
-                    aws_http_headers_erase(response_headers, g_content_range_header_name);
-                }
+        if (meta_request->client->object_metadata_cache != NULL && !empty_file_error && object_size > 0) {
+            struct aws_byte_cursor etag_header_value;
+            if (!aws_http_headers_get(request->send_data.response_headers, g_etag_header_name, &etag_header_value)) {
+                aws_s3_object_metadata_cache_put(
+                    meta_request->client->object_metadata_cache,
+                    meta_request->initial_request_message,
+                    object_size,
+                    etag_header_value);
             }
+        }
 
-            uint64_t content_length = object_size ? object_range_end - object_range_start + 1 : 0;
-            char content_length_buffer[64] = "";
-            snprintf(content_length_buffer, sizeof(content_length_buffer), "%" PRIu64, content_length);
-            aws_http_headers_set(
-                response_headers, g_content_length_header_name, aws_byte_cursor_from_c_str(content_length_buffer));
+        if (!empty_file_error && meta_request->headers_callback != NULL) {
+            if (s_deliver_response_headers(meta_request, request, object_range_start, object_range_end, object_size)) {
+                error_code = aws_last_error_or_unknown();
+            }
+        }
+    } else if (auto_ranged_get->object_range_from_cache && request->part_number == 1 && !request_failed) {
+        /* Part 1 stands in for the discovery request when the object range came from the object metadata cache */
+        uint64_t response_object_size = 0;
+        struct aws_byte_cursor etag_header_value;
+        if (aws_http_headers_get(request->send_data.response_headers, g_etag_header_name, &etag_header_value) ||
+            !aws_string_eq_byte_cursor(auto_ranged_get->etag, &etag_header_value) ||
+            aws_s3_parse_content_range_response_header(
+                meta_request->allocator, request->send_data.response_headers, NULL, NULL, &response_object_size) ||
+            response_object_size != auto_ranged_get->cached_object_size) {
+
+            /* If-Match should have caught this, but the object doesn't match what was cached either way */
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_META_REQUEST,
+                "id=%p Object doesn't match its cached ETag and size, it was modified",
+                (void *)meta_request);
+            aws_s3_object_metadata_cache_remove(
+                meta_request->client->object_metadata_cache,
+                meta_request->initial_request_message,
+                aws_byte_cursor_from_string(auto_ranged_get->etag));
+            error_code = AWS_ERROR_S3_OBJECT_MODIFIED;
+            goto update_synced_data;
+        }
 
-            if (meta_request->headers_callback(
-                    meta_request,
-                    response_headers,
-                    s_s3_auto_ranged_get_success_status(meta_request),
-                    meta_request->user_data)) {
+        if (meta_request->headers_callback != NULL) {
+            /* BEGIN CRITICAL SECTION */
+            aws_s3_meta_request_lock_synced_data(meta_request);
+            object_range_start = auto_ranged_get->synced_data.object_range_start;
+            object_range_end = auto_ranged_get->synced_data.object_range_end;
+            aws_s3_meta_request_unlock_synced_data(meta_request);
+            /* END CRITICAL SECTION */
 
+            if (s_deliver_response_headers(
+                    meta_request, request, object_range_start, object_range_end, response_object_size)) {
                 error_code = aws_last_error_or_unknown();
             }
-            meta_request->headers_callback = NULL;
+        }
+    }
 
-            aws_http_headers_release(response_headers);
+    if (request_failed && auto_ranged_get->object_range_from_cache &&
+        request->send_data.response_status == AWS_HTTP_STATUS_CODE_412_PRECONDITION_FAILED) {
+        /* Object changed since it was cached, so the next download discovers it again */
+        aws_s3_object_metadata_cache_remove(
+            meta_request->client->object_metadata_cache,
+            meta_request->initial_request_message,
+            aws_byte_cursor_from_string(auto_ranged_get->etag));
+    }
+
+    if (meta_request->receive_buffer_callback != NULL && !request_failed && error_code == AWS_ERROR_SUCCESS &&
+        !empty_file_error && !request->has_caller_response_body &&
+        request->request_tag != AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_HEAD_OBJECT) {
+        /* Body didn't go to caller's memory directly (ex. the part discovering object size), copy it over */
+        if (aws_s3_meta_request_copy_to_receive_buffer(meta_request, request)) {
+            error_code = aws_last_error_or_unknown();
         }
     }
 
+    if (meta_request->recv_file != NULL && error_code == AWS_ERROR_SUCCESS) {
+        /* Reserve space for the whole range once it's known, before any part is written */
+        part_finish.preallocate_recv_file = found_object_size && object_size > 0 && meta_request->recv_file_preallocate;
+        part_finish.write_to_recv_file = !request_failed && !empty_file_error &&
+                                         request->request_tag != AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_HEAD_OBJECT;
+    }
+
 update_synced_data:
 
+    part_finish.request = request;
+    part_finish.error_code = error_code;
+    part_finish.object_range_start = object_range_start;
+    part_finish.object_range_end = object_range_end;
+    part_finish.object_size = object_size;
+    part_finish.first_part_size = first_part_size;
+    part_finish.found_object_size = found_object_size;
+    part_finish.request_failed = request_failed;
+    part_finish.first_part_size_mismatch = first_part_size_mismatch;
+    part_finish.empty_file_error = empty_file_error;
+    part_finish.past_object_end = past_object_end;
+
+    if (part_finish.preallocate_recv_file || part_finish.write_to_recv_file) {
+        /* Don't block the connection's thread on the file, the same way reads of a send_filepath don't */
+        struct aws_event_loop_group *file_io_elg = aws_s3_client_get_file_io_elg(meta_request->client);
+        if (file_io_elg != NULL) {
+            struct s3_auto_ranged_get_part_finish *deferred =
+                aws_mem_calloc(meta_request->allocator, 1, sizeof(struct s3_auto_ranged_get_part_finish));
+            *deferred = part_finish;
+            aws_s3_request_acquire(request);
+            aws_task_init(&deferred->task, s_s3_auto_ranged_get_finish_part_task, deferred, "s3_get_finish_part_task");
+            aws_event_loop_schedule_task_now(aws_event_loop_group_get_next_loop(file_io_elg), &deferred->task);
+            return;
+        }
+    }
+
+    s_s3_auto_ranged_get_finish_part(meta_request, &part_finish);
+}
+
+/* Rest of finishing a part: its file I/O, then recording the result */
+static void s_s3_auto_ranged_get_finish_part(
+    struct aws_s3_meta_request *meta_request,
+    const struct s3_auto_ranged_get_part_finish *part_finish) {
+
+    struct aws_s3_auto_ranged_get *auto_ranged_get = meta_request->impl;
+    struct aws_s3_request *request = part_finish->request;
+    int error_code = part_finish->error_code;
+    uint64_t object_range_start = part_finish->object_range_start;
+    uint64_t object_range_end = part_finish->object_range_end;
+    uint64_t object_size = part_finish->object_size;
+    uint64_t first_part_size = part_finish->first_part_size;
+    bool found_object_size = part_finish->found_object_size;
+    bool request_failed = part_finish->request_failed;
+    bool first_part_size_mismatch = part_finish->first_part_size_mismatch;
+    bool empty_file_error = part_finish->empty_file_error;
+    bool past_object_end = part_finish->past_object_end;
+
+    if (part_finish->preallocate_recv_file) {
+        if (aws_parallel_output_stream_preallocate(
+                meta_request->recv_file, object_range_end - object_range_start + 1)) {
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_META_REQUEST,
+                "id=%p Failed to preallocate recv_file, error %d (%s)",
+                (void *)meta_request,
+                aws_last_error(),
+                aws_error_str(aws_last_error()));
+            error_code = aws_last_error_or_unknown();
+        }
+    }
+
+    if (part_finish->write_to_recv_file && error_code == AWS_ERROR_SUCCESS) {
+        if (s_write_to_recv_file(meta_request, request, found_object_size, object_range_start)) {
+            error_code = aws_last_error_or_unknown();
+        }
+    }
+
+    if (auto_ranged_get->block_cache != NULL && !request_failed && error_code == AWS_ERROR_SUCCESS &&
+        !request->is_noop) {
+        struct aws_byte_buf key;
+        if (s_block_cache_key_init(meta_request, request, &key)) {
+            /* Only queues the spill of blocks this pushes out of memory, their files are written on the ELG */
+            aws_s3_block_cache_put(
+                auto_ranged_get->block_cache,
+                aws_byte_cursor_from_buf(&key),
+                aws_byte_cursor_from_buf(&request->send_data.response_body),
+                aws_s3_client_get_file_io_elg(meta_request->client));
+            aws_byte_buf_clean_up(&key);
+        }
+    }
+
     /* BEGIN CRITICAL SECTION */
     {
         aws_s3_meta_request_lock_synced_data(meta_request);
@@ -883,6 +1917,12 @@ update_synced_data:
             }
         }
 
+        if (error_code == AWS_ERROR_SUCCESS &&
+            (past_object_end || (request->is_speculative && !request_failed) ||
+             (found_object_size && auto_ranged_get->synced_data.num_speculative_parts > 0))) {
+            error_code = s_check_speculative_parts_synced(meta_request, request, past_object_end);
+        }
+
         switch (request->request_tag) {
             case AWS_S3_AUTO_RANGE_GET_REQUEST_TYPE_HEAD_OBJECT:
                 auto_ranged_get->synced_data.head_object_completed = true;
@@ -904,8 +1944,18 @@ update_synced_data:
                      * empty, successful response headers will be provided to users. If not, the newer version of the
                      * file will be downloaded.
                      */
-                    auto_ranged_get->synced_data.num_parts_requested = 0;
+                    auto_ranged_get->synced_data.num_parts_requested =
+                        auto_ranged_get->synced_data.num_speculative_parts;
                     auto_ranged_get->synced_data.object_range_known = 0;
+                    /* Part 1 of the retry may not be a whole part long, as speculative parts assume */
+                    auto_ranged_get->synced_data.max_speculative_parts =
+                        auto_ranged_get->synced_data.num_speculative_parts;
+                    break;
+                }
+
+                if (past_object_end) {
+                    /* Nothing to deliver */
+                    ++auto_ranged_get->synced_data.num_parts_completed;
                     break;
                 }
 
@@ -924,11 +1974,17 @@ update_synced_data:
                     }
                     ++auto_ranged_get->synced_data.num_parts_successful;
 
+                    if (s_hedges_parts(meta_request) && !request->is_noop) {
+                        s_record_part_duration_synced(auto_ranged_get, request);
+                    }
+
                     /* Send progress_callback for delivery on io_event_loop thread */
                     if (meta_request->progress_callback != NULL) {
                         struct aws_s3_meta_request_event event = {.type = AWS_S3_META_REQUEST_EVENT_PROGRESS};
                         event.u.progress.info.bytes_transferred = request->send_data.response_body.len;
-                        if (auto_ranged_get->synced_data.object_range_empty) {
+                        if (auto_ranged_get->synced_data.object_range_empty ||
+                            !auto_ranged_get->synced_data.object_range_known) {
+                            /* Speculative parts may finish before the object range is known */
                             event.u.progress.info.content_length = 0;
                         } else {
                             /* Note that range-end is inclusive */
@@ -938,9 +1994,15 @@ update_synced_data:
                         aws_s3_meta_request_add_event_for_delivery_synced(meta_request, &event);
                     }
 
-                    aws_s3_meta_request_stream_response_body_synced(meta_request, request);
-                    /* The body of the request is queued to be streamed, don't finish the metrics yet. */
-                    finishing_metrics = false;
+                    if (s_delivers_body_out_of_order(meta_request)) {
+                        /* Body is already where the caller wants it, no need to wait for earlier parts */
+                        ++meta_request->synced_data.num_parts_delivery_sent;
+                        ++meta_request->synced_data.num_parts_delivery_completed;
+                    } else {
+                        aws_s3_meta_request_stream_response_body_synced(meta_request, request);
+                        /* The body of the request is queued to be streamed, don't finish the metrics yet. */
+                        finishing_metrics = false;
+                    }
 
                     AWS_LOGF_DEBUG(
                         AWS_LS_S3_META_REQUEST,
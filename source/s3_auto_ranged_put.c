@@ -6,6 +6,7 @@
 #include "aws/s3/private/s3_auto_ranged_put.h"
 #include "aws/s3/private/s3_checksums.h"
 #include "aws/s3/private/s3_list_parts.h"
+#include "aws/s3/private/s3_parallel_input_stream.h"
 #include "aws/s3/private/s3_request_messages.h"
 #include "aws/s3/private/s3_util.h"
 #include <aws/common/clock.h>
@@ -91,6 +92,7 @@ static struct aws_future_http_message *s_s3_prepare_list_parts(struct aws_s3_req
 
 static struct aws_future_http_message *s_s3_prepare_create_multipart_upload(struct aws_s3_request *request);
 
+static bool s_has_mapped_body(const struct aws_s3_meta_request *meta_request);
 static struct aws_future_http_message *s_s3_prepare_upload_part(struct aws_s3_request *request);
 static void s_s3_prepare_upload_part_on_read_done(void *user_data);
 static void s_s3_prepare_upload_part_finish(struct aws_s3_prepare_upload_part_job *part_prep, int error_code);
@@ -549,17 +551,19 @@ static bool s_s3_auto_ranged_put_update(
             if (should_create_next_part_request) {
 
                 struct aws_s3_buffer_pool_ticket *ticket = NULL;
+                /* Parts of a mapped body are sent straight from the mapping, so they need no buffer */
+                bool needs_ticket = !s_has_mapped_body(meta_request);
                 if (meta_request->synced_data.async_write.ready_to_send) {
                     /* Async-write already has a ticket, take ownership */
                     AWS_FATAL_ASSERT(meta_request->synced_data.async_write.buffered_data_ticket);
                     ticket = meta_request->synced_data.async_write.buffered_data_ticket;
                     meta_request->synced_data.async_write.buffered_data_ticket = NULL;
-                } else {
+                } else if (needs_ticket) {
                     /* Try to reserve a ticket */
-                    ticket = aws_s3_buffer_pool_reserve(meta_request->client->buffer_pool, meta_request->part_size);
+                    ticket = aws_s3_meta_request_reserve_ticket_synced(meta_request, meta_request->part_size);
                 }
 
-                if (ticket != NULL) {
+                if (ticket != NULL || !needs_ticket) {
                     /* Allocate a request for another part. */
                     request = aws_s3_request_new(
                         meta_request,
@@ -933,6 +937,11 @@ struct aws_future_http_message *s_s3_prepare_create_multipart_upload(struct aws_
     return future;
 }
 
+static bool s_has_mapped_body(const struct aws_s3_meta_request *meta_request) {
+    return meta_request->request_body_parallel_stream != NULL &&
+           aws_parallel_input_stream_is_mapped(meta_request->request_body_parallel_stream);
+}
+
 /* Prepare an UploadPart request */
 struct aws_future_http_message *s_s3_prepare_upload_part(struct aws_s3_request *request) {
     struct aws_s3_meta_request *meta_request = request->meta_request;
@@ -955,10 +964,37 @@ struct aws_future_http_message *s_s3_prepare_upload_part(struct aws_s3_request *
         /* Read the body */
         uint64_t offset = 0;
         size_t request_body_size = s_compute_request_body_size(meta_request, request->part_number, &offset);
+        if (s_has_mapped_body(meta_request)) {
+            /* Point the body into the mapping instead of copying it into a buffer.
+             * The buffer doesn't own the memory, so cleaning it up leaves the mapping alone. */
+            struct aws_byte_cursor range;
+            AWS_ZERO_STRUCT(range);
+            int error_code = aws_parallel_input_stream_get_mapped_range(
+                meta_request->request_body_parallel_stream, offset, request_body_size, &range);
+            request->request_body = aws_byte_buf_from_array(range.ptr, range.len);
+
+            part_prep->asyncstep_read_part = aws_future_bool_new(allocator);
+            if (error_code) {
+                aws_future_bool_set_error(part_prep->asyncstep_read_part, aws_last_error());
+            } else {
+                aws_future_bool_set_result(part_prep->asyncstep_read_part, range.len < request_body_size);
+            }
+            aws_future_bool_register_callback(
+                part_prep->asyncstep_read_part, s_s3_prepare_upload_part_on_read_done, part_prep);
+            return message_future;
+        }
         if (request->request_body.capacity == 0) {
             AWS_FATAL_ASSERT(request->ticket);
             request->request_body =
                 aws_s3_buffer_pool_acquire_buffer(request->meta_request->client->buffer_pool, request->ticket);
+            if (request->request_body.buffer == NULL) {
+                /* Buffer provider is out of memory */
+                part_prep->asyncstep_read_part = aws_future_bool_new(allocator);
+                aws_future_bool_set_error(part_prep->asyncstep_read_part, aws_last_error_or_unknown());
+                aws_future_bool_register_callback(
+                    part_prep->asyncstep_read_part, s_s3_prepare_upload_part_on_read_done, part_prep);
+                return message_future;
+            }
             request->request_body.capacity = request_body_size;
         }
 
@@ -0,0 +1,688 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include "aws/s3/private/s3_block_cache.h"
+#include "aws/s3/private/s3_util.h"
+
+#include <aws/common/file.h>
+#include <aws/common/hash_table.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/mutex.h>
+#include <aws/common/ref_count.h>
+#include <aws/common/string.h>
+#include <aws/common/uuid.h>
+#include <aws/http/request_response.h>
+#include <aws/io/event_loop.h>
+#include <aws/io/future.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+/* File I/O for spilling happens without the lock held, on the I/O ELG passed to get or put. While it does, the block
+ * is in neither the eviction policy nor disk_blocks, so nothing else can evict it. */
+enum s3_block_cache_block_state {
+    /* Data is in memory, and the eviction policy tracks the block */
+    S3_BLOCK_CACHE_BLOCK_IN_MEMORY,
+    /* Data is still in memory while it's written to file_path */
+    S3_BLOCK_CACHE_BLOCK_SPILLING,
+    /* Data is in file_path, and the block is in disk_blocks */
+    S3_BLOCK_CACHE_BLOCK_ON_DISK,
+    /* file_path is being read back */
+    S3_BLOCK_CACHE_BLOCK_UNSPILLING,
+};
+
+struct aws_s3_block_cache_block {
+    /* Key in the cache's table, pointing into key_storage */
+    struct aws_byte_cursor key;
+    struct aws_string *key_storage;
+
+    struct aws_s3_block_cache_entry entry;
+
+    enum s3_block_cache_block_state state;
+
+    /* Block data while it's in memory. Empty once spilled. */
+    struct aws_byte_buf data;
+
+    /* File the block is spilled to, or NULL while it's in memory */
+    struct aws_string *file_path;
+
+    /* Node in disk_blocks while spilled, or in a list of blocks to spill while spilling */
+    struct aws_linked_list_node disk_node;
+};
+
+struct aws_s3_block_cache {
+    struct aws_allocator *allocator;
+    struct aws_ref_count ref_count;
+
+    uint64_t memory_limit;
+    uint64_t disk_limit;
+
+    /* NULL if blocks aren't spilled */
+    struct aws_string *spill_directory;
+
+    const struct aws_s3_block_cache_eviction_policy_vtable *policy;
+    void *policy_user_data;
+
+    struct aws_mutex lock;
+
+    struct {
+        /* aws_byte_cursor key -> aws_s3_block_cache_block */
+        struct aws_hash_table blocks;
+
+        /* Spilled blocks, oldest first */
+        struct aws_linked_list disk_blocks;
+
+        struct aws_s3_block_cache_stats stats;
+    } synced_data;
+};
+
+/* Default eviction policy: least recently used block leaves memory first */
+struct s3_block_cache_lru {
+    struct aws_allocator *allocator;
+
+    /* Least recently used first */
+    struct aws_linked_list entries;
+};
+
+struct s3_block_cache_lru_node {
+    struct aws_linked_list_node node;
+    struct aws_s3_block_cache_entry *entry;
+};
+
+static void s_lru_on_insert(void *user_data, struct aws_s3_block_cache_entry *entry) {
+    struct s3_block_cache_lru *lru = user_data;
+    struct s3_block_cache_lru_node *lru_node =
+        aws_mem_calloc(lru->allocator, 1, sizeof(struct s3_block_cache_lru_node));
+    lru_node->entry = entry;
+    aws_linked_list_push_back(&lru->entries, &lru_node->node);
+    entry->policy_data = lru_node;
+}
+
+static void s_lru_on_access(void *user_data, struct aws_s3_block_cache_entry *entry) {
+    struct s3_block_cache_lru *lru = user_data;
+    struct s3_block_cache_lru_node *lru_node = entry->policy_data;
+    aws_linked_list_remove(&lru_node->node);
+    aws_linked_list_push_back(&lru->entries, &lru_node->node);
+}
+
+static void s_lru_on_remove(void *user_data, struct aws_s3_block_cache_entry *entry) {
+    struct s3_block_cache_lru *lru = user_data;
+    struct s3_block_cache_lru_node *lru_node = entry->policy_data;
+    aws_linked_list_remove(&lru_node->node);
+    aws_mem_release(lru->allocator, lru_node);
+    entry->policy_data = NULL;
+}
+
+static struct aws_s3_block_cache_entry *s_lru_choose_victim(void *user_data) {
+    struct s3_block_cache_lru *lru = user_data;
+    if (aws_linked_list_empty(&lru->entries)) {
+        return NULL;
+    }
+    struct aws_linked_list_node *node = aws_linked_list_front(&lru->entries);
+    return AWS_CONTAINER_OF(node, struct s3_block_cache_lru_node, node)->entry;
+}
+
+static void s_lru_destroy(void *user_data) {
+    struct s3_block_cache_lru *lru = user_data;
+    AWS_ASSERT(aws_linked_list_empty(&lru->entries));
+    aws_mem_release(lru->allocator, lru);
+}
+
+static const struct aws_s3_block_cache_eviction_policy_vtable s_lru_policy_vtable = {
+    .on_insert = s_lru_on_insert,
+    .on_access = s_lru_on_access,
+    .on_remove = s_lru_on_remove,
+    .choose_victim = s_lru_choose_victim,
+    .destroy = s_lru_destroy,
+};
+
+static void s_s3_block_cache_destroy(void *user_data);
+
+struct aws_s3_block_cache *aws_s3_block_cache_new(
+    struct aws_allocator *allocator,
+    const struct aws_s3_block_cache_options *options) {
+    AWS_PRECONDITION(allocator);
+    AWS_PRECONDITION(options);
+
+    if (options->memory_limit_in_bytes == 0) {
+        AWS_LOGF_ERROR(AWS_LS_S3_GENERAL, "Cannot create block cache, memory_limit_in_bytes must not be 0");
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    if (options->spill_directory.len > 0 && options->disk_limit_in_bytes == 0) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_GENERAL, "Cannot create block cache, disk_limit_in_bytes must be set with spill_directory");
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    struct aws_string *spill_directory = NULL;
+    if (options->spill_directory.len > 0) {
+        spill_directory = aws_string_new_from_cursor(allocator, &options->spill_directory);
+        if (!aws_directory_exists(spill_directory)) {
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_GENERAL,
+                "Cannot create block cache, spill_directory '%s' does not exist",
+                aws_string_c_str(spill_directory));
+            aws_string_destroy(spill_directory);
+            aws_raise_error(AWS_ERROR_FILE_INVALID_PATH);
+            return NULL;
+        }
+    }
+
+    struct aws_s3_block_cache *block_cache = aws_mem_calloc(allocator, 1, sizeof(struct aws_s3_block_cache));
+    block_cache->allocator = allocator;
+    aws_ref_count_init(&block_cache->ref_count, block_cache, s_s3_block_cache_destroy);
+    block_cache->memory_limit = options->memory_limit_in_bytes;
+    block_cache->disk_limit = options->disk_limit_in_bytes;
+    block_cache->spill_directory = spill_directory;
+
+    if (options->eviction_policy != NULL) {
+        block_cache->policy = options->eviction_policy;
+        block_cache->policy_user_data = options->eviction_policy_user_data;
+    } else {
+        struct s3_block_cache_lru *lru = aws_mem_calloc(allocator, 1, sizeof(struct s3_block_cache_lru));
+        lru->allocator = allocator;
+        aws_linked_list_init(&lru->entries);
+        block_cache->policy = &s_lru_policy_vtable;
+        block_cache->policy_user_data = lru;
+    }
+
+    aws_mutex_init(&block_cache->lock);
+    aws_hash_table_init(
+        &block_cache->synced_data.blocks,
+        allocator,
+        64,
+        aws_hash_byte_cursor_ptr,
+        (aws_hash_callback_eq_fn *)aws_byte_cursor_eq,
+        NULL,
+        NULL);
+    aws_linked_list_init(&block_cache->synced_data.disk_blocks);
+
+    return block_cache;
+}
+
+struct aws_s3_block_cache *aws_s3_block_cache_acquire(struct aws_s3_block_cache *block_cache) {
+    if (block_cache != NULL) {
+        aws_ref_count_acquire(&block_cache->ref_count);
+    }
+    return block_cache;
+}
+
+struct aws_s3_block_cache *aws_s3_block_cache_release(struct aws_s3_block_cache *block_cache) {
+    if (block_cache != NULL) {
+        aws_ref_count_release(&block_cache->ref_count);
+    }
+    return NULL;
+}
+
+struct aws_s3_block_cache_stats aws_s3_block_cache_get_stats(struct aws_s3_block_cache *block_cache) {
+    AWS_PRECONDITION(block_cache);
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&block_cache->lock);
+    struct aws_s3_block_cache_stats stats = block_cache->synced_data.stats;
+    aws_mutex_unlock(&block_cache->lock);
+    /* END CRITICAL SECTION */
+
+    return stats;
+}
+
+int aws_s3_block_cache_key_init(
+    struct aws_byte_buf *out_key,
+    struct aws_allocator *allocator,
+    const struct aws_http_message *message,
+    struct aws_byte_cursor etag,
+    uint64_t range_start,
+    uint64_t range_end) {
+    AWS_PRECONDITION(out_key);
+    AWS_PRECONDITION(message);
+
+    struct aws_byte_cursor host;
+    AWS_ZERO_STRUCT(host);
+    aws_http_headers_get(aws_http_message_get_const_headers(message), g_host_header_name, &host);
+
+    struct aws_byte_cursor path;
+    AWS_ZERO_STRUCT(path);
+    if (aws_http_message_get_request_path(message, &path)) {
+        return AWS_OP_ERR;
+    }
+
+    char range_buffer[64] = "";
+    snprintf(range_buffer, sizeof(range_buffer), "%" PRIu64 "-%" PRIu64, range_start, range_end);
+    struct aws_byte_cursor range = aws_byte_cursor_from_c_str(range_buffer);
+    struct aws_byte_cursor separator = aws_byte_cursor_from_c_str("\n");
+
+    aws_byte_buf_init(out_key, allocator, host.len + path.len + etag.len + range.len + 2 * separator.len);
+    aws_byte_buf_append(out_key, &host);
+    aws_byte_buf_append(out_key, &path);
+    aws_byte_buf_append(out_key, &separator);
+    aws_byte_buf_append(out_key, &etag);
+    aws_byte_buf_append(out_key, &separator);
+    aws_byte_buf_append(out_key, &range);
+    return AWS_OP_SUCCESS;
+}
+
+static void s_block_destroy(struct aws_s3_block_cache *block_cache, struct aws_s3_block_cache_block *block) {
+    if (block->file_path != NULL) {
+        remove(aws_string_c_str(block->file_path));
+        aws_string_destroy(block->file_path);
+    }
+    aws_byte_buf_clean_up(&block->data);
+    aws_string_destroy(block->key_storage);
+    aws_mem_release(block_cache->allocator, block);
+}
+
+/* Drop a block from the cache, wherever it is */
+static void s_evict_block_synced(struct aws_s3_block_cache *block_cache, struct aws_s3_block_cache_block *block) {
+    switch (block->state) {
+        case S3_BLOCK_CACHE_BLOCK_IN_MEMORY:
+            block_cache->policy->on_remove(block_cache->policy_user_data, &block->entry);
+            block_cache->synced_data.stats.memory_used -= block->entry.size;
+            break;
+        case S3_BLOCK_CACHE_BLOCK_ON_DISK:
+            aws_linked_list_remove(&block->disk_node);
+            block_cache->synced_data.stats.disk_used -= block->entry.size;
+            break;
+        case S3_BLOCK_CACHE_BLOCK_SPILLING:
+        case S3_BLOCK_CACHE_BLOCK_UNSPILLING:
+            /* Room on disk was taken when spilling started, and stays taken until the file is gone */
+            block_cache->synced_data.stats.disk_used -= block->entry.size;
+            break;
+    }
+    aws_hash_table_remove(&block_cache->synced_data.blocks, &block->key, NULL, NULL);
+    ++block_cache->synced_data.stats.evictions;
+    s_block_destroy(block_cache, block);
+}
+
+/* Path of a new file in the spill directory. The name has a UUID, so caches in other processes sharing the directory
+ * don't pick the same one. */
+static struct aws_string *s_new_spill_file_path(struct aws_s3_block_cache *block_cache) {
+    struct aws_uuid uuid;
+    aws_uuid_init(&uuid);
+    char uuid_str[AWS_UUID_STR_LEN] = "";
+    struct aws_byte_buf uuid_buf = aws_byte_buf_from_empty_array(uuid_str, sizeof(uuid_str));
+    aws_uuid_to_str(&uuid, &uuid_buf);
+
+    char file_name[128] = "";
+    snprintf(
+        file_name,
+        sizeof(file_name),
+        "%caws-s3-block-%.*s",
+        aws_get_platform_directory_separator(),
+        (int)uuid_buf.len,
+        (const char *)uuid_buf.buffer);
+    struct aws_byte_buf path_buf;
+    aws_byte_buf_init_copy_from_cursor(
+        &path_buf, block_cache->allocator, aws_byte_cursor_from_string(block_cache->spill_directory));
+    struct aws_byte_cursor file_name_cursor = aws_byte_cursor_from_c_str(file_name);
+    aws_byte_buf_append_dynamic(&path_buf, &file_name_cursor);
+    struct aws_string *file_path = aws_string_new_from_buf(block_cache->allocator, &path_buf);
+    aws_byte_buf_clean_up(&path_buf);
+    return file_path;
+}
+
+/* Take a block out of memory and make room for it on disk. Its file is written by s_spill_blocks() once the lock is
+ * released. Returns false if it can't be spilled. */
+static bool s_start_spill_synced(struct aws_s3_block_cache *block_cache, struct aws_s3_block_cache_block *block) {
+    if (block_cache->spill_directory == NULL || block->entry.size > block_cache->disk_limit) {
+        return false;
+    }
+
+    /* Make room on disk, oldest spilled blocks go first. Blocks whose files are in use can't go. */
+    while (block_cache->synced_data.stats.disk_used + block->entry.size > block_cache->disk_limit) {
+        if (aws_linked_list_empty(&block_cache->synced_data.disk_blocks)) {
+            return false;
+        }
+        struct aws_linked_list_node *oldest = aws_linked_list_front(&block_cache->synced_data.disk_blocks);
+        s_evict_block_synced(block_cache, AWS_CONTAINER_OF(oldest, struct aws_s3_block_cache_block, disk_node));
+    }
+
+    block_cache->policy->on_remove(block_cache->policy_user_data, &block->entry);
+    block->state = S3_BLOCK_CACHE_BLOCK_SPILLING;
+    block->file_path = s_new_spill_file_path(block_cache);
+    block_cache->synced_data.stats.memory_used -= block->entry.size;
+    block_cache->synced_data.stats.disk_used += block->entry.size;
+    return true;
+}
+
+/* Get memory under its limit. Blocks that can be spilled go to blocks_to_spill, the rest are evicted. */
+static void s_shrink_memory_synced(struct aws_s3_block_cache *block_cache, struct aws_linked_list *blocks_to_spill) {
+    while (block_cache->synced_data.stats.memory_used > block_cache->memory_limit) {
+        struct aws_s3_block_cache_entry *victim = block_cache->policy->choose_victim(block_cache->policy_user_data);
+        if (victim == NULL) {
+            break;
+        }
+        struct aws_s3_block_cache_block *block = AWS_CONTAINER_OF(victim, struct aws_s3_block_cache_block, entry);
+        if (s_start_spill_synced(block_cache, block)) {
+            aws_linked_list_push_back(blocks_to_spill, &block->disk_node);
+        } else {
+            s_evict_block_synced(block_cache, block);
+        }
+    }
+}
+
+/* Write the files of blocks that started spilling. Must be called without the lock held. */
+static void s_spill_blocks(struct aws_s3_block_cache *block_cache, struct aws_linked_list *blocks_to_spill) {
+    while (!aws_linked_list_empty(blocks_to_spill)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(blocks_to_spill);
+        struct aws_s3_block_cache_block *block = AWS_CONTAINER_OF(node, struct aws_s3_block_cache_block, disk_node);
+
+        /* Data doesn't change while spilling, so it's safe to read without the lock.
+         * "x" fails if the file exists instead of writing over someone else's. */
+        bool written = false;
+        FILE *file = aws_fopen(aws_string_c_str(block->file_path), "wbx");
+        if (file != NULL) {
+            written = fwrite(block->data.buffer, 1, block->data.len, file) == block->data.len;
+            written = (fclose(file) == 0) && written;
+            if (!written) {
+                remove(aws_string_c_str(block->file_path));
+            }
+        }
+        int error = errno;
+
+        /* BEGIN CRITICAL SECTION */
+        aws_mutex_lock(&block_cache->lock);
+        if (written) {
+            aws_byte_buf_clean_up(&block->data);
+            block->state = S3_BLOCK_CACHE_BLOCK_ON_DISK;
+            aws_linked_list_push_back(&block_cache->synced_data.disk_blocks, &block->disk_node);
+            ++block_cache->synced_data.stats.spills;
+        } else {
+            AWS_LOGF_WARN(
+                AWS_LS_S3_GENERAL,
+                "id=%p: Failed to spill block to '%s', errno %d. Evicting it instead.",
+                (void *)block_cache,
+                aws_string_c_str(block->file_path),
+                error);
+            /* Don't remove a file that's someone else's */
+            aws_string_destroy(block->file_path);
+            block->file_path = NULL;
+            s_evict_block_synced(block_cache, block);
+        }
+        aws_mutex_unlock(&block_cache->lock);
+        /* END CRITICAL SECTION */
+    }
+}
+
+/* Writes the files of blocks that started spilling, on an event loop of the I/O ELG */
+struct s3_block_cache_spill_job {
+    struct aws_task task;
+    struct aws_s3_block_cache *block_cache;
+    struct aws_linked_list blocks_to_spill;
+};
+
+static void s_spill_task(struct aws_task *task, void *arg, enum aws_task_status task_status) {
+    (void)task;
+    (void)task_status;
+    struct s3_block_cache_spill_job *job = arg;
+    struct aws_s3_block_cache *block_cache = job->block_cache;
+
+    /* Files are written even if the ELG is shutting down, or the blocks would be stuck spilling */
+    s_spill_blocks(block_cache, &job->blocks_to_spill);
+    aws_mem_release(block_cache->allocator, job);
+    aws_s3_block_cache_release(block_cache);
+}
+
+/* Write the files of blocks that started spilling on io_elg, or right away if io_elg is NULL.
+ * Must be called without the lock held. */
+static void s_schedule_spill(
+    struct aws_s3_block_cache *block_cache,
+    struct aws_linked_list *blocks_to_spill,
+    struct aws_event_loop_group *io_elg) {
+
+    if (aws_linked_list_empty(blocks_to_spill)) {
+        return;
+    }
+
+    if (io_elg == NULL) {
+        s_spill_blocks(block_cache, blocks_to_spill);
+        return;
+    }
+
+    struct s3_block_cache_spill_job *job =
+        aws_mem_calloc(block_cache->allocator, 1, sizeof(struct s3_block_cache_spill_job));
+    job->block_cache = aws_s3_block_cache_acquire(block_cache);
+    aws_linked_list_init(&job->blocks_to_spill);
+    aws_linked_list_swap_contents(&job->blocks_to_spill, blocks_to_spill);
+    aws_task_init(&job->task, s_spill_task, job, "s3_block_cache_spill_task");
+    aws_event_loop_schedule_task_now(aws_event_loop_group_get_next_loop(io_elg), &job->task);
+}
+
+/* Finish reading a spilled block into data, and move it back into memory. Returns false if it couldn't be read. */
+static bool s_finish_unspill_synced(
+    struct aws_s3_block_cache *block_cache,
+    struct aws_s3_block_cache_block *block,
+    bool read,
+    struct aws_byte_cursor data,
+    struct aws_linked_list *blocks_to_spill) {
+
+    AWS_ASSERT(block->state == S3_BLOCK_CACHE_BLOCK_UNSPILLING);
+    if (!read) {
+        AWS_LOGF_WARN(
+            AWS_LS_S3_GENERAL,
+            "id=%p: Failed to read spilled block from '%s'. Evicting it.",
+            (void *)block_cache,
+            aws_string_c_str(block->file_path));
+        s_evict_block_synced(block_cache, block);
+        return false;
+    }
+
+    remove(aws_string_c_str(block->file_path));
+    aws_string_destroy(block->file_path);
+    block->file_path = NULL;
+    block_cache->synced_data.stats.disk_used -= block->entry.size;
+
+    aws_byte_buf_init_copy_from_cursor(&block->data, block_cache->allocator, data);
+    block->state = S3_BLOCK_CACHE_BLOCK_IN_MEMORY;
+    block_cache->policy->on_insert(block_cache->policy_user_data, &block->entry);
+    block_cache->synced_data.stats.memory_used += block->entry.size;
+    s_shrink_memory_synced(block_cache, blocks_to_spill);
+    return true;
+}
+
+/* Read the file of an unspilling block to the end of dest, and move the block back into memory.
+ * Blocks pushed out of memory by it are spilled by this thread too. Must be called without the lock held.
+ * Returns true on a hit. */
+static bool s_unspill_block(
+    struct aws_s3_block_cache *block_cache,
+    struct aws_s3_block_cache_block *block,
+    struct aws_byte_buf *dest) {
+
+    /* Nobody else touches an unspilling block, so its file is read without the lock */
+    size_t size = block->entry.size;
+    bool read = false;
+    FILE *file = aws_fopen(aws_string_c_str(block->file_path), "rb");
+    if (file != NULL) {
+        read = fread(dest->buffer + dest->len, 1, size, file) == size;
+        fclose(file);
+    }
+    struct aws_byte_cursor data = {.ptr = dest->buffer + dest->len, .len = size};
+
+    struct aws_linked_list blocks_to_spill;
+    aws_linked_list_init(&blocks_to_spill);
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&block_cache->lock);
+    bool hit = s_finish_unspill_synced(block_cache, block, read, data, &blocks_to_spill);
+    if (hit) {
+        ++block_cache->synced_data.stats.hits;
+    } else {
+        ++block_cache->synced_data.stats.misses;
+    }
+    aws_mutex_unlock(&block_cache->lock);
+    /* END CRITICAL SECTION */
+
+    if (hit) {
+        dest->len += size;
+    }
+    s_spill_blocks(block_cache, &blocks_to_spill);
+    return hit;
+}
+
+/* Reads a spilled block back into dest, on an event loop of the I/O ELG */
+struct s3_block_cache_unspill_job {
+    struct aws_task task;
+    struct aws_s3_block_cache *block_cache;
+    struct aws_s3_block_cache_block *block;
+    struct aws_byte_buf *dest;
+    struct aws_future_bool *future;
+};
+
+static void s_unspill_task(struct aws_task *task, void *arg, enum aws_task_status task_status) {
+    (void)task;
+    (void)task_status;
+    struct s3_block_cache_unspill_job *job = arg;
+    struct aws_s3_block_cache *block_cache = job->block_cache;
+
+    /* Read even if the ELG is shutting down, or the block would be stuck unspilling */
+    bool hit = s_unspill_block(block_cache, job->block, job->dest);
+    aws_future_bool_set_result(job->future, hit);
+    aws_future_bool_release(job->future);
+    aws_mem_release(block_cache->allocator, job);
+    aws_s3_block_cache_release(block_cache);
+}
+
+struct aws_future_bool *aws_s3_block_cache_get(
+    struct aws_s3_block_cache *block_cache,
+    struct aws_byte_cursor key,
+    struct aws_byte_buf *dest,
+    struct aws_event_loop_group *io_elg) {
+    AWS_PRECONDITION(block_cache);
+    AWS_PRECONDITION(dest);
+
+    struct aws_future_bool *future = aws_future_bool_new(block_cache->allocator);
+    bool hit = false;
+    struct aws_s3_block_cache_block *block_to_read = NULL;
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&block_cache->lock);
+
+    struct aws_hash_element *elem = NULL;
+    aws_hash_table_find(&block_cache->synced_data.blocks, &key, &elem);
+    if (elem != NULL) {
+        struct aws_s3_block_cache_block *block = elem->value;
+        if (block->entry.size <= dest->capacity - dest->len) {
+            switch (block->state) {
+                case S3_BLOCK_CACHE_BLOCK_IN_MEMORY:
+                case S3_BLOCK_CACHE_BLOCK_SPILLING: {
+                    /* A spilling block's data stays in memory until its file is written */
+                    if (block->state == S3_BLOCK_CACHE_BLOCK_IN_MEMORY) {
+                        block_cache->policy->on_access(block_cache->policy_user_data, &block->entry);
+                    }
+                    struct aws_byte_cursor data = aws_byte_cursor_from_buf(&block->data);
+                    aws_byte_buf_append(dest, &data);
+                    hit = true;
+                    break;
+                }
+                case S3_BLOCK_CACHE_BLOCK_ON_DISK:
+                    /* Out of disk_blocks, the file can't be evicted while it's read */
+                    aws_linked_list_remove(&block->disk_node);
+                    block->state = S3_BLOCK_CACHE_BLOCK_UNSPILLING;
+                    block_to_read = block;
+                    break;
+                case S3_BLOCK_CACHE_BLOCK_UNSPILLING:
+                    /* Someone else is reading it back, count it as a miss rather than wait */
+                    break;
+            }
+        }
+    }
+
+    if (block_to_read == NULL) {
+        if (hit) {
+            ++block_cache->synced_data.stats.hits;
+        } else {
+            ++block_cache->synced_data.stats.misses;
+        }
+    }
+
+    aws_mutex_unlock(&block_cache->lock);
+    /* END CRITICAL SECTION */
+
+    if (block_to_read == NULL) {
+        aws_future_bool_set_result(future, hit);
+    } else if (io_elg == NULL) {
+        aws_future_bool_set_result(future, s_unspill_block(block_cache, block_to_read, dest));
+    } else {
+        struct s3_block_cache_unspill_job *job =
+            aws_mem_calloc(block_cache->allocator, 1, sizeof(struct s3_block_cache_unspill_job));
+        job->block_cache = aws_s3_block_cache_acquire(block_cache);
+        job->block = block_to_read;
+        job->dest = dest;
+        job->future = aws_future_bool_acquire(future);
+        aws_task_init(&job->task, s_unspill_task, job, "s3_block_cache_unspill_task");
+        aws_event_loop_schedule_task_now(aws_event_loop_group_get_next_loop(io_elg), &job->task);
+    }
+    return future;
+}
+
+void aws_s3_block_cache_put(
+    struct aws_s3_block_cache *block_cache,
+    struct aws_byte_cursor key,
+    struct aws_byte_cursor data,
+    struct aws_event_loop_group *io_elg) {
+    AWS_PRECONDITION(block_cache);
+
+    if (data.len > block_cache->memory_limit) {
+        return;
+    }
+
+    struct aws_linked_list blocks_to_spill;
+    aws_linked_list_init(&blocks_to_spill);
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&block_cache->lock);
+
+    struct aws_hash_element *elem = NULL;
+    aws_hash_table_find(&block_cache->synced_data.blocks, &key, &elem);
+    if (elem == NULL) {
+        struct aws_s3_block_cache_block *block =
+            aws_mem_calloc(block_cache->allocator, 1, sizeof(struct aws_s3_block_cache_block));
+        block->key_storage = aws_string_new_from_cursor(block_cache->allocator, &key);
+        block->key = aws_byte_cursor_from_string(block->key_storage);
+        block->entry.size = data.len;
+        aws_byte_buf_init_copy_from_cursor(&block->data, block_cache->allocator, data);
+
+        if (aws_hash_table_put(&block_cache->synced_data.blocks, &block->key, block, NULL)) {
+            s_block_destroy(block_cache, block);
+        } else {
+            block_cache->policy->on_insert(block_cache->policy_user_data, &block->entry);
+            block_cache->synced_data.stats.memory_used += data.len;
+            s_shrink_memory_synced(block_cache, &blocks_to_spill);
+        }
+    }
+
+    aws_mutex_unlock(&block_cache->lock);
+    /* END CRITICAL SECTION */
+
+    s_schedule_spill(block_cache, &blocks_to_spill, io_elg);
+}
+
+static int s_destroy_block_callback(void *context, struct aws_hash_element *elem) {
+    struct aws_s3_block_cache *block_cache = context;
+    struct aws_s3_block_cache_block *block = elem->value;
+    if (block->state == S3_BLOCK_CACHE_BLOCK_IN_MEMORY) {
+        block_cache->policy->on_remove(block_cache->policy_user_data, &block->entry);
+    }
+    s_block_destroy(block_cache, block);
+    return AWS_COMMON_HASH_TABLE_ITER_CONTINUE | AWS_COMMON_HASH_TABLE_ITER_DELETE;
+}
+
+static void s_s3_block_cache_destroy(void *user_data) {
+    struct aws_s3_block_cache *block_cache = user_data;
+
+    aws_hash_table_foreach(&block_cache->synced_data.blocks, s_destroy_block_callback, block_cache);
+    aws_hash_table_clean_up(&block_cache->synced_data.blocks);
+
+    if (block_cache->policy->destroy != NULL) {
+        block_cache->policy->destroy(block_cache->policy_user_data);
+    }
+
+    aws_string_destroy(block_cache->spill_directory);
+    aws_mutex_clean_up(&block_cache->lock);
+    aws_mem_release(block_cache->allocator, block_cache);
+}
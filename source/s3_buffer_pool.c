@@ -6,9 +6,26 @@
 #include <aws/s3/private/s3_buffer_pool.h>
 
 #include <aws/common/array_list.h>
+#include <aws/common/atomics.h>
+#include <aws/common/hash_table.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/math.h>
 #include <aws/common/mutex.h>
+#include <aws/common/ref_count.h>
+#include <aws/common/thread.h>
 #include <aws/s3/private/s3_util.h>
 
+#if !defined(_WIN32)
+#    include <sys/mman.h>
+#endif
+
+#if defined(__linux__)
+#    include <stdio.h>
+#    include <stdlib.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
 /*
  * S3 Buffer Pool.
  * Fairly trivial implementation of "arena" style allocator.
@@ -27,22 +44,89 @@
  * are needed and then finding available space in existing blocks or creating a
  * new block. Acquire will always take over the whole chunk, so some space is
  * likely wasted.
+ * To keep acquire and release constant time regardless of how many blocks the
+ * pool has, blocks with free space are kept on "free run" lists, one list per
+ * possible acquire length (1 to 4 chunks). A block is on list n if it has at
+ * least n consecutive free chunks, so acquire just takes the first block from
+ * the matching list and finds the offset inside the block with a ctz over its
+ * bit mask. Tickets remember the index of the block they were allocated from,
+ * so release does not need to search for the owning block either.
+ * Blocks can be allocated from the base allocator (default), or mapped
+ * directly with mmap, optionally backed by huge pages, see
+ * aws_s3_buffer_pool_memory_backing. Some blocks can be pre-faulted on
+ * creation, those are never trimmed.
+ * On multi-socket hosts the pool can be NUMA aware. In that case primary
+ * storage is split per NUMA node: every block is bound to a node, each node
+ * has its own free run lists and shards, and buffers are handed out from the
+ * node of the CPU that acquires them (typically the event loop thread that
+ * services the request). Memory limit and reservations are still shared
+ * across all nodes.
  * Ex. say chunk_size is 8mb and s_chunks_per_block is 16, which makes block size 128mb.
  * acquires up to 32mb will be done from primary. So 1 block can hold 4 buffers
  * of 32mb (4 chunks) or 16 buffers of 8mb (1 chunk). If requested buffer size
  * is 12mb, 2 chunks are used for acquire and 4mb will be wasted.
- * Secondary storage delegates directly to system allocator.
+ * Secondary storage is split into size classes. Class sizes grow
+ * geometrically from primary cutoff, with S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING
+ * classes between each power of 2 multiple of the cutoff, so a buffer is at
+ * most 12.5% larger than requested. Secondary buffers are rounded up to their
+ * class size, and released buffers are kept on the class's free list for
+ * reuse until the pool is trimmed. Free buffers, and space lost to rounding
+ * buffers up to their class, count towards the memory limit together with
+ * everything reserved and used: a reservation that would put the pool over
+ * the limit trims free buffers first.
+ * Ex. with 8mb chunk size, classes are 36mb, 40mb, ..., 64mb, 72mb, ...,
+ * 128mb, ... up to 8gb, so a client using 64mb or 256mb parts keeps reusing
+ * the same buffers instead of going to the allocator for every part.
+ * Requests above the largest class delegate directly to system allocator.
  *
  * One complication is "forced" buffers. A forced buffer is one that
  * comes from primary or secondary storage as usual, but it is allowed to exceed
  * the memory limit. This is only used when we want to use memory from
  * the pool, but waiting for a normal ticket reservation could cause deadlock.
+ *
+ * Concurrency: all usage accounting is done with atomics, so reserving and
+ * releasing tickets never takes the pool lock. The memory limit is enforced
+ * with a CAS loop on a single "overall taken" counter.
+ * Single chunk buffers (the common case of part sized buffers) additionally
+ * go through a sharded front-end. Each shard is a small lock-free cache of
+ * recently released chunks, and the shard is picked based on the calling
+ * thread, so event loop threads mostly hit their own shard. Chunks sitting in
+ * a shard cache are still marked as allocated in their block. The pool lock
+ * is only taken when a shard cannot satisfy an acquire or is full on release
+ * (i.e. chunks need to be stolen from or returned to blocks), when new blocks
+ * are allocated and when the pool is trimmed.
+ *
+ * Async reservations: if a reservation cannot be satisfied right away, the
+ * caller is put on a FIFO wait queue (protected by the pool lock) and gets a
+ * future for the ticket. Whenever a ticket is released, memory is handed over
+ * directly to waiters at the front of the queue, in the order they arrived.
+ * Once anybody is waiting, new reservations (sync or async) do not jump the
+ * queue, so a large reservation is not starved by a stream of small ones.
+ *
+ * Buffer providers: a pool created with aws_s3_buffer_pool_new_from_provider()
+ * has no primary storage or size classes of its own. Every ticket goes down the
+ * secondary path, and reserve/acquire/release of memory are delegated to the
+ * provider, which also enforces the memory limit. Tickets, the wait queue,
+ * trackers and usage accounting work the same as for any other pool. The
+ * provider's memory can be freed outside of the pool too, so waiters are
+ * also woken by aws_s3_buffer_pool_notify_provider_memory_available(). The
+ * provider is never called with the pool lock held.
  */
 
 struct aws_s3_buffer_pool_ticket {
+    /* Pool the ticket was reserved from, so it can be released from a future. */
+    struct aws_s3_buffer_pool *pool;
     size_t size;
     uint8_t *ptr;
     size_t chunks_used;
+    /* Index of the primary block ptr was allocated from. Only valid for primary buffers. */
+    size_t block_index;
+    /* NUMA node of that block. Only valid for primary buffers. */
+    size_t numa_node;
+    /* Size class of the buffer. Only valid for secondary buffers. */
+    size_t size_class;
+    /* Optional. See aws_s3_buffer_pool_ticket_set_tracker() */
+    struct aws_s3_buffer_pool_tracker *tracker;
     bool forced;
 };
 
@@ -50,6 +134,18 @@ struct aws_s3_buffer_pool_ticket {
  * themselves are not preallocated. */
 static size_t s_block_list_initial_capacity = 5;
 
+static struct aws_s3_buffer_pool_ticket *s_ticket_release(struct aws_s3_buffer_pool_ticket *ticket) {
+    if (ticket != NULL) {
+        aws_s3_buffer_pool_release_ticket(ticket->pool, ticket);
+    }
+    return NULL;
+}
+
+AWS_FUTURE_T_POINTER_WITH_RELEASE_IMPLEMENTATION(
+    aws_future_s3_buffer_ticket,
+    struct aws_s3_buffer_pool_ticket,
+    s_ticket_release);
+
 /* Amount of mem reserved for use outside of buffer pool.
  * This is an optimistic upper bound on mem used as we dont track it.
  * Covers both usage outside of pool, i.e. all allocations done as part of s3
@@ -61,6 +157,12 @@ static const size_t s_buffer_pool_reserved_mem = MB_TO_BYTES(128);
  */
 static const size_t s_chunks_per_block = 16;
 
+/*
+ * Max number of chunks a single primary acquire can take.
+ * Acquires above that go to secondary storage.
+ */
+#define S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE 4
+
 /*
  * Max size of chunks in primary.
  * Effectively if client part size is above the following number, primary
@@ -69,13 +171,78 @@ static const size_t s_chunks_per_block = 16;
  */
 static const size_t s_max_chunk_size_for_buffer_reuse = MB_TO_BYTES(64);
 
+/* Page size assumed when pre-faulting blocks. Touching more often than needed is harmless. */
+static const size_t s_prefault_page_size = KB_TO_BYTES(4);
+
+/* Size that MAP_HUGETLB mappings are rounded up to (default huge page size on x86_64 and aarch64). */
+static const size_t s_huge_page_size = MB_TO_BYTES(2);
+
+/* Memory policy mode from linux/mempolicy.h. Preferred (rather than bind) so that a
+ * block can still be allocated if its node runs out of memory. */
+static const int s_mpol_preferred = 1;
+
 /* Forced buffers only count against the memory limit up to a certain percent.
  * For example: if mem_limit is 10GiB, and forced_use is 11GiB, and THIS number is 90(%),
  * we still consider 1GiB available for normal buffer usage. */
 static const size_t s_max_impact_of_forced_buffers_on_memory_limit_as_percentage = 80;
 
+/* Number of secondary size classes between each power of 2 multiple of primary cutoff. */
+#define S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING 8
+
+/* Number of powers of 2 multiples of primary cutoff covered by secondary size classes. */
+#define S3_BUFFER_POOL_SIZE_CLASS_DOUBLINGS 8
+
+#define S3_BUFFER_POOL_NUM_SIZE_CLASSES (S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING * S3_BUFFER_POOL_SIZE_CLASS_DOUBLINGS)
+
+/* Marks tickets whose buffer is not from a size class. */
+#define S3_BUFFER_POOL_NO_SIZE_CLASS SIZE_MAX
+
+/* Number of shards in the pool front-end. Must be a power of 2. */
+#define S3_BUFFER_POOL_NUM_SHARDS 16
+
+/* Number of free chunks each shard can cache before returning them to their blocks. */
+#define S3_BUFFER_POOL_SHARD_CACHE_SIZE 4
+
+/*
+ * Per-thread-group cache of free single chunk buffers.
+ * Each slot holds either NULL or a released ticket that still owns its chunk.
+ * Slots are only ever touched with atomic exchange/CAS, so no lock is needed.
+ */
+struct s3_buffer_pool_shard {
+    struct aws_atomic_var cached_chunks[S3_BUFFER_POOL_SHARD_CACHE_SIZE];
+};
+
+/* Secondary storage for buffers of one size. */
+struct s3_buffer_pool_size_class {
+    size_t buffer_size;
+
+    /* Released buffers kept for reuse (uint8_t *). Protected by pool mutex. */
+    struct aws_array_list free_buffers;
+
+    /* Buffers allocated for this class, both in use and free. Protected by pool mutex. */
+    size_t num_allocated;
+};
+
+/* Primary storage state kept separately for each NUMA node. Pool without NUMA awareness has exactly one. */
+struct s3_buffer_pool_numa_node {
+    /* free_runs[i] is a list of this node's blocks that have at least i + 1 consecutive free chunks.
+     * Protected by pool mutex. */
+    struct aws_linked_list free_runs[S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE];
+
+    /* Only hold chunks from this node's blocks. */
+    struct s3_buffer_pool_shard shards[S3_BUFFER_POOL_NUM_SHARDS];
+
+    /* Protected by pool mutex. */
+    size_t primary_allocated;
+};
+
 struct aws_s3_buffer_pool {
     struct aws_allocator *base_allocator;
+
+    /* Pool can be shared by multiple clients, see aws_s3_shared_buffer_pool_new() */
+    struct aws_ref_count ref_count;
+
+    /* Protects blocks. Accounting below is done with atomics and does not need the lock. */
     struct aws_mutex mutex;
 
     size_t block_size;
@@ -87,24 +254,111 @@ struct aws_s3_buffer_pool {
 
     size_t mem_limit;
 
-    bool has_reservation_hold;
+    enum aws_s3_buffer_pool_memory_backing memory_backing;
 
-    size_t primary_allocated;
-    size_t primary_reserved;
-    size_t primary_used;
+    /* How much unused memory aws_s3_buffer_pool_trim_step() keeps around. */
+    size_t trim_low_water_mark;
+
+    /* bool */
+    struct aws_atomic_var has_reservation_hold;
+
+    /* Sum of primary/secondary reserved and used. This is the number the memory limit is enforced against. */
+    struct aws_atomic_var overall_taken;
+
+    struct aws_atomic_var primary_allocated;
+    struct aws_atomic_var primary_reserved;
+    struct aws_atomic_var primary_used;
+    struct aws_atomic_var primary_locked_ops;
 
-    size_t secondary_reserved;
-    size_t secondary_used;
+    struct aws_atomic_var secondary_reserved;
+    struct aws_atomic_var secondary_used;
+    struct aws_atomic_var secondary_cached;
+    /* Bytes secondary buffers in use were rounded up by to fit their size class. Not part of overall_taken, but
+     * counts towards memory held by the pool, same as secondary_cached. */
+    struct aws_atomic_var secondary_rounding;
 
-    size_t forced_used;
+    struct aws_atomic_var forced_used;
 
+    /* Empty if pool has no primary storage (chunk size of 0). */
+    struct s3_buffer_pool_size_class size_classes[S3_BUFFER_POOL_NUM_SIZE_CLASSES];
+    size_t num_size_classes;
+
+    /* Array of num_numa_nodes nodes. */
+    struct s3_buffer_pool_numa_node *numa_nodes;
+    size_t num_numa_nodes;
+    /* Array of num_numa_nodes kernel node ids, indexed by pool node. Kernel ids can be sparse (ex. 0 and 2),
+     * so they are not the same as the pool's node indices. */
+    int *kernel_numa_node_ids;
+
+    /* Array of struct s3_buffer_pool_block *, indexed by block index.
+     * Slots of trimmed blocks are NULL until they are reused. */
     struct aws_array_list blocks;
+
+    /* Indices of NULL slots in blocks. */
+    struct aws_array_list free_block_indices;
+
+    size_t num_blocks;
+
+    /* List of struct s3_buffer_pool_reserve_waiter, oldest first. Protected by mutex. */
+    struct aws_linked_list reserve_waiters;
+    /* Length of reserve_waiters, so releasing a ticket can check for waiters without taking the lock. */
+    struct aws_atomic_var num_reserve_waiters;
+    /* Set while a thread is waking reserve waiters, so waiters are woken one at a time, in order.
+     * Protected by mutex. See s_wake_reserve_waiters() */
+    bool waking_reserve_waiters;
+    /* Set if memory may have been released while waking, so the waking thread tries again. Protected by mutex. */
+    bool wake_reserve_waiters_again;
+    /* Waiter off the queue while the waking thread takes memory for it without the lock. Protected by mutex. */
+    struct s3_buffer_pool_reserve_waiter *waiter_being_woken;
+
+    /* If set, memory comes from the provider instead of blocks and size classes.
+     * See aws_s3_buffer_pool_new_from_provider() */
+    const struct aws_s3_buffer_provider_vtable *provider;
+    void *provider_user_data;
+
+    /* Protected by mutex, same as blocks */
+    size_t primary_hugetlb_allocated;
+    size_t primary_thp_allocated;
+    size_t primary_prefaulted;
+};
+
+struct s3_buffer_pool_reserve_waiter {
+    struct aws_linked_list_node node;
+    size_t size;
+    /* Pool holds a reference until the future is completed. */
+    struct aws_future_s3_buffer_ticket *future;
+    /* Cancelled while it was being woken. Protected by mutex. */
+    bool cancelled;
+};
+
+/* How memory of a specific block was obtained. */
+enum s3_buffer_pool_block_memory_type {
+    S3_BUFFER_POOL_BLOCK_MEMORY_ALLOCATOR,
+    S3_BUFFER_POOL_BLOCK_MEMORY_MMAP,
+    S3_BUFFER_POOL_BLOCK_MEMORY_MMAP_THP,
+    S3_BUFFER_POOL_BLOCK_MEMORY_HUGETLB,
 };
 
 struct s3_buffer_pool_block {
     size_t block_size;
     uint8_t *block_ptr;
     uint16_t alloc_bit_mask;
+
+    enum s3_buffer_pool_block_memory_type memory_type;
+    /* Length of the mapping, if block was mmap'd. Can be larger than block_size. */
+    size_t mapped_size;
+
+    /* Block was pre-faulted on creation and is never trimmed. */
+    bool is_prefaulted;
+
+    size_t block_index;
+
+    /* NUMA node block memory is bound to. Always 0 if pool is not NUMA aware. */
+    size_t numa_node;
+
+    /* free_run_nodes[i] is linked into free_runs[i] of the block's NUMA node while in_free_runs[i] is set. */
+    struct aws_linked_list_node free_run_nodes[S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE];
+    bool in_free_runs[S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE];
 };
 
 /*
@@ -143,11 +397,294 @@ static inline bool s_check_bits(uint16_t num, size_t position, size_t n) {
     return (num >> position) & mask;
 }
 
+/*
+ * Returns mask where bit i is set if n bits starting at position i are all
+ * clear in num, i.e. a run of n free chunks starts at chunk i.
+ * Note: n must be at most S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE.
+ */
+static inline uint16_t s_free_runs(uint16_t num, size_t n) {
+    AWS_PRECONDITION(n >= 1 && n <= S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE);
+    uint16_t free_bits = (uint16_t)~num;
+    uint16_t runs = free_bits;
+    for (size_t i = 1; i < n; ++i) {
+        runs &= (uint16_t)(free_bits >> i);
+    }
+    return runs;
+}
+
+/*
+ * Maps pool NUMA nodes to kernel node ids, in ascending order of the nodes with CPUs listed in
+ * /sys/devices/system/node/has_cpu (ex. "0,2" or "0-3").
+ * Falls back to pool node index == kernel node id if the kernel lists fewer nodes than the pool has.
+ */
+static void s_load_kernel_numa_node_ids(struct aws_s3_buffer_pool *buffer_pool) {
+    size_t num_node_ids = 0;
+
+#if defined(__linux__)
+    char node_list[256] = {0};
+    FILE *file = fopen("/sys/devices/system/node/has_cpu", "r");
+    if (file != NULL) {
+        if (fgets(node_list, sizeof(node_list), file) == NULL) {
+            node_list[0] = '\0';
+        }
+        fclose(file);
+    }
+
+    const char *it = node_list;
+    while (*it >= '0' && *it <= '9' && num_node_ids < buffer_pool->num_numa_nodes) {
+        char *end = NULL;
+        long first = strtol(it, &end, 10);
+        long last = first;
+        if (*end == '-') {
+            last = strtol(end + 1, &end, 10);
+        }
+        for (long node_id = first; node_id <= last && node_id <= INT32_MAX; ++node_id) {
+            if (num_node_ids == buffer_pool->num_numa_nodes) {
+                break;
+            }
+            buffer_pool->kernel_numa_node_ids[num_node_ids++] = (int)node_id;
+        }
+        it = *end == ',' ? end + 1 : end;
+    }
+#endif
+
+    if (num_node_ids < buffer_pool->num_numa_nodes) {
+        if (buffer_pool->num_numa_nodes > 1) {
+            AWS_LOGF_DEBUG(
+                AWS_LS_S3_CLIENT,
+                "Kernel lists %zu NUMA nodes with CPUs, but buffer pool has %zu. "
+                "Assuming node ids start at 0 with no gaps.",
+                num_node_ids,
+                buffer_pool->num_numa_nodes);
+        }
+        for (size_t i = 0; i < buffer_pool->num_numa_nodes; ++i) {
+            buffer_pool->kernel_numa_node_ids[i] = (int)i;
+        }
+    }
+}
+
+/*
+ * Asks the kernel to place pages of a freshly mapped block on the block's NUMA node.
+ * Must be called before the block is touched. Failure is not fatal, block just ends up on the node of whoever
+ * touches it first.
+ */
+static void s_block_bind_to_numa_node(struct aws_s3_buffer_pool *buffer_pool, struct s3_buffer_pool_block *block) {
+    if (buffer_pool->num_numa_nodes <= 1) {
+        return;
+    }
+
+#if defined(__linux__) && defined(SYS_mbind)
+    unsigned long node_mask = 0;
+    int kernel_node_id = buffer_pool->kernel_numa_node_ids[block->numa_node];
+    if (kernel_node_id >= 0 && (size_t)kernel_node_id < sizeof(node_mask) * 8) {
+        node_mask = 1UL << kernel_node_id;
+        if (syscall(
+                SYS_mbind,
+                block->block_ptr,
+                block->mapped_size,
+                s_mpol_preferred,
+                &node_mask,
+                sizeof(node_mask) * 8,
+                0) == 0) {
+            return;
+        }
+    }
+#endif
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_S3_CLIENT, "Failed to bind buffer pool block to NUMA node %zu. Using default policy.", block->numa_node);
+}
+
+/*
+ * Allocates from the allocator, aligned to AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT.
+ * The pointer actually allocated is kept right before the aligned one, for s_aligned_mem_release().
+ */
+static uint8_t *s_aligned_mem_acquire(struct aws_allocator *allocator, size_t size) {
+    uint8_t *allocated = aws_mem_acquire(allocator, size + sizeof(void *) + AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT - 1);
+    uintptr_t aligned = ((uintptr_t)allocated + sizeof(void *) + AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT - 1) &
+                        ~(uintptr_t)(AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT - 1);
+    uint8_t *ptr = (uint8_t *)aligned;
+    memcpy(ptr - sizeof(void *), (void *)&allocated, sizeof(void *));
+    return ptr;
+}
+
+static void s_aligned_mem_release(struct aws_allocator *allocator, uint8_t *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    void *allocated = NULL;
+    memcpy((void *)&allocated, ptr - sizeof(void *), sizeof(void *));
+    aws_mem_release(allocator, allocated);
+}
+
+/* Allocates memory for a block, based on pool's memory backing. */
+static void s_block_memory_acquire(struct aws_s3_buffer_pool *buffer_pool, struct s3_buffer_pool_block *block) {
+    block->block_size = buffer_pool->block_size;
+    block->memory_type = S3_BUFFER_POOL_BLOCK_MEMORY_ALLOCATOR;
+    block->mapped_size = 0;
+
+#if !defined(_WIN32)
+    if (buffer_pool->memory_backing == AWS_S3_BUFFER_POOL_MEMORY_BACKING_HUGETLB) {
+#    if defined(MAP_HUGETLB)
+        size_t mapped_size = (block->block_size + s_huge_page_size - 1) / s_huge_page_size * s_huge_page_size;
+        void *mapped =
+            mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapped != MAP_FAILED) {
+            block->block_ptr = mapped;
+            block->mapped_size = mapped_size;
+            block->memory_type = S3_BUFFER_POOL_BLOCK_MEMORY_HUGETLB;
+            buffer_pool->primary_hugetlb_allocated += block->block_size;
+            s_block_bind_to_numa_node(buffer_pool, block);
+            return;
+        }
+#    endif
+        AWS_LOGF_DEBUG(
+            AWS_LS_S3_CLIENT,
+            "Failed to map buffer pool block of size %zu from huge pages. Falling back to regular pages.",
+            block->block_size);
+    }
+
+    if (buffer_pool->memory_backing != AWS_S3_BUFFER_POOL_MEMORY_BACKING_ALLOCATOR) {
+        void *mapped = mmap(NULL, block->block_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped != MAP_FAILED) {
+            block->block_ptr = mapped;
+            block->mapped_size = block->block_size;
+            block->memory_type = S3_BUFFER_POOL_BLOCK_MEMORY_MMAP;
+#    if defined(MADV_HUGEPAGE)
+            if (madvise(mapped, block->mapped_size, MADV_HUGEPAGE) == 0) {
+                block->memory_type = S3_BUFFER_POOL_BLOCK_MEMORY_MMAP_THP;
+                buffer_pool->primary_thp_allocated += block->block_size;
+            }
+#    endif
+            s_block_bind_to_numa_node(buffer_pool, block);
+            return;
+        }
+        AWS_LOGF_WARN(
+            AWS_LS_S3_CLIENT,
+            "Failed to map buffer pool block of size %zu. Falling back to allocator.",
+            block->block_size);
+    }
+#endif /* !_WIN32 */
+
+    block->block_ptr = s_aligned_mem_acquire(buffer_pool->base_allocator, block->block_size);
+}
+
+static void s_block_memory_release(struct aws_s3_buffer_pool *buffer_pool, struct s3_buffer_pool_block *block) {
+    switch (block->memory_type) {
+        case S3_BUFFER_POOL_BLOCK_MEMORY_HUGETLB:
+            buffer_pool->primary_hugetlb_allocated -= block->block_size;
+            break;
+        case S3_BUFFER_POOL_BLOCK_MEMORY_MMAP_THP:
+            buffer_pool->primary_thp_allocated -= block->block_size;
+            break;
+        default:
+            break;
+    }
+
+    if (block->is_prefaulted) {
+        buffer_pool->primary_prefaulted -= block->block_size;
+    }
+
+    if (block->memory_type == S3_BUFFER_POOL_BLOCK_MEMORY_ALLOCATOR) {
+        s_aligned_mem_release(buffer_pool->base_allocator, block->block_ptr);
+    } else {
+#if !defined(_WIN32)
+        munmap(block->block_ptr, block->mapped_size);
+#endif
+    }
+    block->block_ptr = NULL;
+}
+
+static struct s3_buffer_pool_block *s_primary_new_block_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t numa_node);
+static void s_block_update_free_runs_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    struct s3_buffer_pool_block *block);
+
+/* Allocates blocks to cover prefault_size and touches every page in them. Blocks are spread evenly over NUMA nodes. */
+static void s_prefault_blocks(struct aws_s3_buffer_pool *buffer_pool, size_t prefault_size) {
+    if (buffer_pool->block_size == 0 || prefault_size == 0) {
+        return;
+    }
+
+    size_t num_blocks = prefault_size / buffer_pool->block_size;
+    if (prefault_size % buffer_pool->block_size != 0) {
+        ++num_blocks; /* round up */
+    }
+    num_blocks = aws_min_size(num_blocks, buffer_pool->mem_limit / buffer_pool->block_size);
+
+    aws_mutex_lock(&buffer_pool->mutex);
+    for (size_t i = 0; i < num_blocks; ++i) {
+        struct s3_buffer_pool_block *block = s_primary_new_block_synced(buffer_pool, i % buffer_pool->num_numa_nodes);
+        for (size_t offset = 0; offset < block->block_size; offset += s_prefault_page_size) {
+            block->block_ptr[offset] = 0;
+        }
+        block->is_prefaulted = true;
+        buffer_pool->primary_prefaulted += block->block_size;
+        s_block_update_free_runs_synced(buffer_pool, block);
+    }
+    aws_mutex_unlock(&buffer_pool->mutex);
+
+    AWS_LOGF_DEBUG(
+        AWS_LS_S3_CLIENT, "Buffer pool pre-faulted %zu blocks of size %zu.", num_blocks, buffer_pool->block_size);
+}
+
+/* Sets up secondary size classes. Classes that would not fit in memory limit are skipped. */
+static void s_init_size_classes(struct aws_s3_buffer_pool *buffer_pool) {
+    if (buffer_pool->primary_size_cutoff == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < S3_BUFFER_POOL_NUM_SIZE_CLASSES; ++i) {
+        size_t doubling = i / S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING;
+        size_t step_i = i % S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING + 1;
+        if (buffer_pool->primary_size_cutoff > (buffer_pool->mem_limit >> doubling)) {
+            break;
+        }
+
+        size_t base = buffer_pool->primary_size_cutoff << doubling;
+        size_t step = (base + S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING - 1) / S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING;
+        size_t buffer_size = base + step * step_i;
+        if (buffer_size > buffer_pool->mem_limit) {
+            break;
+        }
+
+        struct s3_buffer_pool_size_class *size_class = &buffer_pool->size_classes[i];
+        size_class->buffer_size = buffer_size;
+        aws_array_list_init_dynamic(&size_class->free_buffers, buffer_pool->base_allocator, 0, sizeof(uint8_t *));
+        ++buffer_pool->num_size_classes;
+    }
+}
+
+static void s_buffer_pool_destroy(void *user_data);
+static struct aws_s3_buffer_pool *s_buffer_pool_new(
+    struct aws_allocator *allocator,
+    size_t chunk_size,
+    size_t mem_limit,
+    const struct aws_s3_buffer_pool_options *options);
+
 struct aws_s3_buffer_pool *aws_s3_buffer_pool_new(
     struct aws_allocator *allocator,
     size_t chunk_size,
     size_t mem_limit) {
 
+    struct aws_s3_buffer_pool_options options = {
+        .chunk_size = chunk_size,
+        .mem_limit = mem_limit,
+    };
+    return aws_s3_buffer_pool_new_with_options(allocator, &options);
+}
+
+struct aws_s3_buffer_pool *aws_s3_buffer_pool_new_with_options(
+    struct aws_allocator *allocator,
+    const struct aws_s3_buffer_pool_options *options) {
+
+    AWS_PRECONDITION(options);
+
+    size_t chunk_size = options->chunk_size;
+    size_t mem_limit = options->mem_limit;
+
     if (mem_limit < GB_TO_BYTES(1)) {
         AWS_LOGF_ERROR(
             AWS_LS_S3_CLIENT,
@@ -166,11 +703,16 @@ struct aws_s3_buffer_pool *aws_s3_buffer_pool_new(
             "if its not sufficient to transfer data within the maximum number of parts");
     }
 
+    /* Chunks are laid out back to back in a block, so round them up for every buffer to stay aligned for direct I/O.
+     * Buffers are still handed out in the size asked for, only up to ALIGNMENT - 1 bytes per chunk go unused. */
+    if (chunk_size % AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT != 0) {
+        chunk_size += AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT - chunk_size % AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT;
+    }
+
     size_t adjusted_mem_lim = mem_limit - s_buffer_pool_reserved_mem;
 
     /*
      * TODO: There is several things we can consider tweaking here:
-     * - if chunk size is a weird number of bytes, force it to the closest page size?
      * - grow chunk size max based on overall mem lim (ex. for 4gb it might be
      *   64mb, but for 8gb it can be 128mb)
      * - align chunk size to better fill available mem? some chunk sizes can
@@ -185,6 +727,15 @@ struct aws_s3_buffer_pool *aws_s3_buffer_pool_new(
         chunk_size = 0;
     }
 
+    return s_buffer_pool_new(allocator, chunk_size, adjusted_mem_lim, options);
+}
+
+static struct aws_s3_buffer_pool *s_buffer_pool_new(
+    struct aws_allocator *allocator,
+    size_t chunk_size,
+    size_t mem_limit,
+    const struct aws_s3_buffer_pool_options *options) {
+
     struct aws_s3_buffer_pool *buffer_pool = aws_mem_calloc(allocator, 1, sizeof(struct aws_s3_buffer_pool));
 
     AWS_FATAL_ASSERT(buffer_pool != NULL);
@@ -195,180 +746,888 @@ struct aws_s3_buffer_pool *aws_s3_buffer_pool_new(
     /* Somewhat arbitrary number.
      * Tries to balance between how many allocations use buffer and buffer space
      * being wasted. */
-    buffer_pool->primary_size_cutoff = chunk_size * 4;
-    buffer_pool->mem_limit = adjusted_mem_lim;
+    buffer_pool->primary_size_cutoff = chunk_size * S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE;
+    buffer_pool->mem_limit = mem_limit;
+    buffer_pool->memory_backing = options->memory_backing;
+    buffer_pool->trim_low_water_mark = options->trim_low_water_mark;
+    buffer_pool->num_numa_nodes = aws_max_size(options->num_numa_nodes, 1);
+    if (buffer_pool->num_numa_nodes > 1 &&
+        buffer_pool->memory_backing == AWS_S3_BUFFER_POOL_MEMORY_BACKING_ALLOCATOR) {
+        /* Only mapped blocks can be bound to a node */
+        buffer_pool->memory_backing = AWS_S3_BUFFER_POOL_MEMORY_BACKING_MMAP;
+    }
+    aws_ref_count_init(&buffer_pool->ref_count, buffer_pool, s_buffer_pool_destroy);
+
     int mutex_error = aws_mutex_init(&buffer_pool->mutex);
     AWS_FATAL_ASSERT(mutex_error == AWS_OP_SUCCESS);
 
+    aws_atomic_init_int(&buffer_pool->has_reservation_hold, 0);
+    aws_atomic_init_int(&buffer_pool->overall_taken, 0);
+    aws_atomic_init_int(&buffer_pool->primary_allocated, 0);
+    aws_atomic_init_int(&buffer_pool->primary_reserved, 0);
+    aws_atomic_init_int(&buffer_pool->primary_used, 0);
+    aws_atomic_init_int(&buffer_pool->primary_locked_ops, 0);
+    aws_atomic_init_int(&buffer_pool->secondary_reserved, 0);
+    aws_atomic_init_int(&buffer_pool->secondary_used, 0);
+    aws_atomic_init_int(&buffer_pool->secondary_cached, 0);
+    aws_atomic_init_int(&buffer_pool->secondary_rounding, 0);
+    aws_atomic_init_int(&buffer_pool->forced_used, 0);
+    aws_atomic_init_int(&buffer_pool->num_reserve_waiters, 0);
+    aws_linked_list_init(&buffer_pool->reserve_waiters);
+
+    buffer_pool->numa_nodes =
+        aws_mem_calloc(allocator, buffer_pool->num_numa_nodes, sizeof(struct s3_buffer_pool_numa_node));
+    buffer_pool->kernel_numa_node_ids = aws_mem_calloc(allocator, buffer_pool->num_numa_nodes, sizeof(int));
+    s_load_kernel_numa_node_ids(buffer_pool);
+    for (size_t node_i = 0; node_i < buffer_pool->num_numa_nodes; ++node_i) {
+        struct s3_buffer_pool_numa_node *numa_node = &buffer_pool->numa_nodes[node_i];
+        for (size_t i = 0; i < S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE; ++i) {
+            aws_linked_list_init(&numa_node->free_runs[i]);
+        }
+        for (size_t shard_i = 0; shard_i < S3_BUFFER_POOL_NUM_SHARDS; ++shard_i) {
+            for (size_t slot_i = 0; slot_i < S3_BUFFER_POOL_SHARD_CACHE_SIZE; ++slot_i) {
+                aws_atomic_init_ptr(&numa_node->shards[shard_i].cached_chunks[slot_i], NULL);
+            }
+        }
+    }
+
     aws_array_list_init_dynamic(
-        &buffer_pool->blocks, allocator, s_block_list_initial_capacity, sizeof(struct s3_buffer_pool_block));
+        &buffer_pool->blocks, allocator, s_block_list_initial_capacity, sizeof(struct s3_buffer_pool_block *));
+    aws_array_list_init_dynamic(
+        &buffer_pool->free_block_indices, allocator, s_block_list_initial_capacity, sizeof(size_t));
+
+    s_init_size_classes(buffer_pool);
+
+    s_prefault_blocks(buffer_pool, options->prefault_size);
 
     return buffer_pool;
 }
 
-void aws_s3_buffer_pool_destroy(struct aws_s3_buffer_pool *buffer_pool) {
-    if (buffer_pool == NULL) {
-        return;
-    }
+struct aws_s3_buffer_pool *aws_s3_buffer_pool_new_from_provider(
+    struct aws_allocator *allocator,
+    const struct aws_s3_buffer_provider_vtable *vtable,
+    void *user_data) {
 
-    for (size_t i = 0; i < aws_array_list_length(&buffer_pool->blocks); ++i) {
-        struct s3_buffer_pool_block *block;
-        aws_array_list_get_at_ptr(&buffer_pool->blocks, (void **)&block, i);
+    AWS_PRECONDITION(allocator);
 
-        AWS_FATAL_ASSERT(block->alloc_bit_mask == 0 && "Allocator still has outstanding blocks");
-        aws_mem_release(buffer_pool->base_allocator, block->block_ptr);
+    if (vtable == NULL || vtable->reserve == NULL || vtable->acquire == NULL || vtable->release == NULL) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_CLIENT, "Cannot create buffer pool from provider. reserve, acquire and release are required.");
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
     }
 
-    aws_array_list_clean_up(&buffer_pool->blocks);
+    /* Provider enforces the limit, pool only reports it */
+    size_t mem_limit = SIZE_MAX;
+    if (vtable->get_usage != NULL) {
+        struct aws_s3_buffer_provider_usage usage = vtable->get_usage(user_data);
+        if (usage.memory_limit != 0 && usage.memory_limit < SIZE_MAX) {
+            mem_limit = (size_t)usage.memory_limit;
+        }
+    }
 
-    aws_mutex_clean_up(&buffer_pool->mutex);
-    struct aws_allocator *base = buffer_pool->base_allocator;
-    aws_mem_release(base, buffer_pool);
+    /* Chunk size of 0 means no primary storage and no size classes, so every ticket goes to the provider */
+    struct aws_s3_buffer_pool_options options;
+    AWS_ZERO_STRUCT(options);
+    struct aws_s3_buffer_pool *buffer_pool = s_buffer_pool_new(allocator, 0, mem_limit, &options);
+    buffer_pool->provider = vtable;
+    buffer_pool->provider_user_data = user_data;
+    return buffer_pool;
 }
 
-void s_buffer_pool_trim_synced(struct aws_s3_buffer_pool *buffer_pool) {
-    for (size_t i = 0; i < aws_array_list_length(&buffer_pool->blocks);) {
-        struct s3_buffer_pool_block *block;
-        aws_array_list_get_at_ptr(&buffer_pool->blocks, (void **)&block, i);
+static void s_drain_shards_synced(struct aws_s3_buffer_pool *buffer_pool);
+static size_t s_trim_size_classes_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t bytes_to_free,
+    size_t max_bytes_to_free,
+    size_t keep_size_class);
 
-        if (block->alloc_bit_mask == 0) {
-            aws_mem_release(buffer_pool->base_allocator, block->block_ptr);
-            aws_array_list_erase(&buffer_pool->blocks, i);
-            /* do not increment since we just released element */
-        } else {
-            ++i;
-        }
+struct aws_s3_buffer_pool *aws_s3_buffer_pool_acquire(struct aws_s3_buffer_pool *buffer_pool) {
+    if (buffer_pool != NULL) {
+        aws_ref_count_acquire(&buffer_pool->ref_count);
     }
+    return buffer_pool;
 }
 
-void aws_s3_buffer_pool_trim(struct aws_s3_buffer_pool *buffer_pool) {
-    aws_mutex_lock(&buffer_pool->mutex);
-    s_buffer_pool_trim_synced(buffer_pool);
-    aws_mutex_unlock(&buffer_pool->mutex);
+struct aws_s3_buffer_pool *aws_s3_buffer_pool_release(struct aws_s3_buffer_pool *buffer_pool) {
+    if (buffer_pool != NULL) {
+        aws_ref_count_release(&buffer_pool->ref_count);
+    }
+    return NULL;
 }
 
-struct aws_s3_buffer_pool_ticket *aws_s3_buffer_pool_reserve(struct aws_s3_buffer_pool *buffer_pool, size_t size) {
-    AWS_PRECONDITION(buffer_pool);
+void aws_s3_buffer_pool_destroy(struct aws_s3_buffer_pool *buffer_pool) {
+    aws_s3_buffer_pool_release(buffer_pool);
+}
 
-    if (buffer_pool->has_reservation_hold) {
-        return NULL;
+static void s_buffer_pool_destroy(void *user_data) {
+    struct aws_s3_buffer_pool *buffer_pool = user_data;
+
+    /* Nobody is going to release memory anymore, fail whoever is still waiting */
+    while (!aws_linked_list_empty(&buffer_pool->reserve_waiters)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&buffer_pool->reserve_waiters);
+        struct s3_buffer_pool_reserve_waiter *waiter =
+            AWS_CONTAINER_OF(node, struct s3_buffer_pool_reserve_waiter, node);
+        aws_future_s3_buffer_ticket_set_error(waiter->future, AWS_ERROR_S3_CANCELED);
+        aws_future_s3_buffer_ticket_release(waiter->future);
+        aws_mem_release(buffer_pool->base_allocator, waiter);
     }
 
-    AWS_FATAL_ASSERT(size != 0);
-    AWS_FATAL_ASSERT(size <= buffer_pool->mem_limit);
+    s_drain_shards_synced(buffer_pool);
 
-    struct aws_s3_buffer_pool_ticket *ticket = NULL;
-    aws_mutex_lock(&buffer_pool->mutex);
+    for (size_t i = 0; i < aws_array_list_length(&buffer_pool->blocks); ++i) {
+        struct s3_buffer_pool_block *block;
+        aws_array_list_get_at(&buffer_pool->blocks, &block, i);
+        if (block == NULL) {
+            continue;
+        }
 
-    size_t overall_taken = buffer_pool->primary_used + buffer_pool->primary_reserved + buffer_pool->secondary_used +
-                           buffer_pool->secondary_reserved;
+        AWS_FATAL_ASSERT(block->alloc_bit_mask == 0 && "Allocator still has outstanding blocks");
+        s_block_memory_release(buffer_pool, block);
+        aws_mem_release(buffer_pool->base_allocator, block);
+    }
 
-    /*
-     * If we are allocating from secondary and there is unused space in
-     * primary, trim the primary in hopes we can free up enough memory.
-     * TODO: something smarter, like partial trim?
-     */
-    if (size > buffer_pool->primary_size_cutoff && (size + overall_taken) > buffer_pool->mem_limit &&
-        (buffer_pool->primary_allocated >
-         (buffer_pool->primary_used + buffer_pool->primary_reserved + buffer_pool->block_size))) {
-        s_buffer_pool_trim_synced(buffer_pool);
-        overall_taken = buffer_pool->primary_used + buffer_pool->primary_reserved + buffer_pool->secondary_used +
-                        buffer_pool->secondary_reserved;
+    s_trim_size_classes_synced(buffer_pool, SIZE_MAX, SIZE_MAX, S3_BUFFER_POOL_NO_SIZE_CLASS);
+    for (size_t i = 0; i < buffer_pool->num_size_classes; ++i) {
+        struct s3_buffer_pool_size_class *size_class = &buffer_pool->size_classes[i];
+        AWS_FATAL_ASSERT(size_class->num_allocated == 0 && "Allocator still has outstanding buffers");
+        aws_array_list_clean_up(&size_class->free_buffers);
     }
 
-    /* Don't let forced buffers account for 100% of the memory limit */
-    const size_t max_impact_of_forced_on_limit =
-        (size_t)(buffer_pool->mem_limit * (s_max_impact_of_forced_buffers_on_memory_limit_as_percentage / 100.0));
-    if (buffer_pool->forced_used > max_impact_of_forced_on_limit) {
-        overall_taken -= buffer_pool->forced_used - max_impact_of_forced_on_limit;
+    aws_array_list_clean_up(&buffer_pool->blocks);
+    aws_array_list_clean_up(&buffer_pool->free_block_indices);
+    aws_mem_release(buffer_pool->base_allocator, buffer_pool->numa_nodes);
+    aws_mem_release(buffer_pool->base_allocator, buffer_pool->kernel_numa_node_ids);
+
+    if (buffer_pool->provider != NULL && buffer_pool->provider->destroy != NULL) {
+        buffer_pool->provider->destroy(buffer_pool->provider_user_data);
     }
 
-    if ((size + overall_taken) <= buffer_pool->mem_limit) {
-        ticket = aws_mem_calloc(buffer_pool->base_allocator, 1, sizeof(struct aws_s3_buffer_pool_ticket));
-        ticket->size = size;
-        if (size <= buffer_pool->primary_size_cutoff) {
-            buffer_pool->primary_reserved += size;
-        } else {
-            buffer_pool->secondary_reserved += size;
+    aws_mutex_clean_up(&buffer_pool->mutex);
+    struct aws_allocator *base = buffer_pool->base_allocator;
+    aws_mem_release(base, buffer_pool);
+}
+
+/* Picks the shard of the given NUMA node for the calling thread. */
+static struct s3_buffer_pool_shard *s_get_shard(struct aws_s3_buffer_pool *buffer_pool, size_t numa_node) {
+    aws_thread_id_t thread_id = aws_thread_current_thread_id();
+    struct aws_byte_cursor thread_id_cur = aws_byte_cursor_from_array(&thread_id, sizeof(thread_id));
+    uint64_t hash = aws_hash_byte_cursor_ptr(&thread_id_cur);
+    return &buffer_pool->numa_nodes[numa_node].shards[hash & (S3_BUFFER_POOL_NUM_SHARDS - 1)];
+}
+
+/* Returns NUMA node of the CPU calling thread is running on. 0 if pool is not NUMA aware or node is unknown. */
+static size_t s_get_current_numa_node(struct aws_s3_buffer_pool *buffer_pool) {
+    if (buffer_pool->num_numa_nodes <= 1) {
+        return 0;
+    }
+
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) {
+        for (size_t i = 0; i < buffer_pool->num_numa_nodes; ++i) {
+            if (buffer_pool->kernel_numa_node_ids[i] == (int)node) {
+                return i;
+            }
         }
-    } else {
-        buffer_pool->has_reservation_hold = true;
     }
+#endif
 
-    aws_mutex_unlock(&buffer_pool->mutex);
+    return 0;
+}
 
-    if (ticket == NULL) {
-        AWS_LOGF_TRACE(
-            AWS_LS_S3_CLIENT,
-            "Memory limit reached while trying to allocate buffer of size %zu. "
-            "Putting new buffer reservations on hold...",
-            size);
-        aws_raise_error(AWS_ERROR_S3_EXCEEDS_MEMORY_LIMIT);
+/* Takes a cached ticket out of the shard. Returns NULL if shard is empty. */
+static struct aws_s3_buffer_pool_ticket *s_shard_pop(struct s3_buffer_pool_shard *shard) {
+    for (size_t i = 0; i < S3_BUFFER_POOL_SHARD_CACHE_SIZE; ++i) {
+        if (aws_atomic_load_ptr(&shard->cached_chunks[i]) != NULL) {
+            struct aws_s3_buffer_pool_ticket *cached = aws_atomic_exchange_ptr(&shard->cached_chunks[i], NULL);
+            if (cached != NULL) {
+                return cached;
+            }
+        }
     }
-    return ticket;
+    return NULL;
 }
 
-bool aws_s3_buffer_pool_has_reservation_hold(struct aws_s3_buffer_pool *buffer_pool) {
-    AWS_PRECONDITION(buffer_pool);
-    return buffer_pool->has_reservation_hold;
+/* Puts a released single chunk ticket into the shard. Returns false if shard is full. */
+static bool s_shard_push(struct s3_buffer_pool_shard *shard, struct aws_s3_buffer_pool_ticket *ticket) {
+    for (size_t i = 0; i < S3_BUFFER_POOL_SHARD_CACHE_SIZE; ++i) {
+        void *expected = NULL;
+        if (aws_atomic_compare_exchange_ptr(&shard->cached_chunks[i], &expected, ticket)) {
+            return true;
+        }
+    }
+    return false;
 }
 
-void aws_s3_buffer_pool_remove_reservation_hold(struct aws_s3_buffer_pool *buffer_pool) {
-    AWS_PRECONDITION(buffer_pool);
-    AWS_LOGF_TRACE(AWS_LS_S3_CLIENT, "Releasing buffer reservation hold.");
-    buffer_pool->has_reservation_hold = false;
+static struct s3_buffer_pool_block *s_get_block_synced(struct aws_s3_buffer_pool *buffer_pool, size_t block_index) {
+    struct s3_buffer_pool_block *block = NULL;
+    aws_array_list_get_at(&buffer_pool->blocks, &block, block_index);
+    AWS_FATAL_ASSERT(block != NULL);
+    return block;
 }
 
-static uint8_t *s_primary_acquire_synced(
+/* Puts the block on (or takes it off) free run lists based on its current bit mask. */
+static void s_block_update_free_runs_synced(
     struct aws_s3_buffer_pool *buffer_pool,
-    struct aws_s3_buffer_pool_ticket *ticket) {
+    struct s3_buffer_pool_block *block) {
+
+    struct s3_buffer_pool_numa_node *numa_node = &buffer_pool->numa_nodes[block->numa_node];
+    for (size_t i = 0; i < S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE; ++i) {
+        bool has_run = s_free_runs(block->alloc_bit_mask, i + 1) != 0;
+        if (has_run && !block->in_free_runs[i]) {
+            aws_linked_list_push_back(&numa_node->free_runs[i], &block->free_run_nodes[i]);
+            block->in_free_runs[i] = true;
+        } else if (!has_run && block->in_free_runs[i]) {
+            aws_linked_list_remove(&block->free_run_nodes[i]);
+            block->in_free_runs[i] = false;
+        }
+    }
+}
 
-    uint8_t *alloc_ptr = NULL;
+/* Marks chunks as free in the block they were allocated from. */
+static void s_primary_release_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t block_index,
+    uint8_t *ptr,
+    size_t chunks_used) {
 
-    size_t chunks_needed = ticket->size / buffer_pool->chunk_size;
-    if (ticket->size % buffer_pool->chunk_size != 0) {
-        ++chunks_needed; /* round up */
-    }
-    ticket->chunks_used = chunks_needed;
+    struct s3_buffer_pool_block *block = s_get_block_synced(buffer_pool, block_index);
+    AWS_FATAL_ASSERT(block->block_ptr <= ptr && block->block_ptr + block->block_size > ptr);
 
-    /* Look for space in existing blocks */
-    for (size_t i = 0; i < aws_array_list_length(&buffer_pool->blocks); ++i) {
-        struct s3_buffer_pool_block *block;
-        aws_array_list_get_at_ptr(&buffer_pool->blocks, (void **)&block, i);
+    size_t alloc_i = (ptr - block->block_ptr) / buffer_pool->chunk_size;
+    block->alloc_bit_mask = s_clear_bits(block->alloc_bit_mask, alloc_i, chunks_used);
+    s_block_update_free_runs_synced(buffer_pool, block);
+}
 
-        for (size_t chunk_i = 0; chunk_i < s_chunks_per_block - chunks_needed + 1; ++chunk_i) {
-            if (!s_check_bits(block->alloc_bit_mask, chunk_i, chunks_needed)) {
-                alloc_ptr = block->block_ptr + chunk_i * buffer_pool->chunk_size;
-                block->alloc_bit_mask = s_set_bits(block->alloc_bit_mask, chunk_i, chunks_needed);
-                goto on_allocated;
+/* Returns all chunks cached in shards back to their blocks. */
+static void s_drain_shards_synced(struct aws_s3_buffer_pool *buffer_pool) {
+    for (size_t node_i = 0; node_i < buffer_pool->num_numa_nodes; ++node_i) {
+        for (size_t shard_i = 0; shard_i < S3_BUFFER_POOL_NUM_SHARDS; ++shard_i) {
+            struct aws_s3_buffer_pool_ticket *cached = NULL;
+            while ((cached = s_shard_pop(&buffer_pool->numa_nodes[node_i].shards[shard_i])) != NULL) {
+                s_primary_release_synced(buffer_pool, cached->block_index, cached->ptr, 1);
+                aws_mem_release(buffer_pool->base_allocator, cached);
             }
         }
     }
+}
 
-    /* No space available. Allocate new block. */
-    struct s3_buffer_pool_block block;
-    block.alloc_bit_mask = s_set_bits(0, 0, chunks_needed);
-    block.block_ptr = aws_mem_acquire(buffer_pool->base_allocator, buffer_pool->block_size);
-    block.block_size = buffer_pool->block_size;
-    aws_array_list_push_back(&buffer_pool->blocks, &block);
-    alloc_ptr = block.block_ptr;
-
-    buffer_pool->primary_allocated += buffer_pool->block_size;
+/* Whether a trim that already freed `freed` bytes should free another unit of unit_size. */
+static bool s_trim_should_free(size_t freed, size_t unit_size, size_t bytes_to_free, size_t max_bytes_to_free) {
+    return freed < bytes_to_free && unit_size <= max_bytes_to_free - freed;
+}
 
-on_allocated:
-    buffer_pool->primary_used += ticket->size;
+/* Frees an empty block. */
+static void s_primary_free_block_synced(struct aws_s3_buffer_pool *buffer_pool, struct s3_buffer_pool_block *block) {
+    AWS_PRECONDITION(block->alloc_bit_mask == 0);
 
-    /* forced buffers acquire immediately, without reserving first */
-    if (ticket->forced == false) {
-        buffer_pool->primary_reserved -= ticket->size;
+    for (size_t run_i = 0; run_i < S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE; ++run_i) {
+        if (block->in_free_runs[run_i]) {
+            aws_linked_list_remove(&block->free_run_nodes[run_i]);
+        }
     }
 
-    return alloc_ptr;
+    buffer_pool->numa_nodes[block->numa_node].primary_allocated -= block->block_size;
+    aws_atomic_fetch_sub(&buffer_pool->primary_allocated, block->block_size);
+
+    struct s3_buffer_pool_block *empty_slot = NULL;
+    aws_array_list_set_at(&buffer_pool->blocks, &empty_slot, block->block_index);
+    aws_array_list_push_back(&buffer_pool->free_block_indices, &block->block_index);
+    --buffer_pool->num_blocks;
+
+    s_block_memory_release(buffer_pool, block);
+    aws_mem_release(buffer_pool->base_allocator, block);
 }
 
-static struct aws_byte_buf s_acquire_buffer_synced(
+/*
+ * Frees buffers kept for reuse in secondary size classes, largest classes first.
+ * Buffers in keep_size_class are left alone. See s_buffer_pool_trim_synced() for limits.
+ * Returns how much was freed.
+ */
+static size_t s_trim_size_classes_synced(
     struct aws_s3_buffer_pool *buffer_pool,
-    struct aws_s3_buffer_pool_ticket *ticket);
+    size_t bytes_to_free,
+    size_t max_bytes_to_free,
+    size_t keep_size_class) {
+
+    size_t freed = 0;
+    for (size_t i = buffer_pool->num_size_classes; i > 0; --i) {
+        size_t class_i = i - 1;
+        if (class_i == keep_size_class) {
+            continue;
+        }
+
+        struct s3_buffer_pool_size_class *size_class = &buffer_pool->size_classes[class_i];
+        while (aws_array_list_length(&size_class->free_buffers) > 0 &&
+               s_trim_should_free(freed, size_class->buffer_size, bytes_to_free, max_bytes_to_free)) {
+            uint8_t *buffer = NULL;
+            aws_array_list_back(&size_class->free_buffers, &buffer);
+            aws_array_list_pop_back(&size_class->free_buffers);
+            s_aligned_mem_release(buffer_pool->base_allocator, buffer);
+            --size_class->num_allocated;
+            aws_atomic_fetch_sub(&buffer_pool->secondary_cached, size_class->buffer_size);
+            freed += size_class->buffer_size;
+        }
+    }
+    return freed;
+}
+
+/*
+ * Frees unused memory: empty blocks in primary (except pre-faulted ones) first,
+ * then buffers kept for reuse in secondary.
+ * Stops once at least bytes_to_free is freed, and never frees more than max_bytes_to_free.
+ * Buffers kept for reuse in keep_size_class are not freed, pass S3_BUFFER_POOL_NO_SIZE_CLASS to free all of them.
+ * Returns how much was freed.
+ */
+static size_t s_buffer_pool_trim_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t bytes_to_free,
+    size_t max_bytes_to_free,
+    size_t keep_size_class) {
+
+    s_drain_shards_synced(buffer_pool);
+
+    size_t freed = 0;
+
+    /* Newest blocks first, so that slots of old blocks stay in use */
+    for (size_t i = aws_array_list_length(&buffer_pool->blocks); i > 0; --i) {
+        if (!s_trim_should_free(freed, buffer_pool->block_size, bytes_to_free, max_bytes_to_free)) {
+            break;
+        }
+
+        struct s3_buffer_pool_block *block;
+        aws_array_list_get_at(&buffer_pool->blocks, &block, i - 1);
+
+        if (block != NULL && block->alloc_bit_mask == 0 && !block->is_prefaulted) {
+            s_primary_free_block_synced(buffer_pool, block);
+            freed += buffer_pool->block_size;
+        }
+    }
+
+    freed += s_trim_size_classes_synced(buffer_pool, bytes_to_free - freed, max_bytes_to_free - freed, keep_size_class);
+    return freed;
+}
+
+/* Returns how much memory pool holds that trim could free. */
+static size_t s_get_trimmable_synced(struct aws_s3_buffer_pool *buffer_pool) {
+    size_t trimmable = aws_atomic_load_int(&buffer_pool->secondary_cached);
+    for (size_t i = 0; i < aws_array_list_length(&buffer_pool->blocks); ++i) {
+        struct s3_buffer_pool_block *block;
+        aws_array_list_get_at(&buffer_pool->blocks, &block, i);
+        if (block != NULL && block->alloc_bit_mask == 0 && !block->is_prefaulted) {
+            trimmable += block->block_size;
+        }
+    }
+    return trimmable;
+}
+
+void aws_s3_buffer_pool_trim(struct aws_s3_buffer_pool *buffer_pool) {
+    if (buffer_pool->provider != NULL) {
+        if (buffer_pool->provider->trim != NULL) {
+            buffer_pool->provider->trim(buffer_pool->provider_user_data);
+        }
+        return;
+    }
+
+    aws_mutex_lock(&buffer_pool->mutex);
+    s_buffer_pool_trim_synced(buffer_pool, SIZE_MAX, SIZE_MAX, S3_BUFFER_POOL_NO_SIZE_CLASS);
+    aws_mutex_unlock(&buffer_pool->mutex);
+}
+
+bool aws_s3_buffer_pool_trim_step(struct aws_s3_buffer_pool *buffer_pool) {
+    AWS_PRECONDITION(buffer_pool);
+
+    if (buffer_pool->provider != NULL) {
+        /* Provider has no notion of gradual trim, let it free everything it keeps for reuse */
+        aws_s3_buffer_pool_trim(buffer_pool);
+        return false;
+    }
+
+    bool has_more_to_trim = false;
+
+    aws_mutex_lock(&buffer_pool->mutex);
+    s_drain_shards_synced(buffer_pool);
+    size_t trimmable = s_get_trimmable_synced(buffer_pool);
+    if (trimmable > buffer_pool->trim_low_water_mark) {
+        /* Decay: free half of what's above the low water mark on each step, without going below the mark */
+        size_t excess = trimmable - buffer_pool->trim_low_water_mark;
+        size_t freed = s_buffer_pool_trim_synced(
+            buffer_pool, aws_max_size(excess / 2, 1), excess, S3_BUFFER_POOL_NO_SIZE_CLASS);
+        has_more_to_trim = freed > 0 && freed < excess;
+
+        AWS_LOGF_TRACE(
+            AWS_LS_S3_CLIENT,
+            "Buffer pool trim step freed %zu out of %zu bytes of unused memory. Low water mark is %zu bytes.",
+            freed,
+            trimmable,
+            buffer_pool->trim_low_water_mark);
+    }
+    aws_mutex_unlock(&buffer_pool->mutex);
+
+    return has_more_to_trim;
+}
+
+/*
+ * Tries to add size to overall_taken without going over the memory limit.
+ * Lock-free, retries if other threads update overall_taken concurrently.
+ */
+static bool s_try_take_memory(struct aws_s3_buffer_pool *buffer_pool, size_t size) {
+    /* Don't let forced buffers account for 100% of the memory limit */
+    const size_t max_impact_of_forced_on_limit =
+        (size_t)(buffer_pool->mem_limit * (s_max_impact_of_forced_buffers_on_memory_limit_as_percentage / 100.0));
+    size_t forced_used = aws_atomic_load_int(&buffer_pool->forced_used);
+    size_t forced_excess =
+        forced_used > max_impact_of_forced_on_limit ? forced_used - max_impact_of_forced_on_limit : 0;
+
+    size_t overall_taken = aws_atomic_load_int(&buffer_pool->overall_taken);
+    do {
+        /* counters are updated independently, so guard against transiently inconsistent values */
+        size_t effective_taken = overall_taken > forced_excess ? overall_taken - forced_excess : 0;
+        if ((size + effective_taken) > buffer_pool->mem_limit) {
+            return false;
+        }
+    } while (!aws_atomic_compare_exchange_int(&buffer_pool->overall_taken, &overall_taken, overall_taken + size));
+
+    return true;
+}
+
+static size_t s_get_size_class(struct aws_s3_buffer_pool *buffer_pool, size_t size);
+
+/*
+ * Returns memory held by the pool, including unused memory in primary and size
+ * classes, and space lost to rounding secondary buffers up to their size class.
+ * Outstanding reservations count as held, since they are allocated on acquire.
+ */
+static size_t s_get_held_memory(struct aws_s3_buffer_pool *buffer_pool) {
+    size_t primary_taken =
+        aws_atomic_load_int(&buffer_pool->primary_used) + aws_atomic_load_int(&buffer_pool->primary_reserved);
+    size_t primary_held = aws_max_size(aws_atomic_load_int(&buffer_pool->primary_allocated), primary_taken);
+    return primary_held + aws_atomic_load_int(&buffer_pool->secondary_used) +
+           aws_atomic_load_int(&buffer_pool->secondary_reserved) +
+           aws_atomic_load_int(&buffer_pool->secondary_rounding) +
+           aws_atomic_load_int(&buffer_pool->secondary_cached);
+}
+
+/*
+ * Unused memory held by primary and size classes, and rounding of secondary
+ * buffers, do not count against the memory limit. If a newly granted
+ * reservation would put memory held by the pool over the limit, trim just
+ * enough unused memory to make room for it before it is acquired.
+ * Primary reservations only trim size classes, empty blocks are about to be
+ * reused by them anyway.
+ */
+static void s_trim_for_reservation(struct aws_s3_buffer_pool *buffer_pool, size_t size) {
+    size_t size_class = s_get_size_class(buffer_pool, size);
+    size_t rounding =
+        size_class == S3_BUFFER_POOL_NO_SIZE_CLASS ? 0 : buffer_pool->size_classes[size_class].buffer_size - size;
+
+    if (s_get_held_memory(buffer_pool) + rounding <= buffer_pool->mem_limit) {
+        return;
+    }
+
+    aws_mutex_lock(&buffer_pool->mutex);
+    /* A buffer kept for reuse in the class turns from cached into used, it is not held twice */
+    size_t reused = 0;
+    if (size_class != S3_BUFFER_POOL_NO_SIZE_CLASS &&
+        aws_array_list_length(&buffer_pool->size_classes[size_class].free_buffers) > 0) {
+        reused = buffer_pool->size_classes[size_class].buffer_size;
+    }
+    size_t held = s_get_held_memory(buffer_pool) + rounding;
+    held = held > reused ? held - reused : 0;
+    if (held > buffer_pool->mem_limit) {
+        size_t excess = held - buffer_pool->mem_limit;
+        size_t freed = size > buffer_pool->primary_size_cutoff
+                           ? s_buffer_pool_trim_synced(buffer_pool, excess, SIZE_MAX, size_class)
+                           : s_trim_size_classes_synced(buffer_pool, excess, SIZE_MAX, S3_BUFFER_POOL_NO_SIZE_CLASS);
+        AWS_LOGF_TRACE(
+            AWS_LS_S3_CLIENT, "Buffer pool trimmed %zu bytes to make room for buffer of size %zu.", freed, size);
+    }
+    aws_mutex_unlock(&buffer_pool->mutex);
+}
+
+/*
+ * Takes memory for a reservation of the given size, without going over the
+ * memory limit. Does not trim, see s_trim_for_reservation().
+ */
+static bool s_try_take_reservation(struct aws_s3_buffer_pool *buffer_pool, size_t size) {
+    if (buffer_pool->provider != NULL) {
+        if (!buffer_pool->provider->reserve(buffer_pool->provider_user_data, size)) {
+            return false;
+        }
+        aws_atomic_fetch_add(&buffer_pool->overall_taken, size);
+        aws_atomic_fetch_add(&buffer_pool->secondary_reserved, size);
+        return true;
+    }
+
+    if (!s_try_take_memory(buffer_pool, size)) {
+        return false;
+    }
+
+    if (size <= buffer_pool->primary_size_cutoff) {
+        aws_atomic_fetch_add(&buffer_pool->primary_reserved, size);
+    } else {
+        aws_atomic_fetch_add(&buffer_pool->secondary_reserved, size);
+    }
+    return true;
+}
+
+/* Creates ticket for memory already taken with s_try_take_reservation(). */
+static struct aws_s3_buffer_pool_ticket *s_new_reserved_ticket(struct aws_s3_buffer_pool *buffer_pool, size_t size) {
+    if (buffer_pool->provider == NULL) {
+        s_trim_for_reservation(buffer_pool, size);
+    }
+
+    struct aws_s3_buffer_pool_ticket *ticket =
+        aws_mem_calloc(buffer_pool->base_allocator, 1, sizeof(struct aws_s3_buffer_pool_ticket));
+    ticket->pool = buffer_pool;
+    ticket->size = size;
+    return ticket;
+}
+
+struct aws_s3_buffer_pool_ticket *aws_s3_buffer_pool_reserve(struct aws_s3_buffer_pool *buffer_pool, size_t size) {
+    AWS_PRECONDITION(buffer_pool);
+
+    if (aws_atomic_load_int(&buffer_pool->has_reservation_hold)) {
+        return NULL;
+    }
+
+    AWS_FATAL_ASSERT(size != 0);
+    AWS_FATAL_ASSERT(size <= buffer_pool->mem_limit);
+
+    /* Don't jump ahead of async reservations waiting for memory */
+    bool reserved =
+        aws_atomic_load_int(&buffer_pool->num_reserve_waiters) == 0 && s_try_take_reservation(buffer_pool, size);
+
+    if (!reserved) {
+        aws_atomic_store_int(&buffer_pool->has_reservation_hold, 1);
+        AWS_LOGF_TRACE(
+            AWS_LS_S3_CLIENT,
+            "Memory limit reached while trying to allocate buffer of size %zu. "
+            "Putting new buffer reservations on hold...",
+            size);
+        aws_raise_error(AWS_ERROR_S3_EXCEEDS_MEMORY_LIMIT);
+        return NULL;
+    }
+
+    return s_new_reserved_ticket(buffer_pool, size);
+}
+
+/*
+ * Hands memory over to waiters at the front of the queue, for as long as
+ * their reservations fit. Memory is taken and futures are completed outside
+ * of the lock, so a provider can take locks of its own (or call
+ * aws_s3_buffer_pool_notify_provider_memory_available()) from reserve.
+ * Only one thread wakes waiters at a time, others just ask it to try again.
+ */
+static void s_wake_reserve_waiters(struct aws_s3_buffer_pool *buffer_pool) {
+    aws_mutex_lock(&buffer_pool->mutex);
+    if (buffer_pool->waking_reserve_waiters) {
+        buffer_pool->wake_reserve_waiters_again = true;
+        aws_mutex_unlock(&buffer_pool->mutex);
+        return;
+    }
+    buffer_pool->waking_reserve_waiters = true;
+
+    while (!aws_linked_list_empty(&buffer_pool->reserve_waiters)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&buffer_pool->reserve_waiters);
+        struct s3_buffer_pool_reserve_waiter *waiter =
+            AWS_CONTAINER_OF(node, struct s3_buffer_pool_reserve_waiter, node);
+        buffer_pool->waiter_being_woken = waiter;
+        buffer_pool->wake_reserve_waiters_again = false;
+        aws_mutex_unlock(&buffer_pool->mutex);
+
+        bool reserved = s_try_take_reservation(buffer_pool, waiter->size);
+        if (reserved) {
+            aws_atomic_fetch_sub(&buffer_pool->num_reserve_waiters, 1);
+            /* If it was cancelled meanwhile, the reservation won the race. Releasing the future releases the ticket. */
+            struct aws_s3_buffer_pool_ticket *ticket = s_new_reserved_ticket(buffer_pool, waiter->size);
+            aws_future_s3_buffer_ticket_set_result_by_move(waiter->future, &ticket);
+            aws_future_s3_buffer_ticket_release(waiter->future);
+            aws_mem_release(buffer_pool->base_allocator, waiter);
+        }
+
+        aws_mutex_lock(&buffer_pool->mutex);
+        buffer_pool->waiter_being_woken = NULL;
+        if (reserved) {
+            continue;
+        }
+
+        if (waiter->cancelled) {
+            aws_atomic_fetch_sub(&buffer_pool->num_reserve_waiters, 1);
+            aws_mutex_unlock(&buffer_pool->mutex);
+            aws_future_s3_buffer_ticket_set_error(waiter->future, AWS_ERROR_S3_CANCELED);
+            aws_future_s3_buffer_ticket_release(waiter->future);
+            aws_mem_release(buffer_pool->base_allocator, waiter);
+            aws_mutex_lock(&buffer_pool->mutex);
+            continue;
+        }
+
+        /* Still first in line. Go again only if memory was released while trying. */
+        aws_linked_list_push_front(&buffer_pool->reserve_waiters, &waiter->node);
+        if (!buffer_pool->wake_reserve_waiters_again) {
+            break;
+        }
+    }
+
+    buffer_pool->waking_reserve_waiters = false;
+    aws_mutex_unlock(&buffer_pool->mutex);
+}
+
+struct aws_future_s3_buffer_ticket *aws_s3_buffer_pool_reserve_async(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t size) {
+    AWS_PRECONDITION(buffer_pool);
+
+    AWS_FATAL_ASSERT(size != 0);
+    AWS_FATAL_ASSERT(size <= buffer_pool->mem_limit);
+
+    struct aws_future_s3_buffer_ticket *future = aws_future_s3_buffer_ticket_new(buffer_pool->base_allocator);
+
+    if (aws_atomic_load_int(&buffer_pool->num_reserve_waiters) == 0 && s_try_take_reservation(buffer_pool, size)) {
+        struct aws_s3_buffer_pool_ticket *ticket = s_new_reserved_ticket(buffer_pool, size);
+        aws_future_s3_buffer_ticket_set_result_by_move(future, &ticket);
+        return future;
+    }
+
+    AWS_LOGF_TRACE(
+        AWS_LS_S3_CLIENT, "Memory limit reached while trying to reserve buffer of size %zu. Waiting in queue...", size);
+
+    struct s3_buffer_pool_reserve_waiter *waiter =
+        aws_mem_calloc(buffer_pool->base_allocator, 1, sizeof(struct s3_buffer_pool_reserve_waiter));
+    waiter->size = size;
+    waiter->future = aws_future_s3_buffer_ticket_acquire(future);
+
+    aws_mutex_lock(&buffer_pool->mutex);
+    aws_linked_list_push_back(&buffer_pool->reserve_waiters, &waiter->node);
+    aws_atomic_fetch_add(&buffer_pool->num_reserve_waiters, 1);
+    aws_mutex_unlock(&buffer_pool->mutex);
+
+    /* Memory might have been released before waiter was queued */
+    s_wake_reserve_waiters(buffer_pool);
+
+    return future;
+}
+
+void aws_s3_buffer_pool_notify_provider_memory_available(struct aws_s3_buffer_pool *buffer_pool) {
+    AWS_PRECONDITION(buffer_pool);
+
+    if (aws_atomic_load_int(&buffer_pool->num_reserve_waiters) > 0) {
+        s_wake_reserve_waiters(buffer_pool);
+    }
+}
+
+void aws_s3_buffer_pool_cancel_reservation(
+    struct aws_s3_buffer_pool *buffer_pool,
+    struct aws_future_s3_buffer_ticket *future) {
+    AWS_PRECONDITION(buffer_pool);
+
+    if (future == NULL) {
+        return;
+    }
+
+    struct s3_buffer_pool_reserve_waiter *cancelled = NULL;
+
+    aws_mutex_lock(&buffer_pool->mutex);
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&buffer_pool->reserve_waiters);
+         node != aws_linked_list_end(&buffer_pool->reserve_waiters);
+         node = aws_linked_list_next(node)) {
+        struct s3_buffer_pool_reserve_waiter *waiter =
+            AWS_CONTAINER_OF(node, struct s3_buffer_pool_reserve_waiter, node);
+        if (waiter->future == future) {
+            aws_linked_list_remove(node);
+            aws_atomic_fetch_sub(&buffer_pool->num_reserve_waiters, 1);
+            cancelled = waiter;
+            break;
+        }
+    }
+    if (cancelled == NULL && buffer_pool->waiter_being_woken != NULL &&
+        buffer_pool->waiter_being_woken->future == future) {
+        /* Waking thread completes it, unless it gets its memory first */
+        buffer_pool->waiter_being_woken->cancelled = true;
+    }
+    aws_mutex_unlock(&buffer_pool->mutex);
+
+    if (cancelled == NULL) {
+        /* Already completed */
+        return;
+    }
+
+    aws_future_s3_buffer_ticket_set_error(cancelled->future, AWS_ERROR_S3_CANCELED);
+    aws_future_s3_buffer_ticket_release(cancelled->future);
+    aws_mem_release(buffer_pool->base_allocator, cancelled);
+
+    /* Waiters behind the cancelled one might fit now */
+    s_wake_reserve_waiters(buffer_pool);
+}
+
+bool aws_s3_buffer_pool_has_reservation_hold(struct aws_s3_buffer_pool *buffer_pool) {
+    AWS_PRECONDITION(buffer_pool);
+    return aws_atomic_load_int(&buffer_pool->has_reservation_hold) != 0;
+}
+
+void aws_s3_buffer_pool_remove_reservation_hold(struct aws_s3_buffer_pool *buffer_pool) {
+    AWS_PRECONDITION(buffer_pool);
+    AWS_LOGF_TRACE(AWS_LS_S3_CLIENT, "Releasing buffer reservation hold.");
+    aws_atomic_store_int(&buffer_pool->has_reservation_hold, 0);
+}
+
+static struct s3_buffer_pool_block *s_primary_new_block_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t numa_node) {
+
+    struct s3_buffer_pool_block *block =
+        aws_mem_calloc(buffer_pool->base_allocator, 1, sizeof(struct s3_buffer_pool_block));
+    block->numa_node = numa_node;
+    s_block_memory_acquire(buffer_pool, block);
+
+    /* Reuse slot of a previously trimmed block if there is one */
+    size_t num_free_indices = aws_array_list_length(&buffer_pool->free_block_indices);
+    if (num_free_indices > 0) {
+        aws_array_list_back(&buffer_pool->free_block_indices, &block->block_index);
+        aws_array_list_pop_back(&buffer_pool->free_block_indices);
+        aws_array_list_set_at(&buffer_pool->blocks, &block, block->block_index);
+    } else {
+        block->block_index = aws_array_list_length(&buffer_pool->blocks);
+        aws_array_list_push_back(&buffer_pool->blocks, &block);
+    }
+
+    ++buffer_pool->num_blocks;
+    buffer_pool->numa_nodes[numa_node].primary_allocated += buffer_pool->block_size;
+    aws_atomic_fetch_add(&buffer_pool->primary_allocated, buffer_pool->block_size);
+
+    return block;
+}
+
+/* Returns first block of the node that has chunks_needed consecutive free chunks, or NULL. */
+static struct s3_buffer_pool_block *s_find_free_run_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t numa_node,
+    size_t chunks_needed) {
+
+    /* Any block on the list has enough consecutive free chunks */
+    struct aws_linked_list *free_run_list = &buffer_pool->numa_nodes[numa_node].free_runs[chunks_needed - 1];
+    if (aws_linked_list_empty(free_run_list)) {
+        return NULL;
+    }
+
+    struct aws_linked_list_node *node = aws_linked_list_front(free_run_list) - (chunks_needed - 1);
+    return AWS_CONTAINER_OF(node, struct s3_buffer_pool_block, free_run_nodes);
+}
+
+static uint8_t *s_primary_acquire_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t numa_node,
+    size_t chunks_needed,
+    size_t *out_block_index,
+    size_t *out_numa_node) {
+
+    AWS_PRECONDITION(chunks_needed >= 1 && chunks_needed <= S3_BUFFER_POOL_MAX_CHUNKS_PER_ACQUIRE);
+
+    struct s3_buffer_pool_block *block = s_find_free_run_synced(buffer_pool, numa_node, chunks_needed);
+
+    /* Rather than growing past the memory limit, take space from other nodes. Remote memory beats no memory. */
+    if (block == NULL &&
+        aws_atomic_load_int(&buffer_pool->primary_allocated) + buffer_pool->block_size > buffer_pool->mem_limit) {
+        for (size_t node_i = 0; node_i < buffer_pool->num_numa_nodes && block == NULL; ++node_i) {
+            block = s_find_free_run_synced(buffer_pool, node_i, chunks_needed);
+        }
+    }
+
+    if (block == NULL) {
+        /* No space available. Allocate new block. */
+        block = s_primary_new_block_synced(buffer_pool, numa_node);
+    }
+
+    uint16_t runs = s_free_runs(block->alloc_bit_mask, chunks_needed);
+    AWS_FATAL_ASSERT(runs != 0);
+    size_t chunk_i = aws_ctz_u32(runs);
+    AWS_ASSERT(!s_check_bits(block->alloc_bit_mask, chunk_i, chunks_needed));
+
+    block->alloc_bit_mask = s_set_bits(block->alloc_bit_mask, chunk_i, chunks_needed);
+    s_block_update_free_runs_synced(buffer_pool, block);
+
+    *out_block_index = block->block_index;
+    *out_numa_node = block->numa_node;
+    return block->block_ptr + chunk_i * buffer_pool->chunk_size;
+}
+
+/* Returns index of the smallest size class that fits size, or S3_BUFFER_POOL_NO_SIZE_CLASS. */
+static size_t s_get_size_class(struct aws_s3_buffer_pool *buffer_pool, size_t size) {
+    if (buffer_pool->num_size_classes == 0 || size <= buffer_pool->primary_size_cutoff) {
+        return S3_BUFFER_POOL_NO_SIZE_CLASS;
+    }
+
+    size_t doubling = 0;
+    size_t base = buffer_pool->primary_size_cutoff;
+    while (size > base * 2) {
+        if (doubling + 1 == S3_BUFFER_POOL_SIZE_CLASS_DOUBLINGS) {
+            return S3_BUFFER_POOL_NO_SIZE_CLASS;
+        }
+        base *= 2;
+        ++doubling;
+    }
+
+    size_t step = (base + S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING - 1) / S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING;
+    size_t step_i = (size - base + step - 1) / step;
+    size_t class_i = doubling * S3_BUFFER_POOL_SIZE_CLASSES_PER_DOUBLING + step_i - 1;
+    if (class_i >= buffer_pool->num_size_classes) {
+        return S3_BUFFER_POOL_NO_SIZE_CLASS;
+    }
+
+    AWS_ASSERT(buffer_pool->size_classes[class_i].buffer_size >= size);
+    return class_i;
+}
+
+/* used_size is how much of the buffer is accounted as used, the rest of it counts as rounding. */
+static uint8_t *s_size_class_acquire_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    struct s3_buffer_pool_size_class *size_class,
+    size_t used_size) {
+
+    aws_atomic_fetch_add(&buffer_pool->secondary_rounding, size_class->buffer_size - used_size);
+
+    uint8_t *buffer = NULL;
+    if (aws_array_list_length(&size_class->free_buffers) > 0) {
+        aws_array_list_back(&size_class->free_buffers, &buffer);
+        aws_array_list_pop_back(&size_class->free_buffers);
+        aws_atomic_fetch_sub(&buffer_pool->secondary_cached, size_class->buffer_size);
+    } else {
+        buffer = s_aligned_mem_acquire(buffer_pool->base_allocator, size_class->buffer_size);
+        ++size_class->num_allocated;
+    }
+    return buffer;
+}
+
+/*
+ * Keeps the buffer for reuse, unless that would put memory kept by the pool over the limit.
+ * used_size is how much of the buffer was accounted as used.
+ */
+static void s_size_class_release_synced(
+    struct aws_s3_buffer_pool *buffer_pool,
+    struct s3_buffer_pool_size_class *size_class,
+    uint8_t *buffer,
+    size_t used_size) {
+
+    aws_atomic_fetch_sub(&buffer_pool->secondary_rounding, size_class->buffer_size - used_size);
+
+    size_t taken_by_others = aws_atomic_load_int(&buffer_pool->overall_taken) - used_size;
+    size_t cached = aws_atomic_load_int(&buffer_pool->secondary_cached);
+    size_t rounding = aws_atomic_load_int(&buffer_pool->secondary_rounding);
+    if (taken_by_others + cached + rounding + size_class->buffer_size <= buffer_pool->mem_limit) {
+        aws_array_list_push_back(&size_class->free_buffers, &buffer);
+        aws_atomic_fetch_add(&buffer_pool->secondary_cached, size_class->buffer_size);
+    } else {
+        s_aligned_mem_release(buffer_pool->base_allocator, buffer);
+        --size_class->num_allocated;
+    }
+}
+
+static struct aws_byte_buf s_acquire_buffer(
+    struct aws_s3_buffer_pool *buffer_pool,
+    struct aws_s3_buffer_pool_ticket *ticket,
+    size_t numa_node);
 
 struct aws_byte_buf aws_s3_buffer_pool_acquire_buffer(
     struct aws_s3_buffer_pool *buffer_pool,
@@ -381,31 +1640,98 @@ struct aws_byte_buf aws_s3_buffer_pool_acquire_buffer(
         return aws_byte_buf_from_empty_array(ticket->ptr, ticket->size);
     }
 
-    aws_mutex_lock(&buffer_pool->mutex);
-    struct aws_byte_buf buf = s_acquire_buffer_synced(buffer_pool, ticket);
-    aws_mutex_unlock(&buffer_pool->mutex);
+    return s_acquire_buffer(buffer_pool, ticket, s_get_current_numa_node(buffer_pool));
+}
 
-    return buf;
+struct aws_byte_buf aws_s3_buffer_pool_acquire_buffer_on_numa_node(
+    struct aws_s3_buffer_pool *buffer_pool,
+    struct aws_s3_buffer_pool_ticket *ticket,
+    size_t numa_node) {
+
+    AWS_PRECONDITION(buffer_pool);
+    AWS_PRECONDITION(ticket);
+
+    if (ticket->ptr != NULL) {
+        return aws_byte_buf_from_empty_array(ticket->ptr, ticket->size);
+    }
+
+    return s_acquire_buffer(buffer_pool, ticket, numa_node % buffer_pool->num_numa_nodes);
 }
 
-static struct aws_byte_buf s_acquire_buffer_synced(
+static struct aws_byte_buf s_acquire_buffer(
     struct aws_s3_buffer_pool *buffer_pool,
-    struct aws_s3_buffer_pool_ticket *ticket) {
+    struct aws_s3_buffer_pool_ticket *ticket,
+    size_t numa_node) {
 
     AWS_PRECONDITION(ticket->ptr == NULL);
 
     if (ticket->size <= buffer_pool->primary_size_cutoff) {
-        ticket->ptr = s_primary_acquire_synced(buffer_pool, ticket);
+        size_t chunks_needed = ticket->size / buffer_pool->chunk_size;
+        if (ticket->size % buffer_pool->chunk_size != 0) {
+            ++chunks_needed; /* round up */
+        }
+        ticket->chunks_used = chunks_needed;
+
+        /* Fast path: take over a chunk cached in this thread's shard */
+        if (chunks_needed == 1) {
+            struct aws_s3_buffer_pool_ticket *cached = s_shard_pop(s_get_shard(buffer_pool, numa_node));
+            if (cached != NULL) {
+                ticket->ptr = cached->ptr;
+                ticket->block_index = cached->block_index;
+                ticket->numa_node = cached->numa_node;
+                aws_mem_release(buffer_pool->base_allocator, cached);
+            }
+        }
+
+        if (ticket->ptr == NULL) {
+            aws_atomic_fetch_add(&buffer_pool->primary_locked_ops, 1);
+            aws_mutex_lock(&buffer_pool->mutex);
+            ticket->ptr = s_primary_acquire_synced(
+                buffer_pool, numa_node, chunks_needed, &ticket->block_index, &ticket->numa_node);
+            aws_mutex_unlock(&buffer_pool->mutex);
+        }
+
+        aws_atomic_fetch_add(&buffer_pool->primary_used, ticket->size);
+
+        /* forced buffers acquire immediately, without reserving first */
+        if (ticket->forced == false) {
+            aws_atomic_fetch_sub(&buffer_pool->primary_reserved, ticket->size);
+        }
     } else {
-        ticket->ptr = aws_mem_acquire(buffer_pool->base_allocator, ticket->size);
-        buffer_pool->secondary_used += ticket->size;
+        ticket->size_class = s_get_size_class(buffer_pool, ticket->size);
+        if (buffer_pool->provider != NULL) {
+            ticket->ptr =
+                buffer_pool->provider->acquire(buffer_pool->provider_user_data, ticket->size, ticket->forced);
+            if (ticket->ptr == NULL) {
+                /* Ticket stays as it was, so releasing it gives back what it holds */
+                AWS_LOGF_ERROR(
+                    AWS_LS_S3_CLIENT, "Buffer provider failed to acquire memory for buffer of size %zu.", ticket->size);
+                aws_raise_error(AWS_ERROR_OOM);
+                struct aws_byte_buf empty_buf;
+                AWS_ZERO_STRUCT(empty_buf);
+                return empty_buf;
+            }
+        } else if (ticket->size_class != S3_BUFFER_POOL_NO_SIZE_CLASS) {
+            aws_mutex_lock(&buffer_pool->mutex);
+            ticket->ptr = s_size_class_acquire_synced(
+                buffer_pool, &buffer_pool->size_classes[ticket->size_class], ticket->size);
+            aws_mutex_unlock(&buffer_pool->mutex);
+        } else {
+            ticket->ptr = s_aligned_mem_acquire(buffer_pool->base_allocator, ticket->size);
+        }
+        aws_atomic_fetch_add(&buffer_pool->secondary_used, ticket->size);
 
         /* forced buffers acquire immediately, without reserving first */
         if (ticket->forced == false) {
-            buffer_pool->secondary_reserved -= ticket->size;
+            aws_atomic_fetch_sub(&buffer_pool->secondary_reserved, ticket->size);
         }
     }
 
+    for (struct aws_s3_buffer_pool_tracker *tracker = ticket->tracker; tracker != NULL; tracker = tracker->parent) {
+        aws_atomic_fetch_sub(&tracker->reserved, ticket->size);
+        aws_atomic_fetch_add(&tracker->used, ticket->size);
+    }
+
     return aws_byte_buf_from_empty_array(ticket->ptr, ticket->size);
 }
 
@@ -419,18 +1745,22 @@ struct aws_byte_buf aws_s3_buffer_pool_acquire_forced_buffer(
 
     AWS_FATAL_ASSERT(size != 0);
 
-    aws_mutex_lock(&buffer_pool->mutex);
-
     struct aws_s3_buffer_pool_ticket *ticket =
         aws_mem_calloc(buffer_pool->base_allocator, 1, sizeof(struct aws_s3_buffer_pool_ticket));
+    ticket->pool = buffer_pool;
     ticket->size = size;
     ticket->forced = true;
 
-    struct aws_byte_buf buf = s_acquire_buffer_synced(buffer_pool, ticket);
+    aws_atomic_fetch_add(&buffer_pool->overall_taken, size);
+    aws_atomic_fetch_add(&buffer_pool->forced_used, size);
 
-    buffer_pool->forced_used += size;
-
-    aws_mutex_unlock(&buffer_pool->mutex);
+    struct aws_byte_buf buf = s_acquire_buffer(buffer_pool, ticket, s_get_current_numa_node(buffer_pool));
+    if (buf.buffer == NULL) {
+        aws_atomic_fetch_sub(&buffer_pool->forced_used, size);
+        aws_atomic_fetch_sub(&buffer_pool->overall_taken, size);
+        aws_mem_release(buffer_pool->base_allocator, ticket);
+        ticket = NULL;
+    }
 
     *out_new_ticket = ticket;
     return buf;
@@ -444,73 +1774,158 @@ void aws_s3_buffer_pool_release_ticket(
         return;
     }
 
+    aws_s3_buffer_pool_ticket_set_tracker(ticket, NULL);
+
     if (ticket->ptr == NULL) {
         /* Ticket was never used, make sure to clean up reserved count. */
-        aws_mutex_lock(&buffer_pool->mutex);
         if (ticket->size <= buffer_pool->primary_size_cutoff) {
-            buffer_pool->primary_reserved -= ticket->size;
+            aws_atomic_fetch_sub(&buffer_pool->primary_reserved, ticket->size);
         } else {
-            buffer_pool->secondary_reserved -= ticket->size;
+            aws_atomic_fetch_sub(&buffer_pool->secondary_reserved, ticket->size);
         }
-        aws_mutex_unlock(&buffer_pool->mutex);
+        if (buffer_pool->provider != NULL) {
+            buffer_pool->provider->release(buffer_pool->provider_user_data, NULL, ticket->size, false);
+        }
+        aws_atomic_fetch_sub(&buffer_pool->overall_taken, ticket->size);
         aws_mem_release(buffer_pool->base_allocator, ticket);
-        return;
+        goto wake_waiters;
     }
 
-    aws_mutex_lock(&buffer_pool->mutex);
-    if (ticket->size <= buffer_pool->primary_size_cutoff) {
+    size_t size = ticket->size;
+    if (ticket->forced) {
+        aws_atomic_fetch_sub(&buffer_pool->forced_used, size);
+    }
 
-        size_t chunks_used = ticket->size / buffer_pool->chunk_size;
-        if (ticket->size % buffer_pool->chunk_size != 0) {
-            ++chunks_used; /* round up */
+    if (size <= buffer_pool->primary_size_cutoff) {
+        /* Fast path: keep the chunk around in this thread's shard. Shard takes over the ticket. */
+        bool cached =
+            ticket->chunks_used == 1 && s_shard_push(s_get_shard(buffer_pool, ticket->numa_node), ticket);
+        if (!cached) {
+            aws_atomic_fetch_add(&buffer_pool->primary_locked_ops, 1);
+            aws_mutex_lock(&buffer_pool->mutex);
+            s_primary_release_synced(buffer_pool, ticket->block_index, ticket->ptr, ticket->chunks_used);
+            aws_mutex_unlock(&buffer_pool->mutex);
+            aws_mem_release(buffer_pool->base_allocator, ticket);
+        }
+        aws_atomic_fetch_sub(&buffer_pool->primary_used, size);
+    } else {
+        if (buffer_pool->provider != NULL) {
+            buffer_pool->provider->release(buffer_pool->provider_user_data, ticket->ptr, size, ticket->forced);
+        } else if (ticket->size_class != S3_BUFFER_POOL_NO_SIZE_CLASS) {
+            aws_mutex_lock(&buffer_pool->mutex);
+            s_size_class_release_synced(
+                buffer_pool, &buffer_pool->size_classes[ticket->size_class], ticket->ptr, size);
+            aws_mutex_unlock(&buffer_pool->mutex);
+        } else {
+            s_aligned_mem_release(buffer_pool->base_allocator, ticket->ptr);
         }
+        aws_mem_release(buffer_pool->base_allocator, ticket);
+        aws_atomic_fetch_sub(&buffer_pool->secondary_used, size);
+    }
 
-        bool found = false;
-        for (size_t i = 0; i < aws_array_list_length(&buffer_pool->blocks); ++i) {
-            struct s3_buffer_pool_block *block;
-            aws_array_list_get_at_ptr(&buffer_pool->blocks, (void **)&block, i);
+    aws_atomic_fetch_sub(&buffer_pool->overall_taken, size);
 
-            if (block->block_ptr <= ticket->ptr && block->block_ptr + block->block_size > ticket->ptr) {
-                size_t alloc_i = (ticket->ptr - block->block_ptr) / buffer_pool->chunk_size;
+wake_waiters:
+    if (aws_atomic_load_int(&buffer_pool->num_reserve_waiters) > 0) {
+        s_wake_reserve_waiters(buffer_pool);
+    }
+}
 
-                block->alloc_bit_mask = s_clear_bits(block->alloc_bit_mask, alloc_i, chunks_used);
-                buffer_pool->primary_used -= ticket->size;
+void aws_s3_buffer_pool_tracker_init(
+    struct aws_s3_buffer_pool_tracker *tracker,
+    struct aws_s3_buffer_pool_tracker *parent) {
+    AWS_PRECONDITION(tracker);
+    aws_atomic_init_int(&tracker->reserved, 0);
+    aws_atomic_init_int(&tracker->used, 0);
+    tracker->parent = parent;
+}
 
-                found = true;
-                break;
-            }
-        }
+void aws_s3_buffer_pool_ticket_set_tracker(
+    struct aws_s3_buffer_pool_ticket *ticket,
+    struct aws_s3_buffer_pool_tracker *tracker) {
+    AWS_PRECONDITION(ticket);
 
-        AWS_FATAL_ASSERT(found);
-    } else {
-        aws_mem_release(buffer_pool->base_allocator, ticket->ptr);
-        buffer_pool->secondary_used -= ticket->size;
+    for (struct aws_s3_buffer_pool_tracker *it = ticket->tracker; it != NULL; it = it->parent) {
+        aws_atomic_fetch_sub(ticket->ptr != NULL ? &it->used : &it->reserved, ticket->size);
     }
 
-    if (ticket->forced) {
-        buffer_pool->forced_used -= ticket->size;
-    }
+    ticket->tracker = tracker;
 
-    aws_mem_release(buffer_pool->base_allocator, ticket);
+    for (struct aws_s3_buffer_pool_tracker *it = tracker; it != NULL; it = it->parent) {
+        aws_atomic_fetch_add(ticket->ptr != NULL ? &it->used : &it->reserved, ticket->size);
+    }
+}
 
-    aws_mutex_unlock(&buffer_pool->mutex);
+size_t aws_s3_buffer_pool_ticket_get_size(const struct aws_s3_buffer_pool_ticket *ticket) {
+    AWS_PRECONDITION(ticket);
+    return ticket->size;
 }
 
 struct aws_s3_buffer_pool_usage_stats aws_s3_buffer_pool_get_usage(struct aws_s3_buffer_pool *buffer_pool) {
     aws_mutex_lock(&buffer_pool->mutex);
+    size_t primary_num_blocks = buffer_pool->num_blocks;
+    size_t primary_hugetlb_allocated = buffer_pool->primary_hugetlb_allocated;
+    size_t primary_thp_allocated = buffer_pool->primary_thp_allocated;
+    size_t primary_prefaulted = buffer_pool->primary_prefaulted;
+    aws_mutex_unlock(&buffer_pool->mutex);
 
-    struct aws_s3_buffer_pool_usage_stats ret = (struct aws_s3_buffer_pool_usage_stats){
+    size_t provider_allocated = 0;
+    if (buffer_pool->provider != NULL && buffer_pool->provider->get_usage != NULL) {
+        struct aws_s3_buffer_provider_usage usage = buffer_pool->provider->get_usage(buffer_pool->provider_user_data);
+        provider_allocated = (size_t)aws_min_u64(usage.allocated, SIZE_MAX);
+    }
+
+    return (struct aws_s3_buffer_pool_usage_stats){
         .mem_limit = buffer_pool->mem_limit,
         .primary_cutoff = buffer_pool->primary_size_cutoff,
-        .primary_allocated = buffer_pool->primary_allocated,
-        .primary_used = buffer_pool->primary_used,
-        .primary_reserved = buffer_pool->primary_reserved,
-        .primary_num_blocks = aws_array_list_length(&buffer_pool->blocks),
-        .secondary_used = buffer_pool->secondary_used,
-        .secondary_reserved = buffer_pool->secondary_reserved,
-        .forced_used = buffer_pool->forced_used,
+        .primary_allocated = aws_atomic_load_int(&buffer_pool->primary_allocated),
+        .primary_used = aws_atomic_load_int(&buffer_pool->primary_used),
+        .primary_locked_ops = aws_atomic_load_int(&buffer_pool->primary_locked_ops),
+        .primary_reserved = aws_atomic_load_int(&buffer_pool->primary_reserved),
+        .primary_num_blocks = primary_num_blocks,
+        .secondary_used = aws_atomic_load_int(&buffer_pool->secondary_used),
+        .secondary_reserved = aws_atomic_load_int(&buffer_pool->secondary_reserved),
+        .secondary_cached = aws_atomic_load_int(&buffer_pool->secondary_cached),
+        .num_size_classes = buffer_pool->num_size_classes,
+        .forced_used = aws_atomic_load_int(&buffer_pool->forced_used),
+        .primary_hugetlb_allocated = primary_hugetlb_allocated,
+        .primary_thp_allocated = primary_thp_allocated,
+        .primary_prefaulted = primary_prefaulted,
+        .num_numa_nodes = buffer_pool->num_numa_nodes,
+        .provider_allocated = provider_allocated,
     };
+}
+
+struct aws_s3_buffer_pool_size_class_usage aws_s3_buffer_pool_get_size_class_usage(
+    struct aws_s3_buffer_pool *buffer_pool,
+    size_t size_class_index) {
+
+    AWS_PRECONDITION(buffer_pool);
+
+    struct aws_s3_buffer_pool_size_class_usage usage;
+    AWS_ZERO_STRUCT(usage);
+    if (size_class_index >= buffer_pool->num_size_classes) {
+        return usage;
+    }
+
+    struct s3_buffer_pool_size_class *size_class = &buffer_pool->size_classes[size_class_index];
+    aws_mutex_lock(&buffer_pool->mutex);
+    usage.buffer_size = size_class->buffer_size;
+    usage.allocated = size_class->num_allocated * size_class->buffer_size;
+    usage.cached = aws_array_list_length(&size_class->free_buffers) * size_class->buffer_size;
+    aws_mutex_unlock(&buffer_pool->mutex);
+    return usage;
+}
 
+size_t aws_s3_buffer_pool_get_numa_node_allocated(struct aws_s3_buffer_pool *buffer_pool, size_t numa_node) {
+    AWS_PRECONDITION(buffer_pool);
+
+    if (numa_node >= buffer_pool->num_numa_nodes) {
+        return 0;
+    }
+
+    aws_mutex_lock(&buffer_pool->mutex);
+    size_t allocated = buffer_pool->numa_nodes[numa_node].primary_allocated;
     aws_mutex_unlock(&buffer_pool->mutex);
-    return ret;
+    return allocated;
 }
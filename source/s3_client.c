@@ -10,6 +10,7 @@
 #include "aws/s3/private/s3_copy_object.h"
 #include "aws/s3/private/s3_default_meta_request.h"
 #include "aws/s3/private/s3_meta_request_impl.h"
+#include "aws/s3/private/s3_object_metadata_cache.h"
 #include "aws/s3/private/s3_parallel_input_stream.h"
 #include "aws/s3/private/s3_request_messages.h"
 #include "aws/s3/private/s3_util.h"
@@ -99,6 +100,7 @@ static void s_s3_client_finish_destroy_default(struct aws_s3_client *client);
 
 /* Called when the body streaming elg shutdown has completed. */
 static void s_s3_client_body_streaming_elg_shutdown(void *user_data);
+static void s_s3_client_file_io_elg_shutdown(void *user_data);
 
 static void s_s3_client_create_connection_for_request(struct aws_s3_client *client, struct aws_s3_request *request);
 
@@ -127,6 +129,8 @@ static void s_s3_client_process_work_default(struct aws_s3_client *client);
 
 static void s_s3_client_endpoint_shutdown_callback(struct aws_s3_client *client);
 
+static void s_s3_client_schedule_buffer_pool_trim_synced(struct aws_s3_client *client);
+
 /* Default factory function for creating a meta request. */
 static struct aws_s3_meta_request *s_s3_client_meta_request_factory_default(
     struct aws_s3_client *client,
@@ -242,6 +246,72 @@ struct aws_s3express_credentials_provider *s_s3express_provider_default_factory(
     return s3express_provider;
 }
 
+static size_t s_get_default_memory_limit(double throughput_target_gbps) {
+#if SIZE_BITS == 32
+    if (throughput_target_gbps > 25.0) {
+        return GB_TO_BYTES(2);
+    } else {
+        return GB_TO_BYTES(1);
+    }
+#else
+    if (throughput_target_gbps > 75.0) {
+        return GB_TO_BYTES(8);
+    } else if (throughput_target_gbps > 25.0) {
+        return GB_TO_BYTES(4);
+    } else {
+        return GB_TO_BYTES(2);
+    }
+#endif
+}
+
+static struct aws_s3_buffer_pool *s_s3_buffer_pool_new(
+    struct aws_allocator *allocator,
+    size_t part_size,
+    size_t mem_limit,
+    const struct aws_s3_buffer_pool_memory_options *memory_options) {
+
+    struct aws_s3_buffer_pool_options buffer_pool_options = {
+        .chunk_size = part_size,
+        .mem_limit = mem_limit,
+    };
+    if (memory_options != NULL) {
+        buffer_pool_options.memory_backing = memory_options->backing;
+        buffer_pool_options.prefault_size = (size_t)aws_min_u64(memory_options->prefault_size_in_bytes, SIZE_MAX);
+        buffer_pool_options.trim_low_water_mark =
+            (size_t)aws_min_u64(memory_options->trim_low_water_mark_in_bytes, SIZE_MAX);
+
+        if (memory_options->numa_local_buffers) {
+            const struct aws_s3_platform_info *platform_info = aws_s3_get_current_platform_info();
+            buffer_pool_options.num_numa_nodes = platform_info->cpu_group_info_array_length;
+            AWS_LOGF_INFO(
+                AWS_LS_S3_CLIENT,
+                "Splitting buffer pool across %zu NUMA nodes.",
+                buffer_pool_options.num_numa_nodes);
+        }
+    }
+
+    return aws_s3_buffer_pool_new_with_options(allocator, &buffer_pool_options);
+}
+
+struct aws_s3_buffer_pool *aws_s3_shared_buffer_pool_new(
+    struct aws_allocator *allocator,
+    const struct aws_s3_shared_buffer_pool_options *options) {
+    AWS_PRECONDITION(allocator);
+    AWS_PRECONDITION(options);
+
+    size_t part_size = s_default_part_size;
+    if (options->part_size != 0) {
+        part_size = (size_t)aws_min_u64(options->part_size, SIZE_MAX);
+    }
+
+    size_t mem_limit = s_get_default_memory_limit(0.0);
+    if (options->memory_limit_in_bytes != 0) {
+        mem_limit = (size_t)aws_min_u64(options->memory_limit_in_bytes, SIZE_MAX);
+    }
+
+    return s_s3_buffer_pool_new(allocator, part_size, mem_limit, options->memory_options);
+}
+
 struct aws_s3_client *aws_s3_client_new(
     struct aws_allocator *allocator,
     const struct aws_s3_client_config *client_config) {
@@ -293,6 +363,16 @@ struct aws_s3_client *aws_s3_client_new(
         return NULL;
     }
 
+    if (client_config->get_hedge_options != NULL &&
+        (client_config->get_hedge_options->percentile > 99 || client_config->get_hedge_options->budget_percent > 100)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_CLIENT,
+            "Cannot create client from client_config; get_hedge_options percentile must be at most 99, and "
+            "budget_percent at most 100.");
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
 #ifdef BYO_CRYPTO
     if (client_config->tls_mode == AWS_MR_TLS_ENABLED && client_config->tls_connection_options == NULL) {
         AWS_LOGF_ERROR(
@@ -308,24 +388,17 @@ struct aws_s3_client *aws_s3_client_new(
 
     client->allocator = allocator;
 
-    size_t mem_limit = 0;
-    if (client_config->memory_limit_in_bytes == 0) {
-#if SIZE_BITS == 32
-        if (client_config->throughput_target_gbps > 25.0) {
-            mem_limit = GB_TO_BYTES(2);
-        } else {
-            mem_limit = GB_TO_BYTES(1);
-        }
-#else
-        if (client_config->throughput_target_gbps > 75.0) {
-            mem_limit = GB_TO_BYTES(8);
-        } else if (client_config->throughput_target_gbps > 25.0) {
-            mem_limit = GB_TO_BYTES(4);
+    size_t part_size = s_default_part_size;
+    if (client_config->part_size != 0) {
+        if (client_config->part_size > SIZE_MAX) {
+            part_size = SIZE_MAX;
         } else {
-            mem_limit = GB_TO_BYTES(2);
+            part_size = (size_t)client_config->part_size;
         }
-#endif
-    } else {
+    }
+
+    size_t mem_limit = 0;
+    if (client_config->memory_limit_in_bytes != 0) {
         // cap memory limit to SIZE_MAX
         if (client_config->memory_limit_in_bytes > SIZE_MAX) {
             mem_limit = SIZE_MAX;
@@ -334,20 +407,23 @@ struct aws_s3_client *aws_s3_client_new(
         }
     }
 
-    size_t part_size = s_default_part_size;
-    if (client_config->part_size != 0) {
-        if (client_config->part_size > SIZE_MAX) {
-            part_size = SIZE_MAX;
-        } else {
-            part_size = (size_t)client_config->part_size;
+    if (client_config->buffer_pool != NULL) {
+        /* Memory limit is optional with a shared pool, and only limits this client's share of it */
+        client->buffer_pool = aws_s3_buffer_pool_acquire(client_config->buffer_pool);
+        *((bool *)&client->shares_buffer_pool) = true;
+        *((size_t *)&client->memory_limit) = mem_limit;
+    } else {
+        if (mem_limit == 0) {
+            mem_limit = s_get_default_memory_limit(client_config->throughput_target_gbps);
         }
-    }
+        client->buffer_pool =
+            s_s3_buffer_pool_new(allocator, part_size, mem_limit, client_config->buffer_pool_memory_options);
 
-    client->buffer_pool = aws_s3_buffer_pool_new(allocator, part_size, mem_limit);
-
-    if (client->buffer_pool == NULL) {
-        goto on_early_fail;
+        if (client->buffer_pool == NULL) {
+            goto on_early_fail;
+        }
     }
+    aws_s3_buffer_pool_tracker_init(&client->memory_usage, NULL);
 
     struct aws_s3_buffer_pool_usage_stats pool_usage = aws_s3_buffer_pool_get_usage(client->buffer_pool);
 
@@ -413,6 +489,11 @@ struct aws_s3_client *aws_s3_client_new(
         *((uint64_t *)&client->max_part_size) = SIZE_MAX;
     }
 
+    for (uint32_t i = 0; i < (uint32_t)AWS_S3_META_REQUEST_TYPE_MAX; ++i) {
+        client->meta_request_memory_limits[i] =
+            (size_t)aws_min_u64(client_config->meta_request_memory_limits_in_bytes[i], SIZE_MAX);
+    }
+
     if (client_config->multipart_upload_threshold != 0) {
         *((uint64_t *)&client->multipart_upload_threshold) = client_config->multipart_upload_threshold;
     } else {
@@ -512,6 +593,9 @@ struct aws_s3_client *aws_s3_client_new(
         }
         client->synced_data.body_streaming_elg_allocated = true;
     }
+
+    /* File I/O ELG is created by the first meta request that sends a file, see aws_s3_client_get_file_io_elg() */
+
     /* Setup cannot fail after this point. */
 
     if (client_config->throughput_target_gbps > 0.0) {
@@ -578,6 +662,23 @@ struct aws_s3_client *aws_s3_client_new(
 
     *((bool *)&client->enable_read_backpressure) = client_config->enable_read_backpressure;
     *((size_t *)&client->initial_read_window) = client_config->initial_read_window;
+    *((uint32_t *)&client->num_speculative_get_parts) = client_config->num_speculative_get_parts;
+    if (client_config->get_hedge_options != NULL) {
+        client->get_hedge_options = *client_config->get_hedge_options;
+        if (client->get_hedge_options.percentile == 0) {
+            client->get_hedge_options.percentile = 95;
+        }
+        if (client->get_hedge_options.budget_percent == 0) {
+            client->get_hedge_options.budget_percent = 5;
+        }
+    }
+    *((size_t *)&client->get_tail_min_part_size) = client_config->get_tail_min_part_size;
+
+    client->block_cache = aws_s3_block_cache_acquire(client_config->block_cache);
+    if (client_config->object_metadata_cache_size > 0) {
+        client->object_metadata_cache =
+            aws_s3_object_metadata_cache_new(allocator, client_config->object_metadata_cache_size);
+    }
 
     client->num_network_interface_names = client_config->num_network_interface_names;
     if (client_config->num_network_interface_names > 0) {
@@ -632,6 +733,8 @@ on_error:
     aws_client_bootstrap_release(client->client_bootstrap);
     aws_mutex_clean_up(&client->synced_data.lock);
 on_early_fail:
+    /* Pool might be shared with other clients, only drop the reference taken above */
+    aws_s3_buffer_pool_release(client->buffer_pool);
     aws_mem_release(client->allocator, client);
     return NULL;
 }
@@ -679,6 +782,9 @@ static void s_s3_client_start_destroy(void *user_data) {
 
     aws_event_loop_group_release(client->body_streaming_elg);
     client->body_streaming_elg = NULL;
+    aws_event_loop_group_release(client->file_io_elg);
+    client->file_io_elg = NULL;
+    client->io_uring = aws_s3_io_uring_release(client->io_uring);
     aws_s3express_credentials_provider_release(client->s3express_provider);
 
     /* BEGIN CRITICAL SECTION */
@@ -740,7 +846,9 @@ static void s_s3_client_finish_destroy_default(struct aws_s3_client *client) {
     aws_s3_client_shutdown_complete_callback_fn *shutdown_callback = client->shutdown_callback;
     void *shutdown_user_data = client->shutdown_callback_user_data;
 
-    aws_s3_buffer_pool_destroy(client->buffer_pool);
+    aws_s3_buffer_pool_release(client->buffer_pool);
+    aws_s3_block_cache_release(client->block_cache);
+    aws_s3_object_metadata_cache_destroy(client->object_metadata_cache);
 
     aws_mem_release(client->allocator, client->network_interface_names_cursor_array);
     for (size_t i = 0; i < client->num_network_interface_names; i++) {
@@ -774,6 +882,22 @@ static void s_s3_client_body_streaming_elg_shutdown(void *user_data) {
     /* END CRITICAL SECTION */
 }
 
+static void s_s3_client_file_io_elg_shutdown(void *user_data) {
+    struct aws_s3_client *client = user_data;
+    AWS_PRECONDITION(client);
+
+    AWS_LOGF_DEBUG(AWS_LS_S3_CLIENT, "id=%p Client file I/O ELG shutdown.", (void *)client);
+
+    /* BEGIN CRITICAL SECTION */
+    {
+        aws_s3_client_lock_synced_data(client);
+        client->synced_data.file_io_elg_allocated = false;
+        s_s3_client_schedule_process_work_synced(client);
+        aws_s3_client_unlock_synced_data(client);
+    }
+    /* END CRITICAL SECTION */
+}
+
 uint32_t aws_s3_client_queue_requests_threaded(
     struct aws_s3_client *client,
     struct aws_linked_list *request_list,
@@ -866,6 +990,22 @@ int s_apply_endpoint_override(
 }
 
 /* Public facing make-meta-request function. */
+struct aws_s3_client_memory_usage aws_s3_client_get_memory_usage(struct aws_s3_client *client) {
+    AWS_PRECONDITION(client);
+
+    struct aws_s3_buffer_pool_usage_stats pool_usage = aws_s3_buffer_pool_get_usage(client->buffer_pool);
+
+    struct aws_s3_client_memory_usage usage = {
+        .reserved = aws_atomic_load_int(&client->memory_usage.reserved),
+        .used = aws_atomic_load_int(&client->memory_usage.used),
+        .limit = client->memory_limit,
+        .pool_memory_limit = pool_usage.mem_limit,
+        .pool_reserved = pool_usage.primary_reserved + pool_usage.secondary_reserved,
+        .pool_used = pool_usage.primary_used + pool_usage.secondary_used,
+    };
+    return usage;
+}
+
 struct aws_s3_meta_request *aws_s3_client_make_meta_request(
     struct aws_s3_client *client,
     const struct aws_s3_meta_request_options *options) {
@@ -1175,6 +1315,10 @@ static struct aws_s3_meta_request *s_s3_client_meta_request_factory_default(
             return NULL;
         }
         content_length_found = true;
+    } else if (options->send_buffer.ptr != NULL) {
+        /* The length of the caller's memory is the length of the body */
+        content_length = options->send_buffer.len;
+        content_length_found = true;
     }
 
     /* There are multiple ways to pass the body in, ensure only 1 was used */
@@ -1185,6 +1329,9 @@ static struct aws_s3_meta_request *s_s3_client_meta_request_factory_default(
     if (options->send_filepath.len > 0) {
         ++body_source_count;
     }
+    if (options->send_buffer.ptr != NULL) {
+        ++body_source_count;
+    }
     if (options->send_using_async_writes == true) {
         if (options->type != AWS_S3_META_REQUEST_TYPE_PUT_OBJECT) {
             /* TODO: we could support async-writes for DEFAULT type too, just takes work & testing */
@@ -1213,10 +1360,75 @@ static struct aws_s3_meta_request *s_s3_client_meta_request_factory_default(
         AWS_LOGF_ERROR(
             AWS_LS_S3_META_REQUEST,
             "Could not create meta request."
-            " More than one data source is set (filepath, async stream, body stream, data writes).");
+            " More than one data source is set (filepath, buffer, async stream, body stream, data writes).");
         aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
         return NULL;
     }
+    if (options->receive_buffer_callback != NULL) {
+        if (options->type != AWS_S3_META_REQUEST_TYPE_GET_OBJECT) {
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_META_REQUEST,
+                "Could not create meta request."
+                " receive-buffer-callback can only be used with auto-ranged-get.");
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            return NULL;
+        }
+        if (options->checksum_config != NULL && options->checksum_config->validate_response_checksum) {
+            /* Validating the checksum of the whole object needs its body delivered in order */
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_META_REQUEST,
+                "Could not create meta request."
+                " receive-buffer-callback cannot be used with response checksum validation.");
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            return NULL;
+        }
+    }
+    if (options->out_of_order_body_callback) {
+        if (options->type != AWS_S3_META_REQUEST_TYPE_GET_OBJECT) {
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_META_REQUEST,
+                "Could not create meta request."
+                " out-of-order-body-callback can only be used with auto-ranged-get.");
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            return NULL;
+        }
+        if (options->checksum_config != NULL && options->checksum_config->validate_response_checksum) {
+            /* Validating the checksum of the whole object needs its body delivered in order */
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_META_REQUEST,
+                "Could not create meta request."
+                " out-of-order-body-callback cannot be used with response checksum validation.");
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            return NULL;
+        }
+    }
+    if (options->recv_filepath.len > 0) {
+        if (options->type != AWS_S3_META_REQUEST_TYPE_GET_OBJECT) {
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_META_REQUEST,
+                "Could not create meta request."
+                " recv-filepath can only be used with auto-ranged-get.");
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            return NULL;
+        }
+        if (options->checksum_config != NULL && options->checksum_config->validate_response_checksum) {
+            /* Validating the checksum of the whole object needs its body delivered in order */
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_META_REQUEST,
+                "Could not create meta request."
+                " recv-filepath cannot be used with response checksum validation.");
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            return NULL;
+        }
+        if (options->receive_buffer_callback != NULL) {
+            AWS_LOGF_ERROR(
+                AWS_LS_S3_META_REQUEST,
+                "Could not create meta request."
+                " More than one destination is set (recv-filepath, receive-buffer-callback).");
+            aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            return NULL;
+        }
+    }
     size_t part_size = client->part_size;
     if (options->part_size != 0) {
         if (options->part_size > SIZE_MAX) {
@@ -1246,6 +1458,14 @@ static struct aws_s3_meta_request *s_s3_client_meta_request_factory_default(
                     struct aws_byte_cursor part_number_query_str = aws_byte_cursor_from_c_str("partNumber");
                     while (aws_query_string_next_param(sub_string, &param)) {
                         if (aws_byte_cursor_eq(&param.key, &part_number_query_str)) {
+                            if (options->receive_buffer_callback != NULL || options->recv_filepath.len > 0) {
+                                AWS_LOGF_ERROR(
+                                    AWS_LS_S3_META_REQUEST,
+                                    "Could not create meta request."
+                                    " receive-buffer-callback and recv-filepath cannot be used to get a single part.");
+                                aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+                                return NULL;
+                            }
                             return aws_s3_meta_request_default_new(
                                 client->allocator,
                                 client,
@@ -1264,7 +1484,7 @@ static struct aws_s3_meta_request *s_s3_client_meta_request_factory_default(
                 AWS_LOGF_ERROR(
                     AWS_LS_S3_META_REQUEST,
                     "Could not create auto-ranged-put meta request."
-                    " Body must be set via filepath, async stream, or body stream.");
+                    " Body must be set via filepath, buffer, async stream, or body stream.");
                 aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
                 return NULL;
             }
@@ -1440,8 +1660,22 @@ static void s_s3_client_trim_buffer_pool_task(struct aws_task *task, void *arg,
 
     uint32_t num_reqs_in_flight = (uint32_t)aws_atomic_load_int(&client->stats.num_requests_in_flight);
 
-    if (num_reqs_in_flight == 0) {
-        aws_s3_buffer_pool_trim(client->buffer_pool);
+    bool idle = num_reqs_in_flight == 0;
+    if (idle && client->shares_buffer_pool) {
+        /* Other clients might still be using the pool */
+        struct aws_s3_buffer_pool_usage_stats pool_usage = aws_s3_buffer_pool_get_usage(client->buffer_pool);
+        size_t pool_taken = pool_usage.primary_used + pool_usage.primary_reserved + pool_usage.secondary_used +
+                            pool_usage.secondary_reserved;
+        idle = pool_taken == 0;
+    }
+
+    if (idle && aws_s3_buffer_pool_trim_step(client->buffer_pool)) {
+        /* Keep decaying unused memory while client stays idle */
+        aws_s3_client_lock_synced_data(client);
+        if (client->synced_data.active) {
+            s_s3_client_schedule_buffer_pool_trim_synced(client);
+        }
+        aws_s3_client_unlock_synced_data(client);
     }
 }
 
@@ -1527,6 +1761,88 @@ static void s_s3_client_schedule_endpoints_cleanup_synced(struct aws_s3_client *
             aws_timestamp_convert(s_endpoints_cleanup_time_offset_in_s, AWS_TIMESTAMP_SECS, AWS_TIMESTAMP_NANOS, NULL));
 }
 
+struct aws_event_loop_group *aws_s3_client_get_file_io_elg(struct aws_s3_client *client) {
+    AWS_PRECONDITION(client);
+
+    struct aws_event_loop_group *file_io_elg = NULL;
+
+    /* BEGIN CRITICAL SECTION */
+    {
+        aws_s3_client_lock_synced_data(client);
+
+        if (client->file_io_elg == NULL) {
+            uint16_t num_file_io_threads = 1;
+            if (client->client_bootstrap != NULL) {
+                num_file_io_threads =
+                    (uint16_t)aws_array_list_length(&client->client_bootstrap->event_loop_group->event_loops);
+            }
+
+            if (num_file_io_threads < 1) {
+                num_file_io_threads = 1;
+            }
+
+            struct aws_shutdown_callback_options file_io_elg_shutdown_options = {
+                .shutdown_callback_fn = s_s3_client_file_io_elg_shutdown,
+                .shutdown_callback_user_data = client,
+            };
+
+            client->file_io_elg = aws_event_loop_group_new_default(
+                client->allocator, num_file_io_threads, &file_io_elg_shutdown_options);
+
+            if (client->file_io_elg != NULL) {
+                client->synced_data.file_io_elg_allocated = true;
+            } else {
+                /* Not worth failing the meta request for, files are then read on the thread asking for the data */
+                AWS_LOGF_WARN(
+                    AWS_LS_S3_CLIENT,
+                    "id=%p Could not create file I/O ELG due to error %d (%s), reading files on the calling thread",
+                    (void *)client,
+                    aws_last_error_or_unknown(),
+                    aws_error_str(aws_last_error_or_unknown()));
+            }
+        }
+        file_io_elg = client->file_io_elg;
+
+        aws_s3_client_unlock_synced_data(client);
+    }
+    /* END CRITICAL SECTION */
+
+    return file_io_elg;
+}
+
+struct aws_s3_io_uring *aws_s3_client_get_io_uring(struct aws_s3_client *client) {
+    AWS_PRECONDITION(client);
+
+    struct aws_s3_io_uring *io_uring = NULL;
+
+    /* BEGIN CRITICAL SECTION */
+    {
+        aws_s3_client_lock_synced_data(client);
+
+        if (client->io_uring == NULL && !client->synced_data.io_uring_unavailable) {
+            client->io_uring = aws_s3_io_uring_new(client->allocator);
+            if (client->io_uring == NULL) {
+                AWS_LOGF_DEBUG(
+                    AWS_LS_S3_CLIENT,
+                    "id=%p Could not create io_uring ring due to error %d (%s)",
+                    (void *)client,
+                    aws_last_error_or_unknown(),
+                    aws_error_str(aws_last_error_or_unknown()));
+                client->synced_data.io_uring_unavailable = true;
+            }
+        }
+        io_uring = client->io_uring;
+
+        aws_s3_client_unlock_synced_data(client);
+    }
+    /* END CRITICAL SECTION */
+
+    if (io_uring == NULL) {
+        aws_raise_error(AWS_ERROR_PLATFORM_NOT_SUPPORTED);
+    }
+    return io_uring;
+}
+
 void aws_s3_client_schedule_process_work(struct aws_s3_client *client) {
     AWS_PRECONDITION(client);
 
@@ -1737,6 +2053,7 @@ static void s_s3_client_process_work_default(struct aws_s3_client *client) {
         bool finish_destroy =
             client->synced_data.active == false && client->synced_data.start_destroy_executing == false &&
             client->synced_data.body_streaming_elg_allocated == false &&
+            client->synced_data.file_io_elg_allocated == false &&
             client->synced_data.process_work_task_scheduled == false &&
             client->synced_data.process_work_task_in_progress == false &&
             client->synced_data.s3express_provider_active == false && client->synced_data.num_endpoints_allocated == 0;
@@ -1747,11 +2064,12 @@ static void s_s3_client_process_work_default(struct aws_s3_client *client) {
             AWS_LOGF_DEBUG(
                 AWS_LS_S3_CLIENT,
                 "id=%p Client shutdown progress: starting_destroy_executing=%d  body_streaming_elg_allocated=%d  "
-                "process_work_task_scheduled=%d  process_work_task_in_progress=%d  num_endpoints_allocated=%d "
-                "s3express_provider_active=%d finish_destroy=%d",
+                "file_io_elg_allocated=%d  process_work_task_scheduled=%d  process_work_task_in_progress=%d  "
+                "num_endpoints_allocated=%d s3express_provider_active=%d finish_destroy=%d",
                 (void *)client,
                 (int)client->synced_data.start_destroy_executing,
                 (int)client->synced_data.body_streaming_elg_allocated,
+                (int)client->synced_data.file_io_elg_allocated,
                 (int)client->synced_data.process_work_task_scheduled,
                 (int)client->synced_data.process_work_task_in_progress,
                 (int)client->synced_data.num_endpoints_allocated,
@@ -1840,8 +2158,6 @@ void aws_s3_client_update_meta_requests_threaded(struct aws_s3_client *client) {
 
     const uint32_t num_passes = AWS_ARRAY_SIZE(pass_flags);
 
-    aws_s3_buffer_pool_remove_reservation_hold(client->buffer_pool);
-
     for (uint32_t pass_index = 0; pass_index < num_passes; ++pass_index) {
 
         /**
@@ -1,6 +1,7 @@
 #include "aws/s3/private/s3_default_meta_request.h"
 #include "aws/s3/private/s3_client_impl.h"
 #include "aws/s3/private/s3_meta_request_impl.h"
+#include "aws/s3/private/s3_parallel_input_stream.h"
 #include "aws/s3/private/s3_request_messages.h"
 #include "aws/s3/private/s3_util.h"
 #include <aws/common/string.h>
@@ -274,7 +275,26 @@ static struct aws_future_void *s_s3_default_prepare_request(struct aws_s3_reques
     request_prep->request = request;
     request_prep->on_complete = aws_future_void_acquire(asyncstep_prepare_request);
 
-    if (meta_request_default->content_length > 0 && request->num_times_prepared == 0) {
+    if (meta_request_default->content_length > 0 && request->num_times_prepared == 0 &&
+        meta_request->request_body_parallel_stream != NULL &&
+        aws_parallel_input_stream_is_mapped(meta_request->request_body_parallel_stream)) {
+        /* Point the body into the memory instead of copying it.
+         * The buffer doesn't own the memory, so cleaning it up leaves the memory alone. */
+        struct aws_byte_cursor range;
+        AWS_ZERO_STRUCT(range);
+        request_prep->step1_read_body = aws_future_bool_new(request->allocator);
+        if (aws_parallel_input_stream_get_mapped_range(
+                meta_request->request_body_parallel_stream, 0, meta_request_default->content_length, &range)) {
+            aws_future_bool_set_error(request_prep->step1_read_body, aws_last_error());
+        } else if (range.len < meta_request_default->content_length) {
+            aws_future_bool_set_error(request_prep->step1_read_body, AWS_ERROR_S3_INCORRECT_CONTENT_LENGTH);
+        } else {
+            request->request_body = aws_byte_buf_from_array(range.ptr, range.len);
+            aws_future_bool_set_result(request_prep->step1_read_body, false);
+        }
+        aws_future_bool_register_callback(
+            request_prep->step1_read_body, s_s3_default_prepare_request_on_read_done, request_prep);
+    } else if (meta_request_default->content_length > 0 && request->num_times_prepared == 0) {
         aws_byte_buf_init(&request->request_body, meta_request->allocator, meta_request_default->content_length);
 
         /* Kick off the async read */
@@ -9,6 +9,7 @@
 #include "aws/s3/private/s3_client_impl.h"
 #include "aws/s3/private/s3_meta_request_impl.h"
 #include "aws/s3/private/s3_parallel_input_stream.h"
+#include "aws/s3/private/s3_parallel_output_stream.h"
 #include "aws/s3/private/s3_request_messages.h"
 #include "aws/s3/private/s3_util.h"
 #include "aws/s3/s3express_credentials_provider.h"
@@ -253,6 +254,7 @@ int aws_s3_meta_request_init_base(
 
     *((size_t *)&meta_request->part_size) = part_size;
     *((bool *)&meta_request->should_compute_content_md5) = should_compute_content_md5;
+    aws_s3_buffer_pool_tracker_init(&meta_request->memory_usage, client != NULL ? &client->memory_usage : NULL);
     checksum_config_init(&meta_request->checksum_config, options->checksum_config);
 
     if (options->signing_config) {
@@ -264,6 +266,12 @@ int aws_s3_meta_request_init_base(
         meta_request->client = aws_s3_client_acquire(client);
         meta_request->io_event_loop = aws_event_loop_group_get_next_loop(client->body_streaming_elg);
         meta_request->synced_data.read_window_running_total = client->initial_read_window;
+
+        size_t memory_limit = (size_t)aws_min_u64(options->memory_limit_in_bytes, SIZE_MAX);
+        if (memory_limit == 0 && options->type < AWS_S3_META_REQUEST_TYPE_MAX) {
+            memory_limit = client->meta_request_memory_limits[options->type];
+        }
+        *((size_t *)&meta_request->memory_limit) = memory_limit;
     }
 
     /* Keep original message around, for headers, method, and synchronous body-stream (if any) */
@@ -273,12 +281,51 @@ int aws_s3_meta_request_init_base(
      * (we checked earlier that the request body is not being passed multiple ways) */
     if (options->send_filepath.len > 0) {
         /* Create parallel read stream from file */
-        meta_request->request_body_parallel_stream =
-            client->vtable->parallel_input_stream_new_from_file(allocator, options->send_filepath);
+        if (options->send_filepath_use_mmap) {
+            meta_request->request_body_parallel_stream =
+                aws_parallel_input_stream_new_from_file_mmap(allocator, options->send_filepath);
+            if (meta_request->request_body_parallel_stream == NULL) {
+                AWS_LOGF_DEBUG(
+                    AWS_LS_S3_META_REQUEST,
+                    "id=%p Could not map file, error %d (%s). Reading it the regular way instead.",
+                    (void *)meta_request,
+                    aws_last_error(),
+                    aws_error_str(aws_last_error()));
+            }
+        }
+        if (meta_request->request_body_parallel_stream == NULL && options->send_filepath_use_io_uring) {
+            struct aws_s3_io_uring *io_uring = aws_s3_client_get_io_uring(client);
+            if (io_uring != NULL) {
+                meta_request->request_body_parallel_stream =
+                    aws_parallel_input_stream_new_from_file_io_uring(allocator, options->send_filepath, io_uring);
+            }
+            if (meta_request->request_body_parallel_stream == NULL) {
+                AWS_LOGF_DEBUG(
+                    AWS_LS_S3_META_REQUEST,
+                    "id=%p Could not read file through io_uring, error %d (%s). Reading it the regular way instead.",
+                    (void *)meta_request,
+                    aws_last_error(),
+                    aws_error_str(aws_last_error()));
+            }
+        }
+        if (meta_request->request_body_parallel_stream == NULL) {
+            struct aws_event_loop_group *file_io_elg = aws_s3_client_get_file_io_elg(client);
+            if (options->send_filepath_use_direct_io) {
+                meta_request->request_body_parallel_stream =
+                    aws_parallel_input_stream_new_from_file_direct(allocator, options->send_filepath, file_io_elg);
+            } else {
+                meta_request->request_body_parallel_stream =
+                    client->vtable->parallel_input_stream_new_from_file(allocator, options->send_filepath, file_io_elg);
+            }
+        }
         if (meta_request->request_body_parallel_stream == NULL) {
             goto error;
         }
 
+    } else if (options->send_buffer.ptr != NULL) {
+        meta_request->request_body_parallel_stream =
+            aws_parallel_input_stream_new_from_buffer(allocator, options->send_buffer);
+
     } else if (options->send_async_stream != NULL) {
         meta_request->request_body_async_stream = aws_async_input_stream_acquire(options->send_async_stream);
 
@@ -286,6 +333,19 @@ int aws_s3_meta_request_init_base(
         meta_request->request_body_using_async_writes = true;
     }
 
+    if (options->recv_filepath.len > 0) {
+        if (options->recv_filepath_use_direct_io) {
+            meta_request->recv_file =
+                aws_parallel_output_stream_new_from_file_direct(allocator, options->recv_filepath);
+        } else {
+            meta_request->recv_file = aws_parallel_output_stream_new_from_file(allocator, options->recv_filepath);
+        }
+        if (meta_request->recv_file == NULL) {
+            goto error;
+        }
+        meta_request->recv_file_preallocate = options->recv_file_preallocate;
+    }
+
     meta_request->synced_data.next_streaming_part = 1;
 
     meta_request->meta_request_level_running_response_sum = NULL;
@@ -293,6 +353,8 @@ int aws_s3_meta_request_init_base(
     meta_request->progress_callback = options->progress_callback;
     meta_request->telemetry_callback = options->telemetry_callback;
     meta_request->upload_review_callback = options->upload_review_callback;
+    meta_request->receive_buffer_callback = options->receive_buffer_callback;
+    meta_request->out_of_order_body_callback = options->out_of_order_body_callback;
 
     if (meta_request->checksum_config.validate_response_checksum) {
         /* TODO: the validate for auto range get should happen for each response received. */
@@ -308,6 +370,7 @@ int aws_s3_meta_request_init_base(
         meta_request->body_callback = options->body_callback;
         meta_request->finish_callback = options->finish_callback;
     }
+    meta_request->send_buffer_release_callback = options->send_buffer_release_callback;
 
     /* Nothing can fail after here. Leave the impl not affected by failure of initializing base. */
     meta_request->impl = impl;
@@ -478,6 +541,7 @@ static void s_s3_meta_request_destroy(void *user_data) {
     /* Clean up our initial http message */
     meta_request->request_body_async_stream = aws_async_input_stream_release(meta_request->request_body_async_stream);
     meta_request->initial_request_message = aws_http_message_release(meta_request->initial_request_message);
+    meta_request->recv_file = aws_parallel_output_stream_release(meta_request->recv_file);
 
     void *meta_request_user_data = meta_request->user_data;
     aws_s3_meta_request_shutdown_fn *shutdown_callback = meta_request->shutdown_callback;
@@ -1201,7 +1265,6 @@ static void s_get_part_response_headers_checksum_helper(
     }
 }
 
-/* warning this might get screwed up with retries/restarts */
 static void s_get_part_response_body_checksum_helper(
     struct aws_s3_checksum *running_response_sum,
     const struct aws_byte_cursor *body) {
@@ -1235,6 +1298,10 @@ static void s_get_response_part_finish_checksum_helper(struct aws_s3_connection
         aws_byte_buf_clean_up(&encoded_response_body_sum);
     } else {
         request->did_validate = false;
+        if (error_code != AWS_OP_SUCCESS && request->has_resumable_response_body) {
+            /* The retry may resume this attempt, cleaned up when the retry is set up if it doesn't */
+            return;
+        }
     }
     aws_checksum_destroy(request->request_level_running_response_sum);
     aws_byte_buf_clean_up(&request->request_level_response_header_checksum);
@@ -1290,8 +1357,18 @@ static int s_s3_meta_request_incoming_headers(
     bool successful_response =
         s_s3_meta_request_error_code_from_response_status(request->send_data.response_status) == AWS_ERROR_SUCCESS;
 
+    if (request->resumes_response_body && !successful_response) {
+        /* Nothing to resume, the error response goes to a buffer of its own */
+        aws_byte_buf_clean_up(&request->send_data.response_body);
+        aws_checksum_destroy(request->request_level_running_response_sum);
+        request->request_level_running_response_sum = NULL;
+        aws_byte_buf_clean_up(&request->request_level_response_header_checksum);
+        request->resumes_response_body = false;
+    }
+
+    /* A resumed response carries on with the checksum of the whole part from the first attempt */
     if (successful_response && meta_request->checksum_config.validate_response_checksum &&
-        request->request_type == AWS_S3_REQUEST_TYPE_GET_OBJECT) {
+        request->request_type == AWS_S3_REQUEST_TYPE_GET_OBJECT && !request->resumes_response_body) {
         s_get_part_response_headers_checksum_helper(connection, meta_request, headers, headers_count);
     }
 
@@ -1357,6 +1434,62 @@ static int s_response_body_append(struct aws_byte_buf *buf, const struct aws_byt
     return buf->allocator != NULL ? aws_byte_buf_append_dynamic(buf, data) : aws_byte_buf_append(buf, data);
 }
 
+/* Gets caller's memory to receive range_size bytes of the object at range_start into. */
+static int s_s3_meta_request_get_receive_buffer(
+    struct aws_s3_meta_request *meta_request,
+    uint64_t range_start,
+    uint64_t range_size,
+    struct aws_byte_buf *out_buffer) {
+
+    AWS_PRECONDITION(meta_request->receive_buffer_callback);
+
+    struct aws_byte_buf caller_buffer;
+    AWS_ZERO_STRUCT(caller_buffer);
+    if (meta_request->receive_buffer_callback(
+            meta_request, range_start, range_size, &caller_buffer, meta_request->user_data)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_META_REQUEST,
+            "id=%p Receive buffer callback raised error %d (%s).",
+            (void *)meta_request,
+            aws_last_error_or_unknown(),
+            aws_error_str(aws_last_error_or_unknown()));
+        return AWS_OP_ERR;
+    }
+
+    if (caller_buffer.buffer == NULL || caller_buffer.capacity - caller_buffer.len < range_size) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_META_REQUEST,
+            "id=%p Receive buffer callback returned a buffer smaller than the requested range of %" PRIu64 " bytes.",
+            (void *)meta_request,
+            range_size);
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    /* Never owned by the request, so nothing is freed when the request cleans up its response body */
+    *out_buffer = aws_byte_buf_from_empty_array(caller_buffer.buffer + caller_buffer.len, (size_t)range_size);
+    return AWS_OP_SUCCESS;
+}
+
+int aws_s3_meta_request_copy_to_receive_buffer(
+    struct aws_s3_meta_request *meta_request,
+    struct aws_s3_request *request) {
+
+    AWS_PRECONDITION(meta_request);
+    AWS_PRECONDITION(request);
+
+    struct aws_byte_cursor body = aws_byte_cursor_from_buf(&request->send_data.response_body);
+    if (body.len == 0) {
+        return AWS_OP_SUCCESS;
+    }
+
+    struct aws_byte_buf dest;
+    if (s_s3_meta_request_get_receive_buffer(meta_request, request->part_range_start, body.len, &dest)) {
+        return AWS_OP_ERR;
+    }
+    aws_byte_buf_write_from_whole_cursor(&dest, body);
+    return AWS_OP_SUCCESS;
+}
+
 static int s_s3_meta_request_incoming_body(
     struct aws_http_stream *stream,
     const struct aws_byte_cursor *data,
@@ -1392,9 +1525,26 @@ static int s_s3_meta_request_incoming_body(
     }
 
     if (request->send_data.response_body.capacity == 0) {
-        if (request->has_part_size_response_body && request->ticket != NULL) {
+        if (request->has_caller_response_body && successful_response) {
+            /* Error responses still go to a buffer of our own, so they can't corrupt caller's memory */
+            if (s_s3_meta_request_get_receive_buffer(
+                    meta_request,
+                    request->part_range_start,
+                    request->part_range_end - request->part_range_start + 1,
+                    &request->send_data.response_body)) {
+                return AWS_OP_ERR;
+            }
+        } else if (request->has_part_size_response_body && request->ticket != NULL) {
             request->send_data.response_body =
                 aws_s3_buffer_pool_acquire_buffer(request->meta_request->client->buffer_pool, request->ticket);
+            if (request->send_data.response_body.buffer == NULL) {
+                AWS_LOGF_ERROR(
+                    AWS_LS_S3_META_REQUEST,
+                    "id=%p: Request %p could not get a buffer for the response body",
+                    (void *)meta_request,
+                    (void *)request);
+                return AWS_OP_ERR;
+            }
         } else {
             size_t buffer_size = s_dynamic_body_initial_buf_size;
             aws_byte_buf_init(&request->send_data.response_body, meta_request->allocator, buffer_size);
@@ -1558,6 +1708,17 @@ static int s_s3_meta_request_error_code_from_response(struct aws_s3_request *req
     }
 }
 
+/* A part that failed partway through a successful response keeps the bytes it received for its retry. */
+static bool s_s3_meta_request_can_resume_response_body(const struct aws_s3_request *request) {
+    if (!request->has_resumable_response_body ||
+        s_s3_meta_request_error_code_from_response_status(request->send_data.response_status) != AWS_ERROR_SUCCESS) {
+        return false;
+    }
+
+    uint64_t part_range_size = request->part_range_end - request->part_range_start + 1;
+    return request->send_data.response_body.len > 0 && request->send_data.response_body.len < part_range_size;
+}
+
 void aws_s3_meta_request_send_request_finish_default(
     struct aws_s3_connection *connection,
     struct aws_http_stream *stream,
@@ -1619,9 +1780,11 @@ void aws_s3_meta_request_send_request_finish_default(
          * has a result, then make sure that this request isn't retried. */
         if (error_code == AWS_ERROR_S3_INVALID_RESPONSE_STATUS ||
             error_code == AWS_ERROR_S3_INTERNAL_PART_SIZE_MISMATCH_RETRYING_WITH_RANGE ||
-            error_code == AWS_ERROR_S3_NON_RECOVERABLE_ASYNC_ERROR || meta_request_finishing) {
+            error_code == AWS_ERROR_S3_NON_RECOVERABLE_ASYNC_ERROR ||
+            error_code == AWS_ERROR_S3_INTERNAL_HEDGED_REQUEST_LOST || meta_request_finishing) {
             finish_code = AWS_S3_CONNECTION_FINISH_CODE_FAILED;
-            if (error_code == AWS_ERROR_S3_INTERNAL_PART_SIZE_MISMATCH_RETRYING_WITH_RANGE) {
+            if (error_code == AWS_ERROR_S3_INTERNAL_PART_SIZE_MISMATCH_RETRYING_WITH_RANGE ||
+                error_code == AWS_ERROR_S3_INTERNAL_HEDGED_REQUEST_LOST) {
                 /* Log at info level instead of error as it's expected and not a fatal error */
                 AWS_LOGF_INFO(
                     AWS_LS_S3_META_REQUEST,
@@ -1669,6 +1832,17 @@ void aws_s3_meta_request_send_request_finish_default(
         }
     }
 
+    request->resumes_response_body =
+        finish_code == AWS_S3_CONNECTION_FINISH_CODE_RETRY && s_s3_meta_request_can_resume_response_body(request);
+    if (request->resumes_response_body) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_S3_META_REQUEST,
+            "id=%p: Request %p keeps the %zu bytes it received, its retry resumes from there",
+            (void *)meta_request,
+            (void *)request,
+            request->send_data.response_body.len);
+    }
+
     if (stream != NULL) {
         aws_http_stream_release(stream);
         stream = NULL;
@@ -1711,11 +1885,25 @@ void aws_s3_meta_request_stream_response_body_synced(
     AWS_PRECONDITION(request);
     AWS_PRECONDITION(request->part_number > 0);
 
+    struct aws_s3_client *client = meta_request->client;
+    AWS_PRECONDITION(client);
+
+    if (meta_request->out_of_order_body_callback) {
+        /* No need to wait for earlier parts, send it for delivery right away */
+        aws_s3_request_acquire(request);
+
+        struct aws_s3_meta_request_event event = {.type = AWS_S3_META_REQUEST_EVENT_RESPONSE_BODY};
+        event.u.response_body.completed_request = request;
+        aws_s3_meta_request_add_event_for_delivery_synced(meta_request, &event);
+
+        aws_atomic_fetch_add(&client->stats.num_requests_streaming_response, 1);
+        ++meta_request->synced_data.num_parts_delivery_sent;
+        return;
+    }
+
     /* Push it into the priority queue. */
     s_s3_meta_request_body_streaming_push_synced(meta_request, request);
 
-    struct aws_s3_client *client = meta_request->client;
-    AWS_PRECONDITION(client);
     aws_atomic_fetch_add(&client->stats.num_requests_stream_queued_waiting, 1);
 
     /* Grab any requests that can be streamed back to the caller
@@ -1782,6 +1970,110 @@ void aws_s3_meta_request_cancel_cancellable_requests_synced(struct aws_s3_meta_r
     }
 }
 
+static void s_s3_meta_request_on_ticket_reserved(void *user_data) {
+    struct aws_s3_meta_request *meta_request = user_data;
+
+    /* Schedule the work task, so the meta request picks up the ticket */
+    aws_s3_client_schedule_process_work(meta_request->client);
+    aws_s3_meta_request_release(meta_request);
+}
+
+/* Whether tickets attached to tracker can't take another size bytes without going over the limit.
+ * Holding a single ticket is always allowed, even if it is over the limit. */
+static bool s_s3_meta_request_memory_limit_reached(
+    struct aws_s3_buffer_pool_tracker *tracker,
+    size_t memory_limit,
+    size_t size) {
+
+    if (memory_limit == 0) {
+        return false;
+    }
+
+    size_t held = aws_atomic_load_int(&tracker->reserved) + aws_atomic_load_int(&tracker->used);
+    return held > 0 && held + size > memory_limit;
+}
+
+struct aws_s3_buffer_pool_ticket *aws_s3_meta_request_reserve_ticket_synced(
+    struct aws_s3_meta_request *meta_request,
+    size_t size) {
+    ASSERT_SYNCED_DATA_LOCK_HELD(meta_request);
+
+    struct aws_s3_buffer_pool *buffer_pool = meta_request->client->buffer_pool;
+    struct aws_future_s3_buffer_ticket *future = meta_request->synced_data.pending_ticket_reservation;
+    struct aws_s3_buffer_pool_ticket *ticket = NULL;
+
+    if (future != NULL) {
+        if (!aws_future_s3_buffer_ticket_is_done(future)) {
+            return NULL;
+        }
+
+        meta_request->synced_data.pending_ticket_reservation = NULL;
+        int error_code = aws_future_s3_buffer_ticket_get_error(future);
+        if (error_code == AWS_ERROR_SUCCESS &&
+            aws_s3_buffer_pool_ticket_get_size(aws_future_s3_buffer_ticket_peek_result(future)) == size) {
+            ticket = aws_future_s3_buffer_ticket_get_result_by_move(future);
+        } else {
+            AWS_LOGF_DEBUG(
+                AWS_LS_S3_META_REQUEST,
+                "id=%p: Buffer reservation failed with error %d (%s) or is no longer needed. Reserving again.",
+                (void *)meta_request,
+                error_code,
+                aws_error_str(error_code));
+        }
+        aws_future_s3_buffer_ticket_release(future);
+        if (ticket != NULL) {
+            goto on_reserved;
+        }
+    }
+
+    if (s_s3_meta_request_memory_limit_reached(&meta_request->memory_usage, meta_request->memory_limit, size)) {
+        AWS_LOGF_TRACE(AWS_LS_S3_META_REQUEST, "id=%p: Meta request reached its memory limit.", (void *)meta_request);
+        return NULL;
+    }
+
+    if (s_s3_meta_request_memory_limit_reached(
+            &meta_request->client->memory_usage, meta_request->client->memory_limit, size)) {
+        AWS_LOGF_TRACE(
+            AWS_LS_S3_META_REQUEST,
+            "id=%p: Client reached its share of the buffer pool's memory.",
+            (void *)meta_request);
+        return NULL;
+    }
+
+    future = aws_s3_buffer_pool_reserve_async(buffer_pool, size);
+    if (aws_future_s3_buffer_ticket_is_done(future) &&
+        aws_future_s3_buffer_ticket_get_error(future) == AWS_ERROR_SUCCESS) {
+        ticket = aws_future_s3_buffer_ticket_get_result_by_move(future);
+        aws_future_s3_buffer_ticket_release(future);
+        goto on_reserved;
+    }
+
+    AWS_LOGF_TRACE(AWS_LS_S3_META_REQUEST, "id=%p: Waiting for buffer pool to release memory.", (void *)meta_request);
+
+    meta_request->synced_data.pending_ticket_reservation = future;
+    aws_future_s3_buffer_ticket_register_event_loop_callback(
+        future,
+        meta_request->client->process_work_event_loop,
+        s_s3_meta_request_on_ticket_reserved,
+        aws_s3_meta_request_acquire(meta_request));
+    return NULL;
+
+on_reserved:
+    aws_s3_buffer_pool_ticket_set_tracker(ticket, &meta_request->memory_usage);
+    return ticket;
+}
+
+struct aws_s3_meta_request_memory_usage aws_s3_meta_request_get_memory_usage(struct aws_s3_meta_request *meta_request) {
+    AWS_PRECONDITION(meta_request);
+
+    struct aws_s3_meta_request_memory_usage usage = {
+        .reserved = aws_atomic_load_int(&meta_request->memory_usage.reserved),
+        .used = aws_atomic_load_int(&meta_request->memory_usage.used),
+        .limit = meta_request->memory_limit,
+    };
+    return usage;
+}
+
 static struct aws_s3_request_metrics *s_s3_request_finish_up_and_release_metrics(
     struct aws_s3_request_metrics *metrics,
     struct aws_s3_meta_request *meta_request) {
@@ -2002,6 +2294,8 @@ void aws_s3_meta_request_finish_default(struct aws_s3_meta_request *meta_request
     aws_simple_completion_callback *pending_async_write_waker = NULL;
     void *pending_async_write_waker_user_data = NULL;
 
+    struct aws_future_s3_buffer_ticket *pending_ticket_reservation = NULL;
+
     struct aws_s3_meta_request_result finish_result;
     AWS_ZERO_STRUCT(finish_result);
 
@@ -2033,6 +2327,10 @@ void aws_s3_meta_request_finish_default(struct aws_s3_meta_request *meta_request
             meta_request->synced_data.async_write.waker = NULL;
             meta_request->synced_data.async_write.waker_user_data = NULL;
         }
+        /* Stop waiting for buffer pool memory */
+        pending_ticket_reservation = meta_request->synced_data.pending_ticket_reservation;
+        meta_request->synced_data.pending_ticket_reservation = NULL;
+
         finish_result = meta_request->synced_data.finish_result;
         AWS_ZERO_STRUCT(meta_request->synced_data.finish_result);
 
@@ -2053,6 +2351,12 @@ void aws_s3_meta_request_finish_default(struct aws_s3_meta_request *meta_request
         pending_async_write_waker(pending_async_write_waker_user_data);
     }
 
+    if (pending_ticket_reservation != NULL) {
+        /* Releasing the future also releases the ticket, if reservation went through in the meantime */
+        aws_s3_buffer_pool_cancel_reservation(meta_request->client->buffer_pool, pending_ticket_reservation);
+        aws_future_s3_buffer_ticket_release(pending_ticket_reservation);
+    }
+
     while (!aws_linked_list_empty(&release_request_list)) {
         struct aws_linked_list_node *request_node = aws_linked_list_pop_front(&release_request_list);
         struct aws_s3_request *release_request = AWS_CONTAINER_OF(request_node, struct aws_s3_request, node);
@@ -2088,7 +2392,13 @@ void aws_s3_meta_request_finish_default(struct aws_s3_meta_request *meta_request
     meta_request->request_body_async_stream = aws_async_input_stream_release(meta_request->request_body_async_stream);
     meta_request->request_body_parallel_stream =
         aws_parallel_input_stream_release(meta_request->request_body_parallel_stream);
+    if (meta_request->send_buffer_release_callback != NULL) {
+        meta_request->send_buffer_release_callback(meta_request->user_data);
+        meta_request->send_buffer_release_callback = NULL;
+    }
     meta_request->initial_request_message = aws_http_message_release(meta_request->initial_request_message);
+    /* Close the file before telling the user it's done, so it's complete when they open it */
+    meta_request->recv_file = aws_parallel_output_stream_release(meta_request->recv_file);
 
     if (meta_request->finish_callback != NULL) {
         meta_request->finish_callback(meta_request, &finish_result, meta_request->user_data);
@@ -2185,6 +2495,24 @@ void aws_s3_meta_request_result_setup(
     result->error_code = error_code;
 }
 
+/* Grab a buffer from the pool for data passed to write().
+ * Only fails if the pool's buffer provider is out of memory. */
+static int s_s3_meta_request_acquire_async_write_buffer_synced(struct aws_s3_meta_request *meta_request) {
+    /* NOTE: we acquire a forced-buffer because there's a risk of deadlock if we
+     * waited for a normal ticket reservation, respecting the pool's memory limit.
+     * (See "test_s3_many_async_uploads_without_data" for description of deadlock scenario) */
+    meta_request->synced_data.async_write.buffered_data = aws_s3_buffer_pool_acquire_forced_buffer(
+        meta_request->client->buffer_pool,
+        meta_request->part_size,
+        &meta_request->synced_data.async_write.buffered_data_ticket /*out_new_ticket*/);
+    if (meta_request->synced_data.async_write.buffered_data_ticket == NULL) {
+        return AWS_OP_ERR;
+    }
+    aws_s3_buffer_pool_ticket_set_tracker(
+        meta_request->synced_data.async_write.buffered_data_ticket, &meta_request->memory_usage);
+    return AWS_OP_SUCCESS;
+}
+
 struct aws_s3_meta_request_poll_write_result aws_s3_meta_request_poll_write(
     struct aws_s3_meta_request *meta_request,
     struct aws_byte_cursor data,
@@ -2205,6 +2533,10 @@ struct aws_s3_meta_request_poll_write_result aws_s3_meta_request_poll_write(
      * and the meta-request should terminate */
     bool illegal_usage_terminate_meta_request = false;
 
+    /* Set this true, while lock is held, if there's no memory to buffer the data in
+     * and the meta-request should terminate */
+    bool out_of_memory_terminate_meta_request = false;
+
     /* BEGIN CRITICAL SECTION */
     aws_s3_meta_request_lock_synced_data(meta_request);
     if (aws_s3_meta_request_has_finish_result_synced(meta_request)) {
@@ -2241,20 +2573,20 @@ struct aws_s3_meta_request_poll_write_result aws_s3_meta_request_poll_write(
         meta_request->synced_data.async_write.waker_user_data = user_data;
         result.is_pending = true;
 
+    } else if (
+        meta_request->synced_data.async_write.buffered_data_ticket == NULL &&
+        s_s3_meta_request_acquire_async_write_buffer_synced(meta_request)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_META_REQUEST,
+            "id=%p: write() could not get a buffer for the data, error %d (%s)",
+            (void *)meta_request,
+            aws_last_error_or_unknown(),
+            aws_error_str(aws_last_error_or_unknown()));
+        out_of_memory_terminate_meta_request = true;
+
     } else {
         /* write call is OK */
 
-        /* If we don't already have a buffer, grab one from the pool. */
-        if (meta_request->synced_data.async_write.buffered_data_ticket == NULL) {
-            /* NOTE: we acquire a forced-buffer because there's a risk of deadlock if we
-             * waited for a normal ticket reservation, respecting the pool's memory limit.
-             * (See "test_s3_many_async_uploads_without_data" for description of deadlock scenario) */
-            meta_request->synced_data.async_write.buffered_data = aws_s3_buffer_pool_acquire_forced_buffer(
-                meta_request->client->buffer_pool,
-                meta_request->part_size,
-                &meta_request->synced_data.async_write.buffered_data_ticket /*out_new_ticket*/);
-        }
-
         /* Copy as much data as we can into the buffer */
         struct aws_byte_cursor processed_data =
             aws_byte_buf_write_to_capacity(&meta_request->synced_data.async_write.buffered_data, &data);
@@ -2292,10 +2624,15 @@ struct aws_s3_meta_request_poll_write_result aws_s3_meta_request_poll_write(
         aws_s3_meta_request_set_fail_synced(meta_request, NULL, AWS_ERROR_INVALID_STATE);
     }
 
+    if (out_of_memory_terminate_meta_request) {
+        result.error_code = AWS_ERROR_OOM;
+        aws_s3_meta_request_set_fail_synced(meta_request, NULL, AWS_ERROR_OOM);
+    }
+
     aws_s3_meta_request_unlock_synced_data(meta_request);
     /* END CRITICAL SECTION */
 
-    if (ready_to_send || illegal_usage_terminate_meta_request) {
+    if (ready_to_send || illegal_usage_terminate_meta_request || out_of_memory_terminate_meta_request) {
         /* Schedule the work task, to continue processing the meta-request */
         aws_s3_client_schedule_process_work(meta_request->client);
     }
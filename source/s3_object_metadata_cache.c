@@ -0,0 +1,229 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include "aws/s3/private/s3_object_metadata_cache.h"
+#include "aws/s3/private/s3_util.h"
+
+#include <aws/common/byte_buf.h>
+#include <aws/common/hash_table.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/math.h>
+#include <aws/common/mutex.h>
+#include <aws/common/string.h>
+#include <aws/http/request_response.h>
+
+struct aws_s3_object_metadata_cache_entry {
+    /* Key in the cache's table, pointing into key_storage */
+    struct aws_byte_cursor key;
+    struct aws_string *key_storage;
+
+    uint64_t object_size;
+    struct aws_string *etag;
+
+    /* Node in lru_entries */
+    struct aws_linked_list_node node;
+};
+
+struct aws_s3_object_metadata_cache {
+    struct aws_allocator *allocator;
+    size_t max_entries;
+
+    struct aws_mutex lock;
+
+    struct {
+        /* aws_byte_cursor key -> aws_s3_object_metadata_cache_entry */
+        struct aws_hash_table entries;
+
+        /* Least recently used first */
+        struct aws_linked_list lru_entries;
+    } synced_data;
+};
+
+struct aws_s3_object_metadata_cache *aws_s3_object_metadata_cache_new(
+    struct aws_allocator *allocator,
+    size_t max_entries) {
+    AWS_PRECONDITION(allocator);
+    AWS_PRECONDITION(max_entries > 0);
+
+    struct aws_s3_object_metadata_cache *cache =
+        aws_mem_calloc(allocator, 1, sizeof(struct aws_s3_object_metadata_cache));
+    cache->allocator = allocator;
+    cache->max_entries = max_entries;
+    aws_mutex_init(&cache->lock);
+    aws_hash_table_init(
+        &cache->synced_data.entries,
+        allocator,
+        aws_min_size(max_entries, 1024),
+        aws_hash_byte_cursor_ptr,
+        (aws_hash_callback_eq_fn *)aws_byte_cursor_eq,
+        NULL,
+        NULL);
+    aws_linked_list_init(&cache->synced_data.lru_entries);
+    return cache;
+}
+
+static void s_entry_destroy(
+    struct aws_s3_object_metadata_cache *cache,
+    struct aws_s3_object_metadata_cache_entry *entry) {
+    aws_string_destroy(entry->etag);
+    aws_string_destroy(entry->key_storage);
+    aws_mem_release(cache->allocator, entry);
+}
+
+static void s_remove_entry_synced(
+    struct aws_s3_object_metadata_cache *cache,
+    struct aws_s3_object_metadata_cache_entry *entry) {
+    aws_linked_list_remove(&entry->node);
+    aws_hash_table_remove(&cache->synced_data.entries, &entry->key, NULL, NULL);
+    s_entry_destroy(cache, entry);
+}
+
+void aws_s3_object_metadata_cache_destroy(struct aws_s3_object_metadata_cache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+
+    while (!aws_linked_list_empty(&cache->synced_data.lru_entries)) {
+        struct aws_linked_list_node *node = aws_linked_list_front(&cache->synced_data.lru_entries);
+        s_remove_entry_synced(cache, AWS_CONTAINER_OF(node, struct aws_s3_object_metadata_cache_entry, node));
+    }
+    aws_hash_table_clean_up(&cache->synced_data.entries);
+    aws_mutex_clean_up(&cache->lock);
+    aws_mem_release(cache->allocator, cache);
+}
+
+/* Key of an object is its Host header followed by the request path */
+static int s_key_init(
+    struct aws_byte_buf *out_key,
+    struct aws_allocator *allocator,
+    const struct aws_http_message *message) {
+
+    struct aws_byte_cursor host;
+    AWS_ZERO_STRUCT(host);
+    aws_http_headers_get(aws_http_message_get_const_headers(message), g_host_header_name, &host);
+
+    struct aws_byte_cursor path;
+    if (aws_http_message_get_request_path(message, &path)) {
+        return AWS_OP_ERR;
+    }
+
+    aws_byte_buf_init(out_key, allocator, host.len + path.len);
+    aws_byte_buf_append(out_key, &host);
+    aws_byte_buf_append(out_key, &path);
+    return AWS_OP_SUCCESS;
+}
+
+/* Find the entry for key, or NULL. Doesn't change how recently the entry was used. */
+static struct aws_s3_object_metadata_cache_entry *s_find_entry_synced(
+    struct aws_s3_object_metadata_cache *cache,
+    const struct aws_byte_buf *key) {
+
+    struct aws_byte_cursor key_cursor = aws_byte_cursor_from_buf(key);
+    struct aws_hash_element *elem = NULL;
+    aws_hash_table_find(&cache->synced_data.entries, &key_cursor, &elem);
+    return elem != NULL ? elem->value : NULL;
+}
+
+bool aws_s3_object_metadata_cache_get(
+    struct aws_s3_object_metadata_cache *cache,
+    const struct aws_http_message *message,
+    uint64_t *out_object_size,
+    struct aws_string **out_etag) {
+    AWS_PRECONDITION(cache);
+    AWS_PRECONDITION(message);
+    AWS_PRECONDITION(out_object_size);
+    AWS_PRECONDITION(out_etag);
+
+    struct aws_byte_buf key;
+    if (s_key_init(&key, cache->allocator, message)) {
+        return false;
+    }
+
+    bool hit = false;
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&cache->lock);
+    struct aws_s3_object_metadata_cache_entry *entry = s_find_entry_synced(cache, &key);
+    if (entry != NULL) {
+        aws_linked_list_remove(&entry->node);
+        aws_linked_list_push_back(&cache->synced_data.lru_entries, &entry->node);
+        *out_object_size = entry->object_size;
+        *out_etag = aws_string_clone_or_reuse(cache->allocator, entry->etag);
+        hit = true;
+    }
+    aws_mutex_unlock(&cache->lock);
+    /* END CRITICAL SECTION */
+
+    aws_byte_buf_clean_up(&key);
+    return hit;
+}
+
+void aws_s3_object_metadata_cache_put(
+    struct aws_s3_object_metadata_cache *cache,
+    const struct aws_http_message *message,
+    uint64_t object_size,
+    struct aws_byte_cursor etag) {
+    AWS_PRECONDITION(cache);
+    AWS_PRECONDITION(message);
+
+    struct aws_byte_buf key;
+    if (s_key_init(&key, cache->allocator, message)) {
+        return;
+    }
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&cache->lock);
+    struct aws_s3_object_metadata_cache_entry *entry = s_find_entry_synced(cache, &key);
+    if (entry != NULL) {
+        aws_linked_list_remove(&entry->node);
+        aws_string_destroy(entry->etag);
+    } else {
+        if (aws_hash_table_get_entry_count(&cache->synced_data.entries) >= cache->max_entries) {
+            struct aws_linked_list_node *lru_node = aws_linked_list_front(&cache->synced_data.lru_entries);
+            s_remove_entry_synced(cache, AWS_CONTAINER_OF(lru_node, struct aws_s3_object_metadata_cache_entry, node));
+        }
+
+        entry = aws_mem_calloc(cache->allocator, 1, sizeof(struct aws_s3_object_metadata_cache_entry));
+        entry->key_storage = aws_string_new_from_buf(cache->allocator, &key);
+        entry->key = aws_byte_cursor_from_string(entry->key_storage);
+        if (aws_hash_table_put(&cache->synced_data.entries, &entry->key, entry, NULL)) {
+            s_entry_destroy(cache, entry);
+            entry = NULL;
+        }
+    }
+    if (entry != NULL) {
+        entry->object_size = object_size;
+        entry->etag = aws_string_new_from_cursor(cache->allocator, &etag);
+        aws_linked_list_push_back(&cache->synced_data.lru_entries, &entry->node);
+    }
+    aws_mutex_unlock(&cache->lock);
+    /* END CRITICAL SECTION */
+
+    aws_byte_buf_clean_up(&key);
+}
+
+void aws_s3_object_metadata_cache_remove(
+    struct aws_s3_object_metadata_cache *cache,
+    const struct aws_http_message *message,
+    struct aws_byte_cursor etag) {
+    AWS_PRECONDITION(cache);
+    AWS_PRECONDITION(message);
+
+    struct aws_byte_buf key;
+    if (s_key_init(&key, cache->allocator, message)) {
+        return;
+    }
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&cache->lock);
+    struct aws_s3_object_metadata_cache_entry *entry = s_find_entry_synced(cache, &key);
+    if (entry != NULL && aws_string_eq_byte_cursor(entry->etag, &etag)) {
+        s_remove_entry_synced(cache, entry);
+    }
+    aws_mutex_unlock(&cache->lock);
+    /* END CRITICAL SECTION */
+
+    aws_byte_buf_clean_up(&key);
+}
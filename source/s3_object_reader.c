@@ -0,0 +1,731 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include "aws/s3/s3_object_reader.h"
+
+#include "aws/s3/private/s3_client_impl.h"
+#include "aws/s3/private/s3_request_messages.h"
+#include "aws/s3/private/s3_util.h"
+#include <aws/common/linked_list.h>
+#include <aws/common/math.h>
+#include <aws/common/mutex.h>
+#include <aws/common/ref_count.h>
+#include <aws/common/string.h>
+#include <aws/http/request_response.h>
+#include <aws/http/status_code.h>
+#include <aws/io/future.h>
+#include <inttypes.h>
+
+/* A range of the object, fetched by one ranged GetObject meta request. */
+struct aws_s3_object_reader_range {
+    /* In aws_s3_object_reader.synced_data.ranges, least recently read first */
+    struct aws_linked_list_node node;
+
+    /* In aws_s3_object_reader_work.ranges_to_send, until it's sent */
+    struct aws_linked_list_node send_node;
+
+    struct aws_s3_object_reader *reader;
+
+    /* Offset of the range in the object */
+    uint64_t start;
+
+    /* Capacity is the size requested. Once complete, len is the size received, which is shorter at end of object. */
+    struct aws_byte_buf data;
+
+    /* Size of the response, from its Content-Length. Set by the headers callback. */
+    uint64_t response_size;
+
+    /* Range started at or past end of object (416 response). Its Content-Range might still tell the object size. */
+    bool not_satisfiable;
+    bool has_object_size;
+    uint64_t object_size;
+
+    struct {
+        bool in_flight;
+
+        /* Reads waiting for this range to arrive */
+        struct aws_linked_list waiting_reads;
+    } synced_data;
+};
+
+/* A call to aws_s3_object_reader_read() that hasn't completed yet */
+struct aws_s3_object_reader_pending_read {
+    struct aws_linked_list_node node;
+
+    /* Offset in the object of the next byte to read into dest */
+    uint64_t offset;
+    struct aws_byte_buf *dest;
+    struct aws_future_bool *future;
+
+    /* Readahead to use for ranges started on behalf of this read */
+    uint64_t readahead_size;
+
+    /* Result, set once the read is done. The future is completed once the lock is released. */
+    int error_code;
+    bool end_of_object;
+};
+
+struct aws_s3_object_reader {
+    struct aws_allocator *allocator;
+    struct aws_ref_count ref_count;
+
+    struct aws_s3_client *client;
+    struct aws_http_message *message;
+    struct aws_cached_signing_config_aws *cached_signing_config;
+
+    uint64_t initial_readahead_size;
+    uint64_t max_readahead_size;
+    uint64_t max_cached_size;
+
+    /* Max size of a single range, so that a large read doesn't allocate all of its size at once */
+    uint64_t max_range_size;
+
+    struct {
+        struct aws_mutex lock;
+
+        /* Ranges fetched or in flight, least recently read first. They don't overlap. */
+        struct aws_linked_list ranges;
+
+        /* Sum of the capacity of ranges */
+        uint64_t cached_size;
+
+        /* Part of cached_size in ranges still in flight, which can't be dropped */
+        uint64_t in_flight_size;
+
+        bool object_size_known;
+        uint64_t object_size;
+
+        /* ETag of the object, once known. Sent as If-Match with later ranges. */
+        struct aws_string *etag;
+
+        /* Where the next read starts, if reads are sequential */
+        uint64_t next_sequential_offset;
+
+        /* Current readahead, 0 if reads don't look sequential */
+        uint64_t readahead_size;
+    } synced_data;
+};
+
+/* What to do once the lock is released: ranges to send and reads to complete */
+struct aws_s3_object_reader_work {
+    struct aws_linked_list ranges_to_send;
+    struct aws_linked_list ranges_to_destroy;
+    struct aws_linked_list reads_to_complete;
+};
+
+static void s_reader_lock_synced_data(struct aws_s3_object_reader *reader) {
+    aws_mutex_lock(&reader->synced_data.lock);
+}
+
+static void s_reader_unlock_synced_data(struct aws_s3_object_reader *reader) {
+    aws_mutex_unlock(&reader->synced_data.lock);
+}
+
+static void s_work_init(struct aws_s3_object_reader_work *work) {
+    aws_linked_list_init(&work->ranges_to_send);
+    aws_linked_list_init(&work->ranges_to_destroy);
+    aws_linked_list_init(&work->reads_to_complete);
+}
+
+static void s_range_destroy(struct aws_s3_object_reader_range *range) {
+    struct aws_allocator *allocator = range->reader->allocator;
+    aws_byte_buf_clean_up(&range->data);
+    aws_mem_release(allocator, range);
+}
+
+static void s_reader_destroy(void *user_data) {
+    struct aws_s3_object_reader *reader = user_data;
+
+    /* In flight ranges hold a reference, so everything left has arrived and nobody waits on it */
+    while (!aws_linked_list_empty(&reader->synced_data.ranges)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&reader->synced_data.ranges);
+        struct aws_s3_object_reader_range *range = AWS_CONTAINER_OF(node, struct aws_s3_object_reader_range, node);
+        AWS_ASSERT(!range->synced_data.in_flight);
+        s_range_destroy(range);
+    }
+
+    aws_string_destroy(reader->synced_data.etag);
+    aws_mutex_clean_up(&reader->synced_data.lock);
+    if (reader->cached_signing_config != NULL) {
+        aws_cached_signing_config_destroy(reader->cached_signing_config);
+    }
+    aws_http_message_release(reader->message);
+    aws_s3_client_release(reader->client);
+    aws_mem_release(reader->allocator, reader);
+}
+
+struct aws_s3_object_reader *aws_s3_object_reader_new(
+    struct aws_allocator *allocator,
+    struct aws_s3_client *client,
+    const struct aws_s3_object_reader_options *options) {
+
+    AWS_PRECONDITION(allocator);
+    AWS_PRECONDITION(client);
+    AWS_PRECONDITION(options);
+
+    if (options->message == NULL ||
+        aws_http_headers_has(aws_http_message_get_headers(options->message), g_range_header_name)) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_GENERAL, "Could not create object reader. Message must be set and must not have a Range header.");
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    uint64_t initial_readahead_size =
+        options->initial_readahead_size != 0 ? options->initial_readahead_size : client->part_size;
+    uint64_t max_readahead_size =
+        options->max_readahead_size != 0 ? options->max_readahead_size : aws_mul_u64_saturating(client->part_size, 8);
+    uint64_t max_cached_size =
+        options->max_cached_size != 0 ? options->max_cached_size : aws_mul_u64_saturating(max_readahead_size, 2);
+
+    if (initial_readahead_size > max_readahead_size || max_readahead_size > SIZE_MAX) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_GENERAL,
+            "Could not create object reader. Readahead of %" PRIu64 " bytes must be between the initial readahead of "
+            "%" PRIu64 " bytes and SIZE_MAX.",
+            max_readahead_size,
+            initial_readahead_size);
+        aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    struct aws_s3_object_reader *reader = aws_mem_calloc(allocator, 1, sizeof(struct aws_s3_object_reader));
+    reader->allocator = allocator;
+    aws_ref_count_init(&reader->ref_count, reader, s_reader_destroy);
+    reader->client = aws_s3_client_acquire(client);
+    reader->message = aws_http_message_acquire(options->message);
+    if (options->signing_config != NULL) {
+        reader->cached_signing_config = aws_cached_signing_config_new(client, options->signing_config);
+    }
+    reader->initial_readahead_size = initial_readahead_size;
+    reader->max_readahead_size = max_readahead_size;
+    reader->max_cached_size = max_cached_size;
+    reader->max_range_size = aws_max_u64(max_readahead_size, client->part_size);
+
+    aws_mutex_init(&reader->synced_data.lock);
+    aws_linked_list_init(&reader->synced_data.ranges);
+
+    return reader;
+}
+
+struct aws_s3_object_reader *aws_s3_object_reader_acquire(struct aws_s3_object_reader *reader) {
+    if (reader != NULL) {
+        aws_ref_count_acquire(&reader->ref_count);
+    }
+    return reader;
+}
+
+struct aws_s3_object_reader *aws_s3_object_reader_release(struct aws_s3_object_reader *reader) {
+    if (reader != NULL) {
+        aws_ref_count_release(&reader->ref_count);
+    }
+    return NULL;
+}
+
+/* Returns the range that offset falls in, or NULL. Also returns where the next range after offset starts. */
+static struct aws_s3_object_reader_range *s_find_range_synced(
+    struct aws_s3_object_reader *reader,
+    uint64_t offset,
+    uint64_t *out_next_range_start) {
+
+    *out_next_range_start = UINT64_MAX;
+
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&reader->synced_data.ranges);
+         node != aws_linked_list_end(&reader->synced_data.ranges);
+         node = aws_linked_list_next(node)) {
+
+        struct aws_s3_object_reader_range *range = AWS_CONTAINER_OF(node, struct aws_s3_object_reader_range, node);
+        if (offset >= range->start && offset - range->start < range->data.capacity) {
+            return range;
+        }
+        if (range->start > offset && range->start < *out_next_range_start) {
+            *out_next_range_start = range->start;
+        }
+    }
+    return NULL;
+}
+
+/* Drop least recently read ranges, until size more bytes fit under the limit or nothing else can be dropped */
+static void s_evict_ranges_synced(
+    struct aws_s3_object_reader *reader,
+    uint64_t size,
+    struct aws_s3_object_reader_work *work) {
+
+    struct aws_linked_list_node *node = aws_linked_list_begin(&reader->synced_data.ranges);
+    while (reader->synced_data.cached_size + size > reader->max_cached_size &&
+           node != aws_linked_list_end(&reader->synced_data.ranges)) {
+
+        struct aws_s3_object_reader_range *range = AWS_CONTAINER_OF(node, struct aws_s3_object_reader_range, node);
+        node = aws_linked_list_next(node);
+
+        if (range->synced_data.in_flight) {
+            continue;
+        }
+        aws_linked_list_remove(&range->node);
+        reader->synced_data.cached_size -= range->data.capacity;
+        aws_linked_list_push_back(&work->ranges_to_destroy, &range->node);
+    }
+}
+
+/* Add a range of up to size bytes at offset, clipped so it doesn't overlap the next range or pass end of object.
+ * It's sent once the lock is released. */
+static struct aws_s3_object_reader_range *s_new_range_synced(
+    struct aws_s3_object_reader *reader,
+    uint64_t offset,
+    uint64_t size,
+    uint64_t next_range_start,
+    struct aws_s3_object_reader_work *work) {
+
+    size = aws_min_u64(size, next_range_start - offset);
+    if (reader->synced_data.object_size_known) {
+        AWS_ASSERT(offset < reader->synced_data.object_size);
+        size = aws_min_u64(size, reader->synced_data.object_size - offset);
+    }
+    AWS_ASSERT(size > 0 && size <= SIZE_MAX);
+
+    s_evict_ranges_synced(reader, size, work);
+
+    struct aws_s3_object_reader_range *range =
+        aws_mem_calloc(reader->allocator, 1, sizeof(struct aws_s3_object_reader_range));
+    range->reader = reader;
+    range->start = offset;
+    aws_byte_buf_init(&range->data, reader->allocator, (size_t)size);
+    range->synced_data.in_flight = true;
+    aws_linked_list_init(&range->synced_data.waiting_reads);
+
+    aws_linked_list_push_back(&reader->synced_data.ranges, &range->node);
+    reader->synced_data.cached_size += size;
+    reader->synced_data.in_flight_size += size;
+
+    /* Keep the reader alive until the range arrives */
+    aws_s3_object_reader_acquire(reader);
+
+    AWS_LOGF_TRACE(
+        AWS_LS_S3_GENERAL,
+        "id=%p Object reader fetching range %" PRIu64 "-%" PRIu64,
+        (void *)reader,
+        offset,
+        offset + size - 1);
+
+    aws_linked_list_push_back(&work->ranges_to_send, &range->send_node);
+    return range;
+}
+
+/* Make sure the readahead window after offset is fetched or in flight, starting at most one new range */
+static void s_readahead_synced(
+    struct aws_s3_object_reader *reader,
+    uint64_t offset,
+    uint64_t readahead_size,
+    struct aws_s3_object_reader_work *work) {
+
+    /* Don't fetch blindly past end of object before its size is known */
+    if (readahead_size == 0 || !reader->synced_data.object_size_known) {
+        return;
+    }
+
+    uint64_t window_end = aws_min_u64(aws_add_u64_saturating(offset, readahead_size), reader->synced_data.object_size);
+    while (offset < window_end) {
+        uint64_t next_range_start = 0;
+        struct aws_s3_object_reader_range *range = s_find_range_synced(reader, offset, &next_range_start);
+        if (range == NULL) {
+            s_new_range_synced(reader, offset, readahead_size, next_range_start, work);
+            return;
+        }
+        if (!range->synced_data.in_flight && range->data.len < range->data.capacity) {
+            /* Range ended early, at end of object */
+            return;
+        }
+        offset = range->start + range->data.capacity;
+    }
+}
+
+/* Start ranges for the rest of a read that waits on a range ending at offset, so a large read is fetched in parallel
+ * rather than one range at a time. Stops before ranges in flight would take more than max_cached_size. */
+static void s_prefetch_read_synced(
+    struct aws_s3_object_reader *reader,
+    struct aws_s3_object_reader_pending_read *read,
+    uint64_t offset,
+    struct aws_s3_object_reader_work *work) {
+
+    /* Don't fetch blindly past end of object before its size is known */
+    if (!reader->synced_data.object_size_known) {
+        return;
+    }
+
+    uint64_t read_end = aws_min_u64(
+        aws_add_u64_saturating(read->offset, read->dest->capacity - read->dest->len), reader->synced_data.object_size);
+    while (offset < read_end) {
+        uint64_t next_range_start = 0;
+        struct aws_s3_object_reader_range *range = s_find_range_synced(reader, offset, &next_range_start);
+        if (range == NULL) {
+            uint64_t size = aws_min_u64(read_end - offset, reader->max_range_size);
+            if (reader->synced_data.in_flight_size + size > reader->max_cached_size) {
+                return;
+            }
+            range = s_new_range_synced(reader, offset, size, next_range_start, work);
+        }
+        offset = range->start + range->data.capacity;
+    }
+}
+
+/* Serve as much of the read as possible. Returns true if the read is done and was moved to reads_to_complete,
+ * false if it's waiting on a range. */
+static bool s_process_read_synced(
+    struct aws_s3_object_reader *reader,
+    struct aws_s3_object_reader_pending_read *read,
+    struct aws_s3_object_reader_work *work) {
+
+    bool end_of_object = false;
+    while (read->dest->len < read->dest->capacity) {
+        if (reader->synced_data.object_size_known && read->offset >= reader->synced_data.object_size) {
+            end_of_object = true;
+            break;
+        }
+
+        uint64_t next_range_start = 0;
+        struct aws_s3_object_reader_range *range = s_find_range_synced(reader, read->offset, &next_range_start);
+        if (range == NULL) {
+            uint64_t size = aws_max_u64(read->dest->capacity - read->dest->len, read->readahead_size);
+            size = aws_min_u64(size, reader->max_range_size);
+            range = s_new_range_synced(reader, read->offset, size, next_range_start, work);
+        }
+
+        if (range->synced_data.in_flight) {
+            aws_linked_list_push_back(&range->synced_data.waiting_reads, &read->node);
+            s_prefetch_read_synced(reader, read, range->start + range->data.capacity, work);
+            return false;
+        }
+
+        /* Most recently read goes last */
+        aws_linked_list_remove(&range->node);
+        aws_linked_list_push_back(&reader->synced_data.ranges, &range->node);
+
+        uint64_t range_offset = read->offset - range->start;
+        if (range_offset >= range->data.len) {
+            /* Range ended early, at end of object */
+            end_of_object = true;
+            break;
+        }
+        struct aws_byte_cursor src = aws_byte_cursor_from_buf(&range->data);
+        aws_byte_cursor_advance(&src, (size_t)range_offset);
+        src.len = aws_min_size(src.len, read->dest->capacity - read->dest->len);
+        aws_byte_buf_write_from_whole_cursor(read->dest, src);
+        read->offset += src.len;
+    }
+
+    read->end_of_object = end_of_object;
+    aws_linked_list_push_back(&work->reads_to_complete, &read->node);
+    return true;
+}
+
+static int s_range_headers_callback(
+    struct aws_s3_meta_request *meta_request,
+    const struct aws_http_headers *headers,
+    int response_status,
+    void *user_data) {
+    (void)meta_request;
+    (void)response_status;
+
+    struct aws_s3_object_reader_range *range = user_data;
+    struct aws_s3_object_reader *reader = range->reader;
+
+    uint64_t response_size = 0;
+    uint64_t object_size = 0;
+    if (aws_s3_parse_content_length_response_header(
+            reader->allocator, (struct aws_http_headers *)headers, &response_size)) {
+        return AWS_OP_ERR;
+    }
+    bool has_object_size = aws_s3_parse_content_range_response_header(
+                               reader->allocator, (struct aws_http_headers *)headers, NULL, NULL, &object_size) ==
+                           AWS_OP_SUCCESS;
+    if (response_size > range->data.capacity) {
+        return aws_raise_error(AWS_ERROR_S3_INVALID_CONTENT_LENGTH_HEADER);
+    }
+    range->response_size = response_size;
+
+    struct aws_byte_cursor etag;
+    bool has_etag = aws_http_headers_get(headers, g_etag_header_name, &etag) == AWS_OP_SUCCESS;
+
+    /* BEGIN CRITICAL SECTION */
+    s_reader_lock_synced_data(reader);
+    if (has_object_size) {
+        reader->synced_data.object_size_known = true;
+        reader->synced_data.object_size = object_size;
+    } else if (response_size == 0) {
+        /* Empty object has no Content-Range */
+        reader->synced_data.object_size_known = true;
+        reader->synced_data.object_size = 0;
+    }
+    if (has_etag && reader->synced_data.etag == NULL) {
+        reader->synced_data.etag = aws_string_new_from_cursor(reader->allocator, &etag);
+    }
+    s_reader_unlock_synced_data(reader);
+    /* END CRITICAL SECTION */
+
+    return AWS_OP_SUCCESS;
+}
+
+static int s_range_receive_buffer_callback(
+    struct aws_s3_meta_request *meta_request,
+    uint64_t range_start,
+    uint64_t range_size,
+    struct aws_byte_buf *out_buffer,
+    void *user_data) {
+    (void)meta_request;
+
+    struct aws_s3_object_reader_range *range = user_data;
+    if (range_start < range->start || range_start - range->start > range->data.capacity ||
+        range_size > range->data.capacity - (range_start - range->start)) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+
+    *out_buffer = aws_byte_buf_from_empty_array(range->data.buffer + (range_start - range->start), (size_t)range_size);
+    return AWS_OP_SUCCESS;
+}
+
+static void s_do_work(struct aws_s3_object_reader *reader, struct aws_s3_object_reader_work *work);
+
+static void s_range_finished(
+    struct aws_s3_object_reader_range *range,
+    int error_code,
+    struct aws_s3_object_reader_work *work) {
+
+    struct aws_s3_object_reader *reader = range->reader;
+    struct aws_linked_list waiting_reads;
+    aws_linked_list_init(&waiting_reads);
+
+    /* BEGIN CRITICAL SECTION */
+    s_reader_lock_synced_data(reader);
+
+    range->synced_data.in_flight = false;
+    reader->synced_data.in_flight_size -= range->data.capacity;
+    aws_linked_list_swap_contents(&waiting_reads, &range->synced_data.waiting_reads);
+
+    if (error_code != AWS_ERROR_SUCCESS) {
+        /* Forget the range, so later reads try again */
+        aws_linked_list_remove(&range->node);
+        reader->synced_data.cached_size -= range->data.capacity;
+        aws_linked_list_push_back(&work->ranges_to_destroy, &range->node);
+
+        while (!aws_linked_list_empty(&waiting_reads)) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&waiting_reads);
+            struct aws_s3_object_reader_pending_read *read =
+                AWS_CONTAINER_OF(node, struct aws_s3_object_reader_pending_read, node);
+            read->error_code = error_code;
+            aws_linked_list_push_back(&work->reads_to_complete, &read->node);
+        }
+    } else {
+        range->data.len = (size_t)range->response_size;
+        if (range->not_satisfiable) {
+            /* Read started somewhere past end of object, so where the range ended says nothing about the size */
+            if (range->has_object_size && !reader->synced_data.object_size_known) {
+                reader->synced_data.object_size_known = true;
+                reader->synced_data.object_size = range->object_size;
+            }
+        } else if (range->data.len < range->data.capacity && !reader->synced_data.object_size_known) {
+            reader->synced_data.object_size_known = true;
+            reader->synced_data.object_size = range->start + range->data.len;
+        }
+
+        while (!aws_linked_list_empty(&waiting_reads)) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&waiting_reads);
+            struct aws_s3_object_reader_pending_read *read =
+                AWS_CONTAINER_OF(node, struct aws_s3_object_reader_pending_read, node);
+            s_process_read_synced(reader, read, work);
+            s_readahead_synced(reader, read->offset, read->readahead_size, work);
+        }
+    }
+
+    s_reader_unlock_synced_data(reader);
+    /* END CRITICAL SECTION */
+}
+
+/* Parses object size out of the Content-Range of a 416 response, which looks like "bytes *\/1234" */
+static int s_parse_unsatisfied_content_range(const struct aws_http_headers *headers, uint64_t *out_object_size) {
+    struct aws_byte_cursor content_range;
+    if (headers == NULL || aws_http_headers_get(headers, g_content_range_header_name, &content_range)) {
+        return aws_raise_error(AWS_ERROR_S3_MISSING_CONTENT_RANGE_HEADER);
+    }
+
+    struct aws_byte_cursor prefix = aws_byte_cursor_from_c_str("bytes */");
+    if (!aws_byte_cursor_starts_with(&content_range, &prefix)) {
+        return aws_raise_error(AWS_ERROR_S3_INVALID_CONTENT_RANGE_HEADER);
+    }
+    aws_byte_cursor_advance(&content_range, prefix.len);
+    if (aws_byte_cursor_utf8_parse_u64(content_range, out_object_size)) {
+        return aws_raise_error(AWS_ERROR_S3_INVALID_CONTENT_RANGE_HEADER);
+    }
+    return AWS_OP_SUCCESS;
+}
+
+static void s_range_finish_callback(
+    struct aws_s3_meta_request *meta_request,
+    const struct aws_s3_meta_request_result *result,
+    void *user_data) {
+    (void)meta_request;
+
+    struct aws_s3_object_reader_range *range = user_data;
+    struct aws_s3_object_reader *reader = range->reader;
+
+    int error_code = result->error_code;
+    if (error_code == AWS_ERROR_S3_INVALID_RESPONSE_STATUS &&
+        result->response_status == AWS_HTTP_STATUS_CODE_416_REQUESTED_RANGE_NOT_SATISFIABLE) {
+        /* Range starts at or past end of object */
+        range->response_size = 0;
+        range->not_satisfiable = true;
+        range->has_object_size =
+            s_parse_unsatisfied_content_range(result->error_response_headers, &range->object_size) == AWS_OP_SUCCESS;
+        error_code = AWS_ERROR_SUCCESS;
+    }
+    if (error_code != AWS_ERROR_SUCCESS) {
+        AWS_LOGF_ERROR(
+            AWS_LS_S3_GENERAL,
+            "id=%p Object reader failed to fetch range at %" PRIu64 ", error %d (%s)",
+            (void *)reader,
+            range->start,
+            error_code,
+            aws_error_str(error_code));
+    }
+
+    struct aws_s3_object_reader_work work;
+    s_work_init(&work);
+    s_range_finished(range, error_code, &work);
+    s_do_work(reader, &work);
+
+    /* Release the reference taken when the range was started */
+    aws_s3_object_reader_release(reader);
+}
+
+static int s_send_range(struct aws_s3_object_reader *reader, struct aws_s3_object_reader_range *range) {
+    struct aws_http_message *message = aws_s3_ranged_get_object_message_new(
+        reader->allocator, reader->message, range->start, range->start + range->data.capacity - 1);
+    if (message == NULL) {
+        return AWS_OP_ERR;
+    }
+
+    int result = AWS_OP_ERR;
+
+    /* BEGIN CRITICAL SECTION */
+    s_reader_lock_synced_data(reader);
+    struct aws_string *etag = reader->synced_data.etag != NULL
+                                  ? aws_string_clone_or_reuse(reader->allocator, reader->synced_data.etag)
+                                  : NULL;
+    s_reader_unlock_synced_data(reader);
+    /* END CRITICAL SECTION */
+
+    if (etag != NULL && !aws_http_headers_has(aws_http_message_get_headers(message), g_if_match_header_name)) {
+        struct aws_http_header if_match_header = {
+            .name = g_if_match_header_name,
+            .value = aws_byte_cursor_from_string(etag),
+        };
+        if (aws_http_message_add_header(message, if_match_header)) {
+            goto done;
+        }
+    }
+
+    struct aws_s3_meta_request_options options = {
+        .type = AWS_S3_META_REQUEST_TYPE_GET_OBJECT,
+        .message = message,
+        .signing_config =
+            reader->cached_signing_config != NULL ? &reader->cached_signing_config->config : NULL,
+        .user_data = range,
+        .headers_callback = s_range_headers_callback,
+        .receive_buffer_callback = s_range_receive_buffer_callback,
+        .finish_callback = s_range_finish_callback,
+    };
+
+    struct aws_s3_meta_request *meta_request = aws_s3_client_make_meta_request(reader->client, &options);
+    if (meta_request == NULL) {
+        goto done;
+    }
+    /* The client keeps the meta request alive until it finishes, and nothing here needs it after that */
+    aws_s3_meta_request_release(meta_request);
+    result = AWS_OP_SUCCESS;
+
+done:
+    aws_string_destroy(etag);
+    aws_http_message_release(message);
+    return result;
+}
+
+/* Send new ranges, complete finished reads and destroy dropped ranges.
+ * Done without the lock held, since completing a future can run the caller's code. */
+static void s_do_work(struct aws_s3_object_reader *reader, struct aws_s3_object_reader_work *work) {
+    while (!aws_linked_list_empty(&work->ranges_to_send)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&work->ranges_to_send);
+        struct aws_s3_object_reader_range *range =
+            AWS_CONTAINER_OF(node, struct aws_s3_object_reader_range, send_node);
+
+        if (s_send_range(reader, range)) {
+            /* Fail it like a range that didn't arrive */
+            s_range_finished(range, aws_last_error_or_unknown(), work);
+            aws_s3_object_reader_release(reader);
+        }
+    }
+
+    while (!aws_linked_list_empty(&work->reads_to_complete)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&work->reads_to_complete);
+        struct aws_s3_object_reader_pending_read *read =
+            AWS_CONTAINER_OF(node, struct aws_s3_object_reader_pending_read, node);
+        if (read->error_code != AWS_ERROR_SUCCESS) {
+            aws_future_bool_set_error(read->future, read->error_code);
+        } else {
+            aws_future_bool_set_result(read->future, read->end_of_object);
+        }
+        aws_future_bool_release(read->future);
+        aws_mem_release(reader->allocator, read);
+    }
+
+    while (!aws_linked_list_empty(&work->ranges_to_destroy)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(&work->ranges_to_destroy);
+        s_range_destroy(AWS_CONTAINER_OF(node, struct aws_s3_object_reader_range, node));
+    }
+}
+
+struct aws_future_bool *aws_s3_object_reader_read(
+    struct aws_s3_object_reader *reader,
+    uint64_t offset,
+    struct aws_byte_buf *dest) {
+
+    AWS_PRECONDITION(reader);
+    AWS_PRECONDITION(dest);
+
+    struct aws_future_bool *future = aws_future_bool_new(reader->allocator);
+
+    struct aws_s3_object_reader_pending_read *read =
+        aws_mem_calloc(reader->allocator, 1, sizeof(struct aws_s3_object_reader_pending_read));
+    read->offset = offset;
+    read->dest = dest;
+    read->future = aws_future_bool_acquire(future);
+
+    uint64_t read_size = dest->capacity - dest->len;
+
+    struct aws_s3_object_reader_work work;
+    s_work_init(&work);
+
+    /* BEGIN CRITICAL SECTION */
+    s_reader_lock_synced_data(reader);
+
+    /* Grow the readahead while reads pick up where the last one ended, start over once they don't */
+    if (offset == reader->synced_data.next_sequential_offset) {
+        uint64_t readahead_size = reader->synced_data.readahead_size == 0
+                                      ? reader->initial_readahead_size
+                                      : aws_mul_u64_saturating(reader->synced_data.readahead_size, 2);
+        reader->synced_data.readahead_size = aws_min_u64(readahead_size, reader->max_readahead_size);
+    } else {
+        reader->synced_data.readahead_size = 0;
+    }
+    reader->synced_data.next_sequential_offset = aws_add_u64_saturating(offset, read_size);
+    read->readahead_size = reader->synced_data.readahead_size;
+
+    s_process_read_synced(reader, read, &work);
+    s_readahead_synced(reader, aws_add_u64_saturating(offset, read_size), read->readahead_size, &work);
+
+    s_reader_unlock_synced_data(reader);
+    /* END CRITICAL SECTION */
+
+    s_do_work(reader, &work);
+    return future;
+}
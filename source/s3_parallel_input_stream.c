@@ -3,15 +3,34 @@
  * SPDX-License-Identifier: Apache-2.0.
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* For O_DIRECT */
+#    define _GNU_SOURCE
+#endif
+
 #include "aws/s3/private/s3_parallel_input_stream.h"
+#include "aws/s3/private/s3_util.h"
 
 #include <aws/common/file.h>
+#include <aws/common/math.h>
+#include <aws/common/string.h>
+#include <aws/common/task.h>
 
+#include <aws/io/event_loop.h>
 #include <aws/io/future.h>
-#include <aws/io/stream.h>
 
 #include <errno.h>
 
+#if !defined(_WIN32)
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+/* Keep each read below what a single read call is guaranteed to handle on all platforms */
+static const size_t s_max_read_size = 1024 * 1024 * 1024;
+
 void aws_parallel_input_stream_init_base(
     struct aws_parallel_input_stream *stream,
     struct aws_allocator *alloc,
@@ -53,20 +72,165 @@ struct aws_future_bool *aws_parallel_input_stream_read(
     return future;
 }
 
+bool aws_parallel_input_stream_is_mapped(const struct aws_parallel_input_stream *stream) {
+    return stream->vtable->get_mapped_range != NULL;
+}
+
+int aws_parallel_input_stream_get_mapped_range(
+    struct aws_parallel_input_stream *stream,
+    uint64_t offset,
+    size_t length,
+    struct aws_byte_cursor *out_range) {
+    AWS_PRECONDITION(out_range);
+
+    if (stream->vtable->get_mapped_range == NULL) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+    return stream->vtable->get_mapped_range(stream, offset, length, out_range);
+}
+
 struct aws_parallel_input_stream_from_file_impl {
     struct aws_parallel_input_stream base;
 
-    struct aws_string *file_path;
+    /* Event loops the reads run on, or NULL to read on the calling thread */
+    struct aws_event_loop_group *reading_elg;
+
+#if defined(_WIN32)
+    /* Opened for overlapped I/O, so reads at different offsets run at once */
+    void *file;
+#else
+    int fd;
+
+    /* Same file opened for direct I/O, or -1. Aligned blocks are read through it, bypassing the page cache. */
+    int direct_fd;
+#endif
+};
+
+/* A read waiting for its turn on an event loop of the reading_elg */
+struct aws_parallel_input_stream_from_file_read_task {
+    struct aws_allocator *alloc;
+    struct aws_task task;
+
+    struct aws_parallel_input_stream *stream;
+    uint64_t offset;
+    struct aws_byte_buf *dest;
+    struct aws_future_bool *future;
 };
 
 static void s_para_from_file_destroy(struct aws_parallel_input_stream *stream) {
     struct aws_parallel_input_stream_from_file_impl *impl = stream->impl;
 
-    aws_string_destroy(impl->file_path);
+#if defined(_WIN32)
+    aws_s3_close_overlapped_file(impl->file);
+#else
+    if (impl->fd >= 0) {
+        close(impl->fd);
+    }
+    if (impl->direct_fd >= 0) {
+        close(impl->direct_fd);
+    }
+#endif
+    aws_event_loop_group_release(impl->reading_elg);
 
     aws_mem_release(stream->alloc, impl);
 }
 
+#if defined(_WIN32)
+
+/* Read from the offset until dest is full or EOF is reached, blocking until done */
+static int s_para_from_file_read_blocking(
+    struct aws_parallel_input_stream_from_file_impl *impl,
+    uint64_t offset,
+    struct aws_byte_buf *dest,
+    bool *out_end_of_stream) {
+
+    while (dest->len < dest->capacity) {
+        uint32_t to_read = (uint32_t)aws_min_size(dest->capacity - dest->len, s_max_read_size);
+        uint32_t num_read = 0;
+        if (aws_s3_overlapped_file_io(impl->file, offset, dest->buffer + dest->len, to_read, false, &num_read)) {
+            return AWS_OP_ERR;
+        }
+        if (num_read == 0) {
+            *out_end_of_stream = true;
+            break;
+        }
+        dest->len += num_read;
+        offset += num_read;
+    }
+    return AWS_OP_SUCCESS;
+}
+
+#else
+
+/* Read from the offset until dest is full or EOF is reached, blocking until done */
+static int s_para_from_file_read_blocking(
+    struct aws_parallel_input_stream_from_file_impl *impl,
+    uint64_t offset,
+    struct aws_byte_buf *dest,
+    bool *out_end_of_stream) {
+
+    bool use_direct_io = impl->direct_fd >= 0;
+    while (dest->len < dest->capacity) {
+        size_t to_read = aws_min_size(dest->capacity - dest->len, s_max_read_size);
+        int fd = impl->fd;
+        if (use_direct_io) {
+            bool direct = false;
+            to_read = aws_s3_next_direct_io_piece(dest->buffer + dest->len, offset, to_read, &direct);
+            if (direct) {
+                fd = impl->direct_fd;
+            }
+        }
+        ssize_t num_read = pread(fd, dest->buffer + dest->len, to_read, (off_t)offset);
+        if (num_read < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EINVAL && fd == impl->direct_fd) {
+                /* The file system wants a different alignment, read the rest through the page cache */
+                use_direct_io = false;
+                continue;
+            }
+            return aws_translate_and_raise_io_error(errno);
+        }
+        if (num_read == 0) {
+            *out_end_of_stream = true;
+            break;
+        }
+        dest->len += (size_t)num_read;
+        offset += (uint64_t)num_read;
+    }
+    return AWS_OP_SUCCESS;
+}
+
+#endif
+
+static void s_para_from_file_read_into_future(
+    struct aws_parallel_input_stream *stream,
+    uint64_t offset,
+    struct aws_byte_buf *dest,
+    struct aws_future_bool *future) {
+
+    bool end_of_stream = false;
+    if (s_para_from_file_read_blocking(stream->impl, offset, dest, &end_of_stream)) {
+        aws_future_bool_set_error(future, aws_last_error());
+    } else {
+        aws_future_bool_set_result(future, end_of_stream);
+    }
+}
+
+static void s_para_from_file_read_task(struct aws_task *task, void *arg, enum aws_task_status status) {
+    (void)task;
+    /* The read still runs if the event loop is shutting down, the future must complete either way */
+    (void)status;
+    struct aws_parallel_input_stream_from_file_read_task *read_task = arg;
+
+    s_para_from_file_read_into_future(read_task->stream, read_task->offset, read_task->dest, read_task->future);
+
+    aws_future_bool_release(read_task->future);
+    aws_parallel_input_stream_release(read_task->stream);
+    aws_mem_release(read_task->alloc, read_task);
+}
+
 struct aws_future_bool *s_para_from_file_read(
     struct aws_parallel_input_stream *stream,
     uint64_t offset,
@@ -74,44 +238,24 @@ struct aws_future_bool *s_para_from_file_read(
 
     struct aws_future_bool *future = aws_future_bool_new(stream->alloc);
     struct aws_parallel_input_stream_from_file_impl *impl = stream->impl;
-    bool success = false;
-    struct aws_input_stream *file_stream = NULL;
-    struct aws_stream_status status = {
-        .is_end_of_stream = false,
-        .is_valid = true,
-    };
-
-    file_stream = aws_input_stream_new_from_file(stream->alloc, aws_string_c_str(impl->file_path));
-    if (!file_stream) {
-        goto done;
-    }
-
-    if (aws_input_stream_seek(file_stream, offset, AWS_SSB_BEGIN)) {
-        goto done;
-    }
-    /* Keep reading until fill the buffer.
-     * Note that we must read() after seek() to determine if we're EOF, the seek alone won't trigger it. */
-    while ((dest->len < dest->capacity) && !status.is_end_of_stream) {
-        /* Read from stream */
-        if (aws_input_stream_read(file_stream, dest) != AWS_OP_SUCCESS) {
-            goto done;
-        }
 
-        /* Check if stream is done */
-        if (aws_input_stream_get_status(file_stream, &status) != AWS_OP_SUCCESS) {
-            goto done;
-        }
-    }
-    success = true;
-done:
-    if (success) {
-        aws_future_bool_set_result(future, status.is_end_of_stream);
-    } else {
-        aws_future_bool_set_error(future, aws_last_error());
+    if (impl->reading_elg == NULL) {
+        s_para_from_file_read_into_future(stream, offset, dest, future);
+        return future;
     }
 
-    aws_input_stream_release(file_stream);
+    /* Keep disk I/O off the caller's thread, which may be an event loop doing network I/O */
+    struct aws_parallel_input_stream_from_file_read_task *read_task =
+        aws_mem_calloc(stream->alloc, 1, sizeof(struct aws_parallel_input_stream_from_file_read_task));
+    read_task->alloc = stream->alloc;
+    read_task->stream = aws_parallel_input_stream_acquire(stream);
+    read_task->offset = offset;
+    read_task->dest = dest;
+    read_task->future = aws_future_bool_acquire(future);
+    aws_task_init(&read_task->task, s_para_from_file_read_task, read_task, "s3_parallel_read_from_file");
 
+    struct aws_event_loop *loop = aws_event_loop_group_get_next_loop(impl->reading_elg);
+    aws_event_loop_schedule_task_now(loop, &read_task->task);
     return future;
 }
 
@@ -120,21 +264,214 @@ static struct aws_parallel_input_stream_vtable s_parallel_input_stream_from_file
     .read = s_para_from_file_read,
 };
 
-struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file(
+static struct aws_parallel_input_stream *s_para_from_file_new(
     struct aws_allocator *allocator,
-    struct aws_byte_cursor file_name) {
+    struct aws_byte_cursor file_name,
+    struct aws_event_loop_group *reading_elg,
+    bool direct_io) {
 
     struct aws_parallel_input_stream_from_file_impl *impl =
         aws_mem_calloc(allocator, 1, sizeof(struct aws_parallel_input_stream_from_file_impl));
     aws_parallel_input_stream_init_base(&impl->base, allocator, &s_parallel_input_stream_from_file_vtable, impl);
-    impl->file_path = aws_string_new_from_cursor(allocator, &file_name);
-    if (!aws_path_exists(impl->file_path)) {
-        /* If file path not exists, raise error from errno. */
+    impl->reading_elg = aws_event_loop_group_acquire(reading_elg);
+
+    struct aws_string *file_path = aws_string_new_from_cursor(allocator, &file_name);
+#if defined(_WIN32)
+    impl->file = aws_s3_open_overlapped_file(allocator, file_path, false /*for_write*/);
+    bool opened = impl->file != NULL;
+#else
+    impl->fd = open(aws_string_c_str(file_path), O_RDONLY | O_CLOEXEC);
+    bool opened = impl->fd >= 0;
+    if (!opened) {
         aws_translate_and_raise_io_error(errno);
+    }
+#    if defined(POSIX_FADV_SEQUENTIAL)
+    if (opened) {
+        /* Each part is read front to back, so let the kernel read ahead further. Only a hint, failure is fine. */
+        (void)posix_fadvise(impl->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+#    endif
+    impl->direct_fd = -1;
+#    if defined(O_DIRECT)
+    if (opened && direct_io) {
+        impl->direct_fd = open(aws_string_c_str(file_path), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        if (impl->direct_fd < 0) {
+            /* ex. EINVAL on file systems without direct I/O */
+            AWS_LOGF_DEBUG(
+                AWS_LS_S3_GENERAL,
+                "id=%p Could not open file for direct I/O, errno %d. Reading through the page cache instead.",
+                (void *)&impl->base,
+                errno);
+        }
+    }
+#    endif
+#endif
+    (void)direct_io;
+    aws_string_destroy(file_path);
+
+    if (!opened) {
+        s_para_from_file_destroy(&impl->base);
+        return NULL;
+    }
+    return &impl->base;
+}
+
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name,
+    struct aws_event_loop_group *reading_elg) {
+
+    return s_para_from_file_new(allocator, file_name, reading_elg, false /*direct_io*/);
+}
+
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file_direct(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name,
+    struct aws_event_loop_group *reading_elg) {
+
+    return s_para_from_file_new(allocator, file_name, reading_elg, true /*direct_io*/);
+}
+
+struct aws_parallel_input_stream_in_memory_impl {
+    struct aws_parallel_input_stream base;
+
+    /* The data. NULL if empty. */
+    uint8_t *mapping;
+    size_t size;
+    size_t page_size;
+
+    /* True if mapping is a file mapped by the stream, false if it's the caller's memory */
+    bool is_file_mapping;
+};
+
+static void s_para_in_memory_destroy(struct aws_parallel_input_stream *stream) {
+    struct aws_parallel_input_stream_in_memory_impl *impl = stream->impl;
+
+#if !defined(_WIN32)
+    if (impl->is_file_mapping && impl->mapping != NULL) {
+        munmap(impl->mapping, impl->size);
+    }
+#endif
+    aws_mem_release(stream->alloc, impl);
+}
+
+static int s_para_in_memory_get_mapped_range(
+    struct aws_parallel_input_stream *stream,
+    uint64_t offset,
+    size_t length,
+    struct aws_byte_cursor *out_range) {
+
+    struct aws_parallel_input_stream_in_memory_impl *impl = stream->impl;
+
+    AWS_ZERO_STRUCT(*out_range);
+    if (offset >= impl->size) {
+        return AWS_OP_SUCCESS;
+    }
+    size_t start = (size_t)offset;
+    *out_range = aws_byte_cursor_from_array(impl->mapping + start, aws_min_size(length, impl->size - start));
+
+#if defined(MADV_WILLNEED)
+    if (impl->is_file_mapping && out_range->len > 0) {
+        /* The range is about to be sent, start paging it in now. Only a hint, failure is fine. */
+        size_t page_start = start - start % impl->page_size;
+        (void)madvise(impl->mapping + page_start, start + out_range->len - page_start, MADV_WILLNEED);
+    }
+#endif
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_future_bool *s_para_in_memory_read(
+    struct aws_parallel_input_stream *stream,
+    uint64_t offset,
+    struct aws_byte_buf *dest) {
+
+    struct aws_future_bool *future = aws_future_bool_new(stream->alloc);
+
+    size_t length = dest->capacity - dest->len;
+    struct aws_byte_cursor range;
+    s_para_in_memory_get_mapped_range(stream, offset, length, &range);
+    aws_byte_buf_write_from_whole_cursor(dest, range);
+    aws_future_bool_set_result(future, range.len < length /*end_of_stream*/);
+    return future;
+}
+
+static struct aws_parallel_input_stream_vtable s_parallel_input_stream_in_memory_vtable = {
+    .destroy = s_para_in_memory_destroy,
+    .read = s_para_in_memory_read,
+    .get_mapped_range = s_para_in_memory_get_mapped_range,
+};
+
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file_mmap(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name) {
+
+#if defined(_WIN32)
+    (void)allocator;
+    (void)file_name;
+
+    aws_raise_error(AWS_ERROR_PLATFORM_NOT_SUPPORTED);
+    return NULL;
+#else
+    struct aws_parallel_input_stream_in_memory_impl *impl =
+        aws_mem_calloc(allocator, 1, sizeof(struct aws_parallel_input_stream_in_memory_impl));
+    aws_parallel_input_stream_init_base(&impl->base, allocator, &s_parallel_input_stream_in_memory_vtable, impl);
+    impl->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    impl->is_file_mapping = true;
+
+    struct aws_string *file_path = aws_string_new_from_cursor(allocator, &file_name);
+    int fd = open(aws_string_c_str(file_path), O_RDONLY | O_CLOEXEC);
+    aws_string_destroy(file_path);
+    if (fd < 0) {
+        aws_translate_and_raise_io_error(errno);
+        goto error;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat)) {
+        aws_translate_and_raise_io_error(errno);
+        goto error;
+    }
+    impl->size = (size_t)file_stat.st_size;
+    if ((off_t)impl->size != file_stat.st_size) {
+        /* Too big to map in a 32-bit address space */
+        aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
         goto error;
     }
+
+    if (impl->size > 0) {
+        void *mapping = mmap(NULL, impl->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            aws_translate_and_raise_io_error(errno);
+            goto error;
+        }
+        impl->mapping = mapping;
+#    if defined(MADV_SEQUENTIAL)
+        /* Each part is sent front to back, so let the kernel read ahead further. Only a hint, failure is fine. */
+        (void)madvise(impl->mapping, impl->size, MADV_SEQUENTIAL);
+#    endif
+    }
+
+    /* The mapping keeps the file's data reachable after the descriptor is closed */
+    close(fd);
     return &impl->base;
+
 error:
-    s_para_from_file_destroy(&impl->base);
+    if (fd >= 0) {
+        close(fd);
+    }
+    s_para_in_memory_destroy(&impl->base);
     return NULL;
+#endif
+}
+
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_buffer(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor buffer) {
+
+    struct aws_parallel_input_stream_in_memory_impl *impl =
+        aws_mem_calloc(allocator, 1, sizeof(struct aws_parallel_input_stream_in_memory_impl));
+    aws_parallel_input_stream_init_base(&impl->base, allocator, &s_parallel_input_stream_in_memory_vtable, impl);
+    impl->mapping = buffer.len > 0 ? buffer.ptr : NULL;
+    impl->size = buffer.len;
+    return &impl->base;
 }
@@ -0,0 +1,719 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include "aws/s3/private/s3_parallel_input_stream.h"
+
+#if defined(AWS_S3_HAVE_IO_URING)
+#    include <sys/syscall.h>
+#endif
+
+#if defined(AWS_S3_HAVE_IO_URING) && defined(__NR_io_uring_setup)
+
+#    include <aws/common/condition_variable.h>
+#    include <aws/common/file.h>
+#    include <aws/common/linked_list.h>
+#    include <aws/common/math.h>
+#    include <aws/common/mutex.h>
+#    include <aws/common/ref_count.h>
+#    include <aws/common/string.h>
+#    include <aws/common/thread.h>
+#    include <aws/io/future.h>
+#    include <aws/s3/s3.h>
+
+#    include <errno.h>
+#    include <fcntl.h>
+#    include <inttypes.h>
+#    include <linux/io_uring.h>
+#    include <string.h>
+#    include <sys/mman.h>
+#    include <sys/uio.h>
+#    include <unistd.h>
+
+/* Number of submission queue entries, shared by all the files read through the ring */
+static const uint32_t s_queue_depth = 128;
+
+/* Size of the registered file table. Streams past that many at once read through plain fds. */
+static const uint32_t s_num_file_slots = 256;
+
+/* Keep each read below what a single read call is guaranteed to handle */
+static const size_t s_max_read_size = 1024 * 1024 * 1024;
+
+/* A read of a stream, from the time it's asked for until its future completes */
+struct aws_parallel_input_stream_io_uring_read {
+    struct aws_allocator *alloc;
+
+    /* Node in the ring's pending_reads or reads_in_flight */
+    struct aws_linked_list_node node;
+
+    /* Holds the stream, and so its fd, until the read is done */
+    struct aws_parallel_input_stream_io_uring_impl *stream;
+
+    struct iovec iov;
+    uint64_t offset;
+    struct aws_byte_buf *dest;
+    struct aws_future_bool *future;
+    int error_code;
+    bool end_of_stream;
+};
+
+struct aws_s3_io_uring {
+    struct aws_allocator *allocator;
+    struct aws_ref_count ref_count;
+
+    int ring_fd;
+
+    /* Rings shared with the kernel. The completion ring may be the same mapping as the submission ring. */
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+
+    uint32_t *sq_head;
+    uint32_t *sq_tail;
+    uint32_t *sq_mask;
+    uint32_t *sq_array;
+    uint32_t *cq_head;
+    uint32_t *cq_tail;
+    uint32_t *cq_mask;
+    struct io_uring_cqe *cqes;
+
+    uint32_t max_reads_in_flight;
+
+    /* Size of the registered file table, 0 if the kernel couldn't register one */
+    uint32_t num_file_slots;
+
+    /* Reaps completions and completes the futures of the reads. Sleeps on wake_poller while no read is in flight.
+     * Once the ring is released, it cleans the ring up. */
+    struct aws_thread poller;
+
+    /* Lock for putting entries on the submission ring, and for synced_data */
+    struct aws_mutex lock;
+    struct aws_condition_variable wake_poller;
+
+    struct {
+        uint32_t num_reads_in_flight;
+
+        /* aws_parallel_input_stream_io_uring_read on the submission ring, in the order they were put there.
+         * The last num_sqes_queued of them aren't submitted to the kernel yet. */
+        struct aws_linked_list reads_in_flight;
+        uint32_t num_sqes_queued;
+
+        /* Set while a thread submits the queued entries, see s_submit_queued() */
+        bool submitting;
+
+        /* Free slots of the registered file table, num_free_file_slots of them */
+        uint32_t *free_file_slots;
+        uint32_t num_free_file_slots;
+
+        /* aws_parallel_input_stream_io_uring_read waiting for room in the ring */
+        struct aws_linked_list pending_reads;
+
+        /* Set once waiting for completions failed. Reads fail with it from then on. */
+        int error_code;
+
+        bool released;
+    } synced_data;
+};
+
+struct aws_parallel_input_stream_io_uring_impl {
+    struct aws_parallel_input_stream base;
+
+    int fd;
+    /* Slot of fd in the ring's registered file table, or -1 if reads use fd */
+    int32_t file_slot;
+    struct aws_s3_io_uring *ring;
+};
+
+static void s_io_uring_clean_up(struct aws_s3_io_uring *ring) {
+    if (ring->sqes != NULL) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ring != NULL && ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring != NULL) {
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+    if (ring->ring_fd >= 0) {
+        close(ring->ring_fd);
+    }
+    if (ring->synced_data.free_file_slots != NULL) {
+        aws_mem_release(ring->allocator, ring->synced_data.free_file_slots);
+    }
+    aws_condition_variable_clean_up(&ring->wake_poller);
+    aws_mutex_clean_up(&ring->lock);
+    aws_mem_release(ring->allocator, ring);
+}
+
+static void s_complete_read(struct aws_parallel_input_stream_io_uring_read *read) {
+    if (read->error_code != AWS_ERROR_SUCCESS) {
+        aws_future_bool_set_error(read->future, read->error_code);
+    } else {
+        aws_future_bool_set_result(read->future, read->end_of_stream);
+    }
+    aws_future_bool_release(read->future);
+    aws_parallel_input_stream_release(&read->stream->base);
+    aws_mem_release(read->alloc, read);
+}
+
+static void s_complete_reads(struct aws_linked_list *reads) {
+    while (!aws_linked_list_empty(reads)) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_front(reads);
+        s_complete_read(AWS_CONTAINER_OF(node, struct aws_parallel_input_stream_io_uring_read, node));
+    }
+}
+
+/* Put a read on the submission ring. It's submitted to the kernel by s_submit_queued(). */
+static void s_queue_sqe_synced(struct aws_s3_io_uring *ring, struct aws_parallel_input_stream_io_uring_read *read) {
+    /* Only ever written with the lock held. Reads in flight never outnumber the entries, so there's room. */
+    uint32_t tail = *ring->sq_tail;
+    uint32_t index = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+    read->iov.iov_base = read->dest->buffer + read->dest->len;
+    read->iov.iov_len = aws_min_size(read->dest->capacity - read->dest->len, s_max_read_size);
+    sqe->opcode = IORING_OP_READV;
+    if (read->stream->file_slot >= 0) {
+        sqe->fd = read->stream->file_slot;
+        sqe->flags = IOSQE_FIXED_FILE;
+    } else {
+        sqe->fd = read->stream->fd;
+    }
+    sqe->addr = (uint64_t)(uintptr_t)&read->iov;
+    sqe->len = 1;
+    sqe->off = read->offset;
+    sqe->user_data = (uint64_t)(uintptr_t)read;
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    ++ring->synced_data.num_sqes_queued;
+}
+
+/* Put the read on the submission ring, or queue it if the ring is full. Returns AWS_OP_ERR, with the read's
+ * error_code set, if the ring can't be used anymore. */
+static int s_submit_read_synced(struct aws_s3_io_uring *ring, struct aws_parallel_input_stream_io_uring_read *read) {
+    if (ring->synced_data.error_code != AWS_ERROR_SUCCESS) {
+        read->error_code = ring->synced_data.error_code;
+        return AWS_OP_ERR;
+    }
+    if (ring->synced_data.num_reads_in_flight >= ring->max_reads_in_flight) {
+        aws_linked_list_push_back(&ring->synced_data.pending_reads, &read->node);
+        return AWS_OP_SUCCESS;
+    }
+    s_queue_sqe_synced(ring, read);
+    aws_linked_list_push_back(&ring->synced_data.reads_in_flight, &read->node);
+    ++ring->synced_data.num_reads_in_flight;
+    return AWS_OP_SUCCESS;
+}
+
+/* Take the entries that couldn't be submitted back off the submission ring, and fail their reads */
+static void s_fail_queued_synced(struct aws_s3_io_uring *ring, int error_code, struct aws_linked_list *failed_reads) {
+    __atomic_store_n(ring->sq_tail, *ring->sq_tail - ring->synced_data.num_sqes_queued, __ATOMIC_RELEASE);
+    for (; ring->synced_data.num_sqes_queued > 0; --ring->synced_data.num_sqes_queued) {
+        struct aws_linked_list_node *node = aws_linked_list_pop_back(&ring->synced_data.reads_in_flight);
+        AWS_CONTAINER_OF(node, struct aws_parallel_input_stream_io_uring_read, node)->error_code = error_code;
+        aws_linked_list_push_front(failed_reads, node);
+        --ring->synced_data.num_reads_in_flight;
+    }
+}
+
+/* Submit every entry queued on the submission ring with one io_uring_enter() call, unless another thread is
+ * already submitting. That thread goes around again for entries queued meanwhile, so reads asked for at about the
+ * same time are submitted together. */
+static void s_submit_queued(struct aws_s3_io_uring *ring) {
+    struct aws_linked_list failed_reads;
+    aws_linked_list_init(&failed_reads);
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&ring->lock);
+    if (ring->synced_data.submitting) {
+        aws_mutex_unlock(&ring->lock);
+        return;
+    }
+    ring->synced_data.submitting = true;
+
+    while (ring->synced_data.num_sqes_queued > 0 && ring->synced_data.error_code == AWS_ERROR_SUCCESS) {
+        uint32_t to_submit = ring->synced_data.num_sqes_queued;
+        aws_mutex_unlock(&ring->lock);
+        long submitted = syscall(__NR_io_uring_enter, ring->ring_fd, to_submit, 0, 0, NULL, 0);
+        int error = errno;
+        aws_mutex_lock(&ring->lock);
+
+        if (ring->synced_data.error_code != AWS_ERROR_SUCCESS) {
+            /* The ring failed meanwhile, and its reads with it */
+            break;
+        }
+        if (submitted >= 0) {
+            if (submitted > 0 && ring->synced_data.num_reads_in_flight == ring->synced_data.num_sqes_queued) {
+                /* First reads in the kernel, the poller has completions to wait for now */
+                aws_condition_variable_notify_one(&ring->wake_poller);
+            }
+            ring->synced_data.num_sqes_queued -= (uint32_t)submitted;
+            continue;
+        }
+        if (error == EINTR) {
+            continue;
+        }
+        if ((error == EAGAIN || error == EBUSY) &&
+            ring->synced_data.num_reads_in_flight > ring->synced_data.num_sqes_queued) {
+            /* Kernel is short on resources. The poller tries again once a read in the kernel completes. */
+            break;
+        }
+        aws_translate_and_raise_io_error(error);
+        s_fail_queued_synced(ring, aws_last_error(), &failed_reads);
+    }
+
+    ring->synced_data.submitting = false;
+    aws_mutex_unlock(&ring->lock);
+    /* END CRITICAL SECTION */
+
+    s_complete_reads(&failed_reads);
+}
+
+/* Only wait on the ring for reads submitted to the kernel. Queued ones might never get there. */
+static bool s_poller_has_work(void *arg) {
+    struct aws_s3_io_uring *ring = arg;
+    return ring->synced_data.num_reads_in_flight > ring->synced_data.num_sqes_queued || ring->synced_data.released;
+}
+
+/* Waiting on the ring failed, and would keep failing. Fail every read, in flight or waiting, and stop using the ring
+ * rather than spin on it. */
+static void s_fail_ring(struct aws_s3_io_uring *ring, int error) {
+    AWS_LOGF_ERROR(
+        AWS_LS_S3_GENERAL,
+        "id=%p Waiting for io_uring completions failed with errno %d, failing its reads",
+        (void *)ring,
+        error);
+
+    struct aws_linked_list failed_reads;
+    aws_linked_list_init(&failed_reads);
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&ring->lock);
+    aws_translate_and_raise_io_error(error);
+    int error_code = aws_last_error();
+    ring->synced_data.error_code = error_code;
+    aws_linked_list_move_all_back(&failed_reads, &ring->synced_data.reads_in_flight);
+    aws_linked_list_move_all_back(&failed_reads, &ring->synced_data.pending_reads);
+    ring->synced_data.num_reads_in_flight = 0;
+    ring->synced_data.num_sqes_queued = 0;
+    aws_mutex_unlock(&ring->lock);
+    /* END CRITICAL SECTION */
+
+    for (struct aws_linked_list_node *node = aws_linked_list_begin(&failed_reads);
+         node != aws_linked_list_end(&failed_reads);
+         node = aws_linked_list_next(node)) {
+        AWS_CONTAINER_OF(node, struct aws_parallel_input_stream_io_uring_read, node)->error_code = error_code;
+    }
+    s_complete_reads(&failed_reads);
+}
+
+static void s_poller_thread(void *arg) {
+    struct aws_s3_io_uring *ring = arg;
+
+    while (true) {
+        /* BEGIN CRITICAL SECTION */
+        aws_mutex_lock(&ring->lock);
+        aws_condition_variable_wait_pred(&ring->wake_poller, &ring->lock, s_poller_has_work, ring);
+        /* Streams hold the ring, and reads hold their stream, so nothing is in flight once it's released */
+        bool done = ring->synced_data.num_reads_in_flight == 0;
+        aws_mutex_unlock(&ring->lock);
+        /* END CRITICAL SECTION */
+
+        if (done) {
+            break;
+        }
+
+        if (syscall(__NR_io_uring_enter, ring->ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+            errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            s_fail_ring(ring, errno);
+            continue;
+        }
+
+        /* Reads that got less than they asked for go again for the rest */
+        struct aws_linked_list resubmit_reads;
+        aws_linked_list_init(&resubmit_reads);
+        struct aws_linked_list done_reads;
+        aws_linked_list_init(&done_reads);
+
+        /* BEGIN CRITICAL SECTION */
+        aws_mutex_lock(&ring->lock);
+        uint32_t head = *ring->cq_head;
+        uint32_t tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            struct aws_parallel_input_stream_io_uring_read *read = (void *)(uintptr_t)cqe->user_data;
+            int32_t result = cqe->res;
+
+            aws_linked_list_remove(&read->node);
+            --ring->synced_data.num_reads_in_flight;
+
+            if (result == -EINTR || result == -EAGAIN) {
+                aws_linked_list_push_back(&resubmit_reads, &read->node);
+            } else if (result < 0) {
+                aws_translate_and_raise_io_error(-result);
+                read->error_code = aws_last_error();
+                aws_linked_list_push_back(&done_reads, &read->node);
+            } else if (result == 0) {
+                read->end_of_stream = true;
+                aws_linked_list_push_back(&done_reads, &read->node);
+            } else {
+                read->dest->len += (size_t)result;
+                read->offset += (uint64_t)result;
+                if (read->dest->len == read->dest->capacity) {
+                    aws_linked_list_push_back(&done_reads, &read->node);
+                } else {
+                    aws_linked_list_push_back(&resubmit_reads, &read->node);
+                }
+            }
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+        aws_linked_list_move_all_front(&ring->synced_data.pending_reads, &resubmit_reads);
+        while (!aws_linked_list_empty(&ring->synced_data.pending_reads) &&
+               ring->synced_data.num_reads_in_flight < ring->max_reads_in_flight) {
+            struct aws_linked_list_node *node = aws_linked_list_pop_front(&ring->synced_data.pending_reads);
+            struct aws_parallel_input_stream_io_uring_read *read =
+                AWS_CONTAINER_OF(node, struct aws_parallel_input_stream_io_uring_read, node);
+            if (s_submit_read_synced(ring, read)) {
+                aws_linked_list_push_back(&done_reads, &read->node);
+            }
+        }
+        aws_mutex_unlock(&ring->lock);
+        /* END CRITICAL SECTION */
+
+        /* Resubmitted reads, and any left queued before, go to the kernel together */
+        s_submit_queued(ring);
+        s_complete_reads(&done_reads);
+    }
+
+    s_io_uring_clean_up(ring);
+}
+
+/* The poller cleans up the ring once it wakes up */
+static void s_io_uring_destroy(void *user_data) {
+    struct aws_s3_io_uring *ring = user_data;
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&ring->lock);
+    ring->synced_data.released = true;
+    aws_condition_variable_notify_one(&ring->wake_poller);
+    aws_mutex_unlock(&ring->lock);
+    /* END CRITICAL SECTION */
+}
+
+static int s_map_rings(struct aws_s3_io_uring *ring, const struct io_uring_params *params) {
+    ring->sq_ring_size = params->sq_off.array + params->sq_entries * sizeof(uint32_t);
+    ring->cq_ring_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+
+    bool single_mmap = false;
+#    if defined(IORING_FEAT_SINGLE_MMAP)
+    single_mmap = (params->features & IORING_FEAT_SINGLE_MMAP) != 0;
+#    endif
+    if (single_mmap) {
+        ring->sq_ring_size = aws_max_size(ring->sq_ring_size, ring->cq_ring_size);
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    void *sq_ring = mmap(
+        NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+        return aws_translate_and_raise_io_error(errno);
+    }
+    ring->sq_ring = sq_ring;
+
+    if (single_mmap) {
+        ring->cq_ring = sq_ring;
+    } else {
+        void *cq_ring = mmap(
+            NULL,
+            ring->cq_ring_size,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_POPULATE,
+            ring->ring_fd,
+            IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED) {
+            return aws_translate_and_raise_io_error(errno);
+        }
+        ring->cq_ring = cq_ring;
+    }
+
+    void *sqes = mmap(
+        NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return aws_translate_and_raise_io_error(errno);
+    }
+    ring->sqes = sqes;
+
+    uint8_t *sq_base = ring->sq_ring;
+    ring->sq_head = (uint32_t *)(sq_base + params->sq_off.head);
+    ring->sq_tail = (uint32_t *)(sq_base + params->sq_off.tail);
+    ring->sq_mask = (uint32_t *)(sq_base + params->sq_off.ring_mask);
+    ring->sq_array = (uint32_t *)(sq_base + params->sq_off.array);
+
+    uint8_t *cq_base = ring->cq_ring;
+    ring->cq_head = (uint32_t *)(cq_base + params->cq_off.head);
+    ring->cq_tail = (uint32_t *)(cq_base + params->cq_off.tail);
+    ring->cq_mask = (uint32_t *)(cq_base + params->cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq_base + params->cq_off.cqes);
+    return AWS_OP_SUCCESS;
+}
+
+/* Register a table of empty file slots, so streams can put their fd in one instead of having it looked up for
+ * each read. Only an optimization, reads use plain fds if it fails. */
+static void s_register_file_table(struct aws_s3_io_uring *ring) {
+    int32_t *fds = aws_mem_calloc(ring->allocator, s_num_file_slots, sizeof(int32_t));
+    for (uint32_t i = 0; i < s_num_file_slots; ++i) {
+        fds[i] = -1;
+    }
+    int result = (int)syscall(__NR_io_uring_register, ring->ring_fd, IORING_REGISTER_FILES, fds, s_num_file_slots);
+    int error = errno;
+    aws_mem_release(ring->allocator, fds);
+    if (result < 0) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_S3_GENERAL,
+            "id=%p Could not register files with io_uring, errno %d. Reading through plain fds.",
+            (void *)ring,
+            error);
+        return;
+    }
+
+    ring->num_file_slots = s_num_file_slots;
+    ring->synced_data.free_file_slots = aws_mem_calloc(ring->allocator, s_num_file_slots, sizeof(uint32_t));
+    /* Lowest slots are handed out first */
+    for (uint32_t i = 0; i < s_num_file_slots; ++i) {
+        ring->synced_data.free_file_slots[i] = s_num_file_slots - 1 - i;
+    }
+    ring->synced_data.num_free_file_slots = s_num_file_slots;
+}
+
+/* Put fd in the slot of the registered file table */
+static int s_update_file_slot(struct aws_s3_io_uring *ring, uint32_t slot, int32_t fd) {
+    struct io_uring_files_update update;
+    AWS_ZERO_STRUCT(update);
+    update.offset = slot;
+    update.fds = (uint64_t)(uintptr_t)&fd;
+    if (syscall(__NR_io_uring_register, ring->ring_fd, IORING_REGISTER_FILES_UPDATE, &update, 1) < 0) {
+        return aws_translate_and_raise_io_error(errno);
+    }
+    return AWS_OP_SUCCESS;
+}
+
+/* Returns the slot of the registered file table fd was put in, or -1 if reads have to use fd */
+static int32_t s_register_file(struct aws_s3_io_uring *ring, int fd) {
+    if (ring->num_file_slots == 0) {
+        return -1;
+    }
+
+    uint32_t slot = 0;
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&ring->lock);
+    bool has_slot = ring->synced_data.num_free_file_slots > 0;
+    if (has_slot) {
+        slot = ring->synced_data.free_file_slots[--ring->synced_data.num_free_file_slots];
+    }
+    aws_mutex_unlock(&ring->lock);
+    /* END CRITICAL SECTION */
+
+    if (!has_slot) {
+        return -1;
+    }
+    if (s_update_file_slot(ring, slot, fd)) {
+        AWS_LOGF_DEBUG(
+            AWS_LS_S3_GENERAL,
+            "id=%p Could not register fd %d in io_uring file slot %" PRIu32 ", error %d. Reading through the fd.",
+            (void *)ring,
+            fd,
+            slot,
+            aws_last_error());
+        /* BEGIN CRITICAL SECTION */
+        aws_mutex_lock(&ring->lock);
+        ring->synced_data.free_file_slots[ring->synced_data.num_free_file_slots++] = slot;
+        aws_mutex_unlock(&ring->lock);
+        /* END CRITICAL SECTION */
+        return -1;
+    }
+    return (int32_t)slot;
+}
+
+/* Empty the slot and give it back. Nothing may be in flight for its file. */
+static void s_unregister_file(struct aws_s3_io_uring *ring, int32_t slot) {
+    if (slot < 0) {
+        return;
+    }
+    /* On failure the slot keeps its file until it's reused, or the ring is closed */
+    (void)s_update_file_slot(ring, (uint32_t)slot, -1);
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&ring->lock);
+    ring->synced_data.free_file_slots[ring->synced_data.num_free_file_slots++] = (uint32_t)slot;
+    aws_mutex_unlock(&ring->lock);
+    /* END CRITICAL SECTION */
+}
+
+struct aws_s3_io_uring *aws_s3_io_uring_new(struct aws_allocator *allocator) {
+    struct aws_s3_io_uring *ring = aws_mem_calloc(allocator, 1, sizeof(struct aws_s3_io_uring));
+    ring->allocator = allocator;
+    aws_ref_count_init(&ring->ref_count, ring, s_io_uring_destroy);
+    ring->ring_fd = -1;
+    aws_mutex_init(&ring->lock);
+    aws_condition_variable_init(&ring->wake_poller);
+    aws_linked_list_init(&ring->synced_data.reads_in_flight);
+    aws_linked_list_init(&ring->synced_data.pending_reads);
+
+    struct io_uring_params params;
+    AWS_ZERO_STRUCT(params);
+    ring->ring_fd = (int)syscall(__NR_io_uring_setup, s_queue_depth, &params);
+    if (ring->ring_fd < 0) {
+        /* ex. ENOSYS on kernels without io_uring, or EPERM where it's disabled */
+        AWS_LOGF_DEBUG(
+            AWS_LS_S3_GENERAL, "id=%p io_uring is not available, setup failed with errno %d", (void *)ring, errno);
+        aws_raise_error(AWS_ERROR_PLATFORM_NOT_SUPPORTED);
+        goto error;
+    }
+    if (s_map_rings(ring, &params)) {
+        goto error;
+    }
+    ring->max_reads_in_flight = params.sq_entries;
+    s_register_file_table(ring);
+
+    struct aws_thread_options thread_options = *aws_default_thread_options();
+    thread_options.join_strategy = AWS_TJS_MANAGED;
+    aws_thread_init(&ring->poller, allocator);
+    if (aws_thread_launch(&ring->poller, s_poller_thread, ring, &thread_options)) {
+        aws_thread_clean_up(&ring->poller);
+        goto error;
+    }
+
+    return ring;
+
+error:
+    s_io_uring_clean_up(ring);
+    return NULL;
+}
+
+struct aws_s3_io_uring *aws_s3_io_uring_acquire(struct aws_s3_io_uring *ring) {
+    if (ring != NULL) {
+        aws_ref_count_acquire(&ring->ref_count);
+    }
+    return ring;
+}
+
+struct aws_s3_io_uring *aws_s3_io_uring_release(struct aws_s3_io_uring *ring) {
+    if (ring != NULL) {
+        aws_ref_count_release(&ring->ref_count);
+    }
+    return NULL;
+}
+
+/* Reads hold the stream, so nothing is in flight for its fd anymore */
+static void s_para_io_uring_destroy(struct aws_parallel_input_stream *stream) {
+    struct aws_parallel_input_stream_io_uring_impl *impl = stream->impl;
+    s_unregister_file(impl->ring, impl->file_slot);
+    if (impl->fd >= 0) {
+        close(impl->fd);
+    }
+    aws_s3_io_uring_release(impl->ring);
+    aws_mem_release(stream->alloc, impl);
+}
+
+static struct aws_future_bool *s_para_io_uring_read(
+    struct aws_parallel_input_stream *stream,
+    uint64_t offset,
+    struct aws_byte_buf *dest) {
+
+    struct aws_parallel_input_stream_io_uring_impl *impl = stream->impl;
+    struct aws_s3_io_uring *ring = impl->ring;
+    struct aws_future_bool *future = aws_future_bool_new(stream->alloc);
+
+    struct aws_parallel_input_stream_io_uring_read *read =
+        aws_mem_calloc(stream->alloc, 1, sizeof(struct aws_parallel_input_stream_io_uring_read));
+    read->alloc = stream->alloc;
+    read->stream = impl;
+    aws_parallel_input_stream_acquire(stream);
+    read->offset = offset;
+    read->dest = dest;
+    read->future = aws_future_bool_acquire(future);
+
+    /* BEGIN CRITICAL SECTION */
+    aws_mutex_lock(&ring->lock);
+    int result = s_submit_read_synced(ring, read);
+    aws_mutex_unlock(&ring->lock);
+    /* END CRITICAL SECTION */
+
+    if (result) {
+        s_complete_read(read);
+    } else {
+        s_submit_queued(ring);
+    }
+    return future;
+}
+
+static struct aws_parallel_input_stream_vtable s_parallel_input_stream_io_uring_vtable = {
+    .destroy = s_para_io_uring_destroy,
+    .read = s_para_io_uring_read,
+};
+
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file_io_uring(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name,
+    struct aws_s3_io_uring *ring) {
+    AWS_PRECONDITION(ring);
+
+    struct aws_string *file_path = aws_string_new_from_cursor(allocator, &file_name);
+    int fd = open(aws_string_c_str(file_path), O_RDONLY | O_CLOEXEC);
+    aws_string_destroy(file_path);
+    if (fd < 0) {
+        aws_translate_and_raise_io_error(errno);
+        return NULL;
+    }
+#    if defined(POSIX_FADV_SEQUENTIAL)
+    /* Each part is read front to back, so let the kernel read ahead further. Only a hint, failure is fine. */
+    (void)posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#    endif
+
+    struct aws_parallel_input_stream_io_uring_impl *impl =
+        aws_mem_calloc(allocator, 1, sizeof(struct aws_parallel_input_stream_io_uring_impl));
+    aws_parallel_input_stream_init_base(&impl->base, allocator, &s_parallel_input_stream_io_uring_vtable, impl);
+    impl->fd = fd;
+    impl->file_slot = s_register_file(ring, fd);
+    impl->ring = aws_s3_io_uring_acquire(ring);
+    return &impl->base;
+}
+
+#else
+
+struct aws_s3_io_uring *aws_s3_io_uring_new(struct aws_allocator *allocator) {
+    (void)allocator;
+
+    aws_raise_error(AWS_ERROR_PLATFORM_NOT_SUPPORTED);
+    return NULL;
+}
+
+struct aws_s3_io_uring *aws_s3_io_uring_acquire(struct aws_s3_io_uring *ring) {
+    return ring;
+}
+
+struct aws_s3_io_uring *aws_s3_io_uring_release(struct aws_s3_io_uring *ring) {
+    (void)ring;
+    return NULL;
+}
+
+struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file_io_uring(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name,
+    struct aws_s3_io_uring *ring) {
+    (void)allocator;
+    (void)file_name;
+    (void)ring;
+
+    aws_raise_error(AWS_ERROR_PLATFORM_NOT_SUPPORTED);
+    return NULL;
+}
+
+#endif
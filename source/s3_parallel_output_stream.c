@@ -0,0 +1,252 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* For O_DIRECT */
+#    define _GNU_SOURCE
+#endif
+
+#include "aws/s3/private/s3_parallel_output_stream.h"
+#include "aws/s3/private/s3_util.h"
+
+#include <aws/common/file.h>
+#include <aws/common/math.h>
+#include <aws/common/string.h>
+
+#include <errno.h>
+
+#if !defined(_WIN32)
+#    include <fcntl.h>
+#    include <unistd.h>
+#endif
+
+/* Keep each write below what a single write call is guaranteed to handle on all platforms */
+static const size_t s_max_write_size = 1024 * 1024 * 1024;
+
+void aws_parallel_output_stream_init_base(
+    struct aws_parallel_output_stream *stream,
+    struct aws_allocator *alloc,
+    const struct aws_parallel_output_stream_vtable *vtable,
+    void *impl) {
+
+    AWS_ZERO_STRUCT(*stream);
+    stream->alloc = alloc;
+    stream->vtable = vtable;
+    stream->impl = impl;
+    aws_ref_count_init(&stream->ref_count, stream, (aws_simple_completion_callback *)vtable->destroy);
+}
+
+struct aws_parallel_output_stream *aws_parallel_output_stream_acquire(struct aws_parallel_output_stream *stream) {
+    if (stream != NULL) {
+        aws_ref_count_acquire(&stream->ref_count);
+    }
+    return stream;
+}
+
+struct aws_parallel_output_stream *aws_parallel_output_stream_release(struct aws_parallel_output_stream *stream) {
+    if (stream != NULL) {
+        aws_ref_count_release(&stream->ref_count);
+    }
+    return NULL;
+}
+
+int aws_parallel_output_stream_write(
+    struct aws_parallel_output_stream *stream,
+    uint64_t offset,
+    struct aws_byte_cursor data) {
+
+    if (data.len == 0) {
+        return AWS_OP_SUCCESS;
+    }
+    if (offset > INT64_MAX - data.len) {
+        return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+    }
+    return stream->vtable->write(stream, offset, data);
+}
+
+int aws_parallel_output_stream_preallocate(struct aws_parallel_output_stream *stream, uint64_t size) {
+    if (size == 0 || stream->vtable->preallocate == NULL) {
+        return AWS_OP_SUCCESS;
+    }
+    if (size > INT64_MAX) {
+        return aws_raise_error(AWS_ERROR_OVERFLOW_DETECTED);
+    }
+    return stream->vtable->preallocate(stream, size);
+}
+
+struct aws_parallel_output_stream_from_file_impl {
+    struct aws_parallel_output_stream base;
+
+#if defined(_WIN32)
+    /* Opened for overlapped I/O, so writes at different offsets run at once */
+    void *file;
+#else
+    int fd;
+
+    /* Same file opened for direct I/O, or -1. Aligned blocks are written through it, bypassing the page cache. */
+    int direct_fd;
+#endif
+};
+
+static void s_para_to_file_destroy(struct aws_parallel_output_stream *stream) {
+    struct aws_parallel_output_stream_from_file_impl *impl = stream->impl;
+
+#if defined(_WIN32)
+    aws_s3_close_overlapped_file(impl->file);
+#else
+    if (impl->fd >= 0) {
+        close(impl->fd);
+    }
+    if (impl->direct_fd >= 0) {
+        close(impl->direct_fd);
+    }
+#endif
+
+    aws_mem_release(stream->alloc, impl);
+}
+
+#if defined(_WIN32)
+
+static int s_para_to_file_write(
+    struct aws_parallel_output_stream *stream,
+    uint64_t offset,
+    struct aws_byte_cursor data) {
+    struct aws_parallel_output_stream_from_file_impl *impl = stream->impl;
+
+    while (data.len > 0) {
+        uint32_t to_write = (uint32_t)aws_min_size(data.len, s_max_write_size);
+        uint32_t num_written = 0;
+        if (aws_s3_overlapped_file_io(impl->file, offset, data.ptr, to_write, true, &num_written)) {
+            return AWS_OP_ERR;
+        }
+        aws_byte_cursor_advance(&data, num_written);
+        offset += num_written;
+    }
+    return AWS_OP_SUCCESS;
+}
+
+#else
+
+static int s_para_to_file_write(
+    struct aws_parallel_output_stream *stream,
+    uint64_t offset,
+    struct aws_byte_cursor data) {
+    struct aws_parallel_output_stream_from_file_impl *impl = stream->impl;
+
+    bool use_direct_io = impl->direct_fd >= 0;
+    while (data.len > 0) {
+        size_t to_write = aws_min_size(data.len, s_max_write_size);
+        int fd = impl->fd;
+        if (use_direct_io) {
+            bool direct = false;
+            to_write = aws_s3_next_direct_io_piece(data.ptr, offset, to_write, &direct);
+            if (direct) {
+                fd = impl->direct_fd;
+            }
+        }
+        ssize_t written = pwrite(fd, data.ptr, to_write, (off_t)offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EINVAL && fd == impl->direct_fd) {
+                /* The file system wants a different alignment, write the rest through the page cache */
+                use_direct_io = false;
+                continue;
+            }
+            return aws_translate_and_raise_io_error(errno);
+        }
+        aws_byte_cursor_advance(&data, (size_t)written);
+        offset += (uint64_t)written;
+    }
+    return AWS_OP_SUCCESS;
+}
+
+#endif
+
+#if defined(__linux__)
+
+static int s_para_to_file_preallocate(struct aws_parallel_output_stream *stream, uint64_t size) {
+    struct aws_parallel_output_stream_from_file_impl *impl = stream->impl;
+
+    int error = posix_fallocate(impl->fd, 0, (off_t)size);
+    if (error == EOPNOTSUPP || error == EINVAL) {
+        /* File system can't do it, writes will just allocate as they go */
+        return AWS_OP_SUCCESS;
+    }
+    if (error != 0) {
+        return aws_translate_and_raise_io_error(error);
+    }
+    return AWS_OP_SUCCESS;
+}
+
+#endif
+
+static struct aws_parallel_output_stream_vtable s_parallel_output_stream_to_file_vtable = {
+    .destroy = s_para_to_file_destroy,
+    .write = s_para_to_file_write,
+#if defined(__linux__)
+    .preallocate = s_para_to_file_preallocate,
+#endif
+};
+
+static struct aws_parallel_output_stream *s_para_to_file_new(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name,
+    bool direct_io) {
+
+    struct aws_parallel_output_stream_from_file_impl *impl =
+        aws_mem_calloc(allocator, 1, sizeof(struct aws_parallel_output_stream_from_file_impl));
+    aws_parallel_output_stream_init_base(&impl->base, allocator, &s_parallel_output_stream_to_file_vtable, impl);
+
+    struct aws_string *file_path = aws_string_new_from_cursor(allocator, &file_name);
+#if defined(_WIN32)
+    impl->file = aws_s3_open_overlapped_file(allocator, file_path, true /*for_write*/);
+    bool opened = impl->file != NULL;
+#else
+    impl->fd = open(aws_string_c_str(file_path), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    bool opened = impl->fd >= 0;
+    if (!opened) {
+        aws_translate_and_raise_io_error(errno);
+    }
+    impl->direct_fd = -1;
+#    if defined(O_DIRECT)
+    if (opened && direct_io) {
+        /* Already created and truncated above */
+        impl->direct_fd = open(aws_string_c_str(file_path), O_WRONLY | O_CLOEXEC | O_DIRECT);
+        if (impl->direct_fd < 0) {
+            /* ex. EINVAL on file systems without direct I/O */
+            AWS_LOGF_DEBUG(
+                AWS_LS_S3_GENERAL,
+                "id=%p Could not open file for direct I/O, errno %d. Writing through the page cache instead.",
+                (void *)&impl->base,
+                errno);
+        }
+    }
+#    endif
+#endif
+    (void)direct_io;
+    aws_string_destroy(file_path);
+
+    if (!opened) {
+        s_para_to_file_destroy(&impl->base);
+        return NULL;
+    }
+    return &impl->base;
+}
+
+struct aws_parallel_output_stream *aws_parallel_output_stream_new_from_file(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name) {
+
+    return s_para_to_file_new(allocator, file_name, false /*direct_io*/);
+}
+
+struct aws_parallel_output_stream *aws_parallel_output_stream_new_from_file_direct(
+    struct aws_allocator *allocator,
+    struct aws_byte_cursor file_name) {
+
+    return s_para_to_file_new(allocator, file_name, true /*direct_io*/);
+}
@@ -38,12 +38,21 @@ struct aws_s3_request *aws_s3_request_new(
     request->part_number = part_number;
     request->record_response_headers = (flags & AWS_S3_REQUEST_FLAG_RECORD_RESPONSE_HEADERS) != 0;
     request->has_part_size_response_body = (flags & AWS_S3_REQUEST_FLAG_PART_SIZE_RESPONSE_BODY) != 0;
+    request->has_caller_response_body = (flags & AWS_S3_REQUEST_FLAG_CALLER_RESPONSE_BODY) != 0;
+    request->has_resumable_response_body = (flags & AWS_S3_REQUEST_FLAG_RESUMABLE_RESPONSE_BODY) != 0;
     request->has_part_size_request_body = (flags & AWS_S3_REQUEST_FLAG_PART_SIZE_REQUEST_BODY) != 0;
     request->always_send = (flags & AWS_S3_REQUEST_FLAG_ALWAYS_SEND) != 0;
 
     return request;
 }
 
+/* Checksum of the response body of a get part request, kept from a failed attempt only if the next one resumes it */
+static void s_s3_request_clean_up_response_checksum(struct aws_s3_request *request) {
+    aws_checksum_destroy(request->request_level_running_response_sum);
+    request->request_level_running_response_sum = NULL;
+    aws_byte_buf_clean_up(&request->request_level_response_header_checksum);
+}
+
 void aws_s3_request_setup_send_data(struct aws_s3_request *request, struct aws_http_message *message) {
     AWS_PRECONDITION(request);
     AWS_PRECONDITION(message);
@@ -66,8 +75,20 @@ void aws_s3_request_setup_send_data(struct aws_s3_request *request, struct aws_h
         }
         request->send_data.metrics = aws_s3_request_metrics_release(metric);
     }
+
+    /* Keep the body received by previous attempts if this attempt resumes from it */
+    struct aws_byte_buf resumed_response_body;
+    AWS_ZERO_STRUCT(resumed_response_body);
+    if (request->resumes_response_body) {
+        resumed_response_body = request->send_data.response_body;
+        AWS_ZERO_STRUCT(request->send_data.response_body);
+    } else {
+        s_s3_request_clean_up_response_checksum(request);
+    }
+
     aws_s3_request_clean_up_send_data(request);
 
+    request->send_data.response_body = resumed_response_body;
     request->send_data.message = message;
     request->send_data.metrics = aws_s3_request_metrics_new(request->allocator, request, message);
     /* Start the timestamp */
@@ -128,6 +149,7 @@ static void s_s3_request_destroy(void *user_data) {
     }
 
     aws_s3_request_clean_up_send_data(request);
+    s_s3_request_clean_up_response_checksum(request);
     aws_byte_buf_clean_up(&request->request_body);
     aws_s3_buffer_pool_release_ticket(request->meta_request->client->buffer_pool, request->ticket);
     aws_string_destroy(request->operation_name);
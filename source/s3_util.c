@@ -16,6 +16,10 @@
 #include <aws/s3/s3_client.h>
 #include <inttypes.h>
 
+#if defined(_WIN32)
+#    include <windows.h>
+#endif
+
 #ifdef _MSC_VER
 /* sscanf warning (not currently scanning for strings) */
 #    pragma warning(disable : 4996)
@@ -709,3 +713,117 @@ void aws_s3_request_finish_up_metrics_synced(struct aws_s3_request *request, str
         request->send_data.metrics = aws_s3_request_metrics_release(metrics);
     }
 }
+
+size_t aws_s3_next_direct_io_piece(const uint8_t *ptr, uint64_t offset, size_t len, bool *out_direct) {
+    AWS_PRECONDITION(out_direct);
+
+    const size_t alignment = AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT;
+    size_t head = (size_t)((alignment - offset % alignment) % alignment);
+
+    /* Memory and file must be misaligned by the same amount, for an aligned block to follow the head */
+    if (((uintptr_t)ptr + head) % alignment != 0 || len < head + alignment) {
+        *out_direct = false;
+        return len;
+    }
+    if (head > 0) {
+        *out_direct = false;
+        return head;
+    }
+    *out_direct = true;
+    return len - len % alignment;
+}
+
+#if defined(_WIN32)
+
+static int s_raise_windows_file_error(DWORD error) {
+    switch (error) {
+        case ERROR_FILE_NOT_FOUND:
+        case ERROR_PATH_NOT_FOUND:
+        case ERROR_INVALID_NAME:
+            return aws_raise_error(AWS_ERROR_FILE_INVALID_PATH);
+        case ERROR_ACCESS_DENIED:
+        case ERROR_SHARING_VIOLATION:
+            return aws_raise_error(AWS_ERROR_NO_PERMISSION);
+        case ERROR_TOO_MANY_OPEN_FILES:
+            return aws_raise_error(AWS_ERROR_MAX_FDS_EXCEEDED);
+        case ERROR_NOT_ENOUGH_MEMORY:
+        case ERROR_OUTOFMEMORY:
+            return aws_raise_error(AWS_ERROR_OOM);
+        default:
+            AWS_LOGF_ERROR(AWS_LS_S3_GENERAL, "File I/O failed with Windows error %lu", (unsigned long)error);
+            return aws_raise_error(AWS_ERROR_SYS_CALL_FAILURE);
+    }
+}
+
+void *aws_s3_open_overlapped_file(struct aws_allocator *allocator, const struct aws_string *path, bool for_write) {
+    struct aws_wstring *w_path = aws_string_convert_to_wstring(allocator, path);
+    if (w_path == NULL) {
+        return NULL;
+    }
+
+    HANDLE file = CreateFileW(
+        aws_wstring_c_str(w_path),
+        for_write ? GENERIC_WRITE : GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL,
+        for_write ? CREATE_ALWAYS : OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | (for_write ? 0 : FILE_FLAG_SEQUENTIAL_SCAN),
+        NULL);
+    DWORD error = GetLastError();
+    aws_wstring_destroy(w_path);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        s_raise_windows_file_error(error);
+        return NULL;
+    }
+    return file;
+}
+
+int aws_s3_overlapped_file_io(
+    void *file,
+    uint64_t offset,
+    uint8_t *buffer,
+    uint32_t len,
+    bool write,
+    uint32_t *out_num_transferred) {
+    AWS_PRECONDITION(out_num_transferred);
+
+    *out_num_transferred = 0;
+
+    OVERLAPPED overlapped;
+    AWS_ZERO_STRUCT(overlapped);
+    overlapped.Offset = (DWORD)offset;
+    overlapped.OffsetHigh = (DWORD)(offset >> 32);
+    /* Threads share the handle, so each waits on its own event rather than on the handle */
+    overlapped.hEvent = CreateEventW(NULL, TRUE /*manual reset*/, FALSE /*initial state*/, NULL);
+    if (overlapped.hEvent == NULL) {
+        return s_raise_windows_file_error(GetLastError());
+    }
+
+    BOOL succeeded =
+        write ? WriteFile(file, buffer, len, NULL, &overlapped) : ReadFile(file, buffer, len, NULL, &overlapped);
+    DWORD error = succeeded ? ERROR_SUCCESS : GetLastError();
+    DWORD num_transferred = 0;
+    if (succeeded || error == ERROR_IO_PENDING) {
+        succeeded = GetOverlappedResult(file, &overlapped, &num_transferred, TRUE /*wait*/);
+        error = succeeded ? ERROR_SUCCESS : GetLastError();
+    }
+    CloseHandle(overlapped.hEvent);
+
+    if (!succeeded) {
+        if (!write && error == ERROR_HANDLE_EOF) {
+            return AWS_OP_SUCCESS;
+        }
+        return s_raise_windows_file_error(error);
+    }
+    *out_num_transferred = (uint32_t)num_transferred;
+    return AWS_OP_SUCCESS;
+}
+
+void aws_s3_close_overlapped_file(void *file) {
+    if (file != NULL) {
+        CloseHandle(file);
+    }
+}
+
+#endif
@@ -24,6 +24,12 @@ VERBOSE = False
 SHOULD_THROTTLE = True
 RETRY_REQUEST_COUNT = 0
 
+# Object served by /get_object_hedge_wins, with real ranges so downloads of many parts succeed
+HEDGE_WINS_OBJECT_SIZE = 1024 * 1024
+HEDGE_WINS_DELAY = 10
+# Start of the last part -> until when its first request is delayed
+HEDGE_WINS_DELAYED_UNTIL = {}
+
 
 base_dir = os.path.dirname(os.path.realpath(__file__))
 
@@ -56,6 +62,10 @@ class ResponseConfig:
     json_path: str = None
     throttle: bool = False
     force_retry: bool = False
+    # Override what the json file says
+    status_code: Optional[int] = None
+    delay: Optional[int] = None
+    extra_headers: Optional[dict] = None
 
     def _resolve_file_path(self, wrapper, request_type):
         global SHOULD_THROTTLE
@@ -87,8 +97,8 @@ class ResponseConfig:
             data = json.load(f)
 
         # if response has delay, then sleep before sending it
-        delay = data.get('delay', 0)
-        status_code = data['status']
+        delay = data.get('delay', 0) if self.delay is None else self.delay
+        status_code = data['status'] if self.status_code is None else self.status_code
         if self.generate_body_size is not None:
             # generate body with a specific size instead
             body = "a" * self.generate_body_size
@@ -97,7 +107,8 @@ class ResponseConfig:
 
         headers = wrapper.basic_headers()
         content_length_set = False
-        for header in data['headers'].items():
+        extra_headers = self.extra_headers or {}
+        for header in list(data['headers'].items()) + list(extra_headers.items()):
             headers.append((header[0], str(header[1])))
             if header[0].lower() == "content-length":
                 content_length_set = True
@@ -412,6 +423,28 @@ def handle_get_object_modified(start_range, end_range, request):
             return ResponseConfig("/get_object_modified_failure")
 
 
+def handle_get_object_hedge_wins(start_range, end_range):
+    # The first request for the last part is delayed. A duplicate request for it, sent while the first one is
+    # delayed, is answered right away and wins.
+    response_config = ResponseConfig("/get_object_hedge_wins")
+    if start_range >= HEDGE_WINS_OBJECT_SIZE:
+        response_config.status_code = 416
+        response_config.extra_headers = {"Content-Range": f"bytes */{HEDGE_WINS_OBJECT_SIZE}"}
+        response_config.generate_body_size = 0
+        return response_config
+
+    end_range = min(end_range, HEDGE_WINS_OBJECT_SIZE - 1)
+    response_config.generate_body_size = end_range - start_range + 1
+    response_config.extra_headers = {
+        "Content-Range": f"bytes {start_range}-{end_range}/{HEDGE_WINS_OBJECT_SIZE}"}
+    if end_range == HEDGE_WINS_OBJECT_SIZE - 1:
+        now = trio.current_time()
+        if now >= HEDGE_WINS_DELAYED_UNTIL.get(start_range, 0):
+            HEDGE_WINS_DELAYED_UNTIL[start_range] = now + HEDGE_WINS_DELAY
+            response_config.delay = HEDGE_WINS_DELAY
+    return response_config
+
+
 def handle_get_object(wrapper, request, parsed_path, head_request=False):
     global RETRY_REQUEST_COUNT
     response_config = ResponseConfig(parsed_path.path)
@@ -446,6 +479,9 @@ def handle_get_object(wrapper, request, parsed_path, head_request=False):
     if parsed_path.path == "/get_object_modified":
         return handle_get_object_modified(start_range, end_range, request)
 
+    if parsed_path.path == "/get_object_hedge_wins":
+        return handle_get_object_hedge_wins(start_range, end_range)
+
     response_config.generate_body_size = data_length
     return response_config
 
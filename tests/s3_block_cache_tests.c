@@ -0,0 +1,366 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/s3/private/s3_block_cache.h>
+#include <aws/s3/private/s3_util.h>
+
+#include "s3_tester.h"
+#include <aws/common/clock.h>
+#include <aws/http/request_response.h>
+#include <aws/io/event_loop.h>
+#include <aws/io/future.h>
+#include <aws/testing/aws_test_harness.h>
+
+#define TEST_BLOCK_SIZE 40
+#define TEST_TIMEOUT_NS (10 * (uint64_t)AWS_TIMESTAMP_NANOS)
+
+/* Get a block into dest, waiting for it to be read back if it's on disk. Returns true on a hit. */
+static bool s_get_block(
+    struct aws_s3_block_cache *block_cache,
+    const char *key,
+    struct aws_byte_buf *dest,
+    struct aws_event_loop_group *io_elg) {
+    struct aws_future_bool *future = aws_s3_block_cache_get(block_cache, aws_byte_cursor_from_c_str(key), dest, io_elg);
+    AWS_FATAL_ASSERT(aws_future_bool_wait(future, TEST_TIMEOUT_NS));
+    bool hit = aws_future_bool_get_result(future);
+    aws_future_bool_release(future);
+    return hit;
+}
+
+/* Put a block of TEST_BLOCK_SIZE bytes, all set to value */
+static void s_put_block_on(
+    struct aws_s3_block_cache *block_cache,
+    const char *key,
+    uint8_t value,
+    struct aws_event_loop_group *io_elg) {
+    uint8_t data[TEST_BLOCK_SIZE];
+    memset(data, value, sizeof(data));
+    aws_s3_block_cache_put(
+        block_cache, aws_byte_cursor_from_c_str(key), aws_byte_cursor_from_array(data, sizeof(data)), io_elg);
+}
+
+/* Get a block, and check it's TEST_BLOCK_SIZE bytes all set to value */
+static int s_check_block_on(
+    struct aws_s3_block_cache *block_cache,
+    const char *key,
+    uint8_t value,
+    struct aws_event_loop_group *io_elg) {
+    uint8_t storage[TEST_BLOCK_SIZE];
+    struct aws_byte_buf dest = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    ASSERT_TRUE(s_get_block(block_cache, key, &dest, io_elg));
+    ASSERT_UINT_EQUALS(TEST_BLOCK_SIZE, dest.len);
+    for (size_t i = 0; i < dest.len; ++i) {
+        ASSERT_UINT_EQUALS(value, dest.buffer[i]);
+    }
+    return AWS_OP_SUCCESS;
+}
+
+/* Without an I/O ELG, files are written and read by the calling thread */
+static void s_put_block(struct aws_s3_block_cache *block_cache, const char *key, uint8_t value) {
+    s_put_block_on(block_cache, key, value, NULL);
+}
+
+static int s_check_block(struct aws_s3_block_cache *block_cache, const char *key, uint8_t value) {
+    return s_check_block_on(block_cache, key, value, NULL);
+}
+
+static bool s_has_block(struct aws_s3_block_cache *block_cache, const char *key) {
+    uint8_t storage[TEST_BLOCK_SIZE];
+    struct aws_byte_buf dest = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    return s_get_block(block_cache, key, &dest, NULL);
+}
+
+AWS_TEST_CASE(test_s3_block_cache_hit_miss, s_test_s3_block_cache_hit_miss)
+static int s_test_s3_block_cache_hit_miss(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_block_cache_options options = {.memory_limit_in_bytes = 100};
+    struct aws_s3_block_cache *block_cache = aws_s3_block_cache_new(allocator, &options);
+    ASSERT_NOT_NULL(block_cache);
+
+    ASSERT_FALSE(s_has_block(block_cache, "a"));
+    s_put_block(block_cache, "a", 1);
+    ASSERT_SUCCESS(s_check_block(block_cache, "a", 1));
+    ASSERT_FALSE(s_has_block(block_cache, "b"));
+
+    /* Putting a key that's already cached changes nothing */
+    s_put_block(block_cache, "a", 2);
+    ASSERT_SUCCESS(s_check_block(block_cache, "a", 1));
+
+    /* A block that doesn't fit in dest is a miss */
+    uint8_t storage[TEST_BLOCK_SIZE - 1];
+    struct aws_byte_buf dest = aws_byte_buf_from_empty_array(storage, sizeof(storage));
+    ASSERT_FALSE(s_get_block(block_cache, "a", &dest, NULL));
+    ASSERT_UINT_EQUALS(0, dest.len);
+
+    /* A block larger than the memory limit isn't cached */
+    uint8_t large[101] = {0};
+    aws_s3_block_cache_put(
+        block_cache, aws_byte_cursor_from_c_str("large"), aws_byte_cursor_from_array(large, sizeof(large)), NULL);
+
+    struct aws_s3_block_cache_stats stats = aws_s3_block_cache_get_stats(block_cache);
+    ASSERT_UINT_EQUALS(2, stats.hits);
+    ASSERT_UINT_EQUALS(3, stats.misses);
+    ASSERT_UINT_EQUALS(0, stats.evictions);
+    ASSERT_UINT_EQUALS(TEST_BLOCK_SIZE, stats.memory_used);
+    ASSERT_UINT_EQUALS(0, stats.disk_used);
+
+    aws_s3_block_cache_release(block_cache);
+    return 0;
+}
+
+AWS_TEST_CASE(test_s3_block_cache_lru_eviction, s_test_s3_block_cache_lru_eviction)
+static int s_test_s3_block_cache_lru_eviction(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* Room for 2 blocks */
+    struct aws_s3_block_cache_options options = {.memory_limit_in_bytes = 2 * TEST_BLOCK_SIZE};
+    struct aws_s3_block_cache *block_cache = aws_s3_block_cache_new(allocator, &options);
+    ASSERT_NOT_NULL(block_cache);
+
+    s_put_block(block_cache, "a", 1);
+    s_put_block(block_cache, "b", 2);
+    ASSERT_SUCCESS(s_check_block(block_cache, "a", 1));
+
+    /* b is least recently used now */
+    s_put_block(block_cache, "c", 3);
+    ASSERT_FALSE(s_has_block(block_cache, "b"));
+    ASSERT_SUCCESS(s_check_block(block_cache, "a", 1));
+    ASSERT_SUCCESS(s_check_block(block_cache, "c", 3));
+
+    struct aws_s3_block_cache_stats stats = aws_s3_block_cache_get_stats(block_cache);
+    ASSERT_UINT_EQUALS(1, stats.evictions);
+    ASSERT_UINT_EQUALS(0, stats.spills);
+    ASSERT_UINT_EQUALS(2 * TEST_BLOCK_SIZE, stats.memory_used);
+
+    aws_s3_block_cache_release(block_cache);
+    return 0;
+}
+
+AWS_TEST_CASE(test_s3_block_cache_spill_to_disk, s_test_s3_block_cache_spill_to_disk)
+static int s_test_s3_block_cache_spill_to_disk(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* Room for 1 block in memory and 2 on disk */
+    struct aws_s3_block_cache_options options = {
+        .memory_limit_in_bytes = TEST_BLOCK_SIZE,
+        .spill_directory = aws_byte_cursor_from_c_str("."),
+        .disk_limit_in_bytes = 2 * TEST_BLOCK_SIZE,
+    };
+    struct aws_s3_block_cache *block_cache = aws_s3_block_cache_new(allocator, &options);
+    ASSERT_NOT_NULL(block_cache);
+
+    s_put_block(block_cache, "a", 1);
+    s_put_block(block_cache, "b", 2);
+    s_put_block(block_cache, "c", 3);
+
+    struct aws_s3_block_cache_stats stats = aws_s3_block_cache_get_stats(block_cache);
+    ASSERT_UINT_EQUALS(2, stats.spills);
+    ASSERT_UINT_EQUALS(0, stats.evictions);
+    ASSERT_UINT_EQUALS(TEST_BLOCK_SIZE, stats.memory_used);
+    ASSERT_UINT_EQUALS(2 * TEST_BLOCK_SIZE, stats.disk_used);
+
+    /* Disk is full, so spilling c evicts a, the oldest on disk */
+    s_put_block(block_cache, "d", 4);
+    ASSERT_FALSE(s_has_block(block_cache, "a"));
+
+    /* Reading b from disk moves it back into memory, and spills d */
+    ASSERT_SUCCESS(s_check_block(block_cache, "b", 2));
+    ASSERT_SUCCESS(s_check_block(block_cache, "b", 2));
+    ASSERT_SUCCESS(s_check_block(block_cache, "c", 3));
+    ASSERT_SUCCESS(s_check_block(block_cache, "d", 4));
+
+    stats = aws_s3_block_cache_get_stats(block_cache);
+    ASSERT_UINT_EQUALS(4, stats.hits);
+    ASSERT_UINT_EQUALS(1, stats.misses);
+    ASSERT_UINT_EQUALS(1, stats.evictions);
+    ASSERT_UINT_EQUALS(TEST_BLOCK_SIZE, stats.memory_used);
+    ASSERT_UINT_EQUALS(2 * TEST_BLOCK_SIZE, stats.disk_used);
+
+    aws_s3_block_cache_release(block_cache);
+
+    /* Spill directory has to exist */
+    options.spill_directory = aws_byte_cursor_from_c_str("s3_test_no_such_directory");
+    ASSERT_NULL(aws_s3_block_cache_new(allocator, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_FILE_INVALID_PATH, aws_last_error());
+
+    /* Disk limit has to be set with a spill directory */
+    options.spill_directory = aws_byte_cursor_from_c_str(".");
+    options.disk_limit_in_bytes = 0;
+    ASSERT_NULL(aws_s3_block_cache_new(allocator, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    options.memory_limit_in_bytes = 0;
+    options.spill_directory = aws_byte_cursor_from_c_str("");
+    ASSERT_NULL(aws_s3_block_cache_new(allocator, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    return 0;
+}
+
+AWS_TEST_CASE(test_s3_block_cache_spill_on_io_elg, s_test_s3_block_cache_spill_on_io_elg)
+static int s_test_s3_block_cache_spill_on_io_elg(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+    struct aws_event_loop_group *io_elg = aws_event_loop_group_new_default(allocator, 1, NULL);
+    ASSERT_NOT_NULL(io_elg);
+
+    /* Room for 1 block in memory and 2 on disk */
+    struct aws_s3_block_cache_options options = {
+        .memory_limit_in_bytes = TEST_BLOCK_SIZE,
+        .spill_directory = aws_byte_cursor_from_c_str("."),
+        .disk_limit_in_bytes = 2 * TEST_BLOCK_SIZE,
+    };
+    struct aws_s3_block_cache *block_cache = aws_s3_block_cache_new(allocator, &options);
+    ASSERT_NOT_NULL(block_cache);
+
+    /* Put only queues the spills, their files are written on the ELG */
+    s_put_block_on(block_cache, "a", 1, io_elg);
+    s_put_block_on(block_cache, "b", 2, io_elg);
+    s_put_block_on(block_cache, "c", 3, io_elg);
+
+    struct aws_s3_block_cache_stats stats = aws_s3_block_cache_get_stats(block_cache);
+    for (size_t i = 0; stats.spills < 2 && i < 1000; ++i) {
+        aws_thread_current_sleep(aws_timestamp_convert(10, AWS_TIMESTAMP_MILLIS, AWS_TIMESTAMP_NANOS, NULL));
+        stats = aws_s3_block_cache_get_stats(block_cache);
+    }
+    ASSERT_UINT_EQUALS(2, stats.spills);
+
+    /* Each block is read back on the ELG, which spills the one in memory to make room */
+    ASSERT_SUCCESS(s_check_block_on(block_cache, "a", 1, io_elg));
+    ASSERT_SUCCESS(s_check_block_on(block_cache, "b", 2, io_elg));
+    ASSERT_SUCCESS(s_check_block_on(block_cache, "c", 3, io_elg));
+
+    stats = aws_s3_block_cache_get_stats(block_cache);
+    ASSERT_UINT_EQUALS(3, stats.hits);
+    ASSERT_UINT_EQUALS(5, stats.spills);
+    ASSERT_UINT_EQUALS(0, stats.evictions);
+    ASSERT_UINT_EQUALS(TEST_BLOCK_SIZE, stats.memory_used);
+    ASSERT_UINT_EQUALS(2 * TEST_BLOCK_SIZE, stats.disk_used);
+
+    aws_s3_block_cache_release(block_cache);
+    aws_event_loop_group_release(io_elg);
+    aws_s3_tester_clean_up(&tester);
+    return 0;
+}
+
+/* Eviction policy dropping the most recently inserted block first */
+struct mru_test_policy {
+    struct aws_s3_block_cache_entry *entries[8];
+    size_t num_entries;
+    size_t num_inserts;
+    size_t num_accesses;
+    size_t num_removes;
+    bool destroyed;
+};
+
+static void s_mru_on_insert(void *user_data, struct aws_s3_block_cache_entry *entry) {
+    struct mru_test_policy *policy = user_data;
+    AWS_FATAL_ASSERT(policy->num_entries < AWS_ARRAY_SIZE(policy->entries));
+    policy->entries[policy->num_entries++] = entry;
+    ++policy->num_inserts;
+}
+
+static void s_mru_on_access(void *user_data, struct aws_s3_block_cache_entry *entry) {
+    (void)entry;
+    struct mru_test_policy *policy = user_data;
+    ++policy->num_accesses;
+}
+
+static void s_mru_on_remove(void *user_data, struct aws_s3_block_cache_entry *entry) {
+    struct mru_test_policy *policy = user_data;
+    for (size_t i = 0; i < policy->num_entries; ++i) {
+        if (policy->entries[i] == entry) {
+            policy->entries[i] = policy->entries[--policy->num_entries];
+            break;
+        }
+    }
+    ++policy->num_removes;
+}
+
+static struct aws_s3_block_cache_entry *s_mru_choose_victim(void *user_data) {
+    struct mru_test_policy *policy = user_data;
+    return policy->num_entries > 0 ? policy->entries[policy->num_entries - 1] : NULL;
+}
+
+static void s_mru_destroy(void *user_data) {
+    struct mru_test_policy *policy = user_data;
+    policy->destroyed = true;
+}
+
+static const struct aws_s3_block_cache_eviction_policy_vtable s_mru_policy_vtable = {
+    .on_insert = s_mru_on_insert,
+    .on_access = s_mru_on_access,
+    .on_remove = s_mru_on_remove,
+    .choose_victim = s_mru_choose_victim,
+    .destroy = s_mru_destroy,
+};
+
+AWS_TEST_CASE(test_s3_block_cache_eviction_policy, s_test_s3_block_cache_eviction_policy)
+static int s_test_s3_block_cache_eviction_policy(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct mru_test_policy policy;
+    AWS_ZERO_STRUCT(policy);
+
+    struct aws_s3_block_cache_options options = {
+        .memory_limit_in_bytes = 2 * TEST_BLOCK_SIZE,
+        .eviction_policy = &s_mru_policy_vtable,
+        .eviction_policy_user_data = &policy,
+    };
+    struct aws_s3_block_cache *block_cache = aws_s3_block_cache_new(allocator, &options);
+    ASSERT_NOT_NULL(block_cache);
+
+    s_put_block(block_cache, "a", 1);
+    s_put_block(block_cache, "b", 2);
+
+    /* c is the most recent, so it goes right away */
+    s_put_block(block_cache, "c", 3);
+    ASSERT_FALSE(s_has_block(block_cache, "c"));
+    ASSERT_SUCCESS(s_check_block(block_cache, "a", 1));
+    ASSERT_SUCCESS(s_check_block(block_cache, "b", 2));
+
+    ASSERT_UINT_EQUALS(3, policy.num_inserts);
+    ASSERT_UINT_EQUALS(2, policy.num_accesses);
+    ASSERT_UINT_EQUALS(1, policy.num_removes);
+    ASSERT_UINT_EQUALS(TEST_BLOCK_SIZE, policy.entries[0]->size);
+
+    /* Blocks still in memory are removed from the policy before it's destroyed */
+    aws_s3_block_cache_release(block_cache);
+    ASSERT_UINT_EQUALS(3, policy.num_removes);
+    ASSERT_UINT_EQUALS(0, policy.num_entries);
+    ASSERT_TRUE(policy.destroyed);
+
+    return 0;
+}
+
+AWS_TEST_CASE(test_s3_block_cache_key, s_test_s3_block_cache_key)
+static int s_test_s3_block_cache_key(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_http_message *message = aws_http_message_new_request(allocator);
+    ASSERT_NOT_NULL(message);
+    ASSERT_SUCCESS(aws_http_message_set_request_path(message, aws_byte_cursor_from_c_str("/key?versionId=1")));
+    struct aws_http_header host_header = {
+        .name = g_host_header_name,
+        .value = aws_byte_cursor_from_c_str("bucket.s3.us-west-2.amazonaws.com"),
+    };
+    ASSERT_SUCCESS(aws_http_message_add_header(message, host_header));
+
+    struct aws_byte_buf key;
+    ASSERT_SUCCESS(
+        aws_s3_block_cache_key_init(&key, allocator, message, aws_byte_cursor_from_c_str("\"etag\""), 0, 1023));
+    ASSERT_BIN_ARRAYS_EQUALS(
+        "bucket.s3.us-west-2.amazonaws.com/key?versionId=1\n\"etag\"\n0-1023",
+        strlen("bucket.s3.us-west-2.amazonaws.com/key?versionId=1\n\"etag\"\n0-1023"),
+        key.buffer,
+        key.len);
+    aws_byte_buf_clean_up(&key);
+
+    aws_http_message_release(message);
+    return 0;
+}
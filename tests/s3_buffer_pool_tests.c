@@ -6,10 +6,13 @@
 #include <aws/s3/private/s3_buffer_pool.h>
 #include <aws/s3/private/s3_util.h>
 
+#include <aws/common/clock.h>
 #include <aws/common/process.h>
 #include <aws/common/thread.h>
 #include <aws/testing/aws_test_harness.h>
 
+#include <inttypes.h>
+
 #define NUM_TEST_ALLOCS 100
 #define NUM_TEST_THREADS 8
 
@@ -133,6 +136,33 @@ static int s_test_s3_buffer_pool_limits(struct aws_allocator *allocator, void *c
 }
 AWS_TEST_CASE(test_s3_buffer_pool_limits, s_test_s3_buffer_pool_limits)
 
+static int s_test_s3_buffer_pool_unaligned_chunk_size(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* Part size that isn't a multiple of 4KiB still gets aligned buffers of the size asked for */
+    const size_t chunk_size = MB_TO_BYTES(8) + 1;
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new(allocator, chunk_size, GB_TO_BYTES(1));
+
+    struct aws_s3_buffer_pool_ticket *tickets[4];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tickets); ++i) {
+        tickets[i] = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+        ASSERT_NOT_NULL(tickets[i]);
+        struct aws_byte_buf buf = aws_s3_buffer_pool_acquire_buffer(buffer_pool, tickets[i]);
+        ASSERT_NOT_NULL(buf.buffer);
+        ASSERT_UINT_EQUALS(chunk_size, buf.capacity);
+        ASSERT_UINT_EQUALS(0, (uintptr_t)buf.buffer % AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT);
+    }
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tickets); ++i) {
+        aws_s3_buffer_pool_release_ticket(buffer_pool, tickets[i]);
+    }
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_unaligned_chunk_size, s_test_s3_buffer_pool_unaligned_chunk_size)
+
 static int s_test_s3_buffer_pool_trim(struct aws_allocator *allocator, void *ctx) {
     (void)allocator;
     (void)ctx;
@@ -359,3 +389,958 @@ static int s_test_s3_buffer_pool_forced_buffer_wont_stop_reservations(struct aws
 AWS_TEST_CASE(
     test_s3_buffer_pool_forced_buffer_wont_stop_reservations,
     s_test_s3_buffer_pool_forced_buffer_wont_stop_reservations)
+
+#define NUM_CONTENTION_ITERATIONS 20000
+#define NUM_CONTENTION_TICKETS_HELD 4
+
+static void s_contention_worker(void *user_data) {
+    struct aws_s3_buffer_pool *pool = ((struct pool_thread_test_data *)user_data)->pool;
+
+    struct aws_s3_buffer_pool_ticket *tickets[NUM_CONTENTION_TICKETS_HELD];
+    AWS_ZERO_ARRAY(tickets);
+
+    for (size_t i = 0; i < NUM_CONTENTION_ITERATIONS; ++i) {
+        size_t slot = i % NUM_CONTENTION_TICKETS_HELD;
+        aws_s3_buffer_pool_release_ticket(pool, tickets[slot]);
+
+        tickets[slot] = aws_s3_buffer_pool_reserve(pool, MB_TO_BYTES(8));
+        AWS_FATAL_ASSERT(tickets[slot]);
+
+        struct aws_byte_buf buf = aws_s3_buffer_pool_acquire_buffer(pool, tickets[slot]);
+        AWS_FATAL_ASSERT(buf.buffer);
+        buf.buffer[0] = (uint8_t)i;
+    }
+
+    for (size_t i = 0; i < NUM_CONTENTION_TICKETS_HELD; ++i) {
+        aws_s3_buffer_pool_release_ticket(pool, tickets[i]);
+    }
+}
+
+/* Reserve/acquire/release from many threads hitting the pool at once.
+ * Checks that accounting is consistent afterwards. */
+static int s_test_s3_buffer_pool_contention(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new(allocator, MB_TO_BYTES(8), GB_TO_BYTES(2));
+
+    s_thread_test(allocator, s_contention_worker, buffer_pool);
+
+    struct aws_s3_buffer_pool_usage_stats stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(0, stats.primary_used);
+    ASSERT_UINT_EQUALS(0, stats.primary_reserved);
+    ASSERT_UINT_EQUALS(0, stats.secondary_used);
+    ASSERT_UINT_EQUALS(0, stats.secondary_reserved);
+    ASSERT_TRUE(stats.primary_allocated <= stats.mem_limit);
+
+    aws_s3_buffer_pool_trim(buffer_pool);
+    stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(0, stats.primary_allocated);
+    ASSERT_UINT_EQUALS(0, stats.primary_num_blocks);
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_contention, s_test_s3_buffer_pool_contention)
+
+/* Part sized buffers recycled on one thread go through its shard and never take the pool lock. */
+static int s_test_s3_buffer_pool_shard_fast_path(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new(allocator, chunk_size, GB_TO_BYTES(1));
+
+    /* First acquire has to carve a chunk out of a new block */
+    struct aws_s3_buffer_pool_ticket *ticket = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+    ASSERT_NOT_NULL(ticket);
+    uint8_t *first_ptr = aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket).buffer;
+    ASSERT_UINT_EQUALS(1, aws_s3_buffer_pool_get_usage(buffer_pool).primary_locked_ops);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+
+    /* From then on, the same chunk keeps going through the shard */
+    for (size_t i = 0; i < 1000; ++i) {
+        ticket = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+        ASSERT_NOT_NULL(ticket);
+        struct aws_byte_buf buf = aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket);
+        ASSERT_PTR_EQUALS(first_ptr, buf.buffer);
+        aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+    }
+
+    struct aws_s3_buffer_pool_usage_stats stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(1, stats.primary_locked_ops);
+    ASSERT_UINT_EQUALS(0, stats.primary_used);
+    ASSERT_UINT_EQUALS(0, stats.primary_reserved);
+
+    /* Multi chunk buffers skip the shards */
+    ticket = aws_s3_buffer_pool_reserve(buffer_pool, 2 * chunk_size);
+    ASSERT_NOT_NULL(ticket);
+    aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+    ASSERT_UINT_EQUALS(3, aws_s3_buffer_pool_get_usage(buffer_pool).primary_locked_ops);
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_shard_fast_path, s_test_s3_buffer_pool_shard_fast_path)
+
+#define NUM_SCALING_CYCLES 10000
+#define MAX_SCALING_MEM_LIMIT_GIB 4
+
+/* Microbenchmark showing acquire/release cost doesn't depend on how many blocks the pool has.
+ * Fills pools with limits from 1GiB to 4GiB and then measures release/reserve/acquire cycles on the full pool.
+ * Buffers use 2 chunks, so they always go through the blocks rather than the shard caches.
+ * Note: blocks are never written to, so this mostly uses address space rather than physical memory. */
+static int s_test_s3_buffer_pool_acquire_release_scaling(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    /* Skip test if this machine can't do enormous allocations */
+    if (SIZE_MAX < GB_TO_BYTES(MAX_SCALING_MEM_LIMIT_GIB)) {
+        return AWS_OP_SKIP;
+    }
+    void *try_large_alloc = malloc(GB_TO_BYTES(MAX_SCALING_MEM_LIMIT_GIB));
+    if (try_large_alloc == NULL) {
+        return AWS_OP_SKIP;
+    }
+    free(try_large_alloc);
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    const size_t buffer_size = 2 * chunk_size;
+
+    for (size_t mem_limit_gib = 1; mem_limit_gib <= MAX_SCALING_MEM_LIMIT_GIB; mem_limit_gib *= 2) {
+        struct aws_s3_buffer_pool *buffer_pool =
+            aws_s3_buffer_pool_new(allocator, chunk_size, GB_TO_BYTES(mem_limit_gib));
+        ASSERT_NOT_NULL(buffer_pool);
+
+        struct aws_array_list tickets;
+        aws_array_list_init_dynamic(&tickets, allocator, 64, sizeof(struct aws_s3_buffer_pool_ticket *));
+
+        /* Fill the pool */
+        struct aws_s3_buffer_pool_ticket *ticket = NULL;
+        while ((ticket = aws_s3_buffer_pool_reserve(buffer_pool, buffer_size)) != NULL) {
+            aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket);
+            aws_array_list_push_back(&tickets, &ticket);
+        }
+        aws_s3_buffer_pool_remove_reservation_hold(buffer_pool);
+
+        size_t num_tickets = aws_array_list_length(&tickets);
+        ASSERT_TRUE(num_tickets > 0);
+
+        uint64_t start_ns = 0;
+        ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&start_ns));
+
+        /* Keep recycling the buffer in the last block, which is the worst case for a linear search */
+        for (size_t i = 0; i < NUM_SCALING_CYCLES; ++i) {
+            aws_array_list_back(&tickets, &ticket);
+            aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+
+            ticket = aws_s3_buffer_pool_reserve(buffer_pool, buffer_size);
+            ASSERT_NOT_NULL(ticket);
+            struct aws_byte_buf buf = aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket);
+            ASSERT_UINT_EQUALS(buffer_size, buf.capacity);
+            aws_array_list_set_at(&tickets, &ticket, num_tickets - 1);
+        }
+
+        uint64_t end_ns = 0;
+        ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&end_ns));
+
+        struct aws_s3_buffer_pool_usage_stats stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+        AWS_LOGF_INFO(
+            AWS_LS_S3_GENERAL,
+            "Buffer pool scaling benchmark: mem_limit=%zuGiB blocks=%zu buffers=%zu: %" PRIu64
+            "ns per release/reserve/acquire cycle",
+            mem_limit_gib,
+            stats.primary_num_blocks,
+            num_tickets,
+            (end_ns - start_ns) / NUM_SCALING_CYCLES);
+
+        /* Blocks are filled densely, no matter which block the recycled buffer came from */
+        ASSERT_UINT_EQUALS(num_tickets * buffer_size, stats.primary_used);
+        ASSERT_TRUE(stats.primary_allocated - stats.primary_used < stats.primary_num_blocks * chunk_size + buffer_size);
+
+        for (size_t i = 0; i < num_tickets; ++i) {
+            aws_array_list_get_at(&tickets, &ticket, i);
+            aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+        }
+        aws_array_list_clean_up(&tickets);
+
+        aws_s3_buffer_pool_destroy(buffer_pool);
+    }
+
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_acquire_release_scaling, s_test_s3_buffer_pool_acquire_release_scaling)
+
+static int s_test_buffer_pool_memory_backing(
+    struct aws_allocator *allocator,
+    enum aws_s3_buffer_pool_memory_backing backing) {
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    const size_t block_size = 16 * chunk_size;
+    struct aws_s3_buffer_pool_options options = {
+        .chunk_size = chunk_size,
+        .mem_limit = GB_TO_BYTES(1),
+        .memory_backing = backing,
+        .prefault_size = block_size + 1, /* rounds up to 2 blocks */
+    };
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new_with_options(allocator, &options);
+    ASSERT_NOT_NULL(buffer_pool);
+
+    struct aws_s3_buffer_pool_usage_stats stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(2, stats.primary_num_blocks);
+    ASSERT_UINT_EQUALS(2 * block_size, stats.primary_allocated);
+    ASSERT_UINT_EQUALS(2 * block_size, stats.primary_prefaulted);
+    ASSERT_TRUE(stats.primary_hugetlb_allocated + stats.primary_thp_allocated <= stats.primary_allocated);
+    if (backing == AWS_S3_BUFFER_POOL_MEMORY_BACKING_ALLOCATOR) {
+        ASSERT_UINT_EQUALS(0, stats.primary_hugetlb_allocated);
+        ASSERT_UINT_EQUALS(0, stats.primary_thp_allocated);
+    }
+
+    /* Fill the pre-faulted blocks, plus 1 more block */
+    struct aws_s3_buffer_pool_ticket *tickets[48];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tickets); ++i) {
+        tickets[i] = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+        ASSERT_NOT_NULL(tickets[i]);
+        struct aws_byte_buf buf = aws_s3_buffer_pool_acquire_buffer(buffer_pool, tickets[i]);
+        ASSERT_NOT_NULL(buf.buffer);
+        memset(buf.buffer, (int)i, buf.capacity);
+    }
+
+    stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(3, stats.primary_num_blocks);
+    ASSERT_UINT_EQUALS(2 * block_size, stats.primary_prefaulted);
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tickets); ++i) {
+        aws_s3_buffer_pool_release_ticket(buffer_pool, tickets[i]);
+    }
+
+    /* Trim only releases the block that wasn't pre-faulted */
+    aws_s3_buffer_pool_trim(buffer_pool);
+    stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(2, stats.primary_num_blocks);
+    ASSERT_UINT_EQUALS(2 * block_size, stats.primary_allocated);
+    ASSERT_UINT_EQUALS(2 * block_size, stats.primary_prefaulted);
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+
+/* Test that pre-faulted blocks are allocated up front and survive trim, for every memory backing */
+static int s_test_s3_buffer_pool_memory_backing(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    ASSERT_SUCCESS(s_test_buffer_pool_memory_backing(allocator, AWS_S3_BUFFER_POOL_MEMORY_BACKING_ALLOCATOR));
+    ASSERT_SUCCESS(s_test_buffer_pool_memory_backing(allocator, AWS_S3_BUFFER_POOL_MEMORY_BACKING_MMAP));
+    /* Falls back to regular pages on hosts without reserved huge pages */
+    ASSERT_SUCCESS(s_test_buffer_pool_memory_backing(allocator, AWS_S3_BUFFER_POOL_MEMORY_BACKING_HUGETLB));
+
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_memory_backing, s_test_s3_buffer_pool_memory_backing)
+
+/* Test that NUMA aware pool keeps blocks of each node separate */
+static int s_test_s3_buffer_pool_numa_nodes(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    const size_t block_size = 16 * chunk_size;
+    struct aws_s3_buffer_pool_options options = {
+        .chunk_size = chunk_size,
+        .mem_limit = GB_TO_BYTES(1),
+        .prefault_size = 2 * block_size,
+        .num_numa_nodes = 2,
+    };
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new_with_options(allocator, &options);
+    ASSERT_NOT_NULL(buffer_pool);
+
+    /* pre-faulted blocks are spread across nodes */
+    struct aws_s3_buffer_pool_usage_stats stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(2, stats.num_numa_nodes);
+    ASSERT_UINT_EQUALS(block_size, aws_s3_buffer_pool_get_numa_node_allocated(buffer_pool, 0));
+    ASSERT_UINT_EQUALS(block_size, aws_s3_buffer_pool_get_numa_node_allocated(buffer_pool, 1));
+    ASSERT_UINT_EQUALS(0, aws_s3_buffer_pool_get_numa_node_allocated(buffer_pool, 2));
+
+    /* filling up node 1 grows node 1 only */
+    struct aws_s3_buffer_pool_ticket *tickets[17];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tickets); ++i) {
+        tickets[i] = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+        ASSERT_NOT_NULL(tickets[i]);
+        struct aws_byte_buf buf = aws_s3_buffer_pool_acquire_buffer_on_numa_node(buffer_pool, tickets[i], 1);
+        ASSERT_NOT_NULL(buf.buffer);
+    }
+
+    ASSERT_UINT_EQUALS(block_size, aws_s3_buffer_pool_get_numa_node_allocated(buffer_pool, 0));
+    ASSERT_UINT_EQUALS(2 * block_size, aws_s3_buffer_pool_get_numa_node_allocated(buffer_pool, 1));
+
+    /* buffers acquired on the calling thread's node come from some node too */
+    struct aws_s3_buffer_pool_ticket *local_ticket = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+    ASSERT_NOT_NULL(local_ticket);
+    ASSERT_NOT_NULL(aws_s3_buffer_pool_acquire_buffer(buffer_pool, local_ticket).buffer);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, local_ticket);
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tickets); ++i) {
+        aws_s3_buffer_pool_release_ticket(buffer_pool, tickets[i]);
+    }
+
+    aws_s3_buffer_pool_trim(buffer_pool);
+    stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(2 * block_size, stats.primary_allocated);
+    ASSERT_UINT_EQUALS(block_size, aws_s3_buffer_pool_get_numa_node_allocated(buffer_pool, 0));
+    ASSERT_UINT_EQUALS(block_size, aws_s3_buffer_pool_get_numa_node_allocated(buffer_pool, 1));
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_numa_nodes, s_test_s3_buffer_pool_numa_nodes)
+
+/* Test that secondary buffers are pooled in size classes */
+static int s_test_s3_buffer_pool_size_classes(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new(allocator, chunk_size, GB_TO_BYTES(2));
+    ASSERT_NOT_NULL(buffer_pool);
+
+    struct aws_s3_buffer_pool_usage_stats stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_TRUE(stats.num_size_classes > 0);
+
+    /* classes grow from primary cutoff and are at most 12.5% larger than what they hold */
+    size_t prev_buffer_size = stats.primary_cutoff;
+    for (size_t i = 0; i < stats.num_size_classes; ++i) {
+        struct aws_s3_buffer_pool_size_class_usage class_usage =
+            aws_s3_buffer_pool_get_size_class_usage(buffer_pool, i);
+        ASSERT_TRUE(class_usage.buffer_size > prev_buffer_size);
+        ASSERT_TRUE(class_usage.buffer_size - prev_buffer_size <= class_usage.buffer_size / 8);
+        ASSERT_TRUE(class_usage.buffer_size <= stats.mem_limit);
+        ASSERT_UINT_EQUALS(0, class_usage.allocated);
+        prev_buffer_size = class_usage.buffer_size;
+    }
+    ASSERT_UINT_EQUALS(0, aws_s3_buffer_pool_get_size_class_usage(buffer_pool, stats.num_size_classes).buffer_size);
+
+    /* 64MB and 256MB buffers land in exactly sized classes and are reused */
+    const size_t sizes[] = {MB_TO_BYTES(64), MB_TO_BYTES(256)};
+    size_t expected_cached = 0;
+    for (size_t size_i = 0; size_i < AWS_ARRAY_SIZE(sizes); ++size_i) {
+        uint8_t *first_ptr = NULL;
+        for (size_t i = 0; i < 3; ++i) {
+            struct aws_s3_buffer_pool_ticket *ticket = aws_s3_buffer_pool_reserve(buffer_pool, sizes[size_i]);
+            ASSERT_NOT_NULL(ticket);
+            struct aws_byte_buf buf = aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket);
+            ASSERT_UINT_EQUALS(sizes[size_i], buf.capacity);
+            if (first_ptr == NULL) {
+                first_ptr = buf.buffer;
+            }
+            ASSERT_PTR_EQUALS(first_ptr, buf.buffer);
+
+            stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+            ASSERT_UINT_EQUALS(sizes[size_i], stats.secondary_used);
+            ASSERT_UINT_EQUALS(expected_cached, stats.secondary_cached);
+            aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+        }
+        expected_cached += sizes[size_i];
+    }
+
+    stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(0, stats.secondary_used);
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(64) + MB_TO_BYTES(256), stats.secondary_cached);
+
+    size_t allocated = 0;
+    size_t cached = 0;
+    size_t classes_used = 0;
+    for (size_t i = 0; i < stats.num_size_classes; ++i) {
+        struct aws_s3_buffer_pool_size_class_usage class_usage =
+            aws_s3_buffer_pool_get_size_class_usage(buffer_pool, i);
+        allocated += class_usage.allocated;
+        cached += class_usage.cached;
+        if (class_usage.allocated > 0) {
+            ASSERT_UINT_EQUALS(class_usage.buffer_size, class_usage.allocated);
+            ++classes_used;
+        }
+    }
+    ASSERT_UINT_EQUALS(2, classes_used);
+    ASSERT_UINT_EQUALS(stats.secondary_cached, allocated);
+    ASSERT_UINT_EQUALS(stats.secondary_cached, cached);
+
+    /* odd sizes are rounded up to a class */
+    struct aws_s3_buffer_pool_ticket *odd_ticket = aws_s3_buffer_pool_reserve(buffer_pool, MB_TO_BYTES(100) + 1);
+    ASSERT_NOT_NULL(odd_ticket);
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(100) + 1, aws_s3_buffer_pool_acquire_buffer(buffer_pool, odd_ticket).capacity);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, odd_ticket);
+
+    aws_s3_buffer_pool_trim(buffer_pool);
+    stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(0, stats.secondary_cached);
+    for (size_t i = 0; i < stats.num_size_classes; ++i) {
+        ASSERT_UINT_EQUALS(0, aws_s3_buffer_pool_get_size_class_usage(buffer_pool, i).allocated);
+    }
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_size_classes, s_test_s3_buffer_pool_size_classes)
+
+/* Buffers kept for reuse and space lost to rounding up to a size class count towards the memory limit,
+ * so new reservations trim the cache instead of letting the pool grow past the limit. */
+static int s_test_s3_buffer_pool_size_class_cache_limit(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    /* 1GB minus 128MB overhead */
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new(allocator, chunk_size, GB_TO_BYTES(1));
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(896), aws_s3_buffer_pool_get_usage(buffer_pool).mem_limit);
+
+    /* Keep a 256MB buffer for reuse */
+    struct aws_s3_buffer_pool_ticket *cached_ticket = aws_s3_buffer_pool_reserve(buffer_pool, MB_TO_BYTES(256));
+    ASSERT_NOT_NULL(cached_ticket);
+    aws_s3_buffer_pool_acquire_buffer(buffer_pool, cached_ticket);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, cached_ticket);
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(256), aws_s3_buffer_pool_get_usage(buffer_pool).secondary_cached);
+
+    /* 6 buffers of 100MB + 1, each rounded up to the 104MB class. Together with the cache that's 880MB held. */
+    struct aws_s3_buffer_pool_ticket *odd_tickets[6];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(odd_tickets); ++i) {
+        odd_tickets[i] = aws_s3_buffer_pool_reserve(buffer_pool, MB_TO_BYTES(100) + 1);
+        ASSERT_NOT_NULL(odd_tickets[i]);
+        aws_s3_buffer_pool_acquire_buffer(buffer_pool, odd_tickets[i]);
+    }
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(256), aws_s3_buffer_pool_get_usage(buffer_pool).secondary_cached);
+
+    /* 2 chunks still fit next to the cache */
+    struct aws_s3_buffer_pool_ticket *chunk_tickets[3];
+    for (size_t i = 0; i < 2; ++i) {
+        chunk_tickets[i] = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+        ASSERT_NOT_NULL(chunk_tickets[i]);
+    }
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(256), aws_s3_buffer_pool_get_usage(buffer_pool).secondary_cached);
+
+    /* The third one only fits if rounding is accounted for and the cache is trimmed */
+    chunk_tickets[2] = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+    ASSERT_NOT_NULL(chunk_tickets[2]);
+    ASSERT_UINT_EQUALS(0, aws_s3_buffer_pool_get_usage(buffer_pool).secondary_cached);
+
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(chunk_tickets); ++i) {
+        aws_s3_buffer_pool_release_ticket(buffer_pool, chunk_tickets[i]);
+    }
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(odd_tickets); ++i) {
+        aws_s3_buffer_pool_release_ticket(buffer_pool, odd_tickets[i]);
+    }
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_size_class_cache_limit, s_test_s3_buffer_pool_size_class_cache_limit)
+
+static int s_fill_and_release_blocks(struct aws_s3_buffer_pool *buffer_pool, size_t chunk_size, size_t num_blocks) {
+    struct aws_s3_buffer_pool_ticket *tickets[16 * 8];
+    size_t num_tickets = 16 * num_blocks;
+    ASSERT_TRUE(num_tickets <= AWS_ARRAY_SIZE(tickets));
+
+    for (size_t i = 0; i < num_tickets; ++i) {
+        tickets[i] = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+        ASSERT_NOT_NULL(tickets[i]);
+        ASSERT_NOT_NULL(aws_s3_buffer_pool_acquire_buffer(buffer_pool, tickets[i]).buffer);
+    }
+    for (size_t i = 0; i < num_tickets; ++i) {
+        aws_s3_buffer_pool_release_ticket(buffer_pool, tickets[i]);
+    }
+
+    ASSERT_UINT_EQUALS(num_blocks, aws_s3_buffer_pool_get_usage(buffer_pool).primary_num_blocks);
+    return 0;
+}
+
+/* Test that trim steps decay unused memory down to the low water mark */
+static int s_test_s3_buffer_pool_trim_step(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    const size_t block_size = 16 * chunk_size;
+    struct aws_s3_buffer_pool_options options = {
+        .chunk_size = chunk_size,
+        .mem_limit = GB_TO_BYTES(2),
+        .trim_low_water_mark = block_size,
+    };
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new_with_options(allocator, &options);
+    ASSERT_NOT_NULL(buffer_pool);
+
+    ASSERT_SUCCESS(s_fill_and_release_blocks(buffer_pool, chunk_size, 8));
+
+    /* each step frees about half of what's above the low water mark */
+    ASSERT_TRUE(aws_s3_buffer_pool_trim_step(buffer_pool));
+    ASSERT_UINT_EQUALS(4, aws_s3_buffer_pool_get_usage(buffer_pool).primary_num_blocks);
+    ASSERT_TRUE(aws_s3_buffer_pool_trim_step(buffer_pool));
+    ASSERT_UINT_EQUALS(2, aws_s3_buffer_pool_get_usage(buffer_pool).primary_num_blocks);
+    ASSERT_FALSE(aws_s3_buffer_pool_trim_step(buffer_pool));
+    ASSERT_UINT_EQUALS(1, aws_s3_buffer_pool_get_usage(buffer_pool).primary_num_blocks);
+
+    /* low water mark is kept */
+    ASSERT_FALSE(aws_s3_buffer_pool_trim_step(buffer_pool));
+    ASSERT_UINT_EQUALS(block_size, aws_s3_buffer_pool_get_usage(buffer_pool).primary_allocated);
+
+    /* but full trim still frees everything */
+    aws_s3_buffer_pool_trim(buffer_pool);
+    ASSERT_UINT_EQUALS(0, aws_s3_buffer_pool_get_usage(buffer_pool).primary_allocated);
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_trim_step, s_test_s3_buffer_pool_trim_step)
+
+/* Test that secondary reservations only trim as much as they need */
+static int s_test_s3_buffer_pool_partial_trim(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    const size_t block_size = 16 * chunk_size;
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new(allocator, chunk_size, GB_TO_BYTES(1));
+    ASSERT_NOT_NULL(buffer_pool);
+
+    ASSERT_SUCCESS(s_fill_and_release_blocks(buffer_pool, chunk_size, 6));
+
+    /* Fits next to unused blocks, nothing is trimmed */
+    struct aws_s3_buffer_pool_ticket *small_ticket = aws_s3_buffer_pool_reserve(buffer_pool, MB_TO_BYTES(64));
+    ASSERT_NOT_NULL(small_ticket);
+    ASSERT_UINT_EQUALS(6, aws_s3_buffer_pool_get_usage(buffer_pool).primary_num_blocks);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, small_ticket);
+
+    /* 768MB of unused blocks + 256MB goes over 896MB limit, only 1 block needs to go */
+    struct aws_s3_buffer_pool_ticket *ticket = aws_s3_buffer_pool_reserve(buffer_pool, MB_TO_BYTES(256));
+    ASSERT_NOT_NULL(ticket);
+    struct aws_s3_buffer_pool_usage_stats stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(5, stats.primary_num_blocks);
+    ASSERT_UINT_EQUALS(5 * block_size, stats.primary_allocated);
+    ASSERT_TRUE(stats.primary_allocated + MB_TO_BYTES(256) <= stats.mem_limit);
+    ASSERT_NOT_NULL(aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket).buffer);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+
+    /* Buffer kept for reuse is used again, without trimming */
+    ticket = aws_s3_buffer_pool_reserve(buffer_pool, MB_TO_BYTES(256));
+    ASSERT_NOT_NULL(ticket);
+    ASSERT_UINT_EQUALS(5, aws_s3_buffer_pool_get_usage(buffer_pool).primary_num_blocks);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_partial_trim, s_test_s3_buffer_pool_partial_trim)
+
+struct s_reserve_order_tester {
+    int order[4];
+    size_t num_completed;
+};
+
+struct s_reserve_order_waiter {
+    struct s_reserve_order_tester *tester;
+    int id;
+};
+
+static void s_on_reserve_completed(void *user_data) {
+    struct s_reserve_order_waiter *waiter = user_data;
+    waiter->tester->order[waiter->tester->num_completed++] = waiter->id;
+}
+
+/* Test that async reservations wait in FIFO order and are woken by released tickets */
+static int s_test_s3_buffer_pool_reserve_async(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new(allocator, chunk_size, GB_TO_BYTES(1));
+    ASSERT_NOT_NULL(buffer_pool);
+
+    /* Reservation completes right away while there is memory */
+    struct aws_future_s3_buffer_ticket *future = aws_s3_buffer_pool_reserve_async(buffer_pool, chunk_size);
+    ASSERT_TRUE(aws_future_s3_buffer_ticket_is_done(future));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, aws_future_s3_buffer_ticket_get_error(future));
+    ASSERT_NOT_NULL(aws_future_s3_buffer_ticket_peek_result(future));
+    /* Releasing future releases the ticket */
+    aws_future_s3_buffer_ticket_release(future);
+    ASSERT_UINT_EQUALS(0, aws_s3_buffer_pool_get_usage(buffer_pool).primary_reserved);
+
+    /* Fill up the pool (1GB minus 128MB overhead) */
+    struct aws_s3_buffer_pool_ticket *tickets[112];
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(tickets); ++i) {
+        tickets[i] = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+        ASSERT_NOT_NULL(tickets[i]);
+    }
+
+    struct s_reserve_order_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    struct s_reserve_order_waiter waiters[4];
+    struct aws_future_s3_buffer_ticket *futures[4];
+    for (int i = 0; i < 4; ++i) {
+        waiters[i].tester = &tester;
+        waiters[i].id = i;
+        futures[i] = aws_s3_buffer_pool_reserve_async(buffer_pool, chunk_size);
+        ASSERT_FALSE(aws_future_s3_buffer_ticket_is_done(futures[i]));
+        aws_future_s3_buffer_ticket_register_callback(futures[i], s_on_reserve_completed, &waiters[i]);
+    }
+
+    /* Reservation hold does not matter, sync reserve can't jump the queue */
+    aws_s3_buffer_pool_remove_reservation_hold(buffer_pool);
+    ASSERT_NULL(aws_s3_buffer_pool_reserve(buffer_pool, chunk_size));
+    ASSERT_INT_EQUALS(AWS_ERROR_S3_EXCEEDS_MEMORY_LIMIT, aws_last_error());
+    aws_s3_buffer_pool_remove_reservation_hold(buffer_pool);
+
+    /* Cancelled waiter is skipped */
+    aws_s3_buffer_pool_cancel_reservation(buffer_pool, futures[1]);
+    ASSERT_UINT_EQUALS(1, tester.num_completed);
+    ASSERT_INT_EQUALS(1, tester.order[0]);
+    ASSERT_INT_EQUALS(AWS_ERROR_S3_CANCELED, aws_future_s3_buffer_ticket_get_error(futures[1]));
+
+    /* Each release hands memory to the oldest waiter */
+    aws_s3_buffer_pool_release_ticket(buffer_pool, tickets[0]);
+    ASSERT_UINT_EQUALS(2, tester.num_completed);
+    ASSERT_INT_EQUALS(0, tester.order[1]);
+    ASSERT_FALSE(aws_future_s3_buffer_ticket_is_done(futures[2]));
+
+    aws_s3_buffer_pool_release_ticket(buffer_pool, tickets[1]);
+    ASSERT_UINT_EQUALS(3, tester.num_completed);
+    ASSERT_INT_EQUALS(2, tester.order[2]);
+    ASSERT_FALSE(aws_future_s3_buffer_ticket_is_done(futures[3]));
+
+    /* Woken ticket is usable like any other */
+    struct aws_s3_buffer_pool_ticket *ticket = aws_future_s3_buffer_ticket_get_result_by_move(futures[0]);
+    ASSERT_NOT_NULL(ticket);
+    ASSERT_NOT_NULL(aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket).buffer);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+    ASSERT_UINT_EQUALS(4, tester.num_completed);
+    ASSERT_INT_EQUALS(3, tester.order[3]);
+
+    for (int i = 0; i < 4; ++i) {
+        aws_future_s3_buffer_ticket_release(futures[i]);
+    }
+    for (size_t i = 2; i < AWS_ARRAY_SIZE(tickets); ++i) {
+        aws_s3_buffer_pool_release_ticket(buffer_pool, tickets[i]);
+    }
+
+    struct aws_s3_buffer_pool_usage_stats stats = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(0, stats.primary_reserved);
+    ASSERT_UINT_EQUALS(0, stats.primary_used);
+
+    /* Releasing a future that holds a ticket wakes the next waiter */
+    future = aws_s3_buffer_pool_reserve_async(buffer_pool, GB_TO_BYTES(1) - MB_TO_BYTES(128));
+    struct aws_future_s3_buffer_ticket *pending_future = aws_s3_buffer_pool_reserve_async(buffer_pool, chunk_size);
+    ASSERT_FALSE(aws_future_s3_buffer_ticket_is_done(pending_future));
+    aws_future_s3_buffer_ticket_release(future);
+    ASSERT_TRUE(aws_future_s3_buffer_ticket_is_done(pending_future));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, aws_future_s3_buffer_ticket_get_error(pending_future));
+
+    aws_future_s3_buffer_ticket_release(pending_future);
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_reserve_async, s_test_s3_buffer_pool_reserve_async)
+
+/* Test that tracker follows tickets attached to it through acquire and release */
+static int s_test_s3_buffer_pool_tracker(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new(allocator, chunk_size, GB_TO_BYTES(1));
+    ASSERT_NOT_NULL(buffer_pool);
+
+    struct aws_s3_buffer_pool_tracker tracker;
+    aws_s3_buffer_pool_tracker_init(&tracker, NULL);
+
+    struct aws_s3_buffer_pool_ticket *primary_ticket = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+    ASSERT_NOT_NULL(primary_ticket);
+    ASSERT_UINT_EQUALS(chunk_size, aws_s3_buffer_pool_ticket_get_size(primary_ticket));
+    aws_s3_buffer_pool_ticket_set_tracker(primary_ticket, &tracker);
+
+    struct aws_s3_buffer_pool_ticket *secondary_ticket = aws_s3_buffer_pool_reserve(buffer_pool, MB_TO_BYTES(64));
+    ASSERT_NOT_NULL(secondary_ticket);
+    aws_s3_buffer_pool_ticket_set_tracker(secondary_ticket, &tracker);
+
+    /* Untracked tickets don't count */
+    struct aws_s3_buffer_pool_ticket *other_ticket = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+    ASSERT_NOT_NULL(other_ticket);
+
+    ASSERT_UINT_EQUALS(chunk_size + MB_TO_BYTES(64), aws_atomic_load_int(&tracker.reserved));
+    ASSERT_UINT_EQUALS(0, aws_atomic_load_int(&tracker.used));
+
+    ASSERT_NOT_NULL(aws_s3_buffer_pool_acquire_buffer(buffer_pool, primary_ticket).buffer);
+    ASSERT_NOT_NULL(aws_s3_buffer_pool_acquire_buffer(buffer_pool, other_ticket).buffer);
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(64), aws_atomic_load_int(&tracker.reserved));
+    ASSERT_UINT_EQUALS(chunk_size, aws_atomic_load_int(&tracker.used));
+
+    /* Forced buffers are attached once acquired */
+    struct aws_s3_buffer_pool_ticket *forced_ticket = NULL;
+    ASSERT_NOT_NULL(aws_s3_buffer_pool_acquire_forced_buffer(buffer_pool, chunk_size, &forced_ticket).buffer);
+    aws_s3_buffer_pool_ticket_set_tracker(forced_ticket, &tracker);
+    ASSERT_UINT_EQUALS(2 * chunk_size, aws_atomic_load_int(&tracker.used));
+
+    aws_s3_buffer_pool_release_ticket(buffer_pool, primary_ticket);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, secondary_ticket);
+    ASSERT_UINT_EQUALS(0, aws_atomic_load_int(&tracker.reserved));
+    ASSERT_UINT_EQUALS(chunk_size, aws_atomic_load_int(&tracker.used));
+
+    /* Detached ticket no longer counts */
+    aws_s3_buffer_pool_ticket_set_tracker(forced_ticket, NULL);
+    ASSERT_UINT_EQUALS(0, aws_atomic_load_int(&tracker.used));
+
+    aws_s3_buffer_pool_release_ticket(buffer_pool, forced_ticket);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, other_ticket);
+    ASSERT_UINT_EQUALS(0, aws_atomic_load_int(&tracker.used));
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_tracker, s_test_s3_buffer_pool_tracker)
+
+/* Test that nested trackers add up, and that pool stays alive until all references are released */
+static int s_test_s3_buffer_pool_shared(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    const size_t chunk_size = MB_TO_BYTES(8);
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_buffer_pool_new(allocator, chunk_size, GB_TO_BYTES(1));
+    ASSERT_NOT_NULL(buffer_pool);
+    ASSERT_PTR_EQUALS(buffer_pool, aws_s3_buffer_pool_acquire(buffer_pool));
+
+    /* ex. one tracker per client, with a tracker per meta request under it */
+    struct aws_s3_buffer_pool_tracker client_tracker;
+    aws_s3_buffer_pool_tracker_init(&client_tracker, NULL);
+    struct aws_s3_buffer_pool_tracker tracker_a;
+    aws_s3_buffer_pool_tracker_init(&tracker_a, &client_tracker);
+    struct aws_s3_buffer_pool_tracker tracker_b;
+    aws_s3_buffer_pool_tracker_init(&tracker_b, &client_tracker);
+
+    struct aws_s3_buffer_pool_ticket *ticket_a = aws_s3_buffer_pool_reserve(buffer_pool, chunk_size);
+    ASSERT_NOT_NULL(ticket_a);
+    aws_s3_buffer_pool_ticket_set_tracker(ticket_a, &tracker_a);
+    struct aws_s3_buffer_pool_ticket *ticket_b = aws_s3_buffer_pool_reserve(buffer_pool, 2 * chunk_size);
+    ASSERT_NOT_NULL(ticket_b);
+    aws_s3_buffer_pool_ticket_set_tracker(ticket_b, &tracker_b);
+
+    ASSERT_NOT_NULL(aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket_b).buffer);
+    ASSERT_UINT_EQUALS(chunk_size, aws_atomic_load_int(&tracker_a.reserved));
+    ASSERT_UINT_EQUALS(2 * chunk_size, aws_atomic_load_int(&tracker_b.used));
+    ASSERT_UINT_EQUALS(chunk_size, aws_atomic_load_int(&client_tracker.reserved));
+    ASSERT_UINT_EQUALS(2 * chunk_size, aws_atomic_load_int(&client_tracker.used));
+
+    /* Releasing one reference keeps pool usable */
+    aws_s3_buffer_pool_release(buffer_pool);
+
+    aws_s3_buffer_pool_release_ticket(buffer_pool, ticket_a);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, ticket_b);
+    ASSERT_UINT_EQUALS(0, aws_atomic_load_int(&client_tracker.reserved));
+    ASSERT_UINT_EQUALS(0, aws_atomic_load_int(&client_tracker.used));
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_shared, s_test_s3_buffer_pool_shared)
+
+/* Provider handing out fixed size slots from a preallocated arena, ex. memory registered with a network card */
+#define S_TEST_ARENA_NUM_SLOTS 4
+#define S_TEST_ARENA_SLOT_SIZE 1024
+
+struct s_test_arena_provider {
+    struct aws_allocator *allocator;
+    uint8_t arena[S_TEST_ARENA_NUM_SLOTS * S_TEST_ARENA_SLOT_SIZE];
+    bool slot_in_use[S_TEST_ARENA_NUM_SLOTS];
+    size_t reserved;
+    /* Slots taken by someone else sharing the arena */
+    size_t reserved_elsewhere;
+    size_t num_forced;
+    size_t num_trims;
+    /* Simulate the arena running dry when acquiring */
+    bool fail_acquire;
+    bool destroyed;
+};
+
+static bool s_test_arena_reserve(void *user_data, size_t size) {
+    struct s_test_arena_provider *arena = user_data;
+    AWS_FATAL_ASSERT(size <= S_TEST_ARENA_SLOT_SIZE);
+    if (arena->reserved + arena->reserved_elsewhere == S_TEST_ARENA_NUM_SLOTS) {
+        return false;
+    }
+    ++arena->reserved;
+    return true;
+}
+
+static uint8_t *s_test_arena_acquire(void *user_data, size_t size, bool forced) {
+    struct s_test_arena_provider *arena = user_data;
+    if (arena->fail_acquire) {
+        return NULL;
+    }
+    if (forced) {
+        ++arena->num_forced;
+        return aws_mem_acquire(arena->allocator, size);
+    }
+    for (size_t i = 0; i < S_TEST_ARENA_NUM_SLOTS; ++i) {
+        if (!arena->slot_in_use[i]) {
+            arena->slot_in_use[i] = true;
+            return arena->arena + i * S_TEST_ARENA_SLOT_SIZE;
+        }
+    }
+    return NULL;
+}
+
+static void s_test_arena_release(void *user_data, uint8_t *ptr, size_t size, bool forced) {
+    (void)size;
+    struct s_test_arena_provider *arena = user_data;
+    if (forced) {
+        AWS_FATAL_ASSERT(ptr != NULL && (ptr < arena->arena || ptr >= arena->arena + sizeof(arena->arena)));
+        --arena->num_forced;
+        aws_mem_release(arena->allocator, ptr);
+        return;
+    }
+    if (ptr != NULL) {
+        arena->slot_in_use[(ptr - arena->arena) / S_TEST_ARENA_SLOT_SIZE] = false;
+    }
+    --arena->reserved;
+}
+
+static void s_test_arena_trim(void *user_data) {
+    struct s_test_arena_provider *arena = user_data;
+    ++arena->num_trims;
+}
+
+static struct aws_s3_buffer_provider_usage s_test_arena_get_usage(void *user_data) {
+    (void)user_data;
+    return (struct aws_s3_buffer_provider_usage){
+        .memory_limit = S_TEST_ARENA_NUM_SLOTS * S_TEST_ARENA_SLOT_SIZE,
+        .allocated = S_TEST_ARENA_NUM_SLOTS * S_TEST_ARENA_SLOT_SIZE,
+    };
+}
+
+static void s_test_arena_destroy(void *user_data) {
+    struct s_test_arena_provider *arena = user_data;
+    arena->destroyed = true;
+}
+
+static struct aws_s3_buffer_provider_vtable s_test_arena_vtable = {
+    .reserve = s_test_arena_reserve,
+    .acquire = s_test_arena_acquire,
+    .release = s_test_arena_release,
+    .trim = s_test_arena_trim,
+    .get_usage = s_test_arena_get_usage,
+    .destroy = s_test_arena_destroy,
+};
+
+/* Test that pool created from a provider hands out provider's memory, and waits for it when provider runs out */
+static int s_test_s3_buffer_pool_provider(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct s_test_arena_provider *arena = aws_mem_calloc(allocator, 1, sizeof(struct s_test_arena_provider));
+    arena->allocator = allocator;
+
+    /* Required functions must be set */
+    struct aws_s3_buffer_provider_vtable bad_vtable = {.reserve = s_test_arena_reserve};
+    ASSERT_NULL(aws_s3_buffer_pool_new_from_provider(allocator, &bad_vtable, arena));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    struct aws_s3_buffer_pool *buffer_pool =
+        aws_s3_buffer_pool_new_from_provider(allocator, &s_test_arena_vtable, arena);
+    ASSERT_NOT_NULL(buffer_pool);
+    struct aws_s3_buffer_pool_usage_stats usage = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(S_TEST_ARENA_NUM_SLOTS * S_TEST_ARENA_SLOT_SIZE, usage.mem_limit);
+    ASSERT_UINT_EQUALS(S_TEST_ARENA_NUM_SLOTS * S_TEST_ARENA_SLOT_SIZE, usage.provider_allocated);
+    ASSERT_UINT_EQUALS(0, usage.num_size_classes);
+
+    struct aws_s3_buffer_pool_ticket *tickets[S_TEST_ARENA_NUM_SLOTS];
+    for (size_t i = 0; i < S_TEST_ARENA_NUM_SLOTS; ++i) {
+        tickets[i] = aws_s3_buffer_pool_reserve(buffer_pool, S_TEST_ARENA_SLOT_SIZE);
+        ASSERT_NOT_NULL(tickets[i]);
+    }
+    ASSERT_UINT_EQUALS(S_TEST_ARENA_NUM_SLOTS, arena->reserved);
+    ASSERT_NULL(aws_s3_buffer_pool_reserve(buffer_pool, S_TEST_ARENA_SLOT_SIZE));
+    aws_s3_buffer_pool_remove_reservation_hold(buffer_pool);
+
+    /* Buffers point into the arena */
+    struct aws_byte_buf buf = aws_s3_buffer_pool_acquire_buffer(buffer_pool, tickets[0]);
+    ASSERT_TRUE(buf.buffer >= arena->arena && buf.buffer < arena->arena + sizeof(arena->arena));
+    ASSERT_UINT_EQUALS(S_TEST_ARENA_SLOT_SIZE, buf.capacity);
+    ASSERT_TRUE(arena->slot_in_use[0]);
+    ASSERT_UINT_EQUALS(S_TEST_ARENA_SLOT_SIZE, aws_s3_buffer_pool_get_usage(buffer_pool).secondary_used);
+
+    /* Async reservation waits for provider memory, and gets it once a ticket is released */
+    struct aws_future_s3_buffer_ticket *future = aws_s3_buffer_pool_reserve_async(buffer_pool, S_TEST_ARENA_SLOT_SIZE);
+    ASSERT_FALSE(aws_future_s3_buffer_ticket_is_done(future));
+    aws_s3_buffer_pool_release_ticket(buffer_pool, tickets[0]);
+    ASSERT_FALSE(arena->slot_in_use[0]);
+    ASSERT_TRUE(aws_future_s3_buffer_ticket_is_done(future));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, aws_future_s3_buffer_ticket_get_error(future));
+    ASSERT_UINT_EQUALS(S_TEST_ARENA_NUM_SLOTS, arena->reserved);
+
+    /* Forced buffer goes over provider's budget */
+    struct aws_s3_buffer_pool_ticket *forced_ticket = NULL;
+    buf = aws_s3_buffer_pool_acquire_forced_buffer(buffer_pool, S_TEST_ARENA_SLOT_SIZE, &forced_ticket);
+    ASSERT_NOT_NULL(buf.buffer);
+    ASSERT_UINT_EQUALS(1, arena->num_forced);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, forced_ticket);
+    ASSERT_UINT_EQUALS(0, arena->num_forced);
+
+    /* Releasing unused tickets gives budget back to the provider */
+    aws_future_s3_buffer_ticket_release(future);
+    for (size_t i = 1; i < S_TEST_ARENA_NUM_SLOTS; ++i) {
+        aws_s3_buffer_pool_release_ticket(buffer_pool, tickets[i]);
+    }
+    ASSERT_UINT_EQUALS(0, arena->reserved);
+
+    aws_s3_buffer_pool_trim(buffer_pool);
+    ASSERT_FALSE(aws_s3_buffer_pool_trim_step(buffer_pool));
+    ASSERT_UINT_EQUALS(2, arena->num_trims);
+
+    ASSERT_FALSE(arena->destroyed);
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    ASSERT_TRUE(arena->destroyed);
+
+    aws_mem_release(allocator, arena);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_provider, s_test_s3_buffer_pool_provider)
+
+/* Test that waiters are woken when provider's memory is freed outside of the pool,
+ * and that provider failing to acquire memory fails the acquisition instead of the process */
+static int s_test_s3_buffer_pool_provider_out_of_memory(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct s_test_arena_provider *arena = aws_mem_calloc(allocator, 1, sizeof(struct s_test_arena_provider));
+    arena->allocator = allocator;
+    struct aws_s3_buffer_pool *buffer_pool =
+        aws_s3_buffer_pool_new_from_provider(allocator, &s_test_arena_vtable, arena);
+    ASSERT_NOT_NULL(buffer_pool);
+
+    /* Arena is all used elsewhere, and the pool holds nothing it could release */
+    arena->reserved_elsewhere = S_TEST_ARENA_NUM_SLOTS;
+    struct aws_future_s3_buffer_ticket *future = aws_s3_buffer_pool_reserve_async(buffer_pool, S_TEST_ARENA_SLOT_SIZE);
+    struct aws_future_s3_buffer_ticket *cancelled_future =
+        aws_s3_buffer_pool_reserve_async(buffer_pool, S_TEST_ARENA_SLOT_SIZE);
+    aws_s3_buffer_pool_notify_provider_memory_available(buffer_pool);
+    ASSERT_FALSE(aws_future_s3_buffer_ticket_is_done(future));
+
+    aws_s3_buffer_pool_cancel_reservation(buffer_pool, cancelled_future);
+    ASSERT_INT_EQUALS(AWS_ERROR_S3_CANCELED, aws_future_s3_buffer_ticket_get_error(cancelled_future));
+    aws_future_s3_buffer_ticket_release(cancelled_future);
+
+    /* Memory freed elsewhere wakes the waiter once the pool is told */
+    arena->reserved_elsewhere = 0;
+    ASSERT_FALSE(aws_future_s3_buffer_ticket_is_done(future));
+    aws_s3_buffer_pool_notify_provider_memory_available(buffer_pool);
+    ASSERT_TRUE(aws_future_s3_buffer_ticket_is_done(future));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, aws_future_s3_buffer_ticket_get_error(future));
+    ASSERT_UINT_EQUALS(1, arena->reserved);
+    struct aws_s3_buffer_pool_ticket *ticket = aws_future_s3_buffer_ticket_get_result_by_move(future);
+    aws_future_s3_buffer_ticket_release(future);
+
+    /* Failing to acquire leaves the ticket reserved, so releasing it gives the budget back */
+    arena->fail_acquire = true;
+    struct aws_byte_buf buf = aws_s3_buffer_pool_acquire_buffer(buffer_pool, ticket);
+    ASSERT_NULL(buf.buffer);
+    ASSERT_INT_EQUALS(AWS_ERROR_OOM, aws_last_error());
+    ASSERT_UINT_EQUALS(0, aws_s3_buffer_pool_get_usage(buffer_pool).secondary_used);
+    aws_s3_buffer_pool_release_ticket(buffer_pool, ticket);
+    ASSERT_UINT_EQUALS(0, arena->reserved);
+
+    struct aws_s3_buffer_pool_ticket *forced_ticket = NULL;
+    buf = aws_s3_buffer_pool_acquire_forced_buffer(buffer_pool, S_TEST_ARENA_SLOT_SIZE, &forced_ticket);
+    ASSERT_NULL(buf.buffer);
+    ASSERT_NULL(forced_ticket);
+    ASSERT_INT_EQUALS(AWS_ERROR_OOM, aws_last_error());
+    struct aws_s3_buffer_pool_usage_stats usage = aws_s3_buffer_pool_get_usage(buffer_pool);
+    ASSERT_UINT_EQUALS(0, usage.forced_used);
+    ASSERT_UINT_EQUALS(0, usage.secondary_used);
+
+    aws_s3_buffer_pool_destroy(buffer_pool);
+    aws_mem_release(allocator, arena);
+    return 0;
+}
+AWS_TEST_CASE(test_s3_buffer_pool_provider_out_of_memory, s_test_s3_buffer_pool_provider_out_of_memory)
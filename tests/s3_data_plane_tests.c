@@ -6,8 +6,10 @@
 #include "aws/s3/private/s3_checksums.h"
 #include "aws/s3/private/s3_client_impl.h"
 #include "aws/s3/private/s3_meta_request_impl.h"
+#include "aws/s3/private/s3_object_metadata_cache.h"
 #include "aws/s3/private/s3_util.h"
 #include "aws/s3/s3_client.h"
+#include "aws/s3/s3_object_reader.h"
 #include "s3_tester.h"
 #include <aws/common/byte_buf.h>
 #include <aws/common/clock.h>
@@ -19,6 +21,7 @@
 #include <aws/http/status_code.h>
 #include <aws/io/channel_bootstrap.h>
 #include <aws/io/event_loop.h>
+#include <aws/io/future.h>
 #include <aws/io/host_resolver.h>
 #include <aws/io/stream.h>
 #include <aws/io/tls_channel_handler.h>
@@ -77,6 +80,60 @@ static int s_test_s3_client_create_error(struct aws_allocator *allocator, void *
     return 0;
 }
 
+AWS_TEST_CASE(test_s3_client_shared_buffer_pool, s_test_s3_client_shared_buffer_pool)
+static int s_test_s3_client_shared_buffer_pool(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct aws_s3_shared_buffer_pool_options pool_options = {
+        .memory_limit_in_bytes = GB_TO_BYTES(4),
+    };
+    struct aws_s3_buffer_pool *buffer_pool = aws_s3_shared_buffer_pool_new(allocator, &pool_options);
+    ASSERT_NOT_NULL(buffer_pool);
+
+    struct aws_s3_client_config client_config;
+    AWS_ZERO_STRUCT(client_config);
+    client_config.buffer_pool = buffer_pool;
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    /* Client that fails to be created doesn't keep a reference to the pool */
+    client_config.max_part_size = GB_TO_BYTES(8);
+    ASSERT_NULL(aws_s3_client_new(allocator, &client_config));
+    ASSERT_INT_EQUALS(AWS_ERROR_S3_INVALID_MEMORY_LIMIT_CONFIG, aws_last_error());
+    client_config.max_part_size = 0;
+
+    struct aws_s3_client *client_a = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client_a);
+
+    /* Second client only gets a share of the pool */
+    client_config.memory_limit_in_bytes = GB_TO_BYTES(1);
+    struct aws_s3_client *client_b = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client_b);
+
+    /* Clients keep the pool alive */
+    aws_s3_buffer_pool_release(buffer_pool);
+
+    struct aws_s3_client_memory_usage usage_a = aws_s3_client_get_memory_usage(client_a);
+    struct aws_s3_client_memory_usage usage_b = aws_s3_client_get_memory_usage(client_b);
+    ASSERT_UINT_EQUALS(0, usage_a.limit);
+    ASSERT_UINT_EQUALS(GB_TO_BYTES(1), usage_b.limit);
+    ASSERT_UINT_EQUALS(usage_a.pool_memory_limit, usage_b.pool_memory_limit);
+    ASSERT_TRUE(usage_a.pool_memory_limit <= GB_TO_BYTES(4));
+    ASSERT_UINT_EQUALS(0, usage_a.reserved + usage_a.used + usage_b.reserved + usage_b.used);
+
+    client_a = aws_s3_client_release(client_a);
+    client_b = aws_s3_client_release(client_b);
+
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
 AWS_TEST_CASE(test_s3_client_monitoring_options_override, s_test_s3_client_monitoring_options_override)
 static int s_test_s3_client_monitoring_options_override(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
@@ -1244,6 +1301,743 @@ static int s_test_s3_get_object_less_than_part_size(struct aws_allocator *alloca
     return 0;
 }
 
+/* Destination for test_s3_get_object_receive_buffer, large enough for the whole object */
+static struct aws_byte_buf s_receive_buffer_destination;
+
+static int s_receive_buffer_into_destination(
+    struct aws_s3_meta_request *meta_request,
+    uint64_t range_start,
+    uint64_t range_size,
+    struct aws_byte_buf *out_buffer,
+    void *user_data) {
+    (void)meta_request;
+    (void)user_data;
+
+    if (range_start + range_size > s_receive_buffer_destination.capacity) {
+        return aws_raise_error(AWS_ERROR_SHORT_BUFFER);
+    }
+    *out_buffer =
+        aws_byte_buf_from_empty_array(s_receive_buffer_destination.buffer + range_start, (size_t)range_size);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(test_s3_get_object_receive_buffer, s_test_s3_get_object_receive_buffer)
+static int s_test_s3_get_object_receive_buffer(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct aws_s3_client_config client_config = {
+        .part_size = MB_TO_BYTES(1),
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client);
+
+    struct aws_string *host_name =
+        aws_s3_tester_build_endpoint_string(allocator, &g_test_bucket_name, &g_test_s3_region);
+    struct aws_http_message *message = aws_s3_test_get_object_request_new(
+        allocator, aws_byte_cursor_from_string(host_name), g_pre_existing_object_10MB);
+
+    ASSERT_SUCCESS(aws_byte_buf_init(&s_receive_buffer_destination, allocator, MB_TO_BYTES(10)));
+
+    struct aws_s3_meta_request_options options;
+    AWS_ZERO_STRUCT(options);
+    options.type = AWS_S3_META_REQUEST_TYPE_GET_OBJECT;
+    options.message = message;
+    options.receive_buffer_callback = s_receive_buffer_into_destination;
+
+    struct aws_s3_meta_request_test_results meta_request_test_results;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+
+    /* Everything arrived in the destination, nothing went through the body callback */
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), meta_request_test_results.progress.total_bytes_transferred);
+    ASSERT_UINT_EQUALS(0, meta_request_test_results.received_body_size);
+
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    /* Can't validate the checksum of the whole object without receiving it in order */
+    struct aws_s3_checksum_config checksum_config = {
+        .validate_response_checksum = true,
+    };
+    options.checksum_config = &checksum_config;
+    ASSERT_NULL(aws_s3_client_make_meta_request(client, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    aws_byte_buf_clean_up(&s_receive_buffer_destination);
+    aws_http_message_release(message);
+    aws_string_destroy(host_name);
+    aws_s3_client_release(client);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
+AWS_TEST_CASE(test_s3_get_object_recv_filepath, s_test_s3_get_object_recv_filepath)
+static int s_test_s3_get_object_recv_filepath(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct aws_s3_client_config client_config = {
+        .part_size = MB_TO_BYTES(1),
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client);
+
+    struct aws_string *host_name =
+        aws_s3_tester_build_endpoint_string(allocator, &g_test_bucket_name, &g_test_s3_region);
+    struct aws_http_message *message = aws_s3_test_get_object_request_new(
+        allocator, aws_byte_cursor_from_string(host_name), g_pre_existing_object_10MB);
+
+    const char *file_path = "s3_test_get_object_recv_filepath.txt"; /* unique name */
+
+    struct aws_s3_meta_request_options options;
+    AWS_ZERO_STRUCT(options);
+    options.type = AWS_S3_META_REQUEST_TYPE_GET_OBJECT;
+    options.message = message;
+    options.recv_filepath = aws_byte_cursor_from_c_str(file_path);
+    options.recv_file_preallocate = true;
+
+    struct aws_s3_meta_request_test_results meta_request_test_results;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+
+    /* Everything went to the file, nothing went through the body callback */
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), meta_request_test_results.progress.total_bytes_transferred);
+    ASSERT_UINT_EQUALS(0, meta_request_test_results.received_body_size);
+    /* Parts were written off the connections' threads */
+    ASSERT_NOT_NULL(client->file_io_elg);
+
+    struct aws_input_stream *file_stream = aws_input_stream_new_from_file(allocator, file_path);
+    ASSERT_NOT_NULL(file_stream);
+    int64_t file_length = 0;
+    ASSERT_SUCCESS(aws_input_stream_get_length(file_stream, &file_length));
+    ASSERT_INT_EQUALS(MB_TO_BYTES(10), file_length);
+    aws_input_stream_release(file_stream);
+
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    /* Can't validate the checksum of the whole object without receiving it in order */
+    struct aws_s3_checksum_config checksum_config = {
+        .validate_response_checksum = true,
+    };
+    options.checksum_config = &checksum_config;
+    ASSERT_NULL(aws_s3_client_make_meta_request(client, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    /* Only one destination for the body */
+    options.checksum_config = NULL;
+    options.receive_buffer_callback = s_receive_buffer_into_destination;
+    ASSERT_NULL(aws_s3_client_make_meta_request(client, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    remove(file_path);
+    aws_http_message_release(message);
+    aws_string_destroy(host_name);
+    aws_s3_client_release(client);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
+/* Checks the body parts of test_s3_get_object_out_of_order_body_callback, which don't arrive in order */
+struct out_of_order_body_test_data {
+    struct aws_byte_buf received;
+    uint64_t max_range_start_seen;
+    bool arrived_out_of_order;
+};
+
+static int s_out_of_order_body_callback(
+    struct aws_s3_meta_request *meta_request,
+    const struct aws_byte_cursor *body,
+    uint64_t range_start,
+    void *user_data) {
+    (void)meta_request;
+
+    struct aws_s3_meta_request_test_results *meta_request_test_results = user_data;
+    struct out_of_order_body_test_data *test_data = meta_request_test_results->tester->user_data;
+
+    if (range_start < test_data->max_range_start_seen) {
+        test_data->arrived_out_of_order = true;
+    }
+    test_data->max_range_start_seen = aws_max_u64(test_data->max_range_start_seen, range_start);
+
+    /* Never called concurrently, so no lock needed */
+    ASSERT_TRUE(range_start + body->len <= test_data->received.capacity);
+    memcpy(test_data->received.buffer + range_start, body->ptr, body->len);
+    test_data->received.len += body->len;
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(test_s3_get_object_out_of_order_body_callback, s_test_s3_get_object_out_of_order_body_callback)
+static int s_test_s3_get_object_out_of_order_body_callback(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct out_of_order_body_test_data test_data;
+    AWS_ZERO_STRUCT(test_data);
+    ASSERT_SUCCESS(aws_byte_buf_init(&test_data.received, allocator, MB_TO_BYTES(10)));
+    tester.user_data = &test_data;
+
+    struct aws_s3_client_config client_config = {
+        .part_size = MB_TO_BYTES(1),
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client);
+
+    struct aws_string *host_name =
+        aws_s3_tester_build_endpoint_string(allocator, &g_test_bucket_name, &g_test_s3_region);
+    struct aws_http_message *message = aws_s3_test_get_object_request_new(
+        allocator, aws_byte_cursor_from_string(host_name), g_pre_existing_object_10MB);
+
+    struct aws_s3_meta_request_options options;
+    AWS_ZERO_STRUCT(options);
+    options.type = AWS_S3_META_REQUEST_TYPE_GET_OBJECT;
+    options.message = message;
+    options.out_of_order_body_callback = true;
+
+    struct aws_s3_meta_request_test_results meta_request_test_results;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    meta_request_test_results.body_callback = s_out_of_order_body_callback;
+
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+
+    /* Every byte arrived exactly once. Whether any part actually overtook an earlier one depends on the network. */
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), meta_request_test_results.received_body_size);
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), test_data.received.len);
+    AWS_LOGF_INFO(
+        AWS_LS_S3_GENERAL, "Parts arrived %s", test_data.arrived_out_of_order ? "out of order" : "in order");
+
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    /* Can't validate the checksum of the whole object without receiving it in order */
+    struct aws_s3_checksum_config checksum_config = {
+        .validate_response_checksum = true,
+    };
+    options.checksum_config = &checksum_config;
+    ASSERT_NULL(aws_s3_client_make_meta_request(client, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    /* Only GET delivers the body in parts */
+    options.checksum_config = NULL;
+    options.type = AWS_S3_META_REQUEST_TYPE_DEFAULT;
+    ASSERT_NULL(aws_s3_client_make_meta_request(client, &options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    aws_byte_buf_clean_up(&test_data.received);
+    aws_http_message_release(message);
+    aws_string_destroy(host_name);
+    aws_s3_client_release(client);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
+/* Reads into dest from offset through the object reader, waiting for the read to complete */
+static int s_object_reader_read_and_wait(
+    struct aws_s3_object_reader *reader,
+    uint64_t offset,
+    struct aws_byte_buf *dest,
+    bool *out_end_of_object) {
+
+    struct aws_future_bool *future = aws_s3_object_reader_read(reader, offset, dest);
+    ASSERT_TRUE(aws_future_bool_wait(future, 60 * (uint64_t)AWS_TIMESTAMP_NANOS));
+    ASSERT_INT_EQUALS(AWS_ERROR_SUCCESS, aws_future_bool_get_error(future));
+    *out_end_of_object = aws_future_bool_get_result(future);
+    aws_future_bool_release(future);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(test_s3_object_reader, s_test_s3_object_reader)
+static int s_test_s3_object_reader(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct aws_s3_client_config client_config = {
+        .part_size = MB_TO_BYTES(1),
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client);
+
+    struct aws_string *host_name =
+        aws_s3_tester_build_endpoint_string(allocator, &g_test_bucket_name, &g_test_s3_region);
+    struct aws_http_message *message = aws_s3_test_get_object_request_new(
+        allocator, aws_byte_cursor_from_string(host_name), g_pre_existing_object_10MB);
+
+    const size_t object_size = MB_TO_BYTES(10);
+    struct aws_s3_object_reader_options reader_options = {
+        .message = message,
+        .initial_readahead_size = KB_TO_BYTES(256),
+        .max_readahead_size = MB_TO_BYTES(4),
+    };
+    struct aws_s3_object_reader *reader = aws_s3_object_reader_new(allocator, client, &reader_options);
+    ASSERT_NOT_NULL(reader);
+
+    /* Read the whole object sequentially, in small reads */
+    struct aws_byte_buf object;
+    ASSERT_SUCCESS(aws_byte_buf_init(&object, allocator, object_size + 1));
+    bool end_of_object = false;
+    while (!end_of_object) {
+        struct aws_byte_buf chunk;
+        ASSERT_SUCCESS(aws_byte_buf_init(&chunk, allocator, KB_TO_BYTES(100)));
+        ASSERT_SUCCESS(s_object_reader_read_and_wait(reader, object.len, &chunk, &end_of_object));
+        ASSERT_TRUE(end_of_object || chunk.len == chunk.capacity);
+        ASSERT_TRUE(aws_byte_buf_write_from_whole_buffer(&object, chunk));
+        aws_byte_buf_clean_up(&chunk);
+    }
+    ASSERT_UINT_EQUALS(object_size, object.len);
+
+    /* Random reads see the same bytes, whether they hit ranges that are still cached or not */
+    const uint64_t offsets[] = {MB_TO_BYTES(5) + 7, 0, object_size - 10, MB_TO_BYTES(1) - 1, MB_TO_BYTES(9) + 3};
+    for (size_t i = 0; i < AWS_ARRAY_SIZE(offsets); ++i) {
+        struct aws_byte_buf chunk;
+        ASSERT_SUCCESS(aws_byte_buf_init(&chunk, allocator, KB_TO_BYTES(64)));
+        ASSERT_SUCCESS(s_object_reader_read_and_wait(reader, offsets[i], &chunk, &end_of_object));
+
+        size_t expected_len = (size_t)aws_min_u64(chunk.capacity, object_size - offsets[i]);
+        ASSERT_UINT_EQUALS(expected_len, chunk.len);
+        ASSERT_BOOL_EQUALS(expected_len < chunk.capacity, end_of_object);
+        ASSERT_BIN_ARRAYS_EQUALS(object.buffer + offsets[i], expected_len, chunk.buffer, chunk.len);
+        aws_byte_buf_clean_up(&chunk);
+    }
+
+    /* Reading past the end finds nothing */
+    {
+        struct aws_byte_buf chunk;
+        ASSERT_SUCCESS(aws_byte_buf_init(&chunk, allocator, 16));
+        ASSERT_SUCCESS(s_object_reader_read_and_wait(reader, object_size + 100, &chunk, &end_of_object));
+        ASSERT_TRUE(end_of_object);
+        ASSERT_UINT_EQUALS(0, chunk.len);
+        aws_byte_buf_clean_up(&chunk);
+    }
+
+    aws_s3_object_reader_release(reader);
+
+    /* A fresh reader whose first read is past the end doesn't know where the object ends, and a read that covers
+     * the whole object is split into ranges no bigger than max_readahead_size */
+    reader = aws_s3_object_reader_new(allocator, client, &reader_options);
+    ASSERT_NOT_NULL(reader);
+    {
+        struct aws_byte_buf chunk;
+        ASSERT_SUCCESS(aws_byte_buf_init(&chunk, allocator, 16));
+        ASSERT_SUCCESS(s_object_reader_read_and_wait(reader, object_size + 100, &chunk, &end_of_object));
+        ASSERT_TRUE(end_of_object);
+        ASSERT_UINT_EQUALS(0, chunk.len);
+        aws_byte_buf_clean_up(&chunk);
+
+        ASSERT_SUCCESS(aws_byte_buf_init(&chunk, allocator, object_size + 1));
+        ASSERT_SUCCESS(s_object_reader_read_and_wait(reader, 0, &chunk, &end_of_object));
+        ASSERT_TRUE(end_of_object);
+        ASSERT_BIN_ARRAYS_EQUALS(object.buffer, object.len, chunk.buffer, chunk.len);
+        aws_byte_buf_clean_up(&chunk);
+    }
+    aws_s3_object_reader_release(reader);
+
+    /* Ranges are the reader's job */
+    struct aws_http_header range_header = {
+        .name = g_range_header_name,
+        .value = aws_byte_cursor_from_c_str("bytes=0-10"),
+    };
+    ASSERT_SUCCESS(aws_http_message_add_header(message, range_header));
+    ASSERT_NULL(aws_s3_object_reader_new(allocator, client, &reader_options));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    aws_byte_buf_clean_up(&object);
+    aws_http_message_release(message);
+    aws_string_destroy(host_name);
+    aws_s3_client_release(client);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
+AWS_TEST_CASE(test_s3_get_object_block_cache, s_test_s3_get_object_block_cache)
+static int s_test_s3_get_object_block_cache(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct aws_s3_block_cache_options cache_options = {
+        .memory_limit_in_bytes = MB_TO_BYTES(16),
+    };
+    struct aws_s3_block_cache *block_cache = aws_s3_block_cache_new(allocator, &cache_options);
+    ASSERT_NOT_NULL(block_cache);
+
+    struct aws_s3_client_config client_config = {
+        .part_size = MB_TO_BYTES(1),
+        .block_cache = block_cache,
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client);
+
+    struct aws_string *host_name =
+        aws_s3_tester_build_endpoint_string(allocator, &g_test_bucket_name, &g_test_s3_region);
+    struct aws_http_message *message = aws_s3_test_get_object_request_new(
+        allocator, aws_byte_cursor_from_string(host_name), g_pre_existing_object_10MB);
+
+    struct aws_s3_meta_request_options options;
+    AWS_ZERO_STRUCT(options);
+    options.type = AWS_S3_META_REQUEST_TYPE_GET_OBJECT;
+    options.message = message;
+
+    /* First download fills the cache. The part discovering the object size is never cached. */
+    struct aws_s3_meta_request_test_results meta_request_test_results;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), meta_request_test_results.received_body_size);
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    struct aws_s3_block_cache_stats stats = aws_s3_block_cache_get_stats(block_cache);
+    ASSERT_UINT_EQUALS(0, stats.hits);
+    ASSERT_UINT_EQUALS(9, stats.misses);
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(9), stats.memory_used);
+
+    /* Second download only sends the first part */
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), meta_request_test_results.received_body_size);
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    stats = aws_s3_block_cache_get_stats(block_cache);
+    ASSERT_UINT_EQUALS(9, stats.hits);
+    ASSERT_UINT_EQUALS(9, stats.misses);
+    ASSERT_UINT_EQUALS(0, stats.evictions);
+
+    /* Parts aren't served from the cache when validating checksums */
+    struct aws_s3_checksum_config checksum_config = {
+        .validate_response_checksum = true,
+    };
+    options.checksum_config = &checksum_config;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    stats = aws_s3_block_cache_get_stats(block_cache);
+    ASSERT_UINT_EQUALS(9, stats.hits);
+    ASSERT_UINT_EQUALS(9, stats.misses);
+
+    aws_http_message_release(message);
+    aws_string_destroy(host_name);
+    aws_s3_client_release(client);
+    aws_s3_block_cache_release(block_cache);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
+AWS_TEST_CASE(test_s3_get_object_metadata_cache, s_test_s3_get_object_metadata_cache)
+static int s_test_s3_get_object_metadata_cache(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct aws_s3_client_config client_config = {
+        .part_size = MB_TO_BYTES(1),
+        .object_metadata_cache_size = 8,
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client);
+    struct aws_s3_object_metadata_cache *cache = client->object_metadata_cache;
+    ASSERT_NOT_NULL(cache);
+
+    struct aws_string *host_name =
+        aws_s3_tester_build_endpoint_string(allocator, &g_test_bucket_name, &g_test_s3_region);
+    struct aws_http_message *message = aws_s3_test_get_object_request_new(
+        allocator, aws_byte_cursor_from_string(host_name), g_pre_existing_object_10MB);
+
+    struct aws_s3_meta_request_options options;
+    AWS_ZERO_STRUCT(options);
+    options.type = AWS_S3_META_REQUEST_TYPE_GET_OBJECT;
+    options.message = message;
+
+    /* First download fills the cache */
+    struct aws_s3_meta_request_test_results meta_request_test_results;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    uint64_t object_size = 0;
+    struct aws_string *etag = NULL;
+    ASSERT_TRUE(aws_s3_object_metadata_cache_get(cache, message, &object_size, &etag));
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), object_size);
+
+    /* Second download takes the size from the cache, and still reports the headers of the whole object */
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), meta_request_test_results.received_body_size);
+    ASSERT_INT_EQUALS(AWS_HTTP_STATUS_CODE_200_OK, meta_request_test_results.headers_response_status);
+    uint64_t content_length = 0;
+    ASSERT_SUCCESS(aws_s3_parse_content_length_response_header(
+        allocator, meta_request_test_results.response_headers, &content_length));
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), content_length);
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    /* A stale ETag fails the download, and drops the object from the cache */
+    aws_s3_object_metadata_cache_put(cache, message, object_size, aws_byte_cursor_from_c_str("\"stale\""));
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(&tester, client, &options, &meta_request_test_results, 0));
+    ASSERT_INT_EQUALS(AWS_ERROR_S3_OBJECT_MODIFIED, meta_request_test_results.finished_error_code);
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    struct aws_string *stale_etag = NULL;
+    ASSERT_FALSE(aws_s3_object_metadata_cache_get(cache, message, &object_size, &stale_etag));
+
+    /* Next download discovers the object again */
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    struct aws_string *new_etag = NULL;
+    ASSERT_TRUE(aws_s3_object_metadata_cache_get(cache, message, &object_size, &new_etag));
+    ASSERT_TRUE(aws_string_eq(etag, new_etag));
+
+    aws_string_destroy(etag);
+    aws_string_destroy(new_etag);
+    aws_http_message_release(message);
+    aws_string_destroy(host_name);
+    aws_s3_client_release(client);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
+static int s_get_object_speculative_parts(
+    struct aws_allocator *allocator,
+    struct aws_s3_tester *tester,
+    struct aws_s3_client *client,
+    struct aws_byte_cursor host_name,
+    struct aws_byte_cursor key,
+    const char *range,
+    uint64_t expected_size) {
+
+    struct aws_http_message *message = aws_s3_test_get_object_request_new(allocator, host_name, key);
+    if (range != NULL) {
+        aws_http_headers_set(
+            aws_http_message_get_headers(message), g_range_header_name, aws_byte_cursor_from_c_str(range));
+    }
+
+    struct aws_s3_meta_request_options options;
+    AWS_ZERO_STRUCT(options);
+    options.type = AWS_S3_META_REQUEST_TYPE_GET_OBJECT;
+    options.message = message;
+
+    struct aws_s3_meta_request_test_results meta_request_test_results;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+    ASSERT_UINT_EQUALS(expected_size, meta_request_test_results.received_body_size);
+
+    uint64_t content_length = 0;
+    ASSERT_SUCCESS(aws_s3_parse_content_length_response_header(
+        allocator, meta_request_test_results.response_headers, &content_length));
+    ASSERT_UINT_EQUALS(expected_size, content_length);
+
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+    aws_http_message_release(message);
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(test_s3_get_object_speculative_parts, s_test_s3_get_object_speculative_parts)
+static int s_test_s3_get_object_speculative_parts(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct aws_s3_client_config client_config = {
+        .part_size = MB_TO_BYTES(1),
+        .num_speculative_get_parts = 4,
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client);
+
+    struct aws_string *host_name =
+        aws_s3_tester_build_endpoint_string(allocator, &g_test_bucket_name, &g_test_s3_region);
+    struct aws_byte_cursor host_name_cursor = aws_byte_cursor_from_string(host_name);
+
+    /* Speculative parts are all within the object */
+    ASSERT_SUCCESS(s_get_object_speculative_parts(
+        allocator, &tester, client, host_name_cursor, g_pre_existing_object_10MB, NULL, MB_TO_BYTES(10)));
+
+    /* Speculative parts are all past the end of the object, and dropped */
+    ASSERT_SUCCESS(s_get_object_speculative_parts(
+        allocator, &tester, client, host_name_cursor, g_pre_existing_object_1MB, NULL, MB_TO_BYTES(1)));
+
+    /* Speculative parts stop at the end of the range, the last one is short */
+    ASSERT_SUCCESS(s_get_object_speculative_parts(
+        allocator,
+        &tester,
+        client,
+        host_name_cursor,
+        g_pre_existing_object_10MB,
+        "bytes=1048576-3670015",
+        MB_TO_BYTES(2) + MB_TO_BYTES(1) / 2));
+
+    aws_string_destroy(host_name);
+    aws_s3_client_release(client);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
+AWS_TEST_CASE(test_s3_get_object_hedged_parts, s_test_s3_get_object_hedged_parts)
+static int s_test_s3_get_object_hedged_parts(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    /* Percentile must be below 100 */
+    struct aws_s3_get_hedge_options hedge_options = {
+        .percentile = 100,
+    };
+    struct aws_s3_client_config client_config = {
+        .part_size = MB_TO_BYTES(1),
+        .get_hedge_options = &hedge_options,
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    ASSERT_NULL(aws_s3_client_new(allocator, &client_config));
+    ASSERT_INT_EQUALS(AWS_ERROR_INVALID_ARGUMENT, aws_last_error());
+
+    /* Hedge any part slower than the median, as many as there are parts */
+    hedge_options.percentile = 50;
+    hedge_options.budget_percent = 100;
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client);
+
+    struct aws_string *host_name =
+        aws_s3_tester_build_endpoint_string(allocator, &g_test_bucket_name, &g_test_s3_region);
+    struct aws_http_message *message = aws_s3_test_get_object_request_new(
+        allocator, aws_byte_cursor_from_string(host_name), g_pre_existing_object_10MB);
+
+    struct aws_s3_meta_request_options options;
+    AWS_ZERO_STRUCT(options);
+    options.type = AWS_S3_META_REQUEST_TYPE_GET_OBJECT;
+    options.message = message;
+
+    /* Whichever request of a part finishes first, the body is delivered once, in order */
+    struct aws_s3_meta_request_test_results meta_request_test_results;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), meta_request_test_results.received_body_size);
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    aws_http_message_release(message);
+    aws_string_destroy(host_name);
+    aws_s3_client_release(client);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
+AWS_TEST_CASE(test_s3_get_object_split_tail_parts, s_test_s3_get_object_split_tail_parts)
+static int s_test_s3_get_object_split_tail_parts(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    AWS_ZERO_STRUCT(tester);
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    /* The 2MB after the first part is less than a part for each connection, so it's split into 512KB parts */
+    struct aws_s3_client_config client_config = {
+        .part_size = MB_TO_BYTES(8),
+        .max_active_connections_override = 4,
+        .get_tail_min_part_size = KB_TO_BYTES(256),
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    ASSERT_NOT_NULL(client);
+
+    struct aws_string *host_name =
+        aws_s3_tester_build_endpoint_string(allocator, &g_test_bucket_name, &g_test_s3_region);
+    struct aws_http_message *message = aws_s3_test_get_object_request_new(
+        allocator, aws_byte_cursor_from_string(host_name), g_pre_existing_object_10MB);
+
+    struct aws_s3_meta_request_options options;
+    AWS_ZERO_STRUCT(options);
+    options.type = AWS_S3_META_REQUEST_TYPE_GET_OBJECT;
+    options.message = message;
+
+    struct aws_s3_meta_request_test_results meta_request_test_results;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_meta_request(
+        &tester, client, &options, &meta_request_test_results, AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS));
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(10), meta_request_test_results.received_body_size);
+    /* More requests than the 2 whole parts */
+    ASSERT_TRUE(aws_array_list_length(&meta_request_test_results.synced_data.metrics) > 2);
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    aws_http_message_release(message);
+    aws_string_destroy(host_name);
+    aws_s3_client_release(client);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
 AWS_TEST_CASE(test_s3_put_object_with_part_remainder, s_test_s3_put_object_with_part_remainder)
 static int s_test_s3_put_object_with_part_remainder(struct aws_allocator *allocator, void *ctx) {
     (void)ctx;
@@ -5122,9 +5916,12 @@ static int s_test_s3_put_fail_object_invalid_send_filepath(struct aws_allocator
         .message = message,
         .send_filepath = aws_byte_cursor_from_c_str("obviously_invalid_file_path"),
     };
+    /* File I/O threads are only started for the first meta request that sends a file */
+    ASSERT_NULL(client->file_io_elg);
     struct aws_s3_meta_request *meta_request = aws_s3_client_make_meta_request(client, &meta_request_options);
     ASSERT_NULL(meta_request);
     ASSERT_INT_EQUALS(AWS_ERROR_FILE_INVALID_PATH, aws_last_error());
+    ASSERT_NOT_NULL(client->file_io_elg);
 
     aws_http_message_release(message);
     aws_s3_client_release(client);
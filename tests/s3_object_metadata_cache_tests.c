@@ -0,0 +1,93 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include <aws/s3/private/s3_object_metadata_cache.h>
+#include <aws/s3/private/s3_util.h>
+
+#include <aws/common/string.h>
+#include <aws/http/request_response.h>
+#include <aws/testing/aws_test_harness.h>
+
+static struct aws_http_message *s_get_object_message_new(
+    struct aws_allocator *allocator,
+    const char *host,
+    const char *path) {
+
+    struct aws_http_message *message = aws_http_message_new_request(allocator);
+    aws_http_message_set_request_path(message, aws_byte_cursor_from_c_str(path));
+    struct aws_http_header host_header = {
+        .name = g_host_header_name,
+        .value = aws_byte_cursor_from_c_str(host),
+    };
+    aws_http_message_add_header(message, host_header);
+    return message;
+}
+
+/* Check the cache has the object the message gets, with the given size and ETag */
+static int s_check_cached(
+    struct aws_s3_object_metadata_cache *cache,
+    struct aws_http_message *message,
+    uint64_t expected_size,
+    const char *expected_etag) {
+
+    uint64_t object_size = 0;
+    struct aws_string *etag = NULL;
+    ASSERT_TRUE(aws_s3_object_metadata_cache_get(cache, message, &object_size, &etag));
+    ASSERT_UINT_EQUALS(expected_size, object_size);
+    ASSERT_TRUE(aws_string_eq_c_str(etag, expected_etag));
+    aws_string_destroy(etag);
+    return AWS_OP_SUCCESS;
+}
+
+static bool s_is_cached(struct aws_s3_object_metadata_cache *cache, struct aws_http_message *message) {
+    uint64_t object_size = 0;
+    struct aws_string *etag = NULL;
+    bool hit = aws_s3_object_metadata_cache_get(cache, message, &object_size, &etag);
+    aws_string_destroy(etag);
+    return hit;
+}
+
+AWS_TEST_CASE(test_s3_object_metadata_cache, s_test_s3_object_metadata_cache)
+static int s_test_s3_object_metadata_cache(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_object_metadata_cache *cache = aws_s3_object_metadata_cache_new(allocator, 2);
+    struct aws_http_message *a = s_get_object_message_new(allocator, "bucket.s3.amazonaws.com", "/a");
+    struct aws_http_message *b = s_get_object_message_new(allocator, "bucket.s3.amazonaws.com", "/b");
+    struct aws_http_message *c = s_get_object_message_new(allocator, "bucket.s3.amazonaws.com", "/c");
+    struct aws_http_message *other_bucket_a = s_get_object_message_new(allocator, "other.s3.amazonaws.com", "/a");
+
+    ASSERT_FALSE(s_is_cached(cache, a));
+    aws_s3_object_metadata_cache_put(cache, a, 100, aws_byte_cursor_from_c_str("\"etag-a\""));
+    ASSERT_SUCCESS(s_check_cached(cache, a, 100, "\"etag-a\""));
+    ASSERT_FALSE(s_is_cached(cache, other_bucket_a));
+
+    /* Putting again replaces the entry */
+    aws_s3_object_metadata_cache_put(cache, a, 200, aws_byte_cursor_from_c_str("\"etag-a2\""));
+    ASSERT_SUCCESS(s_check_cached(cache, a, 200, "\"etag-a2\""));
+
+    /* Full, so putting c drops b, the least recently used */
+    aws_s3_object_metadata_cache_put(cache, b, 300, aws_byte_cursor_from_c_str("\"etag-b\""));
+    ASSERT_SUCCESS(s_check_cached(cache, a, 200, "\"etag-a2\""));
+    aws_s3_object_metadata_cache_put(cache, c, 400, aws_byte_cursor_from_c_str("\"etag-c\""));
+    ASSERT_FALSE(s_is_cached(cache, b));
+    ASSERT_SUCCESS(s_check_cached(cache, a, 200, "\"etag-a2\""));
+    ASSERT_SUCCESS(s_check_cached(cache, c, 400, "\"etag-c\""));
+
+    /* Remove only drops the entry if it still has the stale ETag */
+    aws_s3_object_metadata_cache_remove(cache, a, aws_byte_cursor_from_c_str("\"etag-a\""));
+    ASSERT_TRUE(s_is_cached(cache, a));
+    aws_s3_object_metadata_cache_remove(cache, a, aws_byte_cursor_from_c_str("\"etag-a2\""));
+    ASSERT_FALSE(s_is_cached(cache, a));
+    ASSERT_TRUE(s_is_cached(cache, c));
+
+    aws_http_message_release(a);
+    aws_http_message_release(b);
+    aws_http_message_release(c);
+    aws_http_message_release(other_bucket_a);
+    aws_s3_object_metadata_cache_destroy(cache);
+
+    return 0;
+}
@@ -165,7 +165,7 @@ TEST_CASE(parallel_read_stream_from_file_sanity_test) {
     struct aws_byte_cursor path_cursor = aws_byte_cursor_from_c_str(file_path);
 
     struct aws_parallel_input_stream *parallel_read_stream =
-        aws_parallel_input_stream_new_from_file(allocator, path_cursor);
+        aws_parallel_input_stream_new_from_file(allocator, path_cursor, NULL);
     ASSERT_NOT_NULL(parallel_read_stream);
 
     aws_parallel_input_stream_acquire(parallel_read_stream);
@@ -249,7 +249,7 @@ TEST_CASE(parallel_read_stream_from_large_file_test) {
     struct aws_byte_cursor path_cursor = aws_byte_cursor_from_c_str(file_path);
 
     struct aws_parallel_input_stream *parallel_read_stream =
-        aws_parallel_input_stream_new_from_file(allocator, path_cursor);
+        aws_parallel_input_stream_new_from_file(allocator, path_cursor, NULL);
     ASSERT_NOT_NULL(parallel_read_stream);
 
     {
@@ -315,3 +315,267 @@ TEST_CASE(parallel_read_stream_from_large_file_test) {
 
     return AWS_OP_SUCCESS;
 }
+
+TEST_CASE(parallel_read_stream_from_file_on_reading_elg_test) {
+    (void)ctx;
+    struct aws_s3_tester tester;
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+    size_t file_length = MB_TO_BYTES(10);
+
+    const char *file_path = "s3_test_parallel_input_stream_read_elg.txt"; /* unique name */
+    ASSERT_SUCCESS(s_create_read_file(file_path, file_length));
+    struct aws_event_loop_group *el_group = aws_event_loop_group_new_default(allocator, 0, NULL);
+    struct aws_byte_cursor path_cursor = aws_byte_cursor_from_c_str(file_path);
+
+    /* The stream keeps the reading ELG alive */
+    struct aws_event_loop_group *reading_elg = aws_event_loop_group_new_default(allocator, 2, NULL);
+    struct aws_parallel_input_stream *parallel_read_stream =
+        aws_parallel_input_stream_new_from_file(allocator, path_cursor, reading_elg);
+    ASSERT_NOT_NULL(parallel_read_stream);
+    aws_event_loop_group_release(reading_elg);
+
+    {
+        /* The whole file */
+        struct aws_byte_buf read_buf;
+        aws_byte_buf_init(&read_buf, allocator, file_length);
+        struct aws_byte_buf expected_read_buf;
+        aws_byte_buf_init(&expected_read_buf, allocator, file_length);
+        bool eos_reached = false;
+
+        ASSERT_SUCCESS(s_parallel_read_test_helper(
+            allocator, parallel_read_stream, &read_buf, el_group, 0, file_length, 8, &eos_reached));
+
+        ASSERT_FALSE(eos_reached);
+        struct aws_input_stream *stream = aws_input_stream_new_from_file(allocator, file_path);
+        ASSERT_SUCCESS(aws_input_stream_read(stream, &expected_read_buf));
+
+        ASSERT_TRUE(aws_byte_buf_eq(&expected_read_buf, &read_buf));
+        aws_byte_buf_clean_up(&read_buf);
+        aws_byte_buf_clean_up(&expected_read_buf);
+        aws_input_stream_release(stream);
+    }
+
+    {
+        /* Past the end of the file, the future completes from the reading ELG with EOS */
+        struct aws_byte_buf read_buf;
+        aws_byte_buf_init(&read_buf, allocator, s_parallel_stream_test->len);
+        struct aws_future_bool *read_future =
+            aws_parallel_input_stream_read(parallel_read_stream, 2 * file_length, &read_buf);
+        ASSERT_TRUE(aws_future_bool_wait(read_future, MAX_TIMEOUT_NS));
+        ASSERT_UINT_EQUALS(AWS_ERROR_SUCCESS, aws_future_bool_get_error(read_future));
+        ASSERT_TRUE(aws_future_bool_get_result(read_future));
+        ASSERT_UINT_EQUALS(0, read_buf.len);
+        aws_byte_buf_clean_up(&read_buf);
+        aws_future_bool_release(read_future);
+    }
+
+    remove(file_path);
+    aws_event_loop_group_release(el_group);
+    aws_parallel_input_stream_release(parallel_read_stream);
+    aws_s3_tester_clean_up(&tester);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(parallel_read_stream_from_file_io_uring_test) {
+    (void)ctx;
+    struct aws_s3_tester tester;
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+    size_t file_length = MB_TO_BYTES(10);
+
+    const char *file_path = "s3_test_parallel_input_stream_read_io_uring.txt"; /* unique name */
+    ASSERT_SUCCESS(s_create_read_file(file_path, file_length));
+    struct aws_byte_cursor path_cursor = aws_byte_cursor_from_c_str(file_path);
+
+    struct aws_s3_io_uring *ring = aws_s3_io_uring_new(allocator);
+    if (ring == NULL && aws_last_error() == AWS_ERROR_PLATFORM_NOT_SUPPORTED) {
+        remove(file_path);
+        aws_s3_tester_clean_up(&tester);
+        return AWS_OP_SKIP;
+    }
+    ASSERT_NOT_NULL(ring);
+
+    /* Two streams on the same ring. They hold it, so it can be released right away. */
+    struct aws_parallel_input_stream *parallel_read_stream =
+        aws_parallel_input_stream_new_from_file_io_uring(allocator, path_cursor, ring);
+    ASSERT_NOT_NULL(parallel_read_stream);
+    struct aws_parallel_input_stream *other_parallel_read_stream =
+        aws_parallel_input_stream_new_from_file_io_uring(allocator, path_cursor, ring);
+    ASSERT_NOT_NULL(other_parallel_read_stream);
+    aws_s3_io_uring_release(ring);
+
+    struct aws_event_loop_group *el_group = aws_event_loop_group_new_default(allocator, 0, NULL);
+
+    {
+        /* The whole file, with more reads in flight than one at a time */
+        struct aws_byte_buf read_buf;
+        aws_byte_buf_init(&read_buf, allocator, file_length);
+        struct aws_byte_buf expected_read_buf;
+        aws_byte_buf_init(&expected_read_buf, allocator, file_length);
+        bool eos_reached = false;
+
+        ASSERT_SUCCESS(s_parallel_read_test_helper(
+            allocator, parallel_read_stream, &read_buf, el_group, 0, file_length, 8, &eos_reached));
+
+        ASSERT_FALSE(eos_reached);
+        struct aws_input_stream *stream = aws_input_stream_new_from_file(allocator, file_path);
+        ASSERT_SUCCESS(aws_input_stream_read(stream, &expected_read_buf));
+
+        ASSERT_TRUE(aws_byte_buf_eq(&expected_read_buf, &read_buf));
+
+        /* The same through the other stream on the ring */
+        aws_byte_buf_reset(&read_buf, true /*zero_contents*/);
+        ASSERT_SUCCESS(s_parallel_read_test_helper(
+            allocator, other_parallel_read_stream, &read_buf, el_group, 0, file_length, 8, &eos_reached));
+        ASSERT_FALSE(eos_reached);
+        ASSERT_TRUE(aws_byte_buf_eq(&expected_read_buf, &read_buf));
+
+        aws_byte_buf_clean_up(&read_buf);
+        aws_byte_buf_clean_up(&expected_read_buf);
+        aws_input_stream_release(stream);
+    }
+
+    {
+        /* Past the end of the file */
+        struct aws_byte_buf read_buf;
+        aws_byte_buf_init(&read_buf, allocator, s_parallel_stream_test->len);
+        struct aws_future_bool *read_future =
+            aws_parallel_input_stream_read(parallel_read_stream, 2 * file_length, &read_buf);
+        ASSERT_TRUE(aws_future_bool_wait(read_future, MAX_TIMEOUT_NS));
+        ASSERT_UINT_EQUALS(AWS_ERROR_SUCCESS, aws_future_bool_get_error(read_future));
+        ASSERT_TRUE(aws_future_bool_get_result(read_future));
+        ASSERT_UINT_EQUALS(0, read_buf.len);
+        aws_byte_buf_clean_up(&read_buf);
+        aws_future_bool_release(read_future);
+    }
+
+    remove(file_path);
+    aws_event_loop_group_release(el_group);
+    aws_parallel_input_stream_release(parallel_read_stream);
+    aws_parallel_input_stream_release(other_parallel_read_stream);
+    aws_s3_tester_clean_up(&tester);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(parallel_read_stream_from_file_mmap_test) {
+    (void)ctx;
+    struct aws_s3_tester tester;
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+    size_t file_length = MB_TO_BYTES(10);
+
+    const char *file_path = "s3_test_parallel_input_stream_read_mmap.txt"; /* unique name */
+    ASSERT_SUCCESS(s_create_read_file(file_path, file_length));
+    struct aws_byte_cursor path_cursor = aws_byte_cursor_from_c_str(file_path);
+
+    struct aws_parallel_input_stream *parallel_read_stream =
+        aws_parallel_input_stream_new_from_file_mmap(allocator, path_cursor);
+    if (parallel_read_stream == NULL && aws_last_error() == AWS_ERROR_PLATFORM_NOT_SUPPORTED) {
+        remove(file_path);
+        aws_s3_tester_clean_up(&tester);
+        return AWS_OP_SKIP;
+    }
+    ASSERT_NOT_NULL(parallel_read_stream);
+    ASSERT_TRUE(aws_parallel_input_stream_is_mapped(parallel_read_stream));
+    struct aws_event_loop_group *el_group = aws_event_loop_group_new_default(allocator, 0, NULL);
+
+    struct aws_byte_buf expected_read_buf;
+    aws_byte_buf_init(&expected_read_buf, allocator, file_length);
+    struct aws_input_stream *stream = aws_input_stream_new_from_file(allocator, file_path);
+    ASSERT_SUCCESS(aws_input_stream_read(stream, &expected_read_buf));
+    aws_input_stream_release(stream);
+
+    {
+        /* Reads copy out of the mapping */
+        struct aws_byte_buf read_buf;
+        aws_byte_buf_init(&read_buf, allocator, file_length);
+        bool eos_reached = false;
+
+        ASSERT_SUCCESS(s_parallel_read_test_helper(
+            allocator, parallel_read_stream, &read_buf, el_group, 0, file_length, 8, &eos_reached));
+
+        ASSERT_FALSE(eos_reached);
+        ASSERT_TRUE(aws_byte_buf_eq(&expected_read_buf, &read_buf));
+        aws_byte_buf_clean_up(&read_buf);
+    }
+
+    {
+        /* Ranges point into the mapping, and stop at the end of the file */
+        struct aws_byte_cursor range;
+        ASSERT_SUCCESS(aws_parallel_input_stream_get_mapped_range(
+            parallel_read_stream, s_parallel_stream_test->len, s_parallel_stream_test->len, &range));
+        ASSERT_TRUE(aws_string_eq_byte_cursor(s_parallel_stream_test, &range));
+
+        ASSERT_SUCCESS(
+            aws_parallel_input_stream_get_mapped_range(parallel_read_stream, file_length - 10, 100, &range));
+        ASSERT_UINT_EQUALS(10, range.len);
+        ASSERT_BIN_ARRAYS_EQUALS(expected_read_buf.buffer + file_length - 10, 10, range.ptr, range.len);
+
+        ASSERT_SUCCESS(
+            aws_parallel_input_stream_get_mapped_range(parallel_read_stream, 2 * file_length, 100, &range));
+        ASSERT_UINT_EQUALS(0, range.len);
+    }
+
+    {
+        /* Past the end of the file */
+        struct aws_byte_buf read_buf;
+        aws_byte_buf_init(&read_buf, allocator, s_parallel_stream_test->len);
+        struct aws_future_bool *read_future =
+            aws_parallel_input_stream_read(parallel_read_stream, 2 * file_length, &read_buf);
+        ASSERT_TRUE(aws_future_bool_wait(read_future, MAX_TIMEOUT_NS));
+        ASSERT_UINT_EQUALS(AWS_ERROR_SUCCESS, aws_future_bool_get_error(read_future));
+        ASSERT_TRUE(aws_future_bool_get_result(read_future));
+        ASSERT_UINT_EQUALS(0, read_buf.len);
+        aws_byte_buf_clean_up(&read_buf);
+        aws_future_bool_release(read_future);
+    }
+
+    aws_byte_buf_clean_up(&expected_read_buf);
+    remove(file_path);
+    aws_event_loop_group_release(el_group);
+    aws_parallel_input_stream_release(parallel_read_stream);
+    aws_s3_tester_clean_up(&tester);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(parallel_read_stream_from_buffer_test) {
+    (void)ctx;
+    struct aws_s3_tester tester;
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct aws_byte_cursor memory = aws_byte_cursor_from_string(s_parallel_stream_test);
+    struct aws_parallel_input_stream *parallel_read_stream =
+        aws_parallel_input_stream_new_from_buffer(allocator, memory);
+    ASSERT_NOT_NULL(parallel_read_stream);
+    ASSERT_TRUE(aws_parallel_input_stream_is_mapped(parallel_read_stream));
+
+    {
+        /* Ranges point into the caller's memory, without a copy */
+        struct aws_byte_cursor range;
+        ASSERT_SUCCESS(aws_parallel_input_stream_get_mapped_range(parallel_read_stream, 5, 10, &range));
+        ASSERT_PTR_EQUALS(memory.ptr + 5, range.ptr);
+        ASSERT_UINT_EQUALS(10, range.len);
+
+        ASSERT_SUCCESS(aws_parallel_input_stream_get_mapped_range(parallel_read_stream, 5, memory.len, &range));
+        ASSERT_UINT_EQUALS(memory.len - 5, range.len);
+    }
+
+    {
+        /* Reads copy out of it, and report EOS once past the end */
+        struct aws_byte_buf read_buf;
+        aws_byte_buf_init(&read_buf, allocator, memory.len + 1);
+        struct aws_future_bool *read_future = aws_parallel_input_stream_read(parallel_read_stream, 0, &read_buf);
+        ASSERT_TRUE(aws_future_bool_is_done(read_future));
+        ASSERT_UINT_EQUALS(AWS_ERROR_SUCCESS, aws_future_bool_get_error(read_future));
+        ASSERT_TRUE(aws_future_bool_get_result(read_future));
+        ASSERT_TRUE(aws_string_eq_byte_buf(s_parallel_stream_test, &read_buf));
+        aws_byte_buf_clean_up(&read_buf);
+        aws_future_bool_release(read_future);
+    }
+
+    aws_parallel_input_stream_release(parallel_read_stream);
+    aws_s3_tester_clean_up(&tester);
+
+    return AWS_OP_SUCCESS;
+}
@@ -0,0 +1,209 @@
+/**
+ * Copyright Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * SPDX-License-Identifier: Apache-2.0.
+ */
+
+#include "aws/s3/private/s3_buffer_pool.h"
+#include "aws/s3/private/s3_parallel_input_stream.h"
+#include "aws/s3/private/s3_parallel_output_stream.h"
+#include "s3_tester.h"
+#include <aws/common/condition_variable.h>
+#include <aws/common/math.h>
+#include <aws/common/mutex.h>
+#include <aws/io/event_loop.h>
+#include <aws/io/future.h>
+#include <aws/io/stream.h>
+#include <aws/testing/aws_test_harness.h>
+
+#define TEST_CASE(NAME)                                                                                                \
+    AWS_TEST_CASE(NAME, s_test_##NAME);                                                                                \
+    static int s_test_##NAME(struct aws_allocator *allocator, void *ctx)
+
+struct parallel_write_test_state {
+    struct aws_mutex lock;
+    struct aws_condition_variable cvar;
+    size_t num_remaining;
+    size_t num_failed;
+};
+
+struct parallel_write_test_args {
+    struct aws_allocator *alloc;
+    struct aws_task task;
+    struct aws_parallel_output_stream *stream;
+    uint64_t offset;
+    struct aws_byte_cursor data;
+    struct parallel_write_test_state *state;
+};
+
+static void s_parallel_write_test_task(struct aws_task *task, void *arg, enum aws_task_status task_status) {
+    (void)task;
+    (void)task_status;
+    struct parallel_write_test_args *args = arg;
+    struct parallel_write_test_state *state = args->state;
+
+    bool failed = aws_parallel_output_stream_write(args->stream, args->offset, args->data) != AWS_OP_SUCCESS;
+    aws_mem_release(args->alloc, args);
+
+    aws_mutex_lock(&state->lock);
+    --state->num_remaining;
+    if (failed) {
+        ++state->num_failed;
+    }
+    aws_mutex_unlock(&state->lock);
+    aws_condition_variable_notify_all(&state->cvar);
+}
+
+static bool s_parallel_write_test_done(void *arg) {
+    struct parallel_write_test_state *state = arg;
+    return state->num_remaining == 0;
+}
+
+static int s_read_whole_file(struct aws_allocator *allocator, const char *file_path, struct aws_byte_buf *out_buf) {
+    struct aws_input_stream *stream = aws_input_stream_new_from_file(allocator, file_path);
+    ASSERT_NOT_NULL(stream);
+    int64_t length = 0;
+    ASSERT_SUCCESS(aws_input_stream_get_length(stream, &length));
+    ASSERT_SUCCESS(aws_byte_buf_init(out_buf, allocator, (size_t)length));
+    while (out_buf->len < out_buf->capacity) {
+        ASSERT_SUCCESS(aws_input_stream_read(stream, out_buf));
+    }
+    aws_input_stream_release(stream);
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(parallel_write_stream_to_file_test) {
+    (void)ctx;
+    struct aws_s3_tester tester;
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    const size_t part_size = 64 * 1024;
+    const size_t num_parts = 16;
+    const size_t file_length = part_size * num_parts - 100; /* last part is short */
+
+    struct aws_byte_buf expected;
+    ASSERT_SUCCESS(aws_byte_buf_init(&expected, allocator, file_length));
+    for (size_t i = 0; i < file_length; ++i) {
+        aws_byte_buf_write_u8(&expected, (uint8_t)(i * 31 + i / part_size));
+    }
+
+    const char *file_path = "s3_test_parallel_output_stream_write.txt"; /* unique name */
+    struct aws_parallel_output_stream *stream =
+        aws_parallel_output_stream_new_from_file(allocator, aws_byte_cursor_from_c_str(file_path));
+    ASSERT_NOT_NULL(stream);
+    ASSERT_SUCCESS(aws_parallel_output_stream_preallocate(stream, file_length));
+
+    struct parallel_write_test_state state = {
+        .lock = AWS_MUTEX_INIT,
+        .cvar = AWS_CONDITION_VARIABLE_INIT,
+        .num_remaining = num_parts,
+    };
+    struct aws_event_loop_group *el_group = aws_event_loop_group_new_default(allocator, 0, NULL);
+
+    /* Write the parts from different threads, last part first */
+    for (size_t i = num_parts; i > 0; --i) {
+        struct parallel_write_test_args *args = aws_mem_calloc(allocator, 1, sizeof(struct parallel_write_test_args));
+        args->alloc = allocator;
+        args->stream = stream;
+        args->offset = (i - 1) * part_size;
+        args->data = aws_byte_cursor_from_buf(&expected);
+        aws_byte_cursor_advance(&args->data, (size_t)args->offset);
+        args->data.len = aws_min_size(args->data.len, part_size);
+        args->state = &state;
+
+        aws_task_init(&args->task, s_parallel_write_test_task, args, "s3_parallel_write_test_task");
+        aws_event_loop_schedule_task_now(aws_event_loop_group_get_next_loop(el_group), &args->task);
+    }
+
+    aws_mutex_lock(&state.lock);
+    ASSERT_SUCCESS(aws_condition_variable_wait_pred(&state.cvar, &state.lock, s_parallel_write_test_done, &state));
+    aws_mutex_unlock(&state.lock);
+    ASSERT_UINT_EQUALS(0, state.num_failed);
+
+    /* Empty writes are fine anywhere */
+    ASSERT_SUCCESS(aws_parallel_output_stream_write(stream, file_length * 2, aws_byte_cursor_from_c_str("")));
+
+    aws_parallel_output_stream_release(stream);
+
+    struct aws_byte_buf actual;
+    ASSERT_SUCCESS(s_read_whole_file(allocator, file_path, &actual));
+    ASSERT_TRUE(aws_byte_buf_eq(&expected, &actual));
+    aws_byte_buf_clean_up(&actual);
+
+    /* Opening again truncates the file */
+    stream = aws_parallel_output_stream_new_from_file(allocator, aws_byte_cursor_from_c_str(file_path));
+    ASSERT_NOT_NULL(stream);
+    ASSERT_SUCCESS(aws_parallel_output_stream_write(stream, 4, aws_byte_cursor_from_c_str("data")));
+    aws_parallel_output_stream_release(stream);
+
+    ASSERT_SUCCESS(s_read_whole_file(allocator, file_path, &actual));
+    ASSERT_UINT_EQUALS(8, actual.len);
+    ASSERT_BIN_ARRAYS_EQUALS("\0\0\0\0data", 8, actual.buffer, actual.len);
+    aws_byte_buf_clean_up(&actual);
+
+    /* Can't create a file in a directory that doesn't exist */
+    ASSERT_NULL(aws_parallel_output_stream_new_from_file(
+        allocator, aws_byte_cursor_from_c_str("s3_test_no_such_directory/s3_test_parallel_output_stream.txt")));
+    ASSERT_TRUE(aws_last_error() != AWS_ERROR_SUCCESS);
+
+    remove(file_path);
+    aws_byte_buf_clean_up(&expected);
+    aws_event_loop_group_release(el_group);
+    aws_s3_tester_clean_up(&tester);
+
+    return AWS_OP_SUCCESS;
+}
+
+TEST_CASE(parallel_write_and_read_file_direct_test) {
+    (void)ctx;
+    struct aws_s3_tester tester;
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    const size_t alignment = AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT;
+    const size_t file_length = alignment * 16 + 100; /* unaligned tail */
+
+    /* Aligned memory, as buffers from the buffer pool are */
+    struct aws_byte_buf storage;
+    ASSERT_SUCCESS(aws_byte_buf_init(&storage, allocator, 2 * file_length + 4 * alignment));
+    uint8_t *expected = (uint8_t *)(((uintptr_t)storage.buffer + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    uint8_t *actual = expected + file_length + alignment - file_length % alignment;
+    for (size_t i = 0; i < file_length; ++i) {
+        expected[i] = (uint8_t)(i * 31 + i / alignment);
+    }
+
+    const char *file_path = "s3_test_parallel_output_stream_write_direct.txt"; /* unique name */
+    struct aws_parallel_output_stream *out_stream =
+        aws_parallel_output_stream_new_from_file_direct(allocator, aws_byte_cursor_from_c_str(file_path));
+    ASSERT_NOT_NULL(out_stream);
+
+    /* An unaligned head, then a write misaligned in memory and file alike, then the rest with an unaligned tail */
+    const size_t head = 10;
+    const size_t middle = alignment * 8;
+    ASSERT_SUCCESS(aws_parallel_output_stream_write(out_stream, 0, aws_byte_cursor_from_array(expected, head)));
+    ASSERT_SUCCESS(
+        aws_parallel_output_stream_write(out_stream, head, aws_byte_cursor_from_array(expected + head, middle)));
+    ASSERT_SUCCESS(aws_parallel_output_stream_write(
+        out_stream,
+        head + middle,
+        aws_byte_cursor_from_array(expected + head + middle, file_length - head - middle)));
+    aws_parallel_output_stream_release(out_stream);
+
+    struct aws_parallel_input_stream *in_stream =
+        aws_parallel_input_stream_new_from_file_direct(allocator, aws_byte_cursor_from_c_str(file_path), NULL);
+    ASSERT_NOT_NULL(in_stream);
+
+    /* Whole file, then past its end */
+    struct aws_byte_buf read_buf = aws_byte_buf_from_empty_array(actual, file_length + alignment);
+    struct aws_future_bool *read_future = aws_parallel_input_stream_read(in_stream, 0, &read_buf);
+    ASSERT_TRUE(aws_future_bool_is_done(read_future));
+    ASSERT_UINT_EQUALS(AWS_ERROR_SUCCESS, aws_future_bool_get_error(read_future));
+    ASSERT_TRUE(aws_future_bool_get_result(read_future));
+    ASSERT_BIN_ARRAYS_EQUALS(expected, file_length, read_buf.buffer, read_buf.len);
+    aws_future_bool_release(read_future);
+    aws_parallel_input_stream_release(in_stream);
+
+    remove(file_path);
+    aws_byte_buf_clean_up(&storage);
+    aws_s3_tester_clean_up(&tester);
+
+    return AWS_OP_SUCCESS;
+}
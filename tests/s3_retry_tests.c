@@ -416,6 +416,88 @@ static int s_test_s3_meta_request_send_request_finish_fail(struct aws_allocator
     return 0;
 }
 
+static void s_s3_meta_request_send_request_finish_drop_first_part(
+    struct aws_s3_connection *connection,
+    struct aws_http_stream *stream,
+    int error_code) {
+
+    struct aws_s3_request *request = connection->request;
+    struct aws_s3_tester *tester = request->meta_request->client->shutdown_callback_user_data;
+    AWS_ASSERT(tester != NULL);
+
+    /* Act as if the connection dropped halfway through the body of the first part that can resume */
+    uint64_t part_range_size = request->part_range_end - request->part_range_start + 1;
+    if (error_code == AWS_ERROR_SUCCESS && request->has_resumable_response_body && !request->resumes_response_body &&
+        request->send_data.response_body.len == part_range_size && part_range_size > 1 &&
+        aws_s3_tester_inc_counter1(tester) == 1) {
+
+        request->send_data.response_body.len /= 2;
+        error_code = AWS_ERROR_HTTP_CONNECTION_CLOSED;
+    }
+
+    struct aws_s3_meta_request_vtable *original_meta_request_vtable =
+        aws_s3_tester_get_meta_request_vtable_patch(tester, 0)->original_vtable;
+
+    original_meta_request_vtable->send_request_finish(connection, stream, error_code);
+}
+
+static struct aws_s3_meta_request *s_meta_request_factory_patch_drop_first_part(
+    struct aws_s3_client *client,
+    const struct aws_s3_meta_request_options *options) {
+
+    struct aws_s3_tester *tester = client->shutdown_callback_user_data;
+    AWS_ASSERT(tester != NULL);
+
+    struct aws_s3_client_vtable *original_client_vtable =
+        aws_s3_tester_get_client_vtable_patch(tester, 0)->original_vtable;
+
+    struct aws_s3_meta_request *meta_request = original_client_vtable->meta_request_factory(client, options);
+
+    struct aws_s3_meta_request_vtable *patched_meta_request_vtable =
+        aws_s3_tester_patch_meta_request_vtable(tester, meta_request, NULL);
+    patched_meta_request_vtable->send_request_finish = s_s3_meta_request_send_request_finish_drop_first_part;
+
+    return meta_request;
+}
+
+/* Test that a part whose connection drops partway through its body is resumed from the bytes it got. */
+AWS_TEST_CASE(test_s3_get_object_resume_failed_part, s_test_s3_get_object_resume_failed_part)
+static int s_test_s3_get_object_resume_failed_part(struct aws_allocator *allocator, void *ctx) {
+    (void)ctx;
+
+    struct aws_s3_tester tester;
+    ASSERT_SUCCESS(aws_s3_tester_init(allocator, &tester));
+
+    struct aws_s3_client_config client_config = {
+        .part_size = 64 * 1024,
+    };
+
+    ASSERT_SUCCESS(aws_s3_tester_bind_client(
+        &tester, &client_config, AWS_S3_TESTER_BIND_CLIENT_REGION | AWS_S3_TESTER_BIND_CLIENT_SIGNING));
+
+    struct aws_s3_client *client = aws_s3_client_new(allocator, &client_config);
+    struct aws_s3_client_vtable *patched_client_vtable = aws_s3_tester_patch_client_vtable(&tester, client, NULL);
+    patched_client_vtable->meta_request_factory = s_meta_request_factory_patch_drop_first_part;
+
+    /* If the retry asked for the whole part again, it wouldn't fit in the part's buffer after the kept bytes */
+    struct aws_s3_meta_request_test_results meta_request_test_results;
+    aws_s3_meta_request_test_results_init(&meta_request_test_results, allocator);
+    ASSERT_SUCCESS(aws_s3_tester_send_get_object_meta_request(
+        &tester,
+        client,
+        g_pre_existing_object_1MB,
+        AWS_S3_TESTER_SEND_META_REQUEST_EXPECT_SUCCESS,
+        &meta_request_test_results));
+    ASSERT_TRUE(tester.synced_data.counter1 > 0);
+    ASSERT_UINT_EQUALS(MB_TO_BYTES(1), meta_request_test_results.received_body_size);
+    aws_s3_meta_request_test_results_clean_up(&meta_request_test_results);
+
+    aws_s3_client_release(client);
+    aws_s3_tester_clean_up(&tester);
+
+    return 0;
+}
+
 static void s_finished_request_remove_upload_id(
     struct aws_s3_meta_request *meta_request,
     struct aws_s3_request *request,
@@ -153,7 +153,12 @@ static int s_s3_test_meta_request_body_callback(
         ASSERT_TRUE(object_range_known);
     }
 
-    ASSERT_TRUE((object_range_start + meta_request_test_results->expected_range_start) == range_start);
+    if (meta_request->out_of_order_body_callback) {
+        /* Parts arrive in any order, only check that they are within the object */
+        ASSERT_TRUE(range_start >= object_range_start);
+    } else {
+        ASSERT_TRUE((object_range_start + meta_request_test_results->expected_range_start) == range_start);
+    }
     meta_request_test_results->expected_range_start += body->len;
 
     if (meta_request_test_results->body_callback != NULL) {
@@ -198,6 +203,11 @@ static void s_s3_test_meta_request_finish(
     aws_s3_tester_notify_meta_request_finished(tester, result);
 }
 
+static void s_s3_test_meta_request_send_buffer_released(void *user_data) {
+    struct aws_s3_meta_request_test_results *meta_request_test_results = user_data;
+    meta_request_test_results->send_buffer_released = true;
+}
+
 static void s_s3_test_meta_request_shutdown(void *user_data) {
     struct aws_s3_meta_request_test_results *meta_request_test_results = user_data;
     struct aws_s3_tester *tester = meta_request_test_results->tester;
@@ -1339,6 +1349,7 @@ int aws_s3_tester_client_new(
     struct aws_s3_client_config client_config = {
         .part_size = options->part_size,
         .max_part_size = options->max_part_size,
+        .get_hedge_options = options->get_hedge_options,
     };
     struct aws_http_proxy_options proxy_options = {
         .connection_type = AWS_HPCT_HTTP_FORWARD,
@@ -1416,6 +1427,8 @@ int aws_s3_tester_send_meta_request_with_options(
     struct aws_allocator *allocator = options->allocator;
 
     struct aws_string *filepath_str = NULL;
+    struct aws_byte_buf send_buffer;
+    AWS_ZERO_STRUCT(send_buffer);
 
     struct aws_s3_tester local_tester;
     AWS_ZERO_STRUCT(local_tester);
@@ -1633,6 +1646,22 @@ int aws_s3_tester_send_meta_request_with_options(
                 input_stream = aws_input_stream_release(input_stream);
             }
 
+            /* if uploading from memory, read input_stream into a buffer, and then upload that */
+            if (options->put_options.from_buffer) {
+                ASSERT_NOT_NULL(input_stream);
+                ASSERT_SUCCESS(aws_byte_buf_init(&send_buffer, allocator, upload_size_bytes));
+                while (send_buffer.len < send_buffer.capacity) {
+                    ASSERT_SUCCESS(aws_input_stream_read(input_stream, &send_buffer));
+                }
+                meta_request_options.send_buffer = aws_byte_cursor_from_buf(&send_buffer);
+                if (meta_request_options.send_buffer.ptr == NULL) {
+                    /* Empty body, the buffer still needs a ptr to count as set */
+                    meta_request_options.send_buffer = aws_byte_cursor_from_c_str("");
+                }
+                meta_request_options.send_buffer_release_callback = s_s3_test_meta_request_send_buffer_released;
+                input_stream = aws_input_stream_release(input_stream);
+            }
+
             /* Put together a simple S3 Put Object request. */
             struct aws_http_message *message;
             if (input_stream != NULL) {
@@ -1795,6 +1824,7 @@ int aws_s3_tester_send_meta_request_with_options(
         aws_file_delete(filepath_str);
         aws_string_destroy(filepath_str);
     }
+    aws_byte_buf_clean_up(&send_buffer);
 
     return AWS_OP_SUCCESS;
 }
@@ -132,6 +132,7 @@ struct aws_s3_tester_client_options {
     size_t max_part_size;
     const struct aws_byte_cursor *network_interface_names_array;
     size_t num_network_interface_names;
+    const struct aws_s3_get_hedge_options *get_hedge_options;
     uint32_t setup_region : 1;
     uint32_t use_proxy : 1;
 };
@@ -199,6 +200,7 @@ struct aws_s3_tester_meta_request_options {
         enum aws_async_read_completion_strategy async_read_strategy;
         size_t max_bytes_per_read; /* test an input-stream read() that doesn't always fill the buffer */
         bool file_on_disk;         /* write to file on disk, then send via aws_s3_meta_request_options.send_filepath */
+        bool from_buffer;          /* read into memory, then send via aws_s3_meta_request_options.send_buffer */
         /* If false, EOF is reported by the read() which produces the last few bytes.
          * If true, EOF isn't reported until there's one more read(), producing zero bytes.
          * This emulates an underlying stream that reports EOF by reading 0 bytes */
@@ -250,6 +252,9 @@ struct aws_s3_meta_request_test_results {
     int finished_error_code;
     enum aws_s3_checksum_algorithm algorithm;
 
+    /* Set by send_buffer_release_callback() */
+    bool send_buffer_released;
+
     /* Record data from progress_callback() */
     struct {
         uint64_t content_length;          /* Remember progress->content_length */
@@ -475,7 +480,8 @@ int aws_s3_tester_check_s3express_creds_for_default_mock_response(struct aws_cre
 
 struct aws_parallel_input_stream *aws_parallel_input_stream_new_from_file_failure_tester(
     struct aws_allocator *allocator,
-    struct aws_byte_cursor file_name);
+    struct aws_byte_cursor file_name,
+    struct aws_event_loop_group *reading_elg);
 
 extern struct aws_s3_client_vtable g_aws_s3_client_mock_vtable;
 
@@ -781,3 +781,33 @@ static int s_test_s3_aws_xml_get_body_at_path(struct aws_allocator *allocator, v
     }
     return AWS_OP_SUCCESS;
 }
+
+AWS_TEST_CASE(test_s3_next_direct_io_piece, s_test_s3_next_direct_io_piece)
+static int s_test_s3_next_direct_io_piece(struct aws_allocator *allocator, void *ctx) {
+    (void)allocator;
+    (void)ctx;
+
+    const size_t alignment = AWS_S3_BUFFER_POOL_BUFFER_ALIGNMENT;
+    const uint8_t *aligned_ptr = (const uint8_t *)(uintptr_t)(alignment * 16);
+    bool direct = false;
+
+    /* Aligned blocks go direct, the unaligned tail doesn't */
+    ASSERT_UINT_EQUALS(3 * alignment, aws_s3_next_direct_io_piece(aligned_ptr, 0, 3 * alignment + 10, &direct));
+    ASSERT_TRUE(direct);
+    ASSERT_UINT_EQUALS(10, aws_s3_next_direct_io_piece(aligned_ptr, 3 * alignment, 10, &direct));
+    ASSERT_FALSE(direct);
+
+    /* Memory and file misaligned by the same amount: the head goes through the page cache first */
+    ASSERT_UINT_EQUALS(alignment - 10, aws_s3_next_direct_io_piece(aligned_ptr + 10, 10, 2 * alignment + 10, &direct));
+    ASSERT_FALSE(direct);
+    ASSERT_UINT_EQUALS(alignment, aws_s3_next_direct_io_piece(aligned_ptr, alignment, alignment + 20, &direct));
+    ASSERT_TRUE(direct);
+
+    /* Misaligned by different amounts, or no whole block: nothing can go direct */
+    ASSERT_UINT_EQUALS(4 * alignment, aws_s3_next_direct_io_piece(aligned_ptr + 1, 0, 4 * alignment, &direct));
+    ASSERT_FALSE(direct);
+    ASSERT_UINT_EQUALS(alignment - 1, aws_s3_next_direct_io_piece(aligned_ptr, 0, alignment - 1, &direct));
+    ASSERT_FALSE(direct);
+
+    return AWS_OP_SUCCESS;
+}